@@ -0,0 +1,52 @@
+#include "Benchmark.h"
+
+#include <iostream>
+
+//==============================================================================
+Benchmark::Benchmark (const juce::String& benchmarkName)
+    : name (benchmarkName)
+{
+    getAllBenchmarks().add (this);
+}
+
+Benchmark::~Benchmark()
+{
+    getAllBenchmarks().removeFirstMatchingValue (this);
+}
+
+juce::Array<Benchmark*>& Benchmark::getAllBenchmarks()
+{
+    static juce::Array<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+juce::Array<juce::var>& Benchmark::getAllResults()
+{
+    static juce::Array<juce::var> results;
+    return results;
+}
+
+void Benchmark::report (const juce::String& caseName,
+                        double nanosecondsPerIteration,
+                        const juce::String& unit,
+                        const juce::NamedValueSet& extraMetrics) const
+{
+    std::cout << "  " << caseName.paddedRight (' ', 56)
+              << juce::String (nanosecondsPerIteration, 2).paddedLeft (' ', 12)
+              << " ns/" << unit;
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty ("benchmark", name);
+    result->setProperty ("case", caseName);
+    result->setProperty ("nanoseconds", nanosecondsPerIteration);
+    result->setProperty ("unit", unit);
+
+    for (const auto& metric : extraMetrics)
+    {
+        std::cout << "  " << metric.name.toString() << "=" << metric.value.toString();
+        result->setProperty (metric.name, metric.value);
+    }
+
+    std::cout << std::endl;
+    getAllResults().add (juce::var (result));
+}
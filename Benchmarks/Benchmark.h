@@ -0,0 +1,93 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/** Stops the compiler from optimising away a computation whose result is only
+    needed by a benchmark.
+*/
+template <typename Type>
+inline void doNotOptimise (const Type& value) noexcept
+{
+   #if JUCE_MSVC
+    static volatile const void* sink;
+    sink = &value;
+   #else
+    asm volatile ("" : : "r,m" (value) : "memory");
+   #endif
+}
+
+//==============================================================================
+/** Base class for a benchmark.
+
+    Like juce::UnitTest, each benchmark is a class with a single static instance,
+    which registers itself in a global list so that MuteBenchmarks can find and run it.
+*/
+class Benchmark
+{
+public:
+    //==============================================================================
+    explicit Benchmark (const juce::String& benchmarkName);
+    virtual ~Benchmark();
+
+    const juce::String& getName() const noexcept    { return name; }
+
+    /** Runs each of this benchmark's cases, reporting the result of each one. */
+    virtual void run() = 0;
+
+    /** Returns every benchmark that has been registered. */
+    static juce::Array<Benchmark*>& getAllBenchmarks();
+
+    /** Returns a JSON object for each case that has been reported so far. */
+    static juce::Array<juce::var>& getAllResults();
+
+protected:
+    //==============================================================================
+    /** Calls a function the given number of times, and returns the number of
+        nanoseconds taken per call.
+
+        The measurement is repeated several times after a warm-up pass, and the
+        fastest repetition is returned, as that is the one least disturbed by the
+        rest of the system.
+    */
+    template <typename Function>
+    static double measureNanoseconds (int iterations, Function&& function)
+    {
+        constexpr int numRepetitions = 5;
+
+        for (int i = 0; i < iterations; ++i)
+            function();
+
+        auto best = std::numeric_limits<double>::max();
+
+        for (int r = 0; r < numRepetitions; ++r)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < iterations; ++i)
+                function();
+
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin (best, elapsed * 1.0e9 / iterations);
+        }
+
+        return best;
+    }
+
+    /** Prints the result of one of this benchmark's cases, and records it for the
+        JSON output.
+
+        Any extra metrics are printed after the time, and added to the case's JSON
+        object under the names they're given here.
+    */
+    void report (const juce::String& caseName,
+                 double nanosecondsPerIteration,
+                 const juce::String& unit = "call",
+                 const juce::NamedValueSet& extraMetrics = {}) const;
+
+private:
+    //==============================================================================
+    juce::String name;
+
+    JUCE_DECLARE_NON_COPYABLE (Benchmark)
+};
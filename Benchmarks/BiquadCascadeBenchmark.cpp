@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+#include "../BiquadCascade.h"
+
+//==============================================================================
+/** Measures the tone filter's three biquads across channel layouts, run through
+    BiquadCascade and through a chain of juce::dsp::ProcessorDuplicators, which
+    is one scalar juce::dsp::IIR::Filter per channel per stage.
+
+    Each block starts from the same noise, so that the boost from repeated
+    filtering can't build up into infinities.
+*/
+class BiquadCascadeBenchmark final : public Benchmark
+{
+public:
+    BiquadCascadeBenchmark()  : Benchmark ("Biquad cascade") {}
+
+    void run() override
+    {
+        using Coefficients = juce::dsp::IIR::Coefficients<float>;
+        using Duplicator = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, Coefficients>;
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+
+        const Coefficients::Ptr stages[] { Coefficients::makeLowShelf (sampleRate, 1000.0f, 0.5f, 0.7f),
+                                           Coefficients::makeHighShelf (sampleRate, 1000.0f, 0.5f, 1.4f),
+                                           Coefficients::makeHighPass (sampleRate, 80.0f) };
+
+        // Stereo, 5.1, 7.1.4 and third order ambisonics
+        for (auto numChannels : { 2, 6, 12, 16 })
+        {
+            const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, (juce::uint32) numChannels };
+            const auto iterations = juce::jmax (64, (1 << 20) / (numChannels * blockSize));
+            const auto label = juce::String (numChannels) + " ch: ";
+
+            juce::AudioBuffer<float> source (numChannels, blockSize), buffer (numChannels, blockSize);
+            fillWithNoise (source);
+            juce::dsp::AudioBlock<float> block (buffer);
+
+            juce::dsp::ProcessorChain<Duplicator, Duplicator, Duplicator> chain;
+            *chain.get<0>().state = *stages[0];
+            *chain.get<1>().state = *stages[1];
+            *chain.get<2>().state = *stages[2];
+            chain.prepare (spec);
+
+            const auto duplicatorTime = measureNanoseconds (iterations, [&]
+            {
+                buffer.makeCopyOf (source, true);
+                chain.process (juce::dsp::ProcessContextReplacing<float> (block));
+                doNotOptimise (buffer.getReadPointer (0)[0]);
+            });
+
+            report (label + "ProcessorDuplicator", duplicatorTime / blockSize, "frame");
+
+            BiquadCascade<float> cascade;
+            cascade.prepare (spec);
+            cascade.setNumStages (3);
+
+            for (int stage = 0; stage < 3; ++stage)
+                cascade.setCoefficients (stage, *stages[stage]);
+
+            const auto cascadeTime = measureNanoseconds (iterations, [&]
+            {
+                buffer.makeCopyOf (source, true);
+                cascade.process (juce::dsp::ProcessContextReplacing<float> (block));
+                doNotOptimise (buffer.getReadPointer (0)[0]);
+            });
+
+            juce::NamedValueSet metrics;
+            metrics.set ("speedup", duplicatorTime / cascadeTime);
+
+            report (label + "BiquadCascade", cascadeTime / blockSize, "frame", metrics);
+        }
+    }
+
+private:
+    static void fillWithNoise (juce::AudioBuffer<float>& buffer)
+    {
+        juce::Random random (0x3d);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+};
+
+static BiquadCascadeBenchmark biquadCascadeBenchmark;
@@ -0,0 +1,72 @@
+#include "CacheMissCounter.h"
+
+#if JUCE_LINUX
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+CacheMissCounter::CacheMissCounter()
+{
+   #if JUCE_LINUX
+    perf_event_attr attributes {};
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof (attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // Counts the calling thread, on whichever CPU it happens to run
+    fd = (int) syscall (SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+   #endif
+}
+
+CacheMissCounter::~CacheMissCounter()
+{
+   #if JUCE_LINUX
+    if (isAvailable())
+        close (fd);
+   #endif
+}
+
+void CacheMissCounter::reset() noexcept
+{
+   #if JUCE_LINUX
+    if (isAvailable())
+    {
+        ioctl (fd, PERF_EVENT_IOC_DISABLE, 0);
+        ioctl (fd, PERF_EVENT_IOC_RESET, 0);
+    }
+   #endif
+}
+
+void CacheMissCounter::resume() noexcept
+{
+   #if JUCE_LINUX
+    if (isAvailable())
+        ioctl (fd, PERF_EVENT_IOC_ENABLE, 0);
+   #endif
+}
+
+void CacheMissCounter::pause() noexcept
+{
+   #if JUCE_LINUX
+    if (isAvailable())
+        ioctl (fd, PERF_EVENT_IOC_DISABLE, 0);
+   #endif
+}
+
+juce::int64 CacheMissCounter::getCount() const noexcept
+{
+   #if JUCE_LINUX
+    juce::int64 count = 0;
+
+    if (isAvailable() && read (fd, &count, sizeof (count)) == (ssize_t) sizeof (count))
+        return count;
+   #endif
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/** Counts the hardware cache misses caused by the calling thread, using
+    perf_event_open.
+
+    This only works on Linux, and only when the kernel lets unprivileged users
+    read hardware counters (see /proc/sys/kernel/perf_event_paranoid), which
+    often isn't the case inside containers and VMs. Everywhere else, isAvailable()
+    returns false and the benchmarks leave cache misses out of their results.
+
+    Counting can be paused and resumed, so that only the code being measured
+    contributes to the total.
+*/
+class CacheMissCounter final
+{
+public:
+    //==============================================================================
+    CacheMissCounter();
+    ~CacheMissCounter();
+
+    /** Returns true if the counter could be opened. */
+    bool isAvailable() const noexcept       { return fd >= 0; }
+
+    /** Sets the count back to zero. The counter is left paused. */
+    void reset() noexcept;
+
+    /** Starts or continues counting. */
+    void resume() noexcept;
+
+    /** Stops counting, without resetting the total. */
+    void pause() noexcept;
+
+    /** Returns the number of cache misses counted since the last reset(). */
+    juce::int64 getCount() const noexcept;
+
+private:
+    //==============================================================================
+    int fd = -1;
+
+    JUCE_DECLARE_NON_COPYABLE (CacheMissCounter)
+};
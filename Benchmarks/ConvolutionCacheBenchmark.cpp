@@ -0,0 +1,137 @@
+#include "Benchmark.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+#if JUCE_LINUX && defined (__GLIBC__)
+ #include <malloc.h>
+#endif
+
+//==============================================================================
+/** Loads a session's worth of juce::dsp::Convolution instances, all with the same
+    room IR, and then each with an IR of its own, which they can't share.
+
+    Load times are per instance, from loading the IR through to preparing the
+    convolution. Memory is the heap in use per instance while they're all loaded,
+    which is only measured with glibc, and left out of the results elsewhere.
+*/
+class ConvolutionCacheBenchmark final : public Benchmark
+{
+public:
+    ConvolutionCacheBenchmark()  : Benchmark ("Convolution IR cache") {}
+
+    void run() override
+    {
+        constexpr int numInstances = 200;
+
+        // The IR's rate matches the spec, so that loading doesn't resample it
+        const juce::dsp::ProcessSpec spec { 44100.0, 512, 2 };
+        const auto ir = makeRoomImpulseResponse (spec.sampleRate);
+
+        const auto label = juce::String (numInstances) + " instances, 1 second stereo IR, ";
+
+        const auto distinct = measure (spec, ir, numInstances, false);
+
+        juce::NamedValueSet distinctMetrics;
+        addBytesPerInstance (distinctMetrics, distinct);
+        report (label + "a different IR each", distinct.nanosecondsPerInstance, "instance", distinctMetrics);
+
+        const auto shared = measure (spec, ir, numInstances, true);
+
+        juce::NamedValueSet sharedMetrics;
+        addBytesPerInstance (sharedMetrics, shared);
+        sharedMetrics.set ("speedup", distinct.nanosecondsPerInstance / shared.nanosecondsPerInstance);
+
+        if (distinct.bytesPerInstance && shared.bytesPerInstance)
+            sharedMetrics.set ("memorySaving", (double) *distinct.bytesPerInstance / (double) *shared.bytesPerInstance);
+
+        report (label + "the same IR", shared.nanosecondsPerInstance, "instance", sharedMetrics);
+    }
+
+private:
+    struct Result
+    {
+        double nanosecondsPerInstance;
+        std::optional<juce::int64> bytesPerInstance;
+    };
+
+    static Result measure (const juce::dsp::ProcessSpec& spec,
+                           const juce::AudioBuffer<float>& ir,
+                           int numInstances,
+                           bool shareIR)
+    {
+        // A shared queue saves starting a background thread for every instance
+        juce::dsp::ConvolutionMessageQueue queue;
+        std::vector<std::unique_ptr<juce::dsp::Convolution>> instances;
+
+        const auto loadAll = [&]
+        {
+            for (int i = 0; i < numInstances; ++i)
+            {
+                auto& convolution = instances.emplace_back (std::make_unique<juce::dsp::Convolution> (queue));
+
+                auto copy = ir;
+
+                // One sample is enough to stop the IRs being recognised as the same
+                if (! shareIR)
+                    copy.setSample (0, 0, copy.getSample (0, 0) + (float) i * 1.0e-6f);
+
+                convolution->loadImpulseResponse (std::move (copy),
+                                                  spec.sampleRate,
+                                                  juce::dsp::Convolution::Stereo::yes,
+                                                  juce::dsp::Convolution::Trim::no,
+                                                  juce::dsp::Convolution::Normalise::yes);
+                convolution->prepare (spec);
+            }
+        };
+
+        const auto nanoseconds = measureNanoseconds (1, [&]
+        {
+            loadAll();
+            doNotOptimise (instances.back()->getCurrentIRSize());
+            instances.clear();
+        });
+
+        Result result { nanoseconds / numInstances, {} };
+
+        if (const auto before = getHeapBytesInUse())
+        {
+            loadAll();
+            result.bytesPerInstance = (*getHeapBytesInUse() - *before) / numInstances;
+            instances.clear();
+        }
+
+        return result;
+    }
+
+    static void addBytesPerInstance (juce::NamedValueSet& metrics, const Result& result)
+    {
+        if (result.bytesPerInstance)
+            metrics.set ("bytesPerInstance", *result.bytesPerInstance);
+    }
+
+    static std::optional<juce::int64> getHeapBytesInUse()
+    {
+       #if JUCE_LINUX && defined (__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        const auto info = mallinfo2();
+        return (juce::int64) (info.uordblks + info.hblkhd);
+       #else
+        return {};
+       #endif
+    }
+
+    /** Exponentially decaying noise, different on each channel. */
+    static juce::AudioBuffer<float> makeRoomImpulseResponse (double sampleRate)
+    {
+        const auto length = (int) sampleRate;
+        juce::AudioBuffer<float> ir (2, length);
+        juce::Random random (0x1234);
+
+        for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+            for (int i = 0; i < length; ++i)
+                ir.setSample (ch, i, (random.nextFloat() * 2.0f - 1.0f) * std::exp (-6.9f * (float) i / (float) length));
+
+        return ir;
+    }
+};
+
+static ConvolutionCacheBenchmark convolutionCacheBenchmark;
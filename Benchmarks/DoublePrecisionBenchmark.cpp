@@ -0,0 +1,119 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Wraps the processor but only offers the float processBlock, so that a double
+    precision graph has to convert each block to float and back around it, which
+    is what happened before the processor supported double precision.
+*/
+class FloatOnlyProcessor final : public juce::AudioProcessor
+{
+public:
+    FloatOnlyProcessor()
+        : AudioProcessor (BusesProperties().withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                                           .withOutput ("Output", juce::AudioChannelSet::stereo(), true))
+    {
+    }
+
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override
+    {
+        inner.setPlayConfigDetails (getTotalNumInputChannels(), getTotalNumOutputChannels(), sampleRate, samplesPerBlock);
+        inner.prepareToPlay (sampleRate, samplesPerBlock);
+    }
+
+    void releaseResources() override                                        { inner.releaseResources(); }
+    void processBlock (juce::AudioBuffer<float>& b, juce::MidiBuffer& m) override { inner.processBlock (b, m); }
+    using AudioProcessor::processBlock;
+
+    const juce::String getName() const override                             { return "Float only"; }
+    double getTailLengthSeconds() const override                            { return 0.0; }
+    bool acceptsMidi() const override                                       { return false; }
+    bool producesMidi() const override                                      { return false; }
+    juce::AudioProcessorEditor* createEditor() override                     { return nullptr; }
+    bool hasEditor() const override                                         { return false; }
+    int getNumPrograms() override                                           { return 1; }
+    int getCurrentProgram() override                                        { return 0; }
+    void setCurrentProgram (int) override                                   {}
+    const juce::String getProgramName (int) override                        { return {}; }
+    void changeProgramName (int, const juce::String&) override              {}
+    void getStateInformation (juce::MemoryBlock&) override                  {}
+    void setStateInformation (const void*, int) override                    {}
+
+private:
+    AudioPluginAudioProcessor inner;
+};
+
+//==============================================================================
+/** Runs a chain of processors in an AudioProcessorGraph at double precision,
+    comparing the shared double precision path with the float-only conversion.
+*/
+class DoublePrecisionBenchmark final : public Benchmark
+{
+public:
+    DoublePrecisionBenchmark()  : Benchmark ("Double precision graph") {}
+
+    void run() override
+    {
+        for (auto blockSize : { 32, 256, 2048 })
+        {
+            for (auto chainLength : { 1, 16 })
+            {
+                const auto label = juce::String (chainLength) + " node(s), " + juce::String (blockSize) + " samples: ";
+                const auto iterations = juce::jmax (64, (1 << 20) / (chainLength * blockSize));
+
+                report (label + "double processBlock",
+                        measureGraph<AudioPluginAudioProcessor> (chainLength, blockSize, iterations), "block");
+
+                report (label + "float processBlock + conversion",
+                        measureGraph<FloatOnlyProcessor> (chainLength, blockSize, iterations), "block");
+            }
+        }
+    }
+
+private:
+    template <typename ProcessorType>
+    static double measureGraph (int chainLength, int blockSize, int iterations)
+    {
+        using IOProcessor = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+        constexpr double sampleRate = 48000.0;
+
+        juce::AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        graph.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+
+        auto previous = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioInputNode))->nodeID;
+        const auto output = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioOutputNode))->nodeID;
+
+        const auto connect = [&] (auto source, auto destination)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                graph.addConnection ({ { source, ch }, { destination, ch } });
+        };
+
+        for (int i = 0; i < chainLength; ++i)
+        {
+            const auto node = graph.addNode (std::make_unique<ProcessorType>())->nodeID;
+            connect (previous, node);
+            previous = node;
+        }
+
+        connect (previous, output);
+        graph.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<double> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        buffer.clear();
+
+        const auto result = measureNanoseconds (iterations, [&]
+        {
+            graph.processBlock (buffer, midi);
+            doNotOptimise (buffer.getReadPointer (0)[0]);
+        });
+
+        graph.releaseResources();
+        return result;
+    }
+};
+
+static DoublePrecisionBenchmark doublePrecisionBenchmark;
@@ -0,0 +1,123 @@
+#include "Benchmark.h"
+
+#include "../FIREngine.h"
+
+//==============================================================================
+/** Measures a stereo FIR filter across kernel lengths and block sizes, run through
+    juce::dsp::FIR::Filter and through each of FIREngine's methods.
+
+    The partitioned FFT's "vsDirect" metric is the direct form's time divided by
+    its own, so the crossover is where that goes above 1, which is what
+    FIREngine::crossoverTaps is based on.
+
+    Each block starts from the same noise, so that the level can't drift up or
+    down into infinities or denormals.
+*/
+class FIREngineBenchmark final : public Benchmark
+{
+public:
+    FIREngineBenchmark()  : Benchmark ("FIR engine") {}
+
+    void run() override
+    {
+        using Filter = juce::dsp::FIR::Filter<float>;
+        using Coefficients = juce::dsp::FIR::Coefficients<float>;
+        using Duplicator = juce::dsp::ProcessorDuplicator<Filter, Coefficients>;
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int numChannels = 2;
+
+        for (auto blockSize : { 64, 256, 1024 })
+        {
+            const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, (juce::uint32) numChannels };
+
+            juce::AudioBuffer<float> source (numChannels, blockSize), buffer (numChannels, blockSize);
+            fillWithNoise (source);
+            juce::dsp::AudioBlock<float> sourceBlock (source), block (buffer);
+
+            for (auto numTaps : { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+            {
+                const auto kernel = makeKernel (numTaps);
+                const auto iterations = juce::jmax (16, (1 << 21) / (numTaps * blockSize));
+                const auto label = juce::String (numTaps) + " taps, " + juce::String (blockSize) + "-sample blocks: ";
+
+                Duplicator duplicator;
+                duplicator.state = new Coefficients (kernel.data(), kernel.size());
+                duplicator.prepare (spec);
+
+                const auto filterTime = measureNanoseconds (iterations, [&]
+                {
+                    block.copyFrom (sourceBlock);
+                    duplicator.process (juce::dsp::ProcessContextReplacing<float> (block));
+                    doNotOptimise (buffer.getReadPointer (0)[0]);
+                });
+
+                report (label + "juce::dsp::FIR::Filter", filterTime / blockSize, "frame");
+
+                const auto directTime = measureEngine (spec, kernel, FIREngine::Method::directForm, iterations, sourceBlock, block);
+
+                juce::NamedValueSet directMetrics;
+                directMetrics.set ("speedup", filterTime / directTime);
+
+                report (label + "direct form", directTime / blockSize, "frame", directMetrics);
+
+                const auto fftTime = measureEngine (spec, kernel, FIREngine::Method::partitionedFFT, iterations, sourceBlock, block);
+
+                juce::NamedValueSet fftMetrics;
+                fftMetrics.set ("speedup", filterTime / fftTime);
+                fftMetrics.set ("vsDirect", directTime / fftTime);
+
+                report (label + "partitioned FFT", fftTime / blockSize, "frame", fftMetrics);
+            }
+        }
+    }
+
+private:
+    static double measureEngine (const juce::dsp::ProcessSpec& spec,
+                                 const std::vector<float>& kernel,
+                                 FIREngine::Method method,
+                                 int iterations,
+                                 const juce::dsp::AudioBlock<float>& sourceBlock,
+                                 juce::dsp::AudioBlock<float> block)
+    {
+        FIREngine engine;
+        engine.setKernel (kernel.data(), (int) kernel.size(), method);
+        engine.prepare (spec);
+
+        return measureNanoseconds (iterations, [&]
+        {
+            block.copyFrom (sourceBlock);
+            engine.process (juce::dsp::ProcessContextReplacing<float> (block));
+            doNotOptimise (block.getChannelPointer (0)[0]);
+        });
+    }
+
+    /** A windowed sinc low pass, at a quarter of the sample rate. */
+    static std::vector<float> makeKernel (int numTaps)
+    {
+        std::vector<float> kernel ((size_t) numTaps);
+        const auto centre = (numTaps - 1) * 0.5;
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            const auto x = (i - centre) * 0.5;
+            const auto sinc = juce::approximatelyEqual (x, 0.0) ? 1.0 : std::sin (juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const auto window = 0.5 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * (i + 0.5) / numTaps);
+
+            kernel[(size_t) i] = (float) (0.5 * sinc * window);
+        }
+
+        return kernel;
+    }
+
+    static void fillWithNoise (juce::AudioBuffer<float>& buffer)
+    {
+        juce::Random random (0x3d);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+};
+
+static FIREngineBenchmark firEngineBenchmark;
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+#include "../GainKernel.h"
+
+//==============================================================================
+/** Measures the gain kernels across channel counts and block sizes, against the
+    plain per-sample loop that processBlock used to run.
+*/
+class GainKernelBenchmark final : public Benchmark
+{
+public:
+    GainKernelBenchmark()  : Benchmark ("Gain kernel") {}
+
+    void run() override
+    {
+        for (auto numChannels : { 1, 2, 6, 8, 16, 32, 64 })
+        {
+            for (auto blockSize : { 16, 64, 256, 1024, 4096 })
+            {
+                juce::AudioBuffer<float> buffer (numChannels, blockSize);
+                fillWithNoise (buffer);
+
+                const juce::dsp::AudioBlock<float> block (buffer);
+                auto* const* channels = buffer.getArrayOfWritePointers();
+
+                // Enough iterations to process roughly the same amount of audio in each case
+                const auto iterations = juce::jmax (16, (1 << 22) / (numChannels * blockSize));
+                const auto numSamples = (double) numChannels * blockSize;
+                const auto label = juce::String (numChannels) + " ch x " + juce::String (blockSize) + ": ";
+
+                // Alternating between two gains whose product is one keeps the
+                // buffer's contents from drifting into denormals or infinities.
+                auto flip = false;
+
+                report (label + "scalar loop",
+                        measureNanoseconds (iterations, [&]
+                        {
+                            const auto gain = (flip = ! flip) ? 0.5f : 2.0f;
+
+                            for (int ch = 0; ch < numChannels; ++ch)
+                                for (int i = 0; i < blockSize; ++i)
+                                    channels[ch][i] *= gain;
+
+                            doNotOptimise (channels[0][0]);
+                        }) / numSamples, "sample");
+
+                report (label + "GainKernel::applyGain",
+                        measureNanoseconds (iterations, [&]
+                        {
+                            GainKernel::applyGain (block, (flip = ! flip) ? 0.5f : 2.0f);
+                            doNotOptimise (channels[0][0]);
+                        }) / numSamples, "sample");
+
+                report (label + "scalar ramp",
+                        measureNanoseconds (iterations, [&]
+                        {
+                            const auto startGain = (flip = ! flip) ? 0.5f : 2.0f;
+                            const auto ratio = std::pow (1.0f / (startGain * startGain), 1.0f / (float) blockSize);
+
+                            for (int ch = 0; ch < numChannels; ++ch)
+                                GainKernel::detail::rampChannelScalar (channels[ch], (size_t) blockSize, startGain, ratio);
+
+                            doNotOptimise (channels[0][0]);
+                        }) / numSamples, "sample");
+
+                report (label + "GainKernel::applyGainRamp",
+                        measureNanoseconds (iterations, [&]
+                        {
+                            const auto startGain = (flip = ! flip) ? 0.5f : 2.0f;
+                            GainKernel::applyGainRamp (block, startGain, 1.0f / startGain);
+                            doNotOptimise (channels[0][0]);
+                        }) / numSamples, "sample");
+            }
+        }
+    }
+
+private:
+    static void fillWithNoise (juce::AudioBuffer<float>& buffer)
+    {
+        juce::Random random (0x3d);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+};
+
+static GainKernelBenchmark gainKernelBenchmark;
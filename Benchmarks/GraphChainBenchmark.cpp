@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Renders chains of 100 Mute instances in an AudioProcessorGraph, to measure
+    what the graph itself adds to the cost of the instances: the copies, mixes
+    and clears that its render sequence does between them.
+
+    There are three layouts:
+    - one chain of 100 instances, which the graph processes in place from end to
+      end
+    - eight chains of 100, all fed from the graph's input and mixed into its
+      output
+    - 100 instances side by side, all fed from the graph's input and mixed into its
+      output, so the output node's input is a mix of 100 sources
+
+    For each one, this reports the time to render a block, and "perInstance", that
+    time divided by the number of instances. Each layout is then rendered again
+    with a processor that does nothing in place of each instance, which leaves
+    only the graph's own work.
+*/
+class GraphChainBenchmark final : public Benchmark
+{
+public:
+    GraphChainBenchmark()  : Benchmark ("Graph chains") {}
+
+    void run() override
+    {
+        struct Layout
+        {
+            juce::String name;
+            int numChains, chainLength;
+        };
+
+        for (const auto emptyProcessors : { false, true })
+        for (const auto& layout : { Layout { "1 chain of 100 instances", 1, 100 },
+                                    Layout { "8 chains of 100 instances, mixed", 8, 100 },
+                                    Layout { "100 instances side by side, mixed", 100, 1 } })
+        {
+            auto graph = createGraph (layout.numChains, layout.chainLength, emptyProcessors);
+            juce::AudioBuffer<float> buffer (numChannels, blockSize);
+            juce::MidiBuffer midi;
+            juce::Random random (0x5e);
+
+            const auto nanoseconds = measureNanoseconds (iterations, [&]
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample (ch, i, random.nextFloat() - 0.5f);
+
+                midi.clear();
+                graph->processBlock (buffer, midi);
+                doNotOptimise (buffer.getReadPointer (0)[0]);
+            });
+
+            juce::NamedValueSet metrics;
+            metrics.set ("perInstance", nanoseconds / (layout.numChains * layout.chainLength));
+
+            report (layout.name + (emptyProcessors ? ", empty processors" : ""), nanoseconds, "block", metrics);
+
+            graph->releaseResources();
+        }
+    }
+
+private:
+    static constexpr int numChannels = 2, blockSize = 512;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int iterations = 200;
+
+    /** A stereo processor that leaves its input as it is. */
+    class EmptyProcessor final : public juce::AudioProcessor
+    {
+    public:
+        EmptyProcessor()
+            : AudioProcessor (BusesProperties().withInput  ("Input",  juce::AudioChannelSet::stereo())
+                                               .withOutput ("Output", juce::AudioChannelSet::stereo()))
+        {
+        }
+
+        const juce::String getName() const override                           { return "Empty"; }
+        void prepareToPlay (double, int) override                             {}
+        void releaseResources() override                                      {}
+        void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+        using AudioProcessor::processBlock;
+
+        double getTailLengthSeconds() const override                          { return 0.0; }
+        bool acceptsMidi() const override                                     { return false; }
+        bool producesMidi() const override                                    { return false; }
+        juce::AudioProcessorEditor* createEditor() override                   { return nullptr; }
+        bool hasEditor() const override                                       { return false; }
+        int getNumPrograms() override                                         { return 1; }
+        int getCurrentProgram() override                                      { return 0; }
+        void setCurrentProgram (int) override                                 {}
+        const juce::String getProgramName (int) override                      { return {}; }
+        void changeProgramName (int, const juce::String&) override            {}
+        void getStateInformation (juce::MemoryBlock&) override                {}
+        void setStateInformation (const void*, int) override                  {}
+    };
+
+    static std::unique_ptr<juce::AudioProcessorGraph> createGraph (int numChains, int chainLength, bool emptyProcessors)
+    {
+        using Graph = juce::AudioProcessorGraph;
+        using IO = Graph::AudioGraphIOProcessor;
+        constexpr auto none = Graph::UpdateKind::none;
+
+        auto graph = std::make_unique<Graph>();
+        graph->setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+
+        const auto audioIn = graph->addNode (std::make_unique<IO> (IO::audioInputNode), std::nullopt, none)->nodeID;
+        const auto audioOut = graph->addNode (std::make_unique<IO> (IO::audioOutputNode), std::nullopt, none)->nodeID;
+
+        for (int chain = 0; chain < numChains; ++chain)
+        {
+            auto previous = audioIn;
+
+            for (int i = 0; i < chainLength; ++i)
+            {
+                auto processor = emptyProcessors ? std::unique_ptr<juce::AudioProcessor> (std::make_unique<EmptyProcessor>())
+                                                 : std::unique_ptr<juce::AudioProcessor> (std::make_unique<AudioPluginAudioProcessor>());
+
+                const auto node = graph->addNode (std::move (processor), std::nullopt, none)->nodeID;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    graph->addConnection ({ { previous, ch }, { node, ch } }, none);
+
+                previous = node;
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                graph->addConnection ({ { previous, ch }, { audioOut, ch } }, none);
+        }
+
+        graph->prepareToPlay (sampleRate, blockSize);
+        graph->rebuild();
+        return graph;
+    }
+};
+
+static GraphChainBenchmark graphChainBenchmark;
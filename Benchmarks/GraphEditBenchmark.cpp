@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Measures how long an edit to a large AudioProcessorGraph takes to reach the
+    audio thread: the time from a call to addConnection or removeConnection, to
+    the new render sequence being ready to swap in.
+
+    The graphs are random webs of Mute instances of a few sizes up to 2000, each
+    instance fed by one or two earlier ones, or by the graph's input, with a share
+    of them mixed into the graph's output. Each edit connects two random instances
+    that weren't already connected, or removes that connection again, and asks for
+    a synchronous rebuild, which is what a host's editing gestures end up waiting
+    for.
+*/
+class GraphEditBenchmark final : public Benchmark
+{
+public:
+    GraphEditBenchmark()  : Benchmark ("Graph edits") {}
+
+    void run() override
+    {
+        for (const auto numInstances : { 250, 500, 1000, 2000 })
+        {
+            using Graph = juce::AudioProcessorGraph;
+
+            juce::Random random (0x5eed);
+            std::vector<Graph::NodeID> instances;
+            auto graph = createGraph (numInstances, random, instances);
+
+            const auto nanoseconds = measureNanoseconds (iterations, [&]
+            {
+                Graph::Connection connection;
+
+                do
+                {
+                    const auto a = random.nextInt (numInstances), b = random.nextInt (numInstances);
+                    connection = { { instances[(size_t) juce::jmin (a, b)], random.nextInt (numChannels) },
+                                   { instances[(size_t) juce::jmax (a, b)], random.nextInt (numChannels) } };
+                }
+                while (! graph->canConnect (connection));
+
+                graph->addConnection (connection, Graph::UpdateKind::sync);
+                graph->removeConnection (connection, Graph::UpdateKind::sync);
+            });
+
+            juce::NamedValueSet metrics;
+            metrics.set ("connections", (int) graph->getConnections().size());
+
+            report (juce::String (numInstances) + " instances", nanoseconds / 2, "edit", metrics);
+
+            graph->releaseResources();
+        }
+    }
+
+private:
+    static constexpr int numChannels = 2, blockSize = 512;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int iterations = 2;
+
+    static std::unique_ptr<juce::AudioProcessorGraph> createGraph (int numInstances, juce::Random& random,
+                                                                   std::vector<juce::AudioProcessorGraph::NodeID>& instances)
+    {
+        using Graph = juce::AudioProcessorGraph;
+        using IO = Graph::AudioGraphIOProcessor;
+        constexpr auto none = Graph::UpdateKind::none;
+
+        auto graph = std::make_unique<Graph>();
+        graph->setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+
+        const auto audioIn = graph->addNode (std::make_unique<IO> (IO::audioInputNode), std::nullopt, none)->nodeID;
+        const auto audioOut = graph->addNode (std::make_unique<IO> (IO::audioOutputNode), std::nullopt, none)->nodeID;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            const auto node = graph->addNode (std::make_unique<AudioPluginAudioProcessor>(), std::nullopt, none)->nodeID;
+
+            // Connecting each instance only to earlier ones keeps the graph free of feedback loops
+            const auto numSources = random.nextInt (2) + 1;
+
+            for (int s = 0; s < numSources; ++s)
+            {
+                const auto source = i < 8 ? audioIn : instances[(size_t) random.nextInt (i)];
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    graph->addConnection ({ { source, ch }, { node, ch } }, none);
+            }
+
+            if (random.nextInt (8) == 0)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    graph->addConnection ({ { node, ch }, { audioOut, ch } }, none);
+
+            instances.push_back (node);
+        }
+
+        graph->prepareToPlay (sampleRate, blockSize);
+        graph->rebuild();
+        return graph;
+    }
+};
+
+static GraphEditBenchmark graphEditBenchmark;
@@ -0,0 +1,149 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Renders a graph of Mute instances with AudioProcessorGraph's parallel render
+    mode, at each number of render threads from none, which is the usual
+    sequential render, up to 32.
+
+    The graph is a session's worth of tracks, each a chain of instances fed from
+    the graph's input, all summed into its output. For each number of threads, this
+    reports the time to render a block, "speedup", the sequential time divided by
+    this one, and "identical", which is 1 if the output matched the sequential
+    render's sample for sample.
+
+    The audio callback's thread counts as one of the threads doing the work, so
+    the speedup can't be expected to grow beyond the number of threads plus one,
+    or the number of CPU cores, whichever is smaller. Each case reports "cpuCores"
+    so that results from different machines can be told apart. On a machine with
+    a single core, the results only show the parallel mode's overhead.
+*/
+class GraphRenderBenchmark final : public Benchmark
+{
+public:
+    GraphRenderBenchmark()  : Benchmark ("Graph render") {}
+
+    void run() override
+    {
+        const auto input = makeNoise();
+        double sequentialTime = 0.0;
+        std::vector<float> sequentialOutput;
+
+        for (const auto numThreads : { 0, 1, 2, 4, 8, 16, 32 })
+        {
+            auto graph = createGraph (numThreads);
+            juce::AudioBuffer<float> buffer (numChannels, blockSize);
+            juce::MidiBuffer midi;
+
+            // A fresh graph renders the same few blocks in every pass, so these
+            // can be compared with the sequential render
+            std::vector<float> output;
+
+            for (int block = 0; block < numComparedBlocks; ++block)
+            {
+                render (*graph, input, buffer, midi);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    output.insert (output.end(), buffer.getReadPointer (ch), buffer.getReadPointer (ch) + blockSize);
+            }
+
+            const auto nanoseconds = measureNanoseconds (iterations, [&]
+            {
+                render (*graph, input, buffer, midi);
+                doNotOptimise (buffer.getReadPointer (0)[0]);
+            });
+
+            if (numThreads == 0)
+            {
+                sequentialTime = nanoseconds;
+                sequentialOutput = output;
+            }
+
+            juce::NamedValueSet metrics;
+            metrics.set ("speedup", sequentialTime / nanoseconds);
+            metrics.set ("identical", output == sequentialOutput ? 1 : 0);
+            metrics.set ("cpuCores", juce::SystemStats::getNumCpus());
+
+            const auto label = juce::String (numTracks) + " tracks of " + juce::String (instancesPerTrack) + " instances, "
+                             + (numThreads == 0 ? juce::String ("sequential")
+                                                : juce::String (numThreads) + (numThreads == 1 ? " render thread" : " render threads"));
+
+            report (label, nanoseconds, "block", metrics);
+
+            graph->releaseResources();
+        }
+    }
+
+private:
+    static constexpr int numTracks = 64, instancesPerTrack = 4;
+    static constexpr int numChannels = 2, blockSize = 512;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int numComparedBlocks = 8, iterations = 100;
+
+    static std::unique_ptr<juce::AudioProcessorGraph> createGraph (int numThreads)
+    {
+        using Graph = juce::AudioProcessorGraph;
+        using IO = Graph::AudioGraphIOProcessor;
+        constexpr auto none = Graph::UpdateKind::none;
+
+        auto graph = std::make_unique<Graph>();
+        graph->setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+        graph->setNumRenderThreads (numThreads);
+
+        const auto audioIn = graph->addNode (std::make_unique<IO> (IO::audioInputNode), std::nullopt, none)->nodeID;
+        const auto audioOut = graph->addNode (std::make_unique<IO> (IO::audioOutputNode), std::nullopt, none)->nodeID;
+
+        juce::Random random (0x5eed);
+
+        for (int track = 0; track < numTracks; ++track)
+        {
+            auto previous = audioIn;
+
+            for (int i = 0; i < instancesPerTrack; ++i)
+            {
+                auto processor = std::make_unique<AudioPluginAudioProcessor>();
+                auto* gain = processor->parameters.getParameter (ParameterIDs::gain);
+                gain->setValueNotifyingHost (gain->convertTo0to1 (-3.0f * random.nextFloat()));
+
+                const auto node = graph->addNode (std::move (processor), std::nullopt, none)->nodeID;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    graph->addConnection ({ { previous, ch }, { node, ch } }, none);
+
+                previous = node;
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                graph->addConnection ({ { previous, ch }, { audioOut, ch } }, none);
+        }
+
+        graph->prepareToPlay (sampleRate, blockSize);
+        graph->rebuild();
+        return graph;
+    }
+
+    static void render (juce::AudioProcessorGraph& graph, const juce::AudioBuffer<float>& input,
+                        juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.copyFrom (ch, 0, input, ch, 0, blockSize);
+
+        midi.clear();
+        graph.processBlock (buffer, midi);
+    }
+
+    static juce::AudioBuffer<float> makeNoise()
+    {
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+        juce::Random random (0x5e);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample (ch, i, random.nextFloat() - 0.5f);
+
+        return buffer;
+    }
+};
+
+static GraphRenderBenchmark graphRenderBenchmark;
@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+
+#include "../LookaheadLimiter.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/** Measures the lookahead limiter at each lookahead time, against juce::dsp::Limiter
+    with the same ceiling and release, at 48 and 96 kHz.
+
+    The input is noise with loud sections and single sample spikes, so both
+    limiters spend most of their time reducing the gain. Alongside the time, each
+    case reports how far its output went over the ceiling.
+*/
+class LookaheadLimiterBenchmark final : public Benchmark
+{
+public:
+    LookaheadLimiterBenchmark()  : Benchmark ("Lookahead limiter") {}
+
+    void run() override
+    {
+        for (auto sampleRate : { 48000.0, 96000.0 })
+        {
+            const auto source = makeBursts ((int) sampleRate);
+            juce::AudioBuffer<float> buffer (source.getNumChannels(), source.getNumSamples());
+            const auto numSamples = (double) source.getNumSamples();
+            const auto label = juce::String (sampleRate / 1000.0) + " kHz: ";
+
+            juce::dsp::Limiter<float> juceLimiter;
+            juceLimiter.prepare ({ sampleRate, (juce::uint32) blockSize, (juce::uint32) source.getNumChannels() });
+            juceLimiter.setThreshold (ceilingDecibels);
+            juceLimiter.setRelease ((float) LookaheadLimiter<float>::releaseSeconds * 1000.0f);
+
+            const auto juceTime = measureNanoseconds (iterations, [&]
+            {
+                buffer.makeCopyOf (source, true);
+
+                for (int start = 0; start < buffer.getNumSamples(); start += blockSize)
+                {
+                    auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) blockSize);
+                    juceLimiter.process (juce::dsp::ProcessContextReplacing<float> (block));
+                }
+
+                doNotOptimise (buffer.getReadPointer (0)[0]);
+            });
+
+            report (label + "juce::dsp::Limiter", juceTime / numSamples, "sample", getOvershoot (buffer));
+
+            for (auto lookahead : { 1.0f, 5.0f, 20.0f })
+            {
+                LookaheadLimiter<float> limiter (source.getNumChannels(), sampleRate, blockSize, lookahead);
+
+                const auto time = measureNanoseconds (iterations, [&]
+                {
+                    buffer.makeCopyOf (source, true);
+
+                    for (int start = 0; start < buffer.getNumSamples(); start += blockSize)
+                    {
+                        juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, blockSize);
+                        limiter.process (block, ceilingDecibels);
+                    }
+
+                    doNotOptimise (buffer.getReadPointer (0)[0]);
+                });
+
+                auto metrics = getOvershoot (buffer);
+                metrics.set ("relativeToJuce", time / juceTime);
+
+                report (label + "LookaheadLimiter " + juce::String (lookahead) + " ms", time / numSamples, "sample", metrics);
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr int blockSize = 256;
+    static constexpr int iterations = 8;
+    static constexpr float ceilingDecibels = -1.0f;
+
+    static juce::NamedValueSet getOvershoot (const juce::AudioBuffer<float>& output)
+    {
+        const auto peak = juce::Decibels::gainToDecibels (output.getMagnitude (0, output.getNumSamples()));
+
+        juce::NamedValueSet metrics;
+        metrics.set ("overshootDecibels", juce::jmax (0.0f, peak - ceilingDecibels));
+        return metrics;
+    }
+
+    /** About a second of stereo noise that alternates between quiet and loud
+        sections, with single sample spikes scattered through it.
+    */
+    static juce::AudioBuffer<float> makeBursts (int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (2, numSamples - numSamples % blockSize);
+        juce::Random random (0x3d);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto level = i % 777 == 0 ? 10.0f : ((i / 3000) % 2 == 0 ? 0.3f : 4.0f);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample (ch, i, level * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        return buffer;
+    }
+};
+
+static LookaheadLimiterBenchmark lookaheadLimiterBenchmark;
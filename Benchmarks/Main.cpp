@@ -0,0 +1,63 @@
+#include "Benchmark.h"
+
+#include <juce_events/juce_events.h>
+
+#include <iostream>
+
+//==============================================================================
+/** Writes every reported result to a JSON file, along with enough about the
+    machine and build to tell whether two files can be compared.
+*/
+static void writeJson (const juce::File& file)
+{
+    auto* root = new juce::DynamicObject();
+    root->setProperty ("time", juce::Time::getCurrentTime().toISO8601 (true));
+    root->setProperty ("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty ("numCpus", juce::SystemStats::getNumCpus());
+    root->setProperty ("operatingSystem", juce::SystemStats::getOperatingSystemName());
+    root->setProperty ("juceVersion", juce::SystemStats::getJUCEVersion());
+    root->setProperty ("results", juce::var (Benchmark::getAllResults()));
+
+    if (! file.replaceWithText (juce::JSON::toString (juce::var (root))))
+        std::cerr << "Couldn't write " << file.getFullPathName() << std::endl;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor's parameter state needs a message manager, even though
+    // nothing here ever opens a window.
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+
+    juce::ArgumentList args (argc, argv);
+
+    // --json=<file> writes the results to a file as well as printing them
+    juce::File jsonFile;
+
+    if (args.containsOption ("--json"))
+        jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile (args.removeValueForOption ("--json").unquoted());
+
+    // Any other arguments are treated as filters: only the benchmarks whose
+    // names contain one of them will be run.
+    juce::StringArray filters;
+
+    for (const auto& arg : args.arguments)
+        filters.add (arg.text);
+
+    for (auto* benchmark : Benchmark::getAllBenchmarks())
+    {
+        const auto& name = benchmark->getName();
+
+        if (! filters.isEmpty()
+            && std::none_of (filters.begin(), filters.end(), [&] (const auto& f) { return name.containsIgnoreCase (f); }))
+            continue;
+
+        std::cout << name << std::endl;
+        benchmark->run();
+    }
+
+    if (jsonFile != juce::File())
+        writeJson (jsonFile);
+
+    return 0;
+}
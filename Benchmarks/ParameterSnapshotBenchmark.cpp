@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Compares looking the gain parameter up by ID every block, which is what
+    processBlock used to do, against reading it through the cached handles.
+*/
+class ParameterSnapshotBenchmark final : public Benchmark
+{
+public:
+    ParameterSnapshotBenchmark()  : Benchmark ("Parameter read per block") {}
+
+    void run() override
+    {
+        constexpr int numBlocks = 1 << 20;
+
+        AudioPluginAudioProcessor processor;
+        ParameterHandles handles { processor.parameters };
+
+        report ("getRawParameterValue (\"gain\")",
+                measureNanoseconds (numBlocks, [&]
+                {
+                    doNotOptimise (processor.parameters.getRawParameterValue ("gain")->load());
+                }), "block");
+
+        report ("ParameterHandles::snapshot()",
+                measureNanoseconds (numBlocks, [&]
+                {
+                    doNotOptimise (handles.snapshot());
+                }), "block");
+
+        // The whole of processBlock at the small block size we run in production
+        constexpr int blockSize = 32;
+
+        processor.setPlayConfigDetails (2, 2, 48000.0, blockSize);
+        processor.prepareToPlay (48000.0, blockSize);
+
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        buffer.clear();
+
+        report ("processBlock, stereo, 32 samples",
+                measureNanoseconds (numBlocks / 8, [&]
+                {
+                    processor.processBlock (buffer, midi);
+                    doNotOptimise (buffer.getReadPointer (0)[0]);
+                }), "block");
+
+        processor.releaseResources();
+    }
+};
+
+static ParameterSnapshotBenchmark parameterSnapshotBenchmark;
@@ -0,0 +1,131 @@
+#include "Benchmark.h"
+#include "CacheMissCounter.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Runs the whole processor, as a host would, across every combination of
+    sample rate, block size and channel layout that we support.
+
+    Each block is timed on its own, so as well as the average cost per sample,
+    this reports the percentiles of the per-block render time, which is what
+    decides whether a host misses its deadline. Where perf_event_open is
+    available, the number of cache misses per block is reported too.
+*/
+class ProcessorSweepBenchmark final : public Benchmark
+{
+public:
+    ProcessorSweepBenchmark()  : Benchmark ("Processor sweep") {}
+
+    void run() override
+    {
+        const std::initializer_list<juce::AudioChannelSet> layouts { juce::AudioChannelSet::mono(),
+                                                                     juce::AudioChannelSet::stereo(),
+                                                                     juce::AudioChannelSet::create5point1(),
+                                                                     juce::AudioChannelSet::create7point1point4() };
+
+        const std::initializer_list<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0,
+                                                          176400.0, 192000.0, 352800.0, 384000.0 };
+
+        for (const auto& layout : layouts)
+        {
+            AudioPluginAudioProcessor processor;
+
+            if (! processor.setBusesLayout ({ { layout }, { layout } }))
+                continue;
+
+            // At 0 dB the gain stage does nothing at all, so use a gain that has to be applied
+            auto* gain = processor.parameters.getParameter (ParameterIDs::gain);
+            gain->setValueNotifyingHost (gain->convertTo0to1 (-6.0f));
+
+            for (auto sampleRate : sampleRates)
+                for (int blockSize = 1; blockSize <= 8192; blockSize *= 2)
+                    measure (processor, layout, sampleRate, blockSize);
+        }
+    }
+
+private:
+    //==============================================================================
+    // juce::Time's high resolution ticks are only microseconds on some platforms,
+    // which is longer than a small block takes to render.
+    using Clock = std::chrono::steady_clock;
+
+    void measure (AudioPluginAudioProcessor& processor, const juce::AudioChannelSet& layout, double sampleRate, int blockSize)
+    {
+        constexpr int numWarmUpBlocks = 64;
+
+        // At least a thousand blocks, so that the 99.9th percentile means something
+        const auto numBlocks = juce::jmax (1000, (1 << 16) / blockSize);
+        const auto numChannels = layout.size();
+
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> input (numChannels, blockSize), buffer (numChannels, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<double> blockTimes ((size_t) numBlocks);
+
+        juce::Random random (0x5eed);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        CacheMissCounter cacheMisses;
+
+        for (int block = -numWarmUpBlocks; block < numBlocks; ++block)
+        {
+            // Start each block from fresh input, so that repeatedly applying the
+            // gain doesn't eventually leave us processing nothing but zeros
+            buffer.makeCopyOf (input, true);
+
+            if (block == 0)
+                cacheMisses.reset();
+
+            cacheMisses.resume();
+            const auto start = Clock::now();
+
+            processor.processBlock (buffer, midi);
+
+            const auto end = Clock::now();
+            cacheMisses.pause();
+
+            doNotOptimise (buffer.getReadPointer (0)[0]);
+
+            if (block >= 0)
+                blockTimes[(size_t) block] = std::chrono::duration<double, std::nano> (end - start).count();
+        }
+
+        processor.releaseResources();
+
+        const auto totalNanoseconds = std::accumulate (blockTimes.begin(), blockTimes.end(), 0.0);
+        std::sort (blockTimes.begin(), blockTimes.end());
+
+        const auto percentile = [&] (double fraction)
+        {
+            const auto index = (size_t) std::ceil (fraction * (double) blockTimes.size()) - 1;
+            return blockTimes[juce::jmin (index, blockTimes.size() - 1)];
+        };
+
+        juce::NamedValueSet metrics;
+        metrics.set ("layout", layout.getDescription());
+        metrics.set ("numChannels", numChannels);
+        metrics.set ("sampleRate", sampleRate);
+        metrics.set ("blockSize", blockSize);
+        metrics.set ("p50BlockNanoseconds", percentile (0.5));
+        metrics.set ("p99BlockNanoseconds", percentile (0.99));
+        metrics.set ("p999BlockNanoseconds", percentile (0.999));
+
+        if (cacheMisses.isAvailable())
+            metrics.set ("cacheMissesPerBlock", (double) cacheMisses.getCount() / numBlocks);
+
+        // For very small blocks, the time includes the cost of reading the clock twice
+        report (layout.getDescription() + ", " + juce::String (sampleRate / 1000.0, 1) + " kHz, "
+                    + juce::String (blockSize) + " samples",
+                totalNanoseconds / ((double) numBlocks * blockSize),
+                "sample",
+                metrics);
+    }
+};
+
+static ProcessorSweepBenchmark processorSweepBenchmark;
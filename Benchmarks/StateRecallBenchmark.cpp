@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+#include "../ProcessorState.h"
+
+//==============================================================================
+/** Saves and recalls the state of a whole session's worth of instances, comparing
+    the binary format with the usual XML approach.
+*/
+class StateRecallBenchmark final : public Benchmark
+{
+public:
+    StateRecallBenchmark()  : Benchmark ("State recall") {}
+
+    void run() override
+    {
+        constexpr int numInstances = 1000;
+        constexpr int iterations = 3;
+
+        juce::OwnedArray<AudioPluginAudioProcessor> instances;
+        juce::Random random (0x5eed);
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto* instance = instances.add (new AudioPluginAudioProcessor());
+            instance->parameters.getParameter (ParameterIDs::gain)->setValueNotifyingHost (random.nextFloat());
+        }
+
+        std::vector<juce::MemoryBlock> binaryStates ((size_t) numInstances), xmlStates ((size_t) numInstances);
+
+        const auto bytesPerInstance = [] (const std::vector<juce::MemoryBlock>& states)
+        {
+            juce::NamedValueSet metrics;
+            metrics.set ("bytesPerInstance", (int) states.front().getSize());
+            return metrics;
+        };
+
+        const auto binarySave = measureNanoseconds (iterations, [&]
+        {
+            for (size_t i = 0; i < binaryStates.size(); ++i)
+            {
+                binaryStates[i].reset();
+                ProcessorState::save (instances[(int) i]->parameters, binaryStates[i]);
+            }
+        });
+
+        const auto xmlSave = measureNanoseconds (iterations, [&]
+        {
+            for (size_t i = 0; i < xmlStates.size(); ++i)
+                saveXml (instances[(int) i]->parameters, xmlStates[i]);
+        });
+
+        // Each pass loads every instance with a different instance's state, so
+        // that every load really does change the parameters.
+        size_t offset = 0;
+
+        const auto binaryLoad = measureNanoseconds (iterations, [&]
+        {
+            ++offset;
+
+            for (size_t i = 0; i < binaryStates.size(); ++i)
+            {
+                const auto& state = binaryStates[(i + offset) % binaryStates.size()];
+                ProcessorState::restore (instances[(int) i]->parameters, state.getData(), state.getSize());
+            }
+        });
+
+        const auto xmlLoad = measureNanoseconds (iterations, [&]
+        {
+            ++offset;
+
+            for (size_t i = 0; i < xmlStates.size(); ++i)
+                restoreXml (instances[(int) i]->parameters, xmlStates[(i + offset) % xmlStates.size()]);
+        });
+
+        const auto label = juce::String (numInstances) + " instances, ";
+
+        report (label + "binary save", binarySave / numInstances, "instance", bytesPerInstance (binaryStates));
+        report (label + "XML save",    xmlSave    / numInstances, "instance", bytesPerInstance (xmlStates));
+        report (label + "binary load", binaryLoad / numInstances, "instance", bytesPerInstance (binaryStates));
+        report (label + "XML load",    xmlLoad    / numInstances, "instance", bytesPerInstance (xmlStates));
+    }
+
+private:
+    //==============================================================================
+    // This is the way JUCE's examples save and restore an AudioProcessorValueTreeState.
+
+    static void saveXml (juce::AudioProcessorValueTreeState& parameters, juce::MemoryBlock& destData)
+    {
+        destData.reset();
+
+        if (auto xml = parameters.copyState().createXml())
+            juce::AudioProcessor::copyXmlToBinary (*xml, destData);
+    }
+
+    static void restoreXml (juce::AudioProcessorValueTreeState& parameters, const juce::MemoryBlock& data)
+    {
+        if (auto xml = juce::AudioProcessor::getXmlFromBinary (data.getData(), (int) data.getSize()))
+            if (xml->hasTagName (parameters.state.getType()))
+                parameters.replaceState (juce::ValueTree::fromXml (*xml));
+    }
+};
+
+static StateRecallBenchmark stateRecallBenchmark;
@@ -0,0 +1,75 @@
+#include "Benchmark.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Measures the processor with the true peak limiter at each oversampling factor,
+    relative to the processor with the limiter switched off. The attack time makes
+    no difference to the cost, so only the fast one is measured.
+
+    The input is full scale noise, so the limiter is working for most of each block.
+*/
+class TruePeakBenchmark final : public Benchmark
+{
+public:
+    TruePeakBenchmark()  : Benchmark ("True peak limiter") {}
+
+    void run() override
+    {
+        constexpr int blockSize = 256;
+        constexpr int iterations = 4096;
+
+        const auto baseline = measureProcessor (false, 0, blockSize, iterations);
+        report ("Limiter off", baseline / blockSize, "sample");
+
+        for (int oversamplingIndex = 0; oversamplingIndex < 4; ++oversamplingIndex)
+        {
+            const auto nanoseconds = measureProcessor (true, oversamplingIndex, blockSize, iterations);
+
+            juce::NamedValueSet metrics;
+            metrics.set ("relativeToOff", nanoseconds / baseline);
+
+            report (juce::String (2 << oversamplingIndex) + "x", nanoseconds / blockSize, "sample", metrics);
+        }
+    }
+
+private:
+    static double measureProcessor (bool truePeak, int oversamplingIndex, int blockSize, int iterations)
+    {
+        constexpr double sampleRate = 48000.0;
+
+        AudioPluginAudioProcessor processor;
+        auto& parameters = processor.parameters;
+
+        parameters.getParameter (ParameterIDs::gain)->setValueNotifyingHost (1.0f);
+        parameters.getParameter (ParameterIDs::truePeak)->setValueNotifyingHost (truePeak ? 1.0f : 0.0f);
+
+        auto* oversampling = parameters.getParameter (ParameterIDs::oversampling);
+        oversampling->setValueNotifyingHost (oversampling->convertTo0to1 ((float) oversamplingIndex));
+
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> source (2, blockSize), buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random (0x3d);
+
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        // Each block starts from the same noise, so that repeated filtering can't
+        // change how much work the limiter has to do.
+        const auto result = measureNanoseconds (iterations, [&]
+        {
+            buffer.makeCopyOf (source, true);
+            processor.processBlock (buffer, midi);
+            doNotOptimise (buffer.getReadPointer (0)[0]);
+        });
+
+        processor.releaseResources();
+        return result;
+    }
+};
+
+static TruePeakBenchmark truePeakBenchmark;
@@ -0,0 +1,191 @@
+#include "Benchmark.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+//==============================================================================
+/** Measures how fast WAV files can be decoded to floating point, which is where
+    the offline renderer starts with every file.
+
+    Each case reads ten seconds of stereo noise at 48 kHz, 4096 frames at a time,
+    from a WAV file of each sample format, through both the stream reader, from
+    memory, and the memory-mapped reader that the offline renderer uses. Each one
+    is read three ways:
+    - "ints", through AudioFormatReader's integer path, then converted to floats
+      with FloatVectorOperations::convertFixedToFloat(), as read() used to do
+    - "floats", through read() with float buffers, which decodes straight to floats
+    - "doubles", through read() with double buffers
+
+    Along with the time per frame, each case reports "gigabytesPerSecond", the
+    rate at which the file's sample data was decoded, and the floats report
+    "speedupOverInts". The doubles write twice as much memory as the other two,
+    so they're slower, and are there to show what the extra precision costs.
+*/
+class WavDecodeBenchmark final : public Benchmark
+{
+public:
+    WavDecodeBenchmark()  : Benchmark ("WAV decoding") {}
+
+    void run() override
+    {
+        for (const auto& sampleFormat : sampleFormats)
+        {
+            const auto wavFile = createWavFile (sampleFormat);
+
+            juce::TemporaryFile file (".wav");
+            file.getFile().replaceWithData (wavFile.getData(), wavFile.getSize());
+
+            for (const auto mapped : { false, true })
+            {
+                const auto reader = createReader (wavFile, file.getFile(), mapped);
+
+                if (reader == nullptr)
+                    continue;
+
+                double intTime = 0.0;
+
+                for (const auto path : { Path::ints, Path::floats, Path::doubles })
+                {
+                    const auto nanoseconds = measureNanoseconds (iterations, [&] { readWholeFile (*reader, path); });
+                    const auto timePerFrame = nanoseconds / numFrames;
+
+                    if (path == Path::ints)
+                        intTime = timePerFrame;
+
+                    juce::NamedValueSet metrics;
+                    metrics.set ("gigabytesPerSecond", (double) (numFrames * numChannels * sampleFormat.bitsPerSample / 8) / nanoseconds);
+
+                    if (path == Path::floats)
+                        metrics.set ("speedupOverInts", intTime / timePerFrame);
+
+                    report (juce::String (sampleFormat.name) + (mapped ? ", memory mapped, " : ", stream, ") + getName (path),
+                            timePerFrame, "frame", metrics);
+                }
+            }
+        }
+    }
+
+private:
+    enum class Path { ints, floats, doubles };
+
+    struct SampleFormat
+    {
+        const char* name;
+        int bitsPerSample;
+        bool isFloatingPoint;
+    };
+
+    static constexpr SampleFormat sampleFormats[] = { { "16-bit int",   16, false },
+                                                      { "24-bit int",   24, false },
+                                                      { "32-bit int",   32, false },
+                                                      { "32-bit float", 32, true },
+                                                      { "64-bit float", 64, true } };
+
+    static constexpr int numChannels = 2, numFrames = 480000, blockSize = 4096;
+    static constexpr int iterations = 4;
+
+    static juce::String getName (Path path)
+    {
+        switch (path)
+        {
+            case Path::ints:      return "ints";
+            case Path::floats:    return "floats";
+            case Path::doubles:   return "doubles";
+        }
+
+        return {};
+    }
+
+    /** Writes the header and sample data of a WAV file by hand, as the writer can't
+        write 32-bit integer or 64-bit float files.
+    */
+    static juce::MemoryBlock createWavFile (const SampleFormat& sampleFormat)
+    {
+        const auto bytesPerFrame = numChannels * sampleFormat.bitsPerSample / 8;
+        const auto dataSize = numFrames * bytesPerFrame;
+
+        juce::MemoryOutputStream out;
+        out.write ("RIFF", 4);
+        out.writeInt (36 + dataSize);
+        out.write ("WAVEfmt ", 8);
+        out.writeInt (16);
+        out.writeShort (sampleFormat.isFloatingPoint ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+        out.writeShort ((short) numChannels);
+        out.writeInt (48000);
+        out.writeInt (48000 * bytesPerFrame);
+        out.writeShort ((short) bytesPerFrame);
+        out.writeShort ((short) sampleFormat.bitsPerSample);
+        out.write ("data", 4);
+        out.writeInt (dataSize);
+
+        juce::Random random (0x5e);
+
+        for (int i = 0; i < numFrames * numChannels; ++i)
+        {
+            if (sampleFormat.bitsPerSample == 64)
+                out.writeDouble (random.nextDouble() - 0.5);
+            else if (sampleFormat.isFloatingPoint)
+                out.writeFloat (random.nextFloat() - 0.5f);
+            else
+                for (int b = 0; b < sampleFormat.bitsPerSample / 8; ++b)
+                    out.writeByte ((char) random.nextInt (256));
+        }
+
+        return out.getMemoryBlock();
+    }
+
+    static std::unique_ptr<juce::AudioFormatReader> createReader (const juce::MemoryBlock& wavFile, const juce::File& file, bool mapped)
+    {
+        juce::WavAudioFormat format;
+
+        if (! mapped)
+            return std::unique_ptr<juce::AudioFormatReader> (format.createReaderFor (new juce::MemoryInputStream (wavFile, false), true));
+
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader (format.createMemoryMappedReader (file));
+
+        if (reader == nullptr || ! reader->mapEntireFile())
+            return {};
+
+        // Touches every page, so that the first measurement doesn't pay for faulting them in
+        for (juce::int64 i = 0; i < reader->lengthInSamples; i += 1024)
+            reader->touchSample (i);
+
+        return reader;
+    }
+
+    void readWholeFile (juce::AudioFormatReader& reader, Path path)
+    {
+        for (int position = 0; position < numFrames; position += blockSize)
+        {
+            const auto numThisTime = juce::jmin (blockSize, numFrames - position);
+
+            if (path == Path::doubles)
+            {
+                reader.read (doubleBuffer.getArrayOfWritePointers(), numChannels, position, numThisTime);
+                continue;
+            }
+
+            auto* const* channels = floatBuffer.getArrayOfWritePointers();
+
+            if (path == Path::floats)
+            {
+                reader.read (channels, numChannels, position, numThisTime);
+                continue;
+            }
+
+            const auto channelsAsInt = reinterpret_cast<int* const*> (channels);
+            reader.read (channelsAsInt, numChannels, position, numThisTime, false);
+
+            if (! reader.usesFloatingPointData)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::convertFixedToFloat (channels[ch], channelsAsInt[ch], 1.0f / 2147483648.0f, numThisTime);
+        }
+
+        doNotOptimise (floatBuffer.getReadPointer (0)[0]);
+        doNotOptimise (doubleBuffer.getReadPointer (0)[0]);
+    }
+
+    juce::AudioBuffer<float> floatBuffer { numChannels, blockSize };
+    juce::AudioBuffer<double> doubleBuffer { numChannels, blockSize };
+};
+
+static WavDecodeBenchmark wavDecodeBenchmark;
@@ -0,0 +1,246 @@
+#include "BiquadCascade.h"
+
+//==============================================================================
+namespace
+{
+    /** The vector type that holds one sample of a group of channels, with one
+        channel per lane. Without SIMD, every group is a single channel.
+    */
+    template <typename SampleType>
+    struct Lanes
+    {
+       #if JUCE_USE_SIMD
+        using Vector = juce::dsp::SIMDRegister<SampleType>;
+
+        static constexpr size_t size = Vector::size();
+
+        static Vector load (const SampleType* source) noexcept              { return Vector::fromRawArray (source); }
+        static void store (const Vector& v, SampleType* dest) noexcept      { v.copyToRawArray (dest); }
+        static Vector expand (SampleType value) noexcept                    { return Vector::expand (value); }
+        static SampleType* align (SampleType* ptr) noexcept                 { return Vector::getNextSIMDAlignedPtr (ptr); }
+       #else
+        using Vector = SampleType;
+
+        static constexpr size_t size = 1;
+
+        static Vector load (const SampleType* source) noexcept              { return *source; }
+        static void store (const Vector& v, SampleType* dest) noexcept      { *dest = v; }
+        static Vector expand (SampleType value) noexcept                    { return value; }
+        static SampleType* align (SampleType* ptr) noexcept                 { return ptr; }
+       #endif
+    };
+
+    /** Runs a fixed number of stages over a group's interleaved samples. Knowing the
+        number of stages at compile time lets the compiler keep every stage's state
+        in registers for the whole block.
+    */
+    template <int NumStages, typename SampleType>
+    void runStages (SampleType* samples,
+                    size_t numSamples,
+                    SampleType* state,
+                    const std::array<std::array<SampleType, 5>, BiquadCascade<SampleType>::maxStages>& coefficients) noexcept
+    {
+        using L = Lanes<SampleType>;
+        using Vector = typename L::Vector;
+        constexpr auto width = L::size;
+
+        constexpr auto numStages = (size_t) NumStages;
+
+        Vector b0[numStages], b1[numStages], b2[numStages], a1[numStages], a2[numStages];
+        Vector s1[numStages], s2[numStages];
+
+        for (size_t s = 0; s < numStages; ++s)
+        {
+            b0[s] = L::expand (coefficients[s][0]);
+            b1[s] = L::expand (coefficients[s][1]);
+            b2[s] = L::expand (coefficients[s][2]);
+            a1[s] = L::expand (coefficients[s][3]);
+            a2[s] = L::expand (coefficients[s][4]);
+            s1[s] = L::load (state + (2 * s) * width);
+            s2[s] = L::load (state + (2 * s + 1) * width);
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto x = L::load (samples + i * width);
+
+            // The same transposed direct form II as juce::dsp::IIR::Filter
+            for (size_t s = 0; s < numStages; ++s)
+            {
+                const auto y = (x * b0[s]) + s1[s];
+                s1[s] = (x * b1[s]) - (y * a1[s]) + s2[s];
+                s2[s] = (x * b2[s]) - (y * a2[s]);
+                x = y;
+            }
+
+            L::store (x, samples + i * width);
+        }
+
+        for (size_t s = 0; s < numStages; ++s)
+        {
+            L::store (s1[s], state + (2 * s) * width);
+            L::store (s2[s], state + (2 * s + 1) * width);
+        }
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+BiquadCascade<SampleType>::BiquadCascade()
+{
+    // Until they're set, every stage passes its input straight through
+    for (auto& c : coefficients)
+        c = { 1, 0, 0, 0, 0 };
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    constexpr auto width = Lanes<SampleType>::size;
+
+    numChannels = (size_t) spec.numChannels;
+    maximumBlockSize = (size_t) juce::jmax (1, (int) spec.maximumBlockSize);
+
+    // Each has one vector's worth of slack, so that it can be aligned
+    const auto numGroups = (numChannels + width - 1) / width;
+    stateStorage.assign (numGroups * (size_t) maxStages * 2 * width + width, 0);
+    scratchStorage.assign (maximumBlockSize * width + width, 0);
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::reset() noexcept
+{
+    std::fill (stateStorage.begin(), stateStorage.end(), (SampleType) 0);
+}
+
+//==============================================================================
+template <typename SampleType>
+void BiquadCascade<SampleType>::setNumStages (int newNumStages) noexcept
+{
+    constexpr auto width = Lanes<SampleType>::size;
+
+    jassert (juce::isPositiveAndNotGreaterThan (newNumStages, maxStages));
+    newNumStages = juce::jlimit (0, maxStages, newNumStages);
+
+    if (newNumStages > numStages && ! stateStorage.empty())
+    {
+        auto* state = Lanes<SampleType>::align (stateStorage.data());
+        const auto groupSize = (size_t) maxStages * 2 * width;
+        const auto numGroups = (numChannels + width - 1) / width;
+
+        for (size_t group = 0; group < numGroups; ++group)
+            std::fill (state + group * groupSize + (size_t) numStages * 2 * width,
+                       state + group * groupSize + (size_t) newNumStages * 2 * width,
+                       (SampleType) 0);
+    }
+
+    numStages = newNumStages;
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setCoefficients (int stage, const Coefficients& newCoefficients) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stage, maxStages));
+
+    const auto* raw = newCoefficients.getRawCoefficients();
+
+    switch (newCoefficients.getFilterOrder())
+    {
+        case 1:     coefficients[(size_t) stage] = { raw[0], raw[1], 0, raw[2], 0 }; break;
+        case 2:     coefficients[(size_t) stage] = { raw[0], raw[1], raw[2], raw[3], raw[4] }; break;
+        default:    jassertfalse; break;    // Higher orders have to be split into biquads first
+    }
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setCoefficients (int stage, const std::array<SampleType, 6>& c) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stage, maxStages));
+    jassert (! juce::approximatelyEqual (c[3], (SampleType) 0));
+
+    const auto a0Inv = (SampleType) 1 / c[3];
+    coefficients[(size_t) stage] = { c[0] * a0Inv, c[1] * a0Inv, c[2] * a0Inv, c[4] * a0Inv, c[5] * a0Inv };
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setCoefficients (int stage, const std::array<SampleType, 4>& c) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stage, maxStages));
+    jassert (! juce::approximatelyEqual (c[2], (SampleType) 0));
+
+    const auto a0Inv = (SampleType) 1 / c[2];
+    coefficients[(size_t) stage] = { c[0] * a0Inv, c[1] * a0Inv, 0, c[3] * a0Inv, 0 };
+}
+
+//==============================================================================
+template <typename SampleType>
+void BiquadCascade<SampleType>::processBlock (const juce::dsp::AudioBlock<const SampleType>& input,
+                                              const juce::dsp::AudioBlock<SampleType>& output) noexcept
+{
+    using L = Lanes<SampleType>;
+    constexpr auto width = L::size;
+
+    const auto channels = juce::jmin (input.getNumChannels(), numChannels);
+    const auto totalSamples = input.getNumSamples();
+
+    // The channels must have been prepared for
+    jassert (input.getNumChannels() <= numChannels);
+
+    if (numStages == 0 || channels == 0)
+    {
+        if (channels > 0 && input.getChannelPointer (0) != output.getChannelPointer (0))
+            output.copyFrom (input);
+
+        return;
+    }
+
+    auto* scratch = L::align (scratchStorage.data());
+    auto* state = L::align (stateStorage.data());
+
+    for (size_t firstChannel = 0; firstChannel < channels; firstChannel += width)
+    {
+        const auto groupSize = juce::jmin (width, channels - firstChannel);
+        auto* groupState = state + (firstChannel / width) * (size_t) maxStages * 2 * width;
+
+        for (size_t start = 0; start < totalSamples; start += maximumBlockSize)
+        {
+            const auto numSamples = juce::jmin (maximumBlockSize, totalSamples - start);
+
+            // Interleave the group's channels, leaving any unused lanes silent
+            if (groupSize < width)
+                std::fill (scratch, scratch + numSamples * width, (SampleType) 0);
+
+            for (size_t lane = 0; lane < groupSize; ++lane)
+            {
+                const auto* source = input.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    scratch[i * width + lane] = source[i];
+            }
+
+            switch (numStages)
+            {
+                case 1:  runStages<1> (scratch, numSamples, groupState, coefficients); break;
+                case 2:  runStages<2> (scratch, numSamples, groupState, coefficients); break;
+                case 3:  runStages<3> (scratch, numSamples, groupState, coefficients); break;
+                case 4:  runStages<4> (scratch, numSamples, groupState, coefficients); break;
+                case 5:  runStages<5> (scratch, numSamples, groupState, coefficients); break;
+                case 6:  runStages<6> (scratch, numSamples, groupState, coefficients); break;
+                case 7:  runStages<7> (scratch, numSamples, groupState, coefficients); break;
+                case 8:  runStages<8> (scratch, numSamples, groupState, coefficients); break;
+                default: jassertfalse; break;
+            }
+
+            for (size_t lane = 0; lane < groupSize; ++lane)
+            {
+                auto* dest = output.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    dest[i] = scratch[i * width + lane];
+            }
+        }
+    }
+}
+
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
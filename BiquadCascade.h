@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/** A chain of biquad filters that runs several channels at once, one channel per
+    SIMD lane.
+
+    juce::dsp::IIR::Filter handles one channel per instance, so a multichannel bus
+    runs the same scalar recursion once for every channel. This instead gathers
+    as many channels as fit in a juce::dsp::SIMDRegister into each sample, and
+    runs the whole cascade over that group in one pass. The filter states are
+    stored channel-interleaved, to match. Every channel shares the same
+    coefficients.
+
+    The arithmetic is the same transposed direct form II, in the same order, as
+    juce::dsp::IIR::Filter, and the coefficients are set from the same
+    juce::dsp::IIR::Coefficients objects, or from the arrays returned by
+    juce::dsp::IIR::ArrayCoefficients, which don't allocate.
+
+    Only prepare() allocates. Everything else is safe to call on the audio thread.
+*/
+template <typename SampleType>
+class BiquadCascade final
+{
+public:
+    //==============================================================================
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+
+    /** The largest number of biquads that a cascade can hold. */
+    static constexpr int maxStages = 8;
+
+    BiquadCascade();
+
+    //==============================================================================
+    /** Allocates the state and working space for the given number of channels and
+        maximum block size, and resets the state.
+    */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+
+    /** Clears the state of every stage. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Sets how many of the stages are used. Any stages that are added start from
+        a cleared state, and the others carry on where they were.
+    */
+    void setNumStages (int newNumStages) noexcept;
+
+    int getNumStages() const noexcept                   { return numStages; }
+
+    /** Sets one stage's coefficients. These must be first or second order. */
+    void setCoefficients (int stage, const Coefficients& newCoefficients) noexcept;
+
+    /** Sets one stage's coefficients from the { b0, b1, b2, a0, a1, a2 } array
+        returned by juce::dsp::IIR::ArrayCoefficients.
+    */
+    void setCoefficients (int stage, const std::array<SampleType, 6>& newCoefficients) noexcept;
+
+    /** Sets one stage's coefficients from the { b0, b1, a0, a1 } array returned by
+        juce::dsp::IIR::ArrayCoefficients' first order filters.
+    */
+    void setCoefficients (int stage, const std::array<SampleType, 4>& newCoefficients) noexcept;
+
+    //==============================================================================
+    /** Filters the context's input into its output, which can be the same block. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& input = context.getInputBlock();
+        auto& output = context.getOutputBlock();
+
+        jassert (input.getNumChannels() == output.getNumChannels());
+        jassert (input.getNumSamples() == output.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                output.copyFrom (input);
+
+            return;
+        }
+
+        processBlock (input, output);
+    }
+
+private:
+    //==============================================================================
+    void processBlock (const juce::dsp::AudioBlock<const SampleType>& input,
+                       const juce::dsp::AudioBlock<SampleType>& output) noexcept;
+
+    // b0, b1, b2, a1, a2 for each stage, already divided by a0
+    std::array<std::array<SampleType, 5>, maxStages> coefficients;
+    int numStages = 0;
+
+    // For each group of channels, then each stage, the two state variables for
+    // every lane. The working space holds one group's samples, interleaved.
+    std::vector<SampleType> stateStorage, scratchStorage;
+    size_t numChannels = 0, maximumBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BiquadCascade)
+};
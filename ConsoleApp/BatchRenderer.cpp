@@ -0,0 +1,202 @@
+#include "BatchRenderer.h"
+
+//==============================================================================
+/** Hands out the files to measure and render, in order, to whichever worker asks
+    next. Rendering a file that's been measured takes priority over measuring
+    another one, so that files don't pile up waiting to be rendered.
+*/
+class BatchRenderer::Schedule final
+{
+public:
+    /** Without measuring, every file is ready to render straight away. */
+    Schedule (int numInputsToUse, bool measureFirst)
+        : numInputs (numInputsToUse),
+          nextToMeasure (measureFirst ? 0 : numInputsToUse)
+    {
+        if (! measureFirst)
+            for (int i = 0; i < numInputs; ++i)
+                readyToRender.push_back (i);
+    }
+
+    struct Task
+    {
+        enum class Type { measure, render, finished };
+
+        Type type = Type::finished;
+        int index = -1;
+    };
+
+    /** Returns the next thing to do, waiting while there's nothing to render but
+        other workers are still measuring files that will need rendering.
+    */
+    Task getNextTask (const juce::ThreadPoolJob& job)
+    {
+        while (! job.shouldExit())
+        {
+            {
+                const juce::ScopedLock sl (lock);
+
+                if (! readyToRender.empty())
+                {
+                    const auto index = readyToRender.front();
+                    readyToRender.pop_front();
+                    return { Task::Type::render, index };
+                }
+
+                if (nextToMeasure < numInputs)
+                {
+                    ++numBeingMeasured;
+                    return { Task::Type::measure, nextToMeasure++ };
+                }
+
+                if (numBeingMeasured == 0)
+                    break;
+            }
+
+            // The timeout lets this notice when the job is asked to stop
+            measured.wait (50);
+        }
+
+        // Wakes up anything else waiting, so that it can finish too
+        measured.signal();
+        return {};
+    }
+
+    /** Called when a file has been measured, with whether it should be rendered. */
+    void finishedMeasuring (int index, bool shouldRender)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            --numBeingMeasured;
+
+            if (shouldRender)
+                readyToRender.push_back (index);
+        }
+
+        measured.signal();
+    }
+
+private:
+    const int numInputs;
+
+    juce::CriticalSection lock;
+    std::deque<int> readyToRender;
+    int nextToMeasure = 0, numBeingMeasured = 0;
+    juce::WaitableEvent measured;
+};
+
+//==============================================================================
+class BatchRenderer::Worker final : public juce::ThreadPoolJob
+{
+public:
+    Worker (BatchRenderer& o,
+            AudioPluginAudioProcessor& p,
+            const juce::Array<juce::File>& in,
+            juce::Array<juce::Result>& out,
+            Schedule& s)
+        : ThreadPoolJob ("Render worker"),
+          owner (o),
+          renderer (o.settings),
+          processor (p),
+          inputs (in),
+          results (out),
+          schedule (s)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        for (;;)
+        {
+            const auto task = schedule.getNextTask (*this);
+
+            // Each index is only ever handed to one worker at a time, so none of
+            // the writes below race
+            if (task.type == Schedule::Task::Type::measure)
+                measure (task.index);
+            else if (task.type == Schedule::Task::Type::render)
+                render (task.index);
+            else
+                return jobHasFinished;
+        }
+    }
+
+private:
+    void measure (int index)
+    {
+        LoudnessMeter::Snapshot measured;
+        auto& result = results.getReference (index);
+        result = renderer.measure (inputs.getReference (index), measured);
+
+        if (result.wasOk() && measured.integrated <= LoudnessMeter::minusInfinityDb)
+            result = juce::Result::fail (inputs.getReference (index).getFullPathName() + " is too quiet to measure its loudness");
+
+        if (result.wasOk())
+            owner.gains.getReference (index) = *owner.settings.targetLoudness - measured.integrated;
+
+        schedule.finishedMeasuring (index, result.wasOk());
+    }
+
+    void render (int index)
+    {
+        auto& result = results.getReference (index);
+        result = renderer.render (inputs.getReference (index), processor, owner.gains.getReference (index));
+
+        // The processor is reset when it's prepared, so these only cover the file just rendered
+        if (result.wasOk())
+        {
+            owner.telemetry.getReference (index) = processor.getTelemetry().getSnapshot();
+            owner.loudness.getReference (index) = processor.getLoudnessMeter().getSnapshot();
+        }
+    }
+
+    BatchRenderer& owner;
+    OfflineRenderer renderer;
+    AudioPluginAudioProcessor& processor;
+    const juce::Array<juce::File>& inputs;
+    juce::Array<juce::Result>& results;
+    Schedule& schedule;
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer (const RenderSettings& s, int numThreads)
+    : settings (s),
+      pool (juce::ThreadPoolOptions{}.withThreadName ("Render pool")
+                                     .withNumberOfThreads (juce::jmax (1, numThreads)))
+{
+    // The processors are created here, on the message thread, rather than on
+    // the workers, because their parameter state registers with the message thread.
+    for (int i = 0; i < pool.getNumThreads(); ++i)
+        processors.add (new AudioPluginAudioProcessor());
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    pool.removeAllJobs (true, -1);
+}
+
+juce::Array<juce::Result> BatchRenderer::renderAll (const juce::Array<juce::File>& inputs)
+{
+    juce::Array<juce::Result> results;
+    results.insertMultiple (0, juce::Result::fail ("Not rendered"), inputs.size());
+
+    telemetry.clearQuick();
+    telemetry.resize (inputs.size());
+
+    loudness.clearQuick();
+    loudness.resize (inputs.size());
+
+    gains.clearQuick();
+    gains.insertMultiple (0, settings.gainDecibels, inputs.size());
+
+    Schedule schedule (inputs.size(), settings.targetLoudness.has_value());
+    juce::OwnedArray<Worker> workers;
+
+    for (auto* processor : processors)
+        pool.addJob (workers.add (new Worker (*this, *processor, inputs, results, schedule)), false);
+
+    for (auto* worker : workers)
+        pool.waitForJobToFinish (worker, -1);
+
+    return results;
+}
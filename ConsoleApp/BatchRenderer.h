@@ -0,0 +1,57 @@
+#pragma once
+
+#include "OfflineRenderer.h"
+
+//==============================================================================
+/** Renders a list of files in parallel on a juce::ThreadPool.
+
+    Each worker thread has its own AudioPluginAudioProcessor and OfflineRenderer,
+    and takes the next unrendered file from the list whenever it finishes one, so
+    a few long files don't hold up the rest of the batch.
+
+    When the settings have a target loudness, every file is measured before it's
+    rendered. The two passes are pipelined: a worker that finishes a file renders
+    one that's already been measured if there is one, and measures the next file
+    otherwise, so the measuring of some files overlaps the rendering of others.
+*/
+class BatchRenderer final
+{
+public:
+    BatchRenderer (const RenderSettings&, int numThreads);
+    ~BatchRenderer();
+
+    /** Renders every file, blocking until they've all finished.
+        Returns one result per input file, in the same order.
+    */
+    juce::Array<juce::Result> renderAll (const juce::Array<juce::File>& inputs);
+
+    /** Returns the processor telemetry for each file passed to the last renderAll()
+        call, in the same order. Files that failed to render have empty telemetry.
+    */
+    const juce::Array<ProcessorTelemetry::Snapshot>& getTelemetry() const noexcept     { return telemetry; }
+
+    /** Returns the loudness of each output file from the last renderAll() call, in
+        the same order. Files that failed to render have unmeasured loudness.
+    */
+    const juce::Array<LoudnessMeter::Snapshot>& getLoudness() const noexcept           { return loudness; }
+
+    /** Returns the gain that was applied to each file in the last renderAll() call,
+        in decibels, in the same order. Without a target loudness, these are all the
+        settings' gainDecibels.
+    */
+    const juce::Array<float>& getGains() const noexcept                                 { return gains; }
+
+private:
+    //==============================================================================
+    class Schedule;
+    class Worker;
+
+    RenderSettings settings;
+    juce::OwnedArray<AudioPluginAudioProcessor> processors;
+    juce::Array<ProcessorTelemetry::Snapshot> telemetry;
+    juce::Array<LoudnessMeter::Snapshot> loudness;
+    juce::Array<float> gains;
+    juce::ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE (BatchRenderer)
+};
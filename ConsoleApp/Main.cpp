@@ -1,10 +1,167 @@
-#include <juce_core/juce_core.h>
+#include "BatchRenderer.h"
 
+#include <iostream>
+
+//==============================================================================
+// These each remove the options they understand from the argument list, so
+// that whatever is left over afterwards is the list of files to process.
+
+static RenderSettings parseRenderSettings (juce::ArgumentList& args)
+{
+    RenderSettings settings;
+
+    if (args.containsOption ("--gain") && ! args.containsOption ("--normalise"))
+        settings.gainDecibels = args.removeValueForOption ("--gain").getFloatValue();
+
+    if (args.containsOption ("--block-size"))
+        settings.blockSize = args.removeValueForOption ("--block-size").getIntValue();
+
+    if (args.containsOption ("--bit-depth"))
+        settings.bitDepth = args.removeValueForOption ("--bit-depth").getIntValue();
+
+    if (args.containsOption ("--sample-rate"))
+        settings.sampleRate = args.removeValueForOption ("--sample-rate").getDoubleValue();
+
+    if (args.containsOption ("--normalise"))
+    {
+        if (args.containsOption ("--gain"))
+            juce::ConsoleApplication::fail ("--normalise and --gain can't be used together");
+
+        settings.targetLoudness = args.removeValueForOption ("--normalise").getFloatValue();
+    }
+
+    if (args.containsOption ("--format"))
+        settings.outputExtension = "." + args.removeValueForOption ("--format").trimCharactersAtStart (".").toLowerCase();
+
+    if (settings.blockSize <= 0)
+        juce::ConsoleApplication::fail ("The block size must be greater than zero");
+
+    if (settings.sampleRate < 0.0)
+        juce::ConsoleApplication::fail ("The sample rate can't be negative");
+
+    settings.outputFolder = args.getExistingFolderForOptionAndRemove ("--output|-o");
+    return settings;
+}
+
+static int parseNumThreads (juce::ArgumentList& args)
+{
+    if (! args.containsOption ("--threads"))
+        return juce::SystemStats::getNumCpus();
+
+    const auto numThreads = args.removeValueForOption ("--threads").getIntValue();
+
+    if (numThreads <= 0)
+        juce::ConsoleApplication::fail ("The number of threads must be greater than zero");
+
+    return numThreads;
+}
+
+static juce::Array<juce::File> parseInputFiles (const juce::ArgumentList& args)
+{
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (args[i].isOption())
+            juce::ConsoleApplication::fail ("Unknown option " + args[i].text);
+
+        inputs.add (args[i].resolveAsExistingFile());
+    }
+
+    if (inputs.isEmpty())
+        juce::ConsoleApplication::fail ("No input files were given");
+
+    return inputs;
+}
+
+static juce::File parseTelemetryFile (juce::ArgumentList& args)
+{
+    if (! args.containsOption ("--telemetry"))
+        return {};
+
+    return juce::File::getCurrentWorkingDirectory().getChildFile (args.removeValueForOption ("--telemetry").unquoted());
+}
+
+//==============================================================================
+/** Writes the processor's telemetry for each file to a JSON file, along with the
+    gain it was given and the loudness of its output.
+*/
+static void writeTelemetry (const juce::File& file,
+                            const juce::Array<juce::File>& inputs,
+                            const BatchRenderer& renderer)
+{
+    juce::Array<juce::var> entries;
+
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        auto entry = renderer.getTelemetry().getReference (i).toVar();
+        auto* object = entry.getDynamicObject();
+        object->setProperty ("file", inputs[i].getFullPathName());
+        object->setProperty ("gainDecibels", renderer.getGains()[i]);
+        object->setProperty ("loudness", renderer.getLoudness().getReference (i).toVar());
+        entries.add (entry);
+    }
+
+    if (! file.replaceWithText (juce::JSON::toString (juce::var (entries))))
+        juce::ConsoleApplication::fail ("Couldn't write " + file.getFullPathName());
+}
+
+//==============================================================================
+static void render (juce::ArgumentList args)
+{
+    args.removeOptionIfFound ("--render");
+
+    const auto settings = parseRenderSettings (args);
+    const auto numThreads = parseNumThreads (args);
+    const auto telemetryFile = parseTelemetryFile (args);
+    const auto inputs = parseInputFiles (args);
+
+    BatchRenderer renderer (settings, numThreads);
+    const auto results = renderer.renderAll (inputs);
+
+    if (telemetryFile != juce::File())
+        writeTelemetry (telemetryFile, inputs, renderer);
+
+    int numFailed = 0;
+
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        if (results.getReference (i).failed())
+        {
+            std::cerr << inputs[i].getFullPathName() << ": " << results.getReference (i).getErrorMessage() << std::endl;
+            ++numFailed;
+        }
+    }
+
+    std::cout << "Rendered " << (inputs.size() - numFailed) << " of " << inputs.size() << " files" << std::endl;
+
+    if (numFailed > 0)
+        juce::ConsoleApplication::fail (juce::String (numFailed) + " file(s) failed to render");
+}
+
+//==============================================================================
 int main (int argc, char* argv[])
 {
+    // The processor's parameter state needs a message manager, even though
+    // nothing here ever opens a window.
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+
+    juce::ConsoleApplication app;
+
+    app.addHelpCommand ("--help|-h", "Usage:", true);
 
-    // Your code goes here!
-    juce::ignoreUnused (argc, argv);
+    app.addCommand ({ "--render",
+                      "--render --output=<folder> [--gain=<dB> | --normalise=<LUFS>] [--format=wav|flac] [--bit-depth=<bits>] "
+                      "[--sample-rate=<Hz>] [--block-size=<samples>] [--threads=<count>] [--telemetry=<file.json>] <files...>",
+                      "Runs each file through the Mute processor and writes the result to the output folder",
+                      "Files are streamed a block at a time, so memory use doesn't depend on their length. "
+                      "They are spread across a pool of threads, each with its own processor instance. "
+                      "--normalise measures each file's integrated loudness first, and renders it with whatever "
+                      "gain brings that to the given level, instead of a fixed --gain. "
+                      "--sample-rate converts files at other rates with a polyphase resampler before processing them. "
+                      "--telemetry writes the processor's load, xruns, denormals and render time histogram "
+                      "for each file to a JSON file, with the gain it was given and its output loudness.",
+                      [] (const auto& args) { render (args); } });
 
-    return 0;
+    return app.findAndRunCommand (argc, argv);
 }
@@ -0,0 +1,232 @@
+#include "OfflineRenderer.h"
+
+//==============================================================================
+namespace
+{
+    /** Reads a file at another sample rate, through a juce::PolyphaseResampler.
+
+        Like AudioFormatReader::read(), this carries on with silence after the end of
+        the file, which is also what flushes the last of it out of the resampler.
+    */
+    class ResamplingReader final
+    {
+    public:
+        ResamplingReader (juce::AudioFormatReader& source, double outputSampleRate, int blockSize)
+            : reader (source),
+              numChannels ((int) source.numChannels),
+              inputBuffer (numChannels, blockSize)
+        {
+            resampler.prepare (reader.sampleRate, outputSampleRate, numChannels, blockSize);
+            outputBuffer.setSize (numChannels, resampler.getMaximumOutputSamples (blockSize));
+        }
+
+        /** Fills the block with the next part of the resampled file. */
+        void read (juce::AudioBuffer<float>& block)
+        {
+            for (int position = 0; position < block.getNumSamples();)
+            {
+                if (numReady == 0)
+                    resampleNextBlock();
+
+                const auto numToCopy = juce::jmin (numReady, block.getNumSamples() - position);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    block.copyFrom (ch, position, outputBuffer, ch, readyStart, numToCopy);
+
+                readyStart += numToCopy;
+                numReady -= numToCopy;
+                position += numToCopy;
+            }
+        }
+
+    private:
+        void resampleNextBlock()
+        {
+            const auto blockSize = inputBuffer.getNumSamples();
+
+            reader.read (inputBuffer.getArrayOfWritePointers(), numChannels, inputPosition, blockSize);
+            inputPosition += blockSize;
+
+            numReady = resampler.process (inputBuffer.getArrayOfReadPointers(), blockSize, outputBuffer.getArrayOfWritePointers());
+            readyStart = 0;
+        }
+
+        juce::AudioFormatReader& reader;
+        const int numChannels;
+        juce::PolyphaseResampler resampler;
+        juce::AudioBuffer<float> inputBuffer, outputBuffer;
+        juce::int64 inputPosition = 0;
+        int readyStart = 0, numReady = 0;
+    };
+}
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer (const RenderSettings& s)
+    : settings (s)
+{
+    formatManager.registerBasicFormats();
+}
+
+juce::File OfflineRenderer::getOutputFileFor (const juce::File& input) const
+{
+    return settings.outputFolder.getChildFile (input.getFileNameWithoutExtension() + settings.outputExtension);
+}
+
+juce::Result OfflineRenderer::measure (const juce::File& input, LoudnessMeter::Snapshot& loudness)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    if (auto* format = formatManager.findFormatForFileExtension (input.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (input));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            reader = std::move (mapped);
+    }
+
+    if (reader == nullptr)
+        reader.reset (formatManager.createReaderFor (input));
+
+    if (reader == nullptr)
+        return juce::Result::fail ("Couldn't open " + input.getFullPathName() + " as an audio file");
+
+    const auto numChannels = (int) reader->numChannels;
+
+    LoudnessMeter meter;
+    meter.prepare (reader->sampleRate, settings.blockSize, juce::AudioChannelSet::canonicalChannelSet (numChannels));
+
+    juce::AudioBuffer<float> buffer (numChannels, settings.blockSize);
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples;)
+    {
+        const auto numThisTime = (int) juce::jmin ((juce::int64) settings.blockSize, reader->lengthInSamples - position);
+        juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), numChannels, numThisTime);
+
+        if (! reader->read (block.getArrayOfWritePointers(), numChannels, position, numThisTime))
+            return juce::Result::fail ("Couldn't read " + input.getFullPathName());
+
+        meter.process (block);
+        position += numThisTime;
+    }
+
+    loudness = meter.getSnapshot();
+    return juce::Result::ok();
+}
+
+juce::AudioFormat* OfflineRenderer::getOutputFormat()
+{
+    for (auto* format : { static_cast<juce::AudioFormat*> (&wavFormat), static_cast<juce::AudioFormat*> (&flacFormat) })
+        if (format->getFileExtensions().contains (settings.outputExtension, true))
+            return format;
+
+    return nullptr;
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::render (const juce::File& input, AudioPluginAudioProcessor& processor, float gainDecibels)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (input));
+
+    if (reader == nullptr)
+        return juce::Result::fail ("Couldn't open " + input.getFullPathName() + " as an audio file");
+
+    const auto numChannels = (int) reader->numChannels;
+    const auto sampleRate = settings.sampleRate > 0.0 ? settings.sampleRate : reader->sampleRate;
+
+    std::unique_ptr<ResamplingReader> resamplingReader;
+    auto inputLength = reader->lengthInSamples;
+
+    if (! juce::approximatelyEqual (sampleRate, reader->sampleRate))
+    {
+        resamplingReader = std::make_unique<ResamplingReader> (*reader, sampleRate, settings.blockSize);
+        inputLength = (juce::int64) std::ceil ((double) inputLength * sampleRate / reader->sampleRate);
+    }
+
+    auto* format = getOutputFormat();
+
+    if (format == nullptr)
+        return juce::Result::fail ("Can't write " + settings.outputExtension + " files");
+
+    if (! format->getPossibleBitDepths().contains (settings.bitDepth))
+        return juce::Result::fail (format->getFormatName() + " can't be written at " + juce::String (settings.bitDepth) + " bits");
+
+    //==============================================================================
+    const auto output = getOutputFileFor (input);
+    output.deleteFile();
+
+    auto stream = output.createOutputStream();
+
+    if (stream == nullptr)
+        return juce::Result::fail ("Couldn't create " + output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), sampleRate, (unsigned int) numChannels,
+                                                                              settings.bitDepth, reader->metadataValues, 0));
+
+    if (writer == nullptr)
+        return juce::Result::fail ("Couldn't write " + juce::String (numChannels) + " channels at "
+                                     + juce::String (sampleRate) + " Hz to " + output.getFullPathName());
+
+    stream.release(); // the writer owns the stream now
+
+    //==============================================================================
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add  (juce::AudioChannelSet::canonicalChannelSet (numChannels));
+    layout.outputBuses.add (juce::AudioChannelSet::canonicalChannelSet (numChannels));
+
+    if (! processor.setBusesLayout (layout))
+        return juce::Result::fail ("The processor doesn't support " + juce::String (numChannels) + " channels");
+
+    // Gains at or below GainRamp::muteDecibels would mute the processor, and it
+    // can't boost, so anything outside that range is applied to the input instead
+    const auto gainIsInRange = gainDecibels > GainRamp::muteDecibels && gainDecibels <= 0.0f;
+    const auto inputGain = gainIsInRange ? 1.0f : juce::Decibels::decibelsToGain (gainDecibels, -1000.0f);
+
+    if (auto* gain = processor.parameters.getParameter (ParameterIDs::gain))
+        gain->setValueNotifyingHost (gain->convertTo0to1 (gainIsInRange ? gainDecibels : 0.0f));
+
+    processor.setNonRealtime (true);
+    processor.setRateAndBufferSizeDetails (sampleRate, settings.blockSize);
+    processor.prepareToPlay (sampleRate, settings.blockSize);
+
+    // The output is shifted back by the processor's latency so that it lines up
+    // with the input, and extended by its tail so that nothing is cut off.
+    const auto latency = (juce::int64) processor.getLatencySamples();
+    const auto tailSeconds = processor.getTailLengthSeconds();
+    const auto tail = std::isfinite (tailSeconds) ? (juce::int64) std::ceil (tailSeconds * sampleRate) : 0;
+    const auto totalLength = inputLength + latency + tail;
+
+    juce::AudioBuffer<float> buffer (numChannels, settings.blockSize);
+    juce::MidiBuffer midi;
+    auto result = juce::Result::ok();
+
+    for (juce::int64 position = 0; position < totalLength;)
+    {
+        const auto numThisTime = (int) juce::jmin ((juce::int64) settings.blockSize, totalLength - position);
+        juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), numChannels, numThisTime);
+
+        // Reading past the end of the input fills the block with silence
+        if (resamplingReader != nullptr)
+            resamplingReader->read (block);
+        else
+            reader->read (block.getArrayOfWritePointers(), numChannels, position, numThisTime);
+
+        if (! juce::exactlyEqual (inputGain, 1.0f))
+            block.applyGain (inputGain);
+
+        processor.processBlock (block, midi);
+        midi.clear();
+
+        const auto numToSkip = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numThisTime, latency - position);
+
+        if (! writer->writeFromAudioSampleBuffer (block, numToSkip, numThisTime - numToSkip))
+        {
+            result = juce::Result::fail ("Couldn't write to " + output.getFullPathName());
+            break;
+        }
+
+        position += numThisTime;
+    }
+
+    processor.releaseResources();
+    return result;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Everything that controls how a file is rendered. */
+struct RenderSettings
+{
+    /** The gain to apply, in decibels. */
+    float gainDecibels = 0.0f;
+
+    /** If set, each file is measured first, and gainDecibels is replaced by
+        whatever gain brings its integrated loudness to this many LUFS.
+    */
+    std::optional<float> targetLoudness;
+
+    /** The number of samples read, processed and written at a time. Memory use
+        depends only on this, not on the length of the files.
+    */
+    int blockSize = 4096;
+
+    /** The folder that rendered files are written into. */
+    juce::File outputFolder;
+
+    /** The file extension, which selects the output format: ".wav" or ".flac". */
+    juce::String outputExtension = ".wav";
+
+    /** The bit depth of the output. For WAV, 32 writes floating point samples. */
+    int bitDepth = 24;
+
+    /** The sample rate of the output, or 0 to keep each file's own rate. Files at
+        other rates are converted with a juce::PolyphaseResampler on their way into
+        the processor, which then runs at this rate.
+    */
+    double sampleRate = 0.0;
+};
+
+//==============================================================================
+/** Streams a single audio file through an AudioPluginAudioProcessor, a block at a
+    time, and writes the result to a new file, converting its sample rate first if
+    the settings ask for a different one.
+*/
+class OfflineRenderer final
+{
+public:
+    explicit OfflineRenderer (const RenderSettings&);
+
+    /** Returns the file that the given input will be rendered to. */
+    juce::File getOutputFileFor (const juce::File& input) const;
+
+    /** Measures a file's loudness, a block at a time.
+
+        WAV and AIFF files are read through a juce::MemoryMappedAudioFormatReader,
+        which reads the samples straight out of the mapped file, leaving the OS to
+        page it in as it goes. Other formats are streamed as they are for render().
+    */
+    juce::Result measure (const juce::File& input, LoudnessMeter::Snapshot& loudness);
+
+    /** Renders a file using the given processor, with the given gain.
+
+        The processor is prepared to match the file and released again afterwards,
+        so the same instance can be reused for one file after another. It must not
+        be used by anything else while this is running.
+
+        The gain is set on the processor's gain parameter, unless it's outside that
+        parameter's range, in which case it's applied to each block on its way into
+        the processor instead.
+    */
+    juce::Result render (const juce::File& input, AudioPluginAudioProcessor& processor, float gainDecibels);
+
+private:
+    //==============================================================================
+    juce::AudioFormat* getOutputFormat();
+
+    RenderSettings settings;
+    juce::AudioFormatManager formatManager;
+    juce::WavAudioFormat wavFormat;
+    juce::FlacAudioFormat flacFormat;
+
+    JUCE_DECLARE_NON_COPYABLE (OfflineRenderer)
+};
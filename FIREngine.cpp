@@ -0,0 +1,385 @@
+#include "FIREngine.h"
+
+//==============================================================================
+namespace
+{
+    using FVO = juce::FloatVectorOperations;
+
+    /** The vector type that the direct form works in. Without SIMD, it works one
+        sample at a time.
+    */
+    struct Lanes
+    {
+       #if JUCE_USE_SIMD
+        using Vector = juce::dsp::SIMDRegister<float>;
+
+        static constexpr size_t size = Vector::size();
+
+        static Vector load (const float* source) noexcept                   { return Vector::fromRawArray (source); }
+        static void store (const Vector& v, float* dest) noexcept           { v.copyToRawArray (dest); }
+        static Vector expand (float value) noexcept                         { return Vector::expand (value); }
+        static float* align (float* ptr) noexcept                           { return Vector::getNextSIMDAlignedPtr (ptr); }
+       #else
+        using Vector = float;
+
+        static constexpr size_t size = 1;
+
+        static Vector load (const float* source) noexcept                   { return *source; }
+        static void store (const Vector& v, float* dest) noexcept           { *dest = v; }
+        static Vector expand (float value) noexcept                         { return value; }
+        static float* align (float* ptr) noexcept                           { return ptr; }
+       #endif
+    };
+
+    size_t roundUpToLanes (size_t n) noexcept
+    {
+        return (n + Lanes::size - 1) / Lanes::size * Lanes::size;
+    }
+
+    /** Works out four registers of direct form output, starting at an aligned
+        sample. Each tap's input is read from the copy of the history that lines
+        it up with the output. The sums are kept in separate variables, rather
+        than an array, so that the compiler keeps them in registers.
+    */
+    void accumulateTaps4 (float* dest,
+                          const float* current,
+                          const float* kernelVectors,
+                          const ptrdiff_t* tapOffsets,
+                          size_t numTaps) noexcept
+    {
+        constexpr auto width = Lanes::size;
+
+        auto s0 = Lanes::expand (0.0f), s1 = s0, s2 = s0, s3 = s0;
+
+        for (size_t tap = 0; tap < numTaps; ++tap)
+        {
+            const auto coefficient = Lanes::load (kernelVectors + tap * width);
+            const auto* source = current + tapOffsets[tap];
+
+            s0 += coefficient * Lanes::load (source);
+            s1 += coefficient * Lanes::load (source + width);
+            s2 += coefficient * Lanes::load (source + 2 * width);
+            s3 += coefficient * Lanes::load (source + 3 * width);
+        }
+
+        Lanes::store (s0, dest);
+        Lanes::store (s1, dest + width);
+        Lanes::store (s2, dest + 2 * width);
+        Lanes::store (s3, dest + 3 * width);
+    }
+
+    /** Works out a single register of direct form output. */
+    void accumulateTaps1 (float* dest,
+                          const float* current,
+                          const float* kernelVectors,
+                          const ptrdiff_t* tapOffsets,
+                          size_t numTaps) noexcept
+    {
+        constexpr auto width = Lanes::size;
+
+        auto sum = Lanes::expand (0.0f);
+
+        for (size_t tap = 0; tap < numTaps; ++tap)
+            sum += Lanes::load (kernelVectors + tap * width) * Lanes::load (current + tapOffsets[tap]);
+
+        Lanes::store (sum, dest);
+    }
+
+    /** The shortest and longest blocks that the partitioned convolution works in.
+        Longer partitions would make juce::dsp::FFT allocate its scratch space.
+    */
+    constexpr size_t minimumPartitionSize = 32, maximumPartitionSize = 4096;
+
+    /** Adds the product of two spectra, each stored as numBins real parts followed
+        by numBins imaginary parts, to a third.
+    */
+    void multiplyAdd (float* dest, const float* a, const float* b, size_t numBins) noexcept
+    {
+        const auto n = (int) numBins;
+
+        FVO::addWithMultiply (dest, a, b, n);
+        FVO::subtractWithMultiply (dest, a + numBins, b + numBins, n);
+        FVO::addWithMultiply (dest + numBins, a, b + numBins, n);
+        FVO::addWithMultiply (dest + numBins, a + numBins, b, n);
+    }
+
+    /** Converts between juce::dsp::FFT's interleaved bins and separate real and
+        imaginary parts.
+    */
+    void deinterleave (const float* source, float* dest, size_t numBins) noexcept
+    {
+        for (size_t i = 0; i < numBins; ++i)
+        {
+            dest[i] = source[2 * i];
+            dest[numBins + i] = source[2 * i + 1];
+        }
+    }
+
+    void interleave (const float* source, float* dest, size_t numBins) noexcept
+    {
+        for (size_t i = 0; i < numBins; ++i)
+        {
+            dest[2 * i] = source[i];
+            dest[2 * i + 1] = source[numBins + i];
+        }
+    }
+}
+
+//==============================================================================
+void FIREngine::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    numChannels = (size_t) spec.numChannels;
+    maximumBlockSize = (size_t) juce::jmax (1, (int) spec.maximumBlockSize);
+
+    allocate();
+}
+
+void FIREngine::reset() noexcept
+{
+    std::fill (copyStorage.begin(), copyStorage.end(), 0.0f);
+    std::fill (windows.begin(), windows.end(), 0.0f);
+    std::fill (inputSpectra.begin(), inputSpectra.end(), 0.0f);
+
+    position = 0;
+    newestSpectrum = 0;
+}
+
+//==============================================================================
+void FIREngine::setKernel (const float* taps, int numTaps, Method newMethod)
+{
+    jassert (numTaps >= 0);
+
+    kernel.assign (taps, taps + juce::jmax (0, numTaps));
+    requestedMethod = newMethod;
+
+    if (numChannels > 0)
+        allocate();
+}
+
+void FIREngine::setKernel (const juce::dsp::FIR::Coefficients<float>& coefficients, Method newMethod)
+{
+    setKernel (coefficients.getRawCoefficients(), (int) coefficients.getFilterOrder() + 1, newMethod);
+}
+
+void FIREngine::allocate()
+{
+    const auto numTaps = kernel.size();
+
+    method = requestedMethod != Method::automatic ? requestedMethod
+           : (numTaps < (size_t) crossoverTaps ? Method::directForm : Method::partitionedFFT);
+
+    copyStorage.clear();
+    fft.reset();
+    kernelSpectra.clear();
+    windows.clear();
+    inputSpectra.clear();
+    tails.clear();
+
+    if (numTaps == 0)
+        return;
+
+    if (method == Method::directForm)
+    {
+        constexpr auto width = Lanes::size;
+
+        // The shifted copies start writing up to a register before the input
+        historySize = roundUpToLanes (juce::jmax (numTaps, width) - 1);
+        copySize = historySize + roundUpToLanes (maximumBlockSize);
+
+        // Each has one register's worth of slack, so that it can be aligned
+        copyStorage.assign (numChannels * width * copySize + width, 0.0f);
+        scratchStorage.assign (roundUpToLanes (maximumBlockSize) + width, 0.0f);
+        kernelVectorStorage.assign (numTaps * width + width, 0.0f);
+        tapOffsets.resize (numTaps);
+
+        auto* kernelVectors = Lanes::align (kernelVectorStorage.data());
+
+        for (size_t tap = 0; tap < numTaps; ++tap)
+        {
+            // The copy whose samples are shifted by this much reads the tap's input
+            // from an aligned position
+            const auto shift = roundUpToLanes (tap) - tap;
+
+            std::fill (kernelVectors + tap * width, kernelVectors + (tap + 1) * width, kernel[tap]);
+            tapOffsets[tap] = (ptrdiff_t) (shift * copySize) - (ptrdiff_t) roundUpToLanes (tap);
+        }
+
+        return;
+    }
+
+    partitionSize = juce::jlimit (minimumPartitionSize, maximumPartitionSize,
+                                  (size_t) juce::nextPowerOfTwo ((int) maximumBlockSize));
+    numPartitions = (numTaps + partitionSize - 1) / partitionSize;
+    spectrumSize = partitionSize + 1;
+
+    const auto fftSize = 2 * partitionSize;
+    const auto spectrumStride = 2 * spectrumSize;
+    const auto numStoredSpectra = juce::jmax ((size_t) 1, numPartitions - 1);
+
+    fft = std::make_unique<juce::dsp::FFT> (juce::roundToInt (std::log2 ((double) fftSize)));
+    fftBuffer.assign (2 * fftSize, 0.0f);
+    spectrum.assign (spectrumStride, 0.0f);
+    sum.assign (spectrumStride, 0.0f);
+
+    // Each partition of the kernel is zero padded to the size of a window. That
+    // leaves the second half of each window's circular convolution with the
+    // partition equal to the linear one, which is the half the output comes from.
+    kernelSpectra.assign (numPartitions * spectrumStride, 0.0f);
+
+    for (size_t p = 0; p < numPartitions; ++p)
+    {
+        const auto start = p * partitionSize;
+        const auto length = juce::jmin (partitionSize, numTaps - start);
+
+        std::fill (fftBuffer.begin(), fftBuffer.end(), 0.0f);
+        std::copy (kernel.begin() + (ptrdiff_t) start, kernel.begin() + (ptrdiff_t) (start + length), fftBuffer.begin());
+
+        fft->performRealOnlyForwardTransform (fftBuffer.data(), true);
+        deinterleave (fftBuffer.data(), kernelSpectra.data() + p * spectrumStride, spectrumSize);
+    }
+
+    windows.assign (numChannels * fftSize, 0.0f);
+    inputSpectra.assign (numChannels * numStoredSpectra * spectrumStride, 0.0f);
+    tails.assign (numChannels * spectrumStride, 0.0f);
+
+    position = 0;
+    newestSpectrum = 0;
+}
+
+//==============================================================================
+void FIREngine::processBlock (const juce::dsp::AudioBlock<const float>& input,
+                              const juce::dsp::AudioBlock<float>& output) noexcept
+{
+    const auto channels = juce::jmin (input.getNumChannels(), numChannels);
+    const auto totalSamples = input.getNumSamples();
+
+    // The channels must have been prepared for
+    jassert (input.getNumChannels() <= numChannels);
+
+    if (kernel.empty())
+    {
+        output.clear();
+        return;
+    }
+
+    for (size_t start = 0; start < totalSamples;)
+    {
+        // The partitioned convolution can only run up to the end of its block
+        const auto numSamples = method == Method::directForm ? juce::jmin (maximumBlockSize, totalSamples - start)
+                                                             : juce::jmin (partitionSize - position, totalSamples - start);
+
+        for (size_t channel = 0; channel < channels; ++channel)
+        {
+            const auto* source = input.getChannelPointer (channel) + start;
+            auto* dest = output.getChannelPointer (channel) + start;
+
+            if (method == Method::directForm)
+                processDirectForm (source, dest, numSamples, channel);
+            else
+                processPartitions (source, dest, numSamples, channel);
+        }
+
+        if (method == Method::partitionedFFT)
+        {
+            position += numSamples;
+
+            if (position == partitionSize)
+                finishPartition();
+        }
+
+        start += numSamples;
+    }
+}
+
+void FIREngine::processDirectForm (const float* input, float* output, size_t numSamples, size_t channel) noexcept
+{
+    constexpr auto width = Lanes::size;
+
+    auto* copies = Lanes::align (copyStorage.data()) + channel * width * copySize;
+    auto* scratch = Lanes::align (scratchStorage.data());
+    const auto* kernelVectors = Lanes::align (kernelVectorStorage.data());
+    const auto* current = copies + historySize;
+    const auto numTaps = kernel.size();
+
+    // The input is copied in first, so that the output can overwrite it
+    std::copy (input, input + numSamples, copies + historySize);
+
+    for (size_t shift = 1; shift < width; ++shift)
+        std::copy (current, current + numSamples, copies + shift * copySize + historySize - shift);
+
+    // Any lanes past the end of the input are worked out too, then ignored
+    const auto numVectors = (numSamples + width - 1) / width;
+    size_t v = 0;
+
+    for (; v + 4 <= numVectors; v += 4)
+        accumulateTaps4 (scratch + v * width, current + v * width, kernelVectors, tapOffsets.data(), numTaps);
+
+    for (; v < numVectors; ++v)
+        accumulateTaps1 (scratch + v * width, current + v * width, kernelVectors, tapOffsets.data(), numTaps);
+
+    std::copy (scratch, scratch + numSamples, output);
+
+    for (size_t shift = 0; shift < width; ++shift)
+    {
+        auto* copy = copies + shift * copySize;
+        std::copy (copy + numSamples, copy + numSamples + historySize, copy);
+    }
+}
+
+void FIREngine::processPartitions (const float* input, float* output, size_t numSamples, size_t channel) noexcept
+{
+    const auto fftSize = 2 * partitionSize;
+    const auto spectrumStride = 2 * spectrumSize;
+    const auto numStoredSpectra = juce::jmax ((size_t) 1, numPartitions - 1);
+
+    auto* window = windows.data() + channel * fftSize;
+    auto* storedSpectra = inputSpectra.data() + channel * numStoredSpectra * spectrumStride;
+    auto* tail = tails.data() + channel * spectrumStride;
+
+    if (position == 0)
+    {
+        FVO::clear (tail, (int) spectrumStride);
+
+        for (size_t p = 1; p < numPartitions; ++p)
+        {
+            const auto stored = (newestSpectrum + numStoredSpectra - (p - 1)) % numStoredSpectra;
+            multiplyAdd (tail, storedSpectra + stored * spectrumStride, kernelSpectra.data() + p * spectrumStride, spectrumSize);
+        }
+    }
+
+    // The rest of the current block is still zero, which doesn't affect the
+    // outputs up to the newest input sample
+    std::copy (input, input + numSamples, window + partitionSize + position);
+
+    std::copy (window, window + fftSize, fftBuffer.data());
+    std::fill (fftBuffer.begin() + (ptrdiff_t) fftSize, fftBuffer.end(), 0.0f);
+    fft->performRealOnlyForwardTransform (fftBuffer.data(), true);
+    deinterleave (fftBuffer.data(), spectrum.data(), spectrumSize);
+
+    std::copy (tail, tail + spectrumStride, sum.data());
+    multiplyAdd (sum.data(), spectrum.data(), kernelSpectra.data(), spectrumSize);
+
+    interleave (sum.data(), fftBuffer.data(), spectrumSize);
+    fft->performRealOnlyInverseTransform (fftBuffer.data());
+
+    const auto* result = fftBuffer.data() + partitionSize + position;
+    std::copy (result, result + numSamples, output);
+
+    // Once the block is full, its spectrum joins the history, and the window moves on
+    if (position + numSamples == partitionSize)
+    {
+        const auto next = (newestSpectrum + 1) % numStoredSpectra;
+        std::copy (spectrum.begin(), spectrum.end(), storedSpectra + next * spectrumStride);
+
+        std::copy (window + partitionSize, window + fftSize, window);
+        std::fill (window + partitionSize, window + fftSize, 0.0f);
+    }
+}
+
+void FIREngine::finishPartition() noexcept
+{
+    const auto numStoredSpectra = juce::jmax ((size_t) 1, numPartitions - 1);
+
+    newestSpectrum = (newestSpectrum + 1) % numStoredSpectra;
+    position = 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/** An FIR filter that stays affordable for long kernels, such as linear phase EQ
+    curves with thousands of taps.
+
+    juce::dsp::FIR::Filter works out every output sample with a scalar loop over
+    all of the taps, so its cost grows with the length of the kernel, and it soon
+    becomes too slow. This picks one of two methods to suit the kernel instead:
+
+    - For short kernels, a direct form that works out a SIMD register's worth of
+      output samples at once, keeping them in registers for every tap.
+    - For long kernels, a uniformly partitioned overlap-save convolution, built on
+      juce::dsp::FFT. The kernel is split into partitions the size of a block,
+      whose spectra are worked out once, and each block of input only needs one
+      forward and one inverse transform, plus a multiply-add per partition.
+
+    Both methods produce the same output as juce::dsp::FIR::Filter, up to rounding,
+    with no added latency, and with any block size up to the prepared maximum.
+    They only handle floats, as juce::dsp::FFT does.
+
+    prepare() and setKernel() allocate, so they must be called off the audio
+    thread, and never at the same time as process().
+*/
+class FIREngine final
+{
+public:
+    //==============================================================================
+    /** The ways in which the kernel can be applied. */
+    enum class Method
+    {
+        automatic,          /**< Picks whichever of the others is faster for the kernel's length. */
+        directForm,         /**< Multiplies and adds each tap, several samples at a time. */
+        partitionedFFT      /**< Multiplies the block's spectrum by the kernel's partitions. */
+    };
+
+    /** The number of taps from which the automatic method switches to the FFT.
+
+        This is where the partitioned FFT overtakes the direct form in the "FIR
+        engine" benchmark, with blocks of anything from 64 to 1024 samples. It
+        depends mostly on the speed of juce::dsp::FFT's engine.
+    */
+    static constexpr int crossoverTaps = 256;
+
+    FIREngine() = default;
+
+    //==============================================================================
+    /** Allocates the state and working space for the given number of channels and
+        maximum block size, and resets the state.
+    */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+
+    /** Clears the filter's memory of the previous input. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Replaces the kernel, and resets the state.
+
+        Tap 0 is applied to the current input sample, as in juce::dsp::FIR::Filter.
+    */
+    void setKernel (const float* taps, int numTaps, Method method = Method::automatic);
+
+    /** Replaces the kernel with a copy of a juce::dsp::FIR::Filter's coefficients. */
+    void setKernel (const juce::dsp::FIR::Coefficients<float>& coefficients, Method method = Method::automatic);
+
+    /** Returns the method in use, which is never automatic once a kernel is set. */
+    Method getMethod() const noexcept                   { return method; }
+
+    int getNumTaps() const noexcept                     { return (int) kernel.size(); }
+
+    //==============================================================================
+    /** Filters the context's input into its output, which can be the same block. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& input = context.getInputBlock();
+        auto& output = context.getOutputBlock();
+
+        jassert (input.getNumChannels() == output.getNumChannels());
+        jassert (input.getNumSamples() == output.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                output.copyFrom (input);
+
+            return;
+        }
+
+        processBlock (input, output);
+    }
+
+private:
+    //==============================================================================
+    void allocate();
+
+    void processBlock (const juce::dsp::AudioBlock<const float>& input,
+                       const juce::dsp::AudioBlock<float>& output) noexcept;
+
+    void processDirectForm (const float* input, float* output, size_t numSamples, size_t channel) noexcept;
+    void processPartitions (const float* input, float* output, size_t numSamples, size_t channel) noexcept;
+    void finishPartition() noexcept;
+
+    // The taps, in their original order
+    std::vector<float> kernel;
+    Method requestedMethod = Method::automatic, method = Method::directForm;
+
+    size_t numChannels = 0, maximumBlockSize = 0;
+
+    // The direct form works a SIMD register of output samples at a time, reading
+    // the input at every offset from a tap. Those reads can't all be aligned, so
+    // each channel keeps one copy of its recent input per lane, each one starting
+    // a sample later than the last. Each copy holds historySize samples of
+    // history, then room for a block. The kernel is stored with every tap
+    // repeated across a register, along with where each tap reads from.
+    std::vector<float> copyStorage, kernelVectorStorage, scratchStorage;
+    std::vector<ptrdiff_t> tapOffsets;
+    size_t historySize = 0, copySize = 0;
+
+    // The partitioned convolution works in blocks of partitionSize samples, and
+    // transforms windows of twice that, holding the previous block then the
+    // current one. The kernel's spectra, and each channel's spectra of its recent
+    // windows, are stored as bins 0 to partitionSize, all real parts then all
+    // imaginary parts. The tail is the sum of every partition except the first,
+    // which only changes once per block, so it's worked out when a block starts.
+    std::unique_ptr<juce::dsp::FFT> fft;
+    size_t partitionSize = 0, numPartitions = 0, spectrumSize = 0;
+    size_t position = 0, newestSpectrum = 0;
+
+    std::vector<float> kernelSpectra, windows, inputSpectra, tails;
+    std::vector<float> fftBuffer, spectrum, sum;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FIREngine)
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/** The inner loops that apply a gain to every channel of a block.
+
+    These work with any number of channels, and with either float or double
+    samples.
+*/
+namespace GainKernel
+{
+    /** Multiplies every channel of the block by a constant gain.
+
+        Unity gain leaves the block untouched, and zero gain just clears it.
+    */
+    template <typename SampleType>
+    void applyGain (const juce::dsp::AudioBlock<SampleType>& block, SampleType gain) noexcept
+    {
+        if (juce::approximatelyEqual (gain, (SampleType) 1))
+            return;
+
+        if (juce::approximatelyEqual (gain, (SampleType) 0))
+        {
+            block.clear();
+            return;
+        }
+
+        block.multiplyBy (gain);
+    }
+
+    //==============================================================================
+    namespace detail
+    {
+        /** Ramps a single channel, continuing from the given gain.
+            Returns the gain applied to the last sample.
+        */
+        template <typename SampleType>
+        SampleType rampChannelScalar (SampleType* data, size_t numSamples, SampleType gain, SampleType ratio) noexcept
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                gain *= ratio;
+                data[i] *= gain;
+            }
+
+            return gain;
+        }
+
+       #if JUCE_USE_SIMD
+        template <typename SampleType>
+        void rampChannelSIMD (SampleType* data, size_t numSamples, SampleType startGain, SampleType ratio) noexcept
+        {
+            using Register = juce::dsp::SIMDRegister<SampleType>;
+            constexpr auto width = Register::size();
+
+            // Run up to the first aligned sample, then one register at a time,
+            // then finish whatever is left over.
+            auto* aligned = Register::getNextSIMDAlignedPtr (data);
+            const auto numHead = juce::jmin (numSamples, (size_t) (aligned - data));
+            auto gain = rampChannelScalar (data, numHead, startGain, ratio);
+
+            data += numHead;
+            numSamples -= numHead;
+
+            if (numSamples >= width)
+            {
+                // The lanes hold gain * ratio^1 ... gain * ratio^width, and every lane
+                // moves on by ratio^width per register.
+                alignas (Register::SIMDRegisterSize) SampleType powers[width];
+                auto power = ratio;
+
+                for (size_t lane = 0; lane < width; ++lane)
+                {
+                    powers[lane] = power;
+                    power *= ratio;
+                }
+
+                const auto step = Register::expand (powers[width - 1]);
+                auto gains = Register::fromRawArray (powers) * gain;
+
+                for (; numSamples >= width; numSamples -= width, data += width)
+                {
+                    (Register::fromRawArray (data) * gains).copyToRawArray (data);
+                    gains *= step;
+                }
+
+                gain = gains.get (0) / ratio;
+            }
+
+            rampChannelScalar (data, numSamples, gain, ratio);
+        }
+       #endif
+    }
+
+    /** Multiplies every channel of the block by a gain that moves geometrically
+        (i.e. linearly in decibels) from startGain to endGain.
+
+        The first sample is multiplied by startGain times one step of the ramp, and
+        the last sample by endGain, so consecutive blocks join up without a repeated
+        or skipped step.
+    */
+    template <typename SampleType>
+    void applyGainRamp (const juce::dsp::AudioBlock<SampleType>& block, SampleType startGain, SampleType endGain) noexcept
+    {
+        const auto numSamples = block.getNumSamples();
+
+        if (numSamples == 0)
+            return;
+
+        // A geometric ramp can't start or finish at zero
+        jassert (startGain > 0 && endGain > 0);
+
+        const auto ratio = std::pow (endGain / startGain, (SampleType) 1 / (SampleType) numSamples);
+
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+        {
+           #if JUCE_USE_SIMD
+            detail::rampChannelSIMD (block.getChannelPointer (ch), numSamples, startGain, ratio);
+           #else
+            detail::rampChannelScalar (block.getChannelPointer (ch), numSamples, startGain, ratio);
+           #endif
+        }
+    }
+}
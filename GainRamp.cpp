@@ -0,0 +1,70 @@
+#include "GainRamp.h"
+#include "GainKernel.h"
+
+//==============================================================================
+GainRamp::GainRamp()
+    : gain (1.0f)
+{
+}
+
+void GainRamp::prepare (double sampleRate) noexcept
+{
+    gain.reset (sampleRate, rampLengthSeconds);
+}
+
+void GainRamp::reset() noexcept
+{
+    gain.setCurrentAndTargetValue (gain.getTargetValue());
+}
+
+float GainRamp::toLinearGain (float gainDecibels) noexcept
+{
+    // A multiplicative ramp can never reach zero, so the floor is kept well below
+    // the parameter's range instead of at minus infinity.
+    return juce::Decibels::decibelsToGain (gainDecibels, -200.0f);
+}
+
+void GainRamp::setTargetDecibels (float newGainDecibels) noexcept
+{
+    gain.setTargetValue (toLinearGain (newGainDecibels));
+    muted = newGainDecibels <= muteDecibels;
+}
+
+void GainRamp::setCurrentAndTargetDecibels (float newGainDecibels) noexcept
+{
+    gain.setCurrentAndTargetValue (toLinearGain (newGainDecibels));
+    muted = newGainDecibels <= muteDecibels;
+}
+
+//==============================================================================
+template <typename SampleType>
+void GainRamp::process (juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept
+{
+    if (isMuted())
+    {
+        // Clearing the whole buffer also marks it as silent, which lets the
+        // plugin wrappers tell the host that there's nothing downstream to process.
+        buffer.clear (startSample, numSamples);
+        return;
+    }
+
+    const auto block = juce::dsp::AudioBlock<SampleType> (buffer).getSubBlock ((size_t) startSample, (size_t) numSamples);
+
+    if (! gain.isSmoothing())
+    {
+        GainKernel::applyGain (block, (SampleType) gain.getTargetValue());
+        return;
+    }
+
+    // The smoother keeps track of how far through the ramp we are, and the kernel
+    // fills in the samples in between. If the ramp finishes part way through the
+    // block, the rest of the block still moves towards the target rather than
+    // sitting at it, which just stretches the ramp by less than one block.
+    const auto startGain = gain.getCurrentValue();
+    const auto endGain = gain.skip (numSamples);
+
+    GainKernel::applyGainRamp (block, (SampleType) startGain, (SampleType) endGain);
+}
+
+template void GainRamp::process (juce::AudioBuffer<float>&, int, int) noexcept;
+template void GainRamp::process (juce::AudioBuffer<double>&, int, int) noexcept;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/** Applies the gain parameter to a buffer, ramping sample by sample whenever the
+    target changes so that automation never steps at a block boundary.
+
+    The ramp is multiplicative (i.e. linear in decibels), which sounds even across
+    the whole range of the parameter. While no ramp is in progress the gain is
+    applied with a single vectorised multiply per channel, so steady-state blocks
+    cost no more than a flat gain would. Ramps are applied by GainKernel's SIMD
+    ramp, which works out each sample's gain in registers.
+
+    Hosts only hand JUCE one parameter value per block, so the processor sets the
+    target once per block. Callers that do know where in a block a change happens
+    (an offline renderer replaying automation, for instance) can split the block at
+    that offset, and call setTargetDecibels() and process() for each part.
+*/
+class GainRamp final
+{
+public:
+    //==============================================================================
+    GainRamp();
+
+    /** The time it takes to ramp from one gain to another. */
+    static constexpr double rampLengthSeconds = 0.02;
+
+    /** Gains at or below this level mute the output completely, rather than
+        attenuating it. It's the bottom of the gain parameter's range.
+    */
+    static constexpr float muteDecibels = -60.0f;
+
+    /** Prepares the ramp for playback. Any ramp in progress is skipped to its target. */
+    void prepare (double sampleRate) noexcept;
+
+    /** Skips any ramp in progress, so the next block starts at the target gain. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Sets the gain to ramp towards, starting at the next sample processed. */
+    void setTargetDecibels (float newGainDecibels) noexcept;
+
+    /** Sets the gain immediately, without ramping. */
+    void setCurrentAndTargetDecibels (float newGainDecibels) noexcept;
+
+    /** Returns true while the gain is moving towards a new target. */
+    bool isRamping() const noexcept             { return gain.isSmoothing(); }
+
+    /** Returns the linear gain that the next sample will be multiplied by. */
+    float getCurrentGain() const noexcept       { return gain.getCurrentValue(); }
+
+    /** Returns true once the gain has settled at or below muteDecibels, in which
+        case process() just clears the buffer.
+    */
+    bool isMuted() const noexcept               { return muted && ! gain.isSmoothing(); }
+
+    /** Moves the ramp on by a number of samples without processing anything, for
+        blocks that the caller has dealt with some other way.
+    */
+    void skip (int numSamples) noexcept         { gain.skip (numSamples); }
+
+    //==============================================================================
+    /** Applies the gain to a region of every channel of the buffer, in place.
+
+        The ramp's state is kept in single precision whichever sample type is being
+        processed, so a processor can switch precision without the gain jumping.
+    */
+    template <typename SampleType>
+    void process (juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept;
+
+    /** Applies the gain to the whole buffer, in place. */
+    template <typename SampleType>
+    void process (juce::AudioBuffer<SampleType>& buffer) noexcept   { process (buffer, 0, buffer.getNumSamples()); }
+
+private:
+    //==============================================================================
+    static float toLinearGain (float gainDecibels) noexcept;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> gain;
+    bool muted = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainRamp)
+};
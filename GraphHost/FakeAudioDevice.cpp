@@ -0,0 +1,93 @@
+#include "FakeAudioDevice.h"
+
+//==============================================================================
+class FakeAudioDevice::CallbackThread final : public juce::Thread
+{
+public:
+    CallbackThread (const FakeAudioDevice& d, int numBlocksToRun, std::function<void()> callbackToUse)
+        : Thread ("Fake audio device"),
+          device (d),
+          numBlocks (numBlocksToRun),
+          callback (std::move (callbackToUse))
+    {
+        timings.callbackNanoseconds.reserve ((size_t) numBlocks);
+    }
+
+    void run() override
+    {
+        using Clock = std::chrono::steady_clock;
+        const std::chrono::duration<double, std::nano> blockDuration (device.blockNanoseconds);
+
+        auto start = Clock::now();
+        int blocksSinceStart = 0;
+
+        for (int block = 0; block < numBlocks && ! threadShouldExit(); ++block)
+        {
+            const auto due = start + std::chrono::duration_cast<Clock::duration> (blockDuration * blocksSinceStart);
+            std::this_thread::sleep_until (due);
+
+            const auto callbackStart = Clock::now();
+            callback();
+            const auto callbackEnd = Clock::now();
+
+            timings.callbackNanoseconds.push_back (std::chrono::duration<double, std::nano> (callbackEnd - callbackStart).count());
+            ++blocksSinceStart;
+
+            if (callbackEnd > due + std::chrono::duration_cast<Clock::duration> (blockDuration))
+            {
+                ++timings.deadlineMisses;
+                start = callbackEnd;
+                blocksSinceStart = 0;
+            }
+        }
+    }
+
+    Timings timings;
+
+private:
+    const FakeAudioDevice& device;
+    const int numBlocks;
+    std::function<void()> callback;
+};
+
+//==============================================================================
+FakeAudioDevice::FakeAudioDevice (double rate, int size)
+    : sampleRate (rate),
+      blockSize (size),
+      blockNanoseconds (1.0e9 * size / rate)
+{
+}
+
+FakeAudioDevice::Timings FakeAudioDevice::run (int numBlocks, std::function<void()> callback)
+{
+    CallbackThread thread (*this, numBlocks, std::move (callback));
+
+    const auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime (blockSize, sampleRate);
+    thread.timings.realtime = thread.startRealtimeThread (options);
+
+    if (! thread.timings.realtime)
+        thread.startThread (juce::Thread::Priority::highest);
+
+    thread.waitForThreadToExit (-1);
+    return thread.timings;
+}
+
+//==============================================================================
+double FakeAudioDevice::Timings::getPercentile (double percentile) const
+{
+    if (callbackNanoseconds.empty())
+        return 0.0;
+
+    auto sorted = callbackNanoseconds;
+    const auto index = (size_t) juce::jlimit (0.0, (double) sorted.size() - 1.0, std::ceil (percentile / 100.0 * (double) sorted.size()) - 1.0);
+    std::nth_element (sorted.begin(), sorted.begin() + (std::ptrdiff_t) index, sorted.end());
+    return sorted[index];
+}
+
+double FakeAudioDevice::Timings::getMean() const
+{
+    if (callbackNanoseconds.empty())
+        return 0.0;
+
+    return std::accumulate (callbackNanoseconds.begin(), callbackNanoseconds.end(), 0.0) / (double) callbackNanoseconds.size();
+}
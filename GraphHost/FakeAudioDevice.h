@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/** Calls an audio callback at the pace that a real audio device would, without
+    any audio hardware involved.
+
+    Block n is due n block durations after the first one. The device waits for
+    each block's due time, calls the callback, and counts a deadline miss if the
+    callback hasn't returned by the time the next block is due, which is when a
+    real device would have run out of audio to play. After a miss the clock
+    starts again from when the late callback returned, as a real device would
+    carry on after an xrun, rather than calling the callback back to back to
+    catch up.
+
+    The callbacks run on a thread of their own, which gets real-time priority if
+    the system allows it.
+*/
+class FakeAudioDevice final
+{
+public:
+    FakeAudioDevice (double sampleRate, int blockSize);
+
+    /** How long each callback took, and how many of them were late. */
+    struct Timings
+    {
+        /** The time that each callback took, in nanoseconds. */
+        std::vector<double> callbackNanoseconds;
+
+        /** The number of callbacks that returned after the next one was due. */
+        int deadlineMisses = 0;
+
+        /** True if the callbacks ran on a real-time thread. */
+        bool realtime = false;
+
+        /** Returns the given percentile of the callback times, from 0 to 100. */
+        double getPercentile (double percentile) const;
+
+        /** Returns the average callback time. */
+        double getMean() const;
+    };
+
+    /** Calls the callback numBlocks times, and waits until they've all returned. */
+    Timings run (int numBlocks, std::function<void()> callback);
+
+    /** Returns the time between callbacks, in nanoseconds. */
+    double getBlockNanoseconds() const noexcept     { return blockNanoseconds; }
+
+private:
+    class CallbackThread;
+
+    double sampleRate;
+    int blockSize;
+    double blockNanoseconds;
+
+    JUCE_DECLARE_NON_COPYABLE (FakeAudioDevice)
+};
@@ -0,0 +1,196 @@
+#include "GraphHost.h"
+
+#if JUCE_MAC
+ #include <malloc/malloc.h>
+#elif JUCE_LINUX
+ #include <malloc.h>
+#endif
+
+//==============================================================================
+/** Returns the number of bytes that the process has allocated and not yet freed,
+    on the platforms where the allocator can say.
+
+    This is used rather than the process's resident memory, which doesn't shrink
+    when memory is freed, so it wouldn't show anything for a second graph built
+    in the space that the first one left.
+*/
+static std::optional<juce::int64> getAllocatedBytes()
+{
+   #if JUCE_MAC
+    malloc_statistics_t statistics;
+    malloc_zone_statistics (nullptr, &statistics);
+    return (juce::int64) statistics.size_in_use;
+   #elif JUCE_LINUX && defined (__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const auto info = mallinfo2();
+    return (juce::int64) (info.uordblks + info.hblkhd);
+   #else
+    return {};
+   #endif
+}
+
+//==============================================================================
+juce::var HostSettings::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty ("numInstances", numInstances);
+    object->setProperty ("chainLength", chainLength == 0 ? numInstances : chainLength);
+    object->setProperty ("numChannels", numChannels);
+    object->setProperty ("sampleRate", sampleRate);
+    object->setProperty ("blockSize", blockSize);
+    object->setProperty ("seconds", seconds);
+    object->setProperty ("numRenderThreads", numRenderThreads);
+    return juce::var (object);
+}
+
+juce::var HostResults::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty ("numBlocks", numBlocks);
+    object->setProperty ("deadlineMisses", deadlineMisses);
+    object->setProperty ("realtime", realtime);
+    object->setProperty ("load", getLoad());
+    object->setProperty ("blockNanoseconds", blockNanoseconds);
+    object->setProperty ("callbackMeanNanoseconds", callbackMean);
+    object->setProperty ("callbackMedianNanoseconds", callbackMedian);
+    object->setProperty ("callback99thPercentileNanoseconds", callback99);
+    object->setProperty ("callback999thPercentileNanoseconds", callback999);
+    object->setProperty ("callbackMaxNanoseconds", callbackMax);
+    object->setProperty ("perNodeNanoseconds", perNode);
+    object->setProperty ("instanceMeanNanoseconds", instanceMean);
+    object->setProperty ("instanceMaxNanoseconds", instanceMax);
+
+    if (bytesPerInstance.has_value())
+        object->setProperty ("bytesPerInstance", *bytesPerInstance);
+
+    return juce::var (object);
+}
+
+//==============================================================================
+GraphHost::GraphHost (const HostSettings& settingsToUse)
+    : settings (settingsToUse),
+      allocatedBytesBefore (getAllocatedBytes())
+{
+    createGraph();
+}
+
+GraphHost::~GraphHost()
+{
+    graph.releaseResources();
+}
+
+HostResults GraphHost::run()
+{
+    juce::AudioBuffer<float> input (settings.numChannels, settings.blockSize), buffer (settings.numChannels, settings.blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random (0x5e);
+
+    for (int ch = 0; ch < settings.numChannels; ++ch)
+        for (int i = 0; i < settings.blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() - 0.5f);
+
+    // Plays the same block of noise over and over, as a device's input would arrive
+    const auto callback = [&]
+    {
+        for (int ch = 0; ch < settings.numChannels; ++ch)
+            buffer.copyFrom (ch, 0, input, ch, 0, settings.blockSize);
+
+        midi.clear();
+        graph.processBlock (buffer, midi);
+    };
+
+    // A few blocks first, so that every instance has touched its memory, and the
+    // telemetry only covers the blocks that are timed
+    for (int i = 0; i < 16; ++i)
+        callback();
+
+    HostResults results;
+
+    if (const auto allocatedBytesAfter = getAllocatedBytes(); allocatedBytesAfter.has_value() && allocatedBytesBefore.has_value())
+        results.bytesPerInstance = (double) (*allocatedBytesAfter - *allocatedBytesBefore) / settings.numInstances;
+
+    std::vector<juce::uint64> blocksBefore, nanosecondsBefore;
+
+    for (auto* instance : instances)
+    {
+        const auto snapshot = instance->getTelemetry().getSnapshot();
+        blocksBefore.push_back (snapshot.numBlocks);
+        nanosecondsBefore.push_back (snapshot.totalRenderNanoseconds);
+    }
+
+    FakeAudioDevice device (settings.sampleRate, settings.blockSize);
+    const auto numBlocks = juce::jmax (1, juce::roundToInt (settings.seconds * settings.sampleRate / settings.blockSize));
+    const auto timings = device.run (numBlocks, callback);
+
+    results.numBlocks = (int) timings.callbackNanoseconds.size();
+    results.deadlineMisses = timings.deadlineMisses;
+    results.realtime = timings.realtime;
+    results.blockNanoseconds = device.getBlockNanoseconds();
+    results.callbackMean = timings.getMean();
+    results.callbackMedian = timings.getPercentile (50.0);
+    results.callback99 = timings.getPercentile (99.0);
+    results.callback999 = timings.getPercentile (99.9);
+    results.callbackMax = timings.getPercentile (100.0);
+    results.perNode = results.callbackMean / settings.numInstances;
+
+    for (int i = 0; i < instances.size(); ++i)
+    {
+        const auto snapshot = instances[i]->getTelemetry().getSnapshot();
+        const auto blocks = snapshot.numBlocks - blocksBefore[(size_t) i];
+
+        if (blocks == 0)
+            continue;
+
+        const auto mean = (double) (snapshot.totalRenderNanoseconds - nanosecondsBefore[(size_t) i]) / (double) blocks;
+        results.instanceMean += mean / instances.size();
+        results.instanceMax = juce::jmax (results.instanceMax, mean);
+    }
+
+    return results;
+}
+
+//==============================================================================
+void GraphHost::createGraph()
+{
+    using Graph = juce::AudioProcessorGraph;
+    using IO = Graph::AudioGraphIOProcessor;
+    constexpr auto none = Graph::UpdateKind::none;
+
+    graph.setPlayConfigDetails (settings.numChannels, settings.numChannels, settings.sampleRate, settings.blockSize);
+    graph.setNumRenderThreads (settings.numRenderThreads);
+
+    const auto audioIn = graph.addNode (std::make_unique<IO> (IO::audioInputNode), std::nullopt, none)->nodeID;
+    const auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode), std::nullopt, none)->nodeID;
+
+    const auto chainLength = settings.chainLength > 0 ? settings.chainLength : settings.numInstances;
+    const auto channels = juce::AudioChannelSet::canonicalChannelSet (settings.numChannels);
+
+    const auto connect = [&] (Graph::NodeID source, Graph::NodeID destination)
+    {
+        for (int ch = 0; ch < settings.numChannels; ++ch)
+            graph.addConnection ({ { source, ch }, { destination, ch } }, none);
+    };
+
+    auto previous = audioIn;
+
+    for (int i = 0; i < settings.numInstances; ++i)
+    {
+        auto processor = std::make_unique<AudioPluginAudioProcessor>();
+        const auto layoutSupported = processor->setBusesLayout ({ { channels }, { channels } });
+        jassertquiet (layoutSupported);
+
+        instances.add (processor.get());
+        const auto node = graph.addNode (std::move (processor), std::nullopt, none)->nodeID;
+
+        connect (previous, node);
+        previous = node;
+
+        if ((i + 1) % chainLength == 0 || i + 1 == settings.numInstances)
+        {
+            connect (previous, audioOut);
+            previous = audioIn;
+        }
+    }
+
+    graph.prepareToPlay (settings.sampleRate, settings.blockSize);
+    graph.rebuild();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "FakeAudioDevice.h"
+
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Everything that controls the graph that a GraphHost builds, and how it's run. */
+struct HostSettings
+{
+    /** The number of AudioPluginAudioProcessor instances in the graph. */
+    int numInstances = 64;
+
+    /** The instances are split into chains of this many, one after another, with
+        every chain fed from the graph's input and mixed into its output. 1 puts
+        every instance side by side, and 0 puts them all in a single chain.
+    */
+    int chainLength = 0;
+
+    int numChannels = 2;
+    double sampleRate = 48000.0;
+    int blockSize = 256;
+
+    /** How long to run the fake device for, in seconds of audio. */
+    double seconds = 10.0;
+
+    /** The number of threads for AudioProcessorGraph's parallel render mode, or 0
+        to render on the device's callback thread alone.
+    */
+    int numRenderThreads = 0;
+
+    /** Converts this to an object that can be written as JSON. */
+    juce::var toVar() const;
+};
+
+//==============================================================================
+/** What a GraphHost measured. All times are in nanoseconds. */
+struct HostResults
+{
+    int numBlocks = 0;
+
+    /** The number of callbacks that weren't finished by the time the next one was due. */
+    int deadlineMisses = 0;
+
+    /** True if the fake device's callbacks ran on a real-time thread. */
+    bool realtime = false;
+
+    /** The time between callbacks, and statistics of the time that each one took. */
+    double blockNanoseconds = 0.0;
+    double callbackMean = 0.0, callbackMedian = 0.0, callback99 = 0.0, callback999 = 0.0, callbackMax = 0.0;
+
+    /** The average callback time divided by the number of instances, which includes
+        each instance's share of the graph's own work.
+    */
+    double perNode = 0.0;
+
+    /** The average time that an instance took to render a block, as measured by its
+        own telemetry, and the same for the slowest instance.
+    */
+    double instanceMean = 0.0, instanceMax = 0.0;
+
+    /** How much more memory the process had allocated per instance, after the
+        instances had been created and had rendered, than before. This includes
+        each one's share of the graph's buffers. It's only available on Linux, with
+        glibc, and macOS.
+    */
+    std::optional<double> bytesPerInstance;
+
+    /** The average callback time as a proportion of the time between callbacks. */
+    double getLoad() const noexcept     { return callbackMean / blockNanoseconds; }
+
+    /** Converts this to an object that can be written as JSON. */
+    juce::var toVar() const;
+};
+
+//==============================================================================
+/** Hosts a number of AudioPluginAudioProcessor instances in an AudioProcessorGraph,
+    and renders it from a FakeAudioDevice, measuring how well it keeps up.
+*/
+class GraphHost final
+{
+public:
+    explicit GraphHost (const HostSettings&);
+    ~GraphHost();
+
+    /** Runs the fake device for the length of time in the settings. */
+    HostResults run();
+
+private:
+    //==============================================================================
+    void createGraph();
+
+    HostSettings settings;
+    std::optional<juce::int64> allocatedBytesBefore;
+    juce::AudioProcessorGraph graph;
+    juce::Array<AudioPluginAudioProcessor*> instances;
+
+    JUCE_DECLARE_NON_COPYABLE (GraphHost)
+};
@@ -0,0 +1,228 @@
+#include "GraphHost.h"
+
+#include <iostream>
+
+//==============================================================================
+// This removes the options it understands from the argument list, so that
+// anything left over afterwards can be reported as unknown.
+
+static HostSettings parseHostSettings (juce::ArgumentList& args)
+{
+    HostSettings settings;
+
+    if (args.containsOption ("--instances"))
+        settings.numInstances = args.removeValueForOption ("--instances").getIntValue();
+
+    if (args.containsOption ("--topology"))
+    {
+        const auto topology = args.removeValueForOption ("--topology");
+
+        if (topology == "serial")
+            settings.chainLength = 0;
+        else if (topology == "parallel")
+            settings.chainLength = 1;
+        else
+            juce::ConsoleApplication::fail ("The topology must be serial or parallel");
+    }
+
+    if (args.containsOption ("--chain-length"))
+    {
+        settings.chainLength = args.removeValueForOption ("--chain-length").getIntValue();
+
+        if (settings.chainLength <= 0)
+            juce::ConsoleApplication::fail ("The chain length must be greater than zero");
+    }
+
+    if (args.containsOption ("--channels"))
+        settings.numChannels = args.removeValueForOption ("--channels").getIntValue();
+
+    if (args.containsOption ("--sample-rate"))
+        settings.sampleRate = args.removeValueForOption ("--sample-rate").getDoubleValue();
+
+    if (args.containsOption ("--block-size"))
+        settings.blockSize = args.removeValueForOption ("--block-size").getIntValue();
+
+    if (args.containsOption ("--seconds"))
+        settings.seconds = args.removeValueForOption ("--seconds").getDoubleValue();
+
+    if (args.containsOption ("--render-threads"))
+        settings.numRenderThreads = args.removeValueForOption ("--render-threads").getIntValue();
+
+    if (settings.numInstances <= 0)
+        juce::ConsoleApplication::fail ("The number of instances must be greater than zero");
+
+    if (settings.numChannels <= 0)
+        juce::ConsoleApplication::fail ("The number of channels must be greater than zero");
+
+    if (settings.sampleRate <= 0.0)
+        juce::ConsoleApplication::fail ("The sample rate must be greater than zero");
+
+    if (settings.blockSize <= 0)
+        juce::ConsoleApplication::fail ("The block size must be greater than zero");
+
+    if (settings.seconds <= 0.0)
+        juce::ConsoleApplication::fail ("The length of the run must be greater than zero");
+
+    if (settings.numRenderThreads < 0)
+        juce::ConsoleApplication::fail ("The number of render threads can't be negative");
+
+    return settings;
+}
+
+static juce::File parseJsonFile (juce::ArgumentList& args)
+{
+    if (! args.containsOption ("--json"))
+        return {};
+
+    return juce::File::getCurrentWorkingDirectory().getChildFile (args.removeValueForOption ("--json").unquoted());
+}
+
+//==============================================================================
+static HostResults runHost (const HostSettings& settings)
+{
+    const auto results = [&]
+    {
+        GraphHost host (settings);
+        return host.run();
+    }();
+
+    std::cout << settings.numInstances << " instances: "
+              << results.deadlineMisses << " deadline misses in " << results.numBlocks << " blocks, load "
+              << juce::String (results.getLoad(), 3) << ", "
+              << juce::String (results.perNode, 0) << " ns per node, "
+              << juce::String (results.instanceMean, 0) << " ns per instance";
+
+    if (results.bytesPerInstance.has_value())
+        std::cout << ", " << juce::String (*results.bytesPerInstance / 1024.0, 1) << " KiB per instance";
+
+    std::cout << std::endl;
+    return results;
+}
+
+static juce::var createRunVar (const HostSettings& settings, const HostResults& results)
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty ("settings", settings.toVar());
+    object->setProperty ("results", results.toVar());
+    return juce::var (object);
+}
+
+/** Finds the most instances that run without a deadline miss: the count doubles
+    from the one in the settings until a run misses one, and then the gap between
+    the last run that kept up and the first one that didn't is halved until it's
+    within 2% of the result.
+*/
+static int findMaxInstances (HostSettings settings, juce::Array<juce::var>& runs)
+{
+    constexpr int limit = 1 << 16;
+
+    const auto keepsUp = [&] (int numInstances)
+    {
+        settings.numInstances = numInstances;
+        const auto results = runHost (settings);
+        runs.add (createRunVar (settings, results));
+        return results.deadlineMisses == 0;
+    };
+
+    int highestKeptUp = 0, lowestMissed = 0;
+
+    for (auto n = settings.numInstances; lowestMissed == 0 && n <= limit; n *= 2)
+    {
+        if (keepsUp (n))
+            highestKeptUp = n;
+        else
+            lowestMissed = n;
+    }
+
+    if (lowestMissed == 0)
+        return highestKeptUp;
+
+    while (lowestMissed - highestKeptUp > juce::jmax (1, highestKeptUp / 50))
+    {
+        const auto n = (highestKeptUp + lowestMissed) / 2;
+
+        if (keepsUp (n))
+            highestKeptUp = n;
+        else
+            lowestMissed = n;
+    }
+
+    return highestKeptUp;
+}
+
+//==============================================================================
+/** Writes the results to a JSON file, along with enough about the machine and
+    build to tell whether two files can be compared.
+*/
+static void writeJson (const juce::File& file, juce::DynamicObject::Ptr root)
+{
+    root->setProperty ("time", juce::Time::getCurrentTime().toISO8601 (true));
+    root->setProperty ("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty ("numCpus", juce::SystemStats::getNumCpus());
+    root->setProperty ("operatingSystem", juce::SystemStats::getOperatingSystemName());
+    root->setProperty ("juceVersion", juce::SystemStats::getJUCEVersion());
+
+    if (! file.replaceWithText (juce::JSON::toString (juce::var (root.get()))))
+        juce::ConsoleApplication::fail ("Couldn't write " + file.getFullPathName());
+}
+
+static void host (juce::ArgumentList args)
+{
+    const auto findMax = args.removeOptionIfFound ("--density");
+    const auto settings = parseHostSettings (args);
+    const auto jsonFile = parseJsonFile (args);
+
+    for (int i = 0; i < args.size(); ++i)
+        juce::ConsoleApplication::fail ("Unknown argument " + args[i].text);
+
+    juce::DynamicObject::Ptr root (new juce::DynamicObject());
+
+    if (findMax)
+    {
+        juce::Array<juce::var> runs;
+        const auto maxInstances = findMaxInstances (settings, runs);
+
+        std::cout << "At most " << maxInstances << " instances ran without a deadline miss" << std::endl;
+
+        root->setProperty ("maxInstances", maxInstances);
+        root->setProperty ("runs", runs);
+    }
+    else
+    {
+        const auto results = runHost (settings);
+        root->setProperty ("runs", juce::Array<juce::var> { createRunVar (settings, results) });
+    }
+
+    if (jsonFile != juce::File())
+        writeJson (jsonFile, root);
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor's parameter state needs a message manager, even though
+    // nothing here ever opens a window.
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+
+    juce::ConsoleApplication app;
+
+    app.addHelpCommand ("--help|-h", "Usage:", false);
+
+    app.addDefaultCommand ({ "",
+                             "[--instances=<count>] [--topology=serial|parallel] [--chain-length=<count>] [--channels=<count>] "
+                             "[--sample-rate=<Hz>] [--block-size=<samples>] [--seconds=<length>] [--render-threads=<count>] "
+                             "[--density] [--json=<file.json>]",
+                             "Hosts Mute instances in an AudioProcessorGraph, and renders it from a simulated audio device",
+                             "The instances are connected one after another with --topology=serial, which is the default, or "
+                             "side by side with --topology=parallel, or in chains of --chain-length, with every chain fed from "
+                             "the graph's input and mixed into its output. The graph is rendered for --seconds of audio, with "
+                             "callbacks paced as a real device would pace them, and reports the number of callbacks that "
+                             "missed their deadline, the cost per node, and the memory per instance. "
+                             "--density instead finds the most instances that run without missing a deadline, starting "
+                             "from --instances and doubling until a run misses one, then narrowing it down. "
+                             "--render-threads renders the graph with its parallel render mode. "
+                             "--json writes every run's settings and results to a JSON file.",
+                             [] (const auto& args) { host (args); } });
+
+    return app.findAndRunCommand (argc, argv);
+}
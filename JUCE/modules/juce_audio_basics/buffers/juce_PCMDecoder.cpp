@@ -0,0 +1,474 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace PCMDecoderHelpers
+{
+    // Every integer format is widened to a 32-bit int, and then scaled by this
+    constexpr double int32Scale = 1.0 / 2147483648.0;
+
+    template <typename Dest>
+    static forcedinline Dest fromInt32 (int32 sample) noexcept
+    {
+        return (Dest) sample * (Dest) int32Scale;
+    }
+
+    static forcedinline int32 readUInt8 (const uint8* p) noexcept   { return (int32) ((uint32) (p[0] ^ 0x80) << 24); }
+    static forcedinline int32 readInt16 (const uint8* p) noexcept   { return (int32) ((uint32) ByteOrder::littleEndianShort (p) << 16); }
+    static forcedinline int32 readInt24 (const uint8* p) noexcept   { return (int32) (((uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16)) << 8); }
+    static forcedinline int32 readInt32 (const uint8* p) noexcept   { return (int32) ByteOrder::littleEndianInt (p); }
+
+    static forcedinline float readFloat32 (const uint8* p) noexcept
+    {
+        const auto bits = ByteOrder::littleEndianInt (p);
+        float result;
+        memcpy (&result, &bits, sizeof (result));
+        return result;
+    }
+
+    static forcedinline double readFloat64 (const uint8* p) noexcept
+    {
+        const auto bits = ByteOrder::littleEndianInt64 (p);
+        double result;
+        memcpy (&result, &bits, sizeof (result));
+        return result;
+    }
+
+    // Each of the vectorised conversions below converts as many samples as it can,
+    // and returns the number it did, leaving the rest to be done one at a time.
+   #if JUCE_USE_SSE_INTRINSICS && JUCE_LITTLE_ENDIAN
+    static forcedinline void storeInt32s (float* dest, __m128i samples) noexcept
+    {
+        _mm_storeu_ps (dest, _mm_mul_ps (_mm_cvtepi32_ps (samples), _mm_set1_ps ((float) int32Scale)));
+    }
+
+    static forcedinline void storeInt32s (double* dest, __m128i samples) noexcept
+    {
+        const auto scale = _mm_set1_pd (int32Scale);
+        _mm_storeu_pd (dest,     _mm_mul_pd (_mm_cvtepi32_pd (samples), scale));
+        _mm_storeu_pd (dest + 2, _mm_mul_pd (_mm_cvtepi32_pd (_mm_srli_si128 (samples, 8)), scale));
+    }
+
+    template <typename Dest>
+    static int decodeInt16 (const uint8* source, Dest* dest, int numSamples) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        int i = 0;
+
+        // Interleaving zeros in below each sample shifts it to the top of a 32-bit lane
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const auto samples = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + 2 * i));
+            storeInt32s (dest + i,     _mm_unpacklo_epi16 (zero, samples));
+            storeInt32s (dest + i + 4, _mm_unpackhi_epi16 (zero, samples));
+        }
+
+        return i;
+    }
+
+    template <typename Dest>
+    static int decodeInt24 (const uint8* source, Dest* dest, int numSamples) noexcept
+    {
+        const auto lane0 = _mm_setr_epi32 (-1, 0, 0, 0), lane1 = _mm_setr_epi32 (0, -1, 0, 0),
+                   lane2 = _mm_setr_epi32 (0, 0, -1, 0), lane3 = _mm_setr_epi32 (0, 0, 0, -1);
+        int i = 0;
+
+        // Four samples take 12 bytes, and the load takes 16, so this stops while
+        // there are at least two more samples after them. Shifting the whole
+        // register left by k bytes brings sample k to the start of lane k, with a
+        // byte of the next sample above it, which the final shift pushes out.
+        for (; i + 6 <= numSamples; i += 4)
+        {
+            const auto bytes = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + 3 * i));
+            const auto samples = _mm_or_si128 (_mm_or_si128 (_mm_and_si128 (bytes, lane0),
+                                                             _mm_and_si128 (_mm_slli_si128 (bytes, 1), lane1)),
+                                               _mm_or_si128 (_mm_and_si128 (_mm_slli_si128 (bytes, 2), lane2),
+                                                             _mm_and_si128 (_mm_slli_si128 (bytes, 3), lane3)));
+            storeInt32s (dest + i, _mm_slli_epi32 (samples, 8));
+        }
+
+        return i;
+    }
+
+    template <typename Dest>
+    static int decodeInt32 (const uint8* source, Dest* dest, int numSamples) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+            storeInt32s (dest + i, _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + 4 * i)));
+
+        return i;
+    }
+
+    static int decodeFloat32 (const uint8* source, double* dest, int numSamples) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto samples = _mm_loadu_ps (reinterpret_cast<const float*> (source + 4 * i));
+            _mm_storeu_pd (dest + i,     _mm_cvtps_pd (samples));
+            _mm_storeu_pd (dest + i + 2, _mm_cvtps_pd (_mm_movehl_ps (samples, samples)));
+        }
+
+        return i;
+    }
+
+    static int decodeFloat64 (const uint8* source, float* dest, int numSamples) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto low  = _mm_cvtpd_ps (_mm_loadu_pd (reinterpret_cast<const double*> (source + 8 * i)));
+            const auto high = _mm_cvtpd_ps (_mm_loadu_pd (reinterpret_cast<const double*> (source + 8 * i + 16)));
+            _mm_storeu_ps (dest + i, _mm_movelh_ps (low, high));
+        }
+
+        return i;
+    }
+
+    static void deinterleaveStereo (const float* source, float* left, float* right, int numFrames) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const auto a = _mm_loadu_ps (source + 2 * i), b = _mm_loadu_ps (source + 2 * i + 4);
+            _mm_storeu_ps (left + i,  _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+            _mm_storeu_ps (right + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = source[2 * i];
+            right[i] = source[2 * i + 1];
+        }
+    }
+
+    static void deinterleaveStereo (const double* source, double* left, double* right, int numFrames) noexcept
+    {
+        int i = 0;
+
+        for (; i + 2 <= numFrames; i += 2)
+        {
+            const auto a = _mm_loadu_pd (source + 2 * i), b = _mm_loadu_pd (source + 2 * i + 2);
+            _mm_storeu_pd (left + i,  _mm_unpacklo_pd (a, b));
+            _mm_storeu_pd (right + i, _mm_unpackhi_pd (a, b));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = source[2 * i];
+            right[i] = source[2 * i + 1];
+        }
+    }
+   #elif JUCE_USE_ARM_NEON && JUCE_LITTLE_ENDIAN
+    static forcedinline void storeInt32s (float* dest, int32x4_t samples) noexcept
+    {
+        vst1q_f32 (dest, vmulq_n_f32 (vcvtq_f32_s32 (samples), (float) int32Scale));
+    }
+
+    static int decodeInt16 (const uint8* source, float* dest, int numSamples) noexcept
+    {
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const auto samples = vld1q_s16 (reinterpret_cast<const int16_t*> (source + 2 * i));
+            storeInt32s (dest + i,     vshll_n_s16 (vget_low_s16 (samples), 16));
+            storeInt32s (dest + i + 4, vshll_n_s16 (vget_high_s16 (samples), 16));
+        }
+
+        return i;
+    }
+
+    static int decodeInt24 (const uint8* source, float* dest, int numSamples) noexcept
+    {
+        const auto zero = vdup_n_u8 (0);
+        int i = 0;
+
+        // vld3 splits eight samples into their low, middle and high bytes, which
+        // are zipped back together as the top three bytes of each 32-bit lane
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const auto bytes = vld3_u8 (source + 3 * i);
+            const auto low  = vzip_u8 (zero, bytes.val[0]);
+            const auto high = vzip_u8 (bytes.val[1], bytes.val[2]);
+            const auto samples = vzipq_u16 (vreinterpretq_u16_u8 (vcombine_u8 (low.val[0], low.val[1])),
+                                            vreinterpretq_u16_u8 (vcombine_u8 (high.val[0], high.val[1])));
+            storeInt32s (dest + i,     vreinterpretq_s32_u16 (samples.val[0]));
+            storeInt32s (dest + i + 4, vreinterpretq_s32_u16 (samples.val[1]));
+        }
+
+        return i;
+    }
+
+    static int decodeInt32 (const uint8* source, float* dest, int numSamples) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+            storeInt32s (dest + i, vld1q_s32 (reinterpret_cast<const int32_t*> (source + 4 * i)));
+
+        return i;
+    }
+
+    static int decodeInt16 (const uint8*, double*, int) noexcept     { return 0; }
+    static int decodeInt24 (const uint8*, double*, int) noexcept     { return 0; }
+    static int decodeInt32 (const uint8*, double*, int) noexcept     { return 0; }
+    static int decodeFloat32 (const uint8*, double*, int) noexcept   { return 0; }
+    static int decodeFloat64 (const uint8*, float*, int) noexcept    { return 0; }
+
+    static void deinterleaveStereo (const float* source, float* left, float* right, int numFrames) noexcept
+    {
+        int i = 0;
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const auto frames = vld2q_f32 (source + 2 * i);
+            vst1q_f32 (left + i,  frames.val[0]);
+            vst1q_f32 (right + i, frames.val[1]);
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = source[2 * i];
+            right[i] = source[2 * i + 1];
+        }
+    }
+   #else
+    template <typename Dest> static int decodeInt16 (const uint8*, Dest*, int) noexcept     { return 0; }
+    template <typename Dest> static int decodeInt24 (const uint8*, Dest*, int) noexcept     { return 0; }
+    template <typename Dest> static int decodeInt32 (const uint8*, Dest*, int) noexcept     { return 0; }
+    static int decodeFloat32 (const uint8*, double*, int) noexcept   { return 0; }
+    static int decodeFloat64 (const uint8*, float*, int) noexcept    { return 0; }
+   #endif
+
+   #if ! ((JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON) && JUCE_LITTLE_ENDIAN)
+    static void deinterleaveStereo (const float* source, float* left, float* right, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            left[i]  = source[2 * i];
+            right[i] = source[2 * i + 1];
+        }
+    }
+   #endif
+
+   #if ! (JUCE_USE_SSE_INTRINSICS && JUCE_LITTLE_ENDIAN)
+    static void deinterleaveStereo (const double* source, double* left, double* right, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            left[i]  = source[2 * i];
+            right[i] = source[2 * i + 1];
+        }
+    }
+   #endif
+
+    //==============================================================================
+    template <typename Dest, typename ReadSample>
+    static void decodeRemaining (const uint8* source, int bytesPerSample, Dest* dest,
+                                 int start, int numSamples, ReadSample&& readSample) noexcept
+    {
+        for (int i = start; i < numSamples; ++i)
+            dest[i] = readSample (source + i * bytesPerSample);
+    }
+
+    template <typename Dest>
+    static void decode (PCMDecoder::Format format, const void* sourceData, Dest* dest, int numSamples) noexcept
+    {
+        using Format = PCMDecoder::Format;
+
+        const auto* source = static_cast<const uint8*> (sourceData);
+        const auto bytesPerSample = PCMDecoder::getBytesPerSample (format);
+
+        const auto fromInt = [] (auto read)
+        {
+            return [read] (const uint8* p) { return fromInt32<Dest> (read (p)); };
+        };
+
+        // Samples that are already in the destination's format are just copied
+        if constexpr (std::is_same_v<Dest, float>)
+        {
+           #if JUCE_LITTLE_ENDIAN
+            if (format == Format::float32)
+            {
+                memcpy (dest, source, (size_t) numSamples * sizeof (float));
+                return;
+            }
+           #endif
+        }
+        else
+        {
+           #if JUCE_LITTLE_ENDIAN
+            if (format == Format::float64)
+            {
+                memcpy (dest, source, (size_t) numSamples * sizeof (double));
+                return;
+            }
+           #endif
+        }
+
+        switch (format)
+        {
+            case Format::unsigned8:    decodeRemaining (source, bytesPerSample, dest, 0, numSamples, fromInt (readUInt8)); break;
+            case Format::signed16:     decodeRemaining (source, bytesPerSample, dest, decodeInt16 (source, dest, numSamples), numSamples, fromInt (readInt16)); break;
+            case Format::signed24:     decodeRemaining (source, bytesPerSample, dest, decodeInt24 (source, dest, numSamples), numSamples, fromInt (readInt24)); break;
+            case Format::signed32:     decodeRemaining (source, bytesPerSample, dest, decodeInt32 (source, dest, numSamples), numSamples, fromInt (readInt32)); break;
+
+            case Format::float32:
+            case Format::float64:
+            {
+                int done = 0;
+
+                if constexpr (std::is_same_v<Dest, float>)
+                    done = format == Format::float64 ? decodeFloat64 (source, dest, numSamples) : 0;
+                else
+                    done = format == Format::float32 ? decodeFloat32 (source, dest, numSamples) : 0;
+
+                if (format == Format::float32)
+                    decodeRemaining (source, bytesPerSample, dest, done, numSamples, [] (const uint8* p) { return (Dest) readFloat32 (p); });
+                else
+                    decodeRemaining (source, bytesPerSample, dest, done, numSamples, [] (const uint8* p) { return (Dest) readFloat64 (p); });
+
+                break;
+            }
+        }
+    }
+
+    // The interleaved data is converted in blocks into a buffer on the stack, which
+    // is small enough to stay in the cache while it's split into channels.
+    template <typename Dest>
+    static void decodeInterleaved (PCMDecoder::Format format, const void* sourceData, int numSourceChannels,
+                                   Dest* const* destChannels, int destOffset, int numDestChannels, int numFrames) noexcept
+    {
+        constexpr int blockSize = 1024;
+
+        jassert (numSourceChannels > 0);
+
+        for (int ch = numSourceChannels; ch < numDestChannels; ++ch)
+            if (auto* dest = destChannels[ch])
+                zeromem (dest + destOffset, (size_t) numFrames * sizeof (Dest));
+
+        const auto numChannels = jmin (numSourceChannels, numDestChannels);
+        const auto* source = static_cast<const uint8*> (sourceData);
+        const auto bytesPerFrame = PCMDecoder::getBytesPerSample (format) * numSourceChannels;
+
+        if (numSourceChannels == 1)
+        {
+            if (numChannels > 0 && destChannels[0] != nullptr)
+                decode (format, source, destChannels[0] + destOffset, numFrames);
+
+            return;
+        }
+
+        if (numSourceChannels > blockSize)
+        {
+            const auto bytesPerSample = PCMDecoder::getBytesPerSample (format);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                if (auto* dest = destChannels[ch])
+                    for (int i = 0; i < numFrames; ++i)
+                        decode (format, source + i * bytesPerFrame + ch * bytesPerSample, dest + destOffset + i, 1);
+
+            return;
+        }
+
+        const auto framesPerBlock = blockSize / numSourceChannels;
+        Dest block[blockSize];
+
+        for (int start = 0; start < numFrames; start += framesPerBlock)
+        {
+            const auto numThisTime = jmin (framesPerBlock, numFrames - start);
+            decode (format, source + start * bytesPerFrame, block, numThisTime * numSourceChannels);
+
+            if (numSourceChannels == 2 && numChannels == 2 && destChannels[0] != nullptr && destChannels[1] != nullptr)
+            {
+                deinterleaveStereo (block, destChannels[0] + destOffset + start, destChannels[1] + destOffset + start, numThisTime);
+                continue;
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                if (auto* dest = destChannels[ch])
+                    for (int i = 0; i < numThisTime; ++i)
+                        dest[destOffset + start + i] = block[i * numSourceChannels + ch];
+        }
+    }
+}
+
+//==============================================================================
+int PCMDecoder::getBytesPerSample (Format format) noexcept
+{
+    switch (format)
+    {
+        case Format::unsigned8:    return 1;
+        case Format::signed16:     return 2;
+        case Format::signed24:     return 3;
+        case Format::signed32:     return 4;
+        case Format::float32:      return 4;
+        case Format::float64:      return 8;
+    }
+
+    jassertfalse;
+    return 0;
+}
+
+void PCMDecoder::decode (Format format, const void* source, float* dest, int numSamples) noexcept
+{
+    PCMDecoderHelpers::decode (format, source, dest, numSamples);
+}
+
+void PCMDecoder::decode (Format format, const void* source, double* dest, int numSamples) noexcept
+{
+    PCMDecoderHelpers::decode (format, source, dest, numSamples);
+}
+
+void PCMDecoder::decodeInterleaved (Format format, const void* source, int numSourceChannels,
+                                    float* const* destChannels, int destOffset, int numDestChannels, int numFrames) noexcept
+{
+    PCMDecoderHelpers::decodeInterleaved (format, source, numSourceChannels, destChannels, destOffset, numDestChannels, numFrames);
+}
+
+void PCMDecoder::decodeInterleaved (Format format, const void* source, int numSourceChannels,
+                                    double* const* destChannels, int destOffset, int numDestChannels, int numFrames) noexcept
+{
+    PCMDecoderHelpers::decodeInterleaved (format, source, numSourceChannels, destChannels, destOffset, numDestChannels, numFrames);
+}
+
+} // namespace juce
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Converts raw little-endian PCM sample data, as it's stored in a file, straight
+    to floating point samples.
+
+    AudioFormatReader::readSamples() decodes into 32-bit integers, which then have
+    to be converted to floats in another pass, and floating point data only gets
+    through it by having its bits copied through ints. These go from the bytes in
+    the file to floats or doubles in one pass, using SSE2 or NEON where they can.
+
+    Integer samples are scaled so that the format's full scale is 1.0, so a 16-bit
+    sample of 0x4000 becomes 0.5. Every integer format is widened to 32 bits first,
+    exactly as AudioFormatReader's integer path does, so decoding to floats gives
+    the same results as reading ints and calling
+    FloatVectorOperations::convertFixedToFloat() on them, bit for bit. Decoding to
+    doubles keeps all 32 bits of a 32-bit integer sample.
+
+    Vectorised conversions are used for all but the 8-bit format. On ARM, only
+    the conversions to float are vectorised.
+
+    @see AudioFormatReader, AudioData
+
+    @tags{Audio}
+*/
+class JUCE_API  PCMDecoder
+{
+public:
+    //==============================================================================
+    /** The sample formats that can be decoded. All of them are little-endian. */
+    enum class Format
+    {
+        unsigned8,    /**< 8-bit unsigned integers, centred on 128, as WAV files use. */
+        signed16,     /**< 16-bit signed integers. */
+        signed24,     /**< 24-bit signed integers, packed into 3 bytes. */
+        signed32,     /**< 32-bit signed integers. */
+        float32,      /**< 32-bit IEEE floats. */
+        float64       /**< 64-bit IEEE floats. */
+    };
+
+    /** Returns the number of bytes that a sample takes up in the given format. */
+    static int getBytesPerSample (Format) noexcept;
+
+    //==============================================================================
+    /** Converts a run of samples that follow on from one another.
+
+        This is the layout of one channel of planar data, or of a mono file. The
+        source doesn't need to be aligned.
+    */
+    static void decode (Format, const void* source, float* dest, int numSamples) noexcept;
+
+    /** Converts a run of samples that follow on from one another.
+
+        This is the layout of one channel of planar data, or of a mono file. The
+        source doesn't need to be aligned.
+    */
+    static void decode (Format, const void* source, double* dest, int numSamples) noexcept;
+
+    /** Converts frames of interleaved samples into separate channels.
+
+        The samples are written from destOffset onwards in each destination channel.
+        Any of the destination pointers can be null, in which case that channel is
+        skipped. Destination channels beyond the number in the source are cleared.
+    */
+    static void decodeInterleaved (Format, const void* source, int numSourceChannels,
+                                   float* const* destChannels, int destOffset, int numDestChannels, int numFrames) noexcept;
+
+    /** Converts frames of interleaved samples into separate channels.
+
+        The samples are written from destOffset onwards in each destination channel.
+        Any of the destination pointers can be null, in which case that channel is
+        skipped. Destination channels beyond the number in the source are cleared.
+    */
+    static void decodeInterleaved (Format, const void* source, int numSourceChannels,
+                                   double* const* destChannels, int destOffset, int numDestChannels, int numFrames) noexcept;
+};
+
+} // namespace juce
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct PCMDecoderTests final : public UnitTest
+{
+    PCMDecoderTests()  : UnitTest ("PCMDecoder", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        using Format = PCMDecoder::Format;
+        const auto formats = { Format::unsigned8, Format::signed16, Format::signed24, Format::signed32, Format::float32, Format::float64 };
+
+        beginTest ("Decoding to floats matches converting the 32-bit ints that AudioData produces");
+        {
+            for (const auto format : formats)
+                for (const auto numSamples : { 0, 1, 5, 7, 8, 13, 100, 1031 })
+                    for (const auto offset : { 0, 1, 3 })
+                        expect (decodesLikeReference<float> (format, numSamples, offset));
+        }
+
+        beginTest ("Decoding to doubles keeps the full precision of the source");
+        {
+            for (const auto format : formats)
+                for (const auto numSamples : { 0, 1, 5, 7, 8, 13, 100, 1031 })
+                    for (const auto offset : { 0, 1, 3 })
+                        expect (decodesLikeReference<double> (format, numSamples, offset));
+
+            const uint8 int32Sample[] = { 0x01, 0x00, 0x00, 0x40 };
+            double decoded = 0.0;
+            PCMDecoder::decode (Format::signed32, int32Sample, &decoded, 1);
+            expect (exactlyEqual (decoded, 0.5 + 1.0 / 2147483648.0));
+        }
+
+        beginTest ("Full scale integers decode to plus and minus one");
+        {
+            const uint8 int16Samples[] = { 0x00, 0x80, 0x00, 0x40, 0x00, 0x00 };
+            float decoded[3] {};
+            PCMDecoder::decode (Format::signed16, int16Samples, decoded, 3);
+
+            expect (exactlyEqual (decoded[0], -1.0f));
+            expect (exactlyEqual (decoded[1], 0.5f));
+            expect (exactlyEqual (decoded[2], 0.0f));
+
+            const uint8 uint8Samples[] = { 0x00, 0x80, 0xc0 };
+            PCMDecoder::decode (Format::unsigned8, uint8Samples, decoded, 3);
+
+            expect (exactlyEqual (decoded[0], -1.0f));
+            expect (exactlyEqual (decoded[1], 0.0f));
+            expect (exactlyEqual (decoded[2], 0.5f));
+        }
+
+        beginTest ("Interleaved frames are split into channels");
+        {
+            for (const auto format : formats)
+                for (const auto numChannels : { 1, 2, 3, 6 })
+                    for (const auto numFrames : { 0, 1, 3, 4, 5, 700 })
+                    {
+                        expect (deinterleavesLikeReference<float>  (format, numChannels, numFrames));
+                        expect (deinterleavesLikeReference<double> (format, numChannels, numFrames));
+                    }
+        }
+    }
+
+private:
+    template <typename Target, typename Source>
+    static Target copyBits (Source source)
+    {
+        static_assert (sizeof (Target) == sizeof (Source));
+        Target result;
+        memcpy (&result, &source, sizeof (result));
+        return result;
+    }
+
+    static MemoryBlock makeRandomBytes (Random& random, size_t numBytes)
+    {
+        MemoryBlock block (numBytes);
+
+        for (size_t i = 0; i < numBytes; ++i)
+            block[i] = (char) random.nextInt (256);
+
+        return block;
+    }
+
+    // Random bits would make NaNs and huge values, so floating point sources are
+    // filled with noise instead
+    static MemoryBlock makeSource (PCMDecoder::Format format, int numSamples, int offset)
+    {
+        Random random (0x5e + numSamples);
+        const auto bytesPerSample = PCMDecoder::getBytesPerSample (format);
+        auto block = makeRandomBytes (random, (size_t) (numSamples * bytesPerSample + offset));
+        auto* data = static_cast<uint8*> (block.getData()) + offset;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (format == PCMDecoder::Format::float32)
+            {
+                const auto bits = ByteOrder::swapIfBigEndian (copyBits<uint32> (random.nextFloat() * 2.0f - 1.0f));
+                memcpy (data + i * bytesPerSample, &bits, sizeof (bits));
+            }
+            else if (format == PCMDecoder::Format::float64)
+            {
+                const auto bits = ByteOrder::swapIfBigEndian (copyBits<uint64> (random.nextDouble() * 2.0 - 1.0));
+                memcpy (data + i * bytesPerSample, &bits, sizeof (bits));
+            }
+        }
+
+        return block;
+    }
+
+    /** Decodes one sample the way that AudioFormatReader's integer path would. */
+    template <typename Dest>
+    static Dest decodeReference (PCMDecoder::Format format, const void* source)
+    {
+        using LE = AudioData::LittleEndian;
+        using NE = AudioData::NativeEndian;
+
+        const auto toInt32 = [source] (auto* sourceFormat)
+        {
+            using SourceFormat = std::remove_pointer_t<decltype (sourceFormat)>;
+
+            int32 result = 0;
+            AudioData::Pointer<AudioData::Int32, NE, AudioData::NonInterleaved, AudioData::NonConst> dest (&result);
+            dest.convertSamples (AudioData::Pointer<SourceFormat, LE, AudioData::NonInterleaved, AudioData::Const> (source), 1);
+            return (Dest) result * (Dest) (1.0 / 2147483648.0);
+        };
+
+        switch (format)
+        {
+            case PCMDecoder::Format::unsigned8:    return toInt32 ((AudioData::UInt8*) nullptr);
+            case PCMDecoder::Format::signed16:     return toInt32 ((AudioData::Int16*) nullptr);
+            case PCMDecoder::Format::signed24:     return toInt32 ((AudioData::Int24*) nullptr);
+            case PCMDecoder::Format::signed32:     return toInt32 ((AudioData::Int32*) nullptr);
+            case PCMDecoder::Format::float32:      return (Dest) copyBits<float>  (ByteOrder::littleEndianInt   (source));
+            case PCMDecoder::Format::float64:      return (Dest) copyBits<double> (ByteOrder::littleEndianInt64 (source));
+        }
+
+        return {};
+    }
+
+    template <typename Dest>
+    static bool decodesLikeReference (PCMDecoder::Format format, int numSamples, int offset)
+    {
+        const auto source = makeSource (format, numSamples, offset);
+        const auto* data = static_cast<const uint8*> (source.getData()) + offset;
+        const auto bytesPerSample = PCMDecoder::getBytesPerSample (format);
+
+        std::vector<Dest> decoded ((size_t) numSamples + 1, (Dest) 9);
+        PCMDecoder::decode (format, data, decoded.data(), numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            if (! exactlyEqual (decoded[(size_t) i], decodeReference<Dest> (format, data + i * bytesPerSample)))
+                return false;
+
+        // Nothing past the end should have been written
+        return exactlyEqual (decoded.back(), (Dest) 9);
+    }
+
+    template <typename Dest>
+    static bool deinterleavesLikeReference (PCMDecoder::Format format, int numChannels, int numFrames)
+    {
+        constexpr int destOffset = 3;
+
+        const auto source = makeSource (format, numFrames * numChannels, 0);
+        const auto* data = static_cast<const uint8*> (source.getData());
+        const auto bytesPerSample = PCMDecoder::getBytesPerSample (format);
+
+        // An extra destination channel, which should be cleared, and a null one
+        // in the middle when there's room for it
+        const auto numDestChannels = numChannels + 1;
+        const auto skippedChannel = numChannels > 2 ? 1 : -1;
+
+        std::vector<std::vector<Dest>> decoded ((size_t) numDestChannels, std::vector<Dest> ((size_t) (destOffset + numFrames), (Dest) 9));
+        std::vector<Dest*> destChannels;
+
+        for (int ch = 0; ch < numDestChannels; ++ch)
+            destChannels.push_back (ch == skippedChannel ? nullptr : decoded[(size_t) ch].data());
+
+        PCMDecoder::decodeInterleaved (format, data, numChannels, destChannels.data(), destOffset, numDestChannels, numFrames);
+
+        for (int ch = 0; ch < numDestChannels; ++ch)
+        {
+            // Nothing before the offset should have been written
+            for (int i = 0; i < destOffset; ++i)
+                if (! exactlyEqual (decoded[(size_t) ch][(size_t) i], (Dest) 9))
+                    return false;
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                const auto expected = ch == skippedChannel ? (Dest) 9
+                                    : ch == numChannels    ? (Dest) 0
+                                                           : decodeReference<Dest> (format, data + (i * numChannels + ch) * bytesPerSample);
+
+                if (! exactlyEqual (decoded[(size_t) ch][(size_t) (destOffset + i)], expected))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+static PCMDecoderTests pcmDecoderTests;
+
+} // namespace juce
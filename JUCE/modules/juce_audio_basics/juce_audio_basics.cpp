@@ -70,10 +70,12 @@
 #include "buffers/juce_FloatVectorOperations.cpp"
 #include "buffers/juce_AudioChannelSet.cpp"
 #include "buffers/juce_AudioProcessLoadMeasurer.cpp"
+#include "buffers/juce_PCMDecoder.cpp"
 #include "utilities/juce_IIRFilter.cpp"
 #include "utilities/juce_LagrangeInterpolator.cpp"
 #include "utilities/juce_WindowedSincInterpolator.cpp"
 #include "utilities/juce_Interpolators.cpp"
+#include "utilities/juce_PolyphaseResampler.cpp"
 #include "utilities/juce_SmoothedValue.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
@@ -111,6 +113,8 @@
 #include "utilities/juce_AudioWorkgroup.cpp"
 
 #if JUCE_UNIT_TESTS
+ #include "buffers/juce_PCMDecoder_test.cpp"
  #include "utilities/juce_ADSR_test.cpp"
+ #include "utilities/juce_PolyphaseResampler_test.cpp"
  #include "midi/ump/juce_UMP_test.cpp"
 #endif
@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace PolyphaseResamplerHelpers
+{
+    // The zeroth order modified Bessel function of the first kind, for the Kaiser window
+    static double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        const auto halfX = 0.5 * x;
+
+        for (int k = 1; k < 64 && term > sum * 1.0e-17; ++k)
+        {
+            const auto factor = halfX / k;
+            term *= factor * factor;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static double getKaiserBeta (double attenuationDb) noexcept
+    {
+        if (attenuationDb > 50.0)
+            return 0.1102 * (attenuationDb - 8.7);
+
+        if (attenuationDb > 21.0)
+            return 0.5842 * std::pow (attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+
+        return 0.0;
+    }
+
+    // The number of taps is always a multiple of 8, so these can work in pairs
+    // of SIMD registers with no remainder.
+    static constexpr int tapMultiple = 8;
+
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    using Ops = FloatVectorHelpers::BasicOps32;
+
+    static forcedinline float addLanes (Ops::ParallelType v) noexcept
+    {
+        float lanes[Ops::numParallel];
+        Ops::storeU (lanes, v);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+
+    static forcedinline float dotProduct (const float* taps, const float* input, int numTaps) noexcept
+    {
+        auto sum0 = Ops::load1 (0.0f), sum1 = sum0;
+
+        for (int i = 0; i < numTaps; i += tapMultiple)
+        {
+            sum0 = Ops::add (sum0, Ops::mul (Ops::loadU (taps + i),     Ops::loadU (input + i)));
+            sum1 = Ops::add (sum1, Ops::mul (Ops::loadU (taps + i + 4), Ops::loadU (input + i + 4)));
+        }
+
+        return addLanes (Ops::add (sum0, sum1));
+    }
+
+    // Works out the input's product with two adjacent phases at once, so that the
+    // input is only loaded once, and interpolates between them.
+    static forcedinline float interpolatedDotProduct (const float* taps, const float* nextTaps, float proportion,
+                                                      const float* input, int numTaps) noexcept
+    {
+        auto sum = Ops::load1 (0.0f), nextSum = sum;
+
+        for (int i = 0; i < numTaps; i += Ops::numParallel)
+        {
+            const auto in = Ops::loadU (input + i);
+            sum     = Ops::add (sum,     Ops::mul (Ops::loadU (taps + i),     in));
+            nextSum = Ops::add (nextSum, Ops::mul (Ops::loadU (nextTaps + i), in));
+        }
+
+        const auto first = addLanes (sum);
+        return first + proportion * (addLanes (nextSum) - first);
+    }
+   #else
+    static forcedinline float dotProduct (const float* taps, const float* input, int numTaps) noexcept
+    {
+        float sum0 = 0.0f, sum1 = 0.0f;
+
+        for (int i = 0; i < numTaps; i += 2)
+        {
+            sum0 += taps[i]     * input[i];
+            sum1 += taps[i + 1] * input[i + 1];
+        }
+
+        return sum0 + sum1;
+    }
+
+    static forcedinline float interpolatedDotProduct (const float* taps, const float* nextTaps, float proportion,
+                                                      const float* input, int numTaps) noexcept
+    {
+        float sum = 0.0f, nextSum = 0.0f;
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            sum     += taps[i]     * input[i];
+            nextSum += nextTaps[i] * input[i];
+        }
+
+        return sum + proportion * (nextSum - sum);
+    }
+   #endif
+}
+
+//==============================================================================
+void PolyphaseResampler::prepare (double inputSampleRate,
+                                  double outputSampleRate,
+                                  int numChannelsToUse,
+                                  int maximumInputBlockSize,
+                                  Quality quality)
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    jassert (inputSampleRate > 0.0 && outputSampleRate > 0.0);
+    jassert (numChannelsToUse > 0 && maximumInputBlockSize > 0);
+    jassert (quality.passband > 0.0 && quality.passband < 1.0);
+
+    inputRate = inputSampleRate;
+    outputRate = outputSampleRate;
+    numChannels = numChannelsToUse;
+    maxInputBlockSize = maximumInputBlockSize;
+
+    // Each output sample moves on by inputRate / outputRate input samples. If that's
+    // a fraction M / L with a small enough L, there are exactly L phases.
+    const auto roundedInputRate = roundToInt (inputRate);
+    const auto roundedOutputRate = roundToInt (outputRate);
+
+    numPhases = maxNumPhases;
+    interpolatesPhases = true;
+
+    if (approximatelyEqual (inputRate, (double) roundedInputRate)
+         && approximatelyEqual (outputRate, (double) roundedOutputRate))
+    {
+        const auto divisor = std::gcd (roundedInputRate, roundedOutputRate);
+
+        if (roundedOutputRate / divisor <= maxNumPhases)
+        {
+            numPhases = roundedOutputRate / divisor;
+            interpolatesPhases = false;
+        }
+    }
+
+    oneSample = (uint64) numPhases << 32;
+
+    const auto step = interpolatesPhases ? (uint64) std::llround (inputRate / outputRate * (double) oneSample)
+                                         : (uint64) (roundedInputRate / std::gcd (roundedInputRate, roundedOutputRate)) << 32;
+
+    wholeStep = (int) (step / oneSample);
+    phaseStep = step % oneSample;
+
+    // A Kaiser windowed sinc, with its transition band between the passband and
+    // the lower of the two Nyquist frequencies, measured in input samples
+    const auto nyquist = 0.5 * jmin (inputRate, outputRate);
+    const auto transitionWidth = (1.0 - quality.passband) * nyquist / inputRate;
+    const auto cutoff = 0.5 * (1.0 + quality.passband) * nyquist / inputRate;
+    const auto attenuation = jmax (21.0, quality.stopbandAttenuationDb);
+    const auto beta = getKaiserBeta (attenuation);
+
+    const auto idealNumTaps = (attenuation - 7.95) / (2.285 * MathConstants<double>::twoPi * transitionWidth);
+    numTaps = jmax (tapMultiple, (int) std::ceil (idealNumTaps / tapMultiple) * tapMultiple);
+
+    // Each phase's tap w multiplies input sample (i - numTaps / 2 + 1 + w), for an
+    // output sample at time i + p / numPhases
+    const auto halfLength = 0.5 * numTaps;
+    const auto windowScale = 1.0 / besselI0 (beta);
+    std::vector<double> taps ((size_t) numTaps);
+
+    filterBank.malloc ((size_t) (numPhases + 1) * (size_t) numTaps);
+
+    for (int p = 0; p <= numPhases; ++p)
+    {
+        double sum = 0.0;
+
+        for (int w = 0; w < numTaps; ++w)
+        {
+            const auto t = (double) p / numPhases + halfLength - 1.0 - w;
+            const auto x = t / halfLength;
+            const auto window = std::abs (x) < 1.0 ? besselI0 (beta * std::sqrt (1.0 - x * x)) * windowScale : 0.0;
+            const auto arg = MathConstants<double>::twoPi * cutoff * t;
+            const auto sinc = approximatelyEqual (t, 0.0) ? 1.0 : std::sin (arg) / arg;
+
+            taps[(size_t) w] = 2.0 * cutoff * sinc * window;
+            sum += taps[(size_t) w];
+        }
+
+        // Keeps the gain at DC exactly the same for every phase
+        auto* row = filterBank + (size_t) p * (size_t) numTaps;
+
+        for (int w = 0; w < numTaps; ++w)
+            row[w] = (float) (taps[(size_t) w] / sum);
+    }
+
+    historyCapacity = numTaps + maxInputBlockSize;
+    history.malloc ((size_t) numChannels * (size_t) historyCapacity);
+
+    reset();
+}
+
+void PolyphaseResampler::prepare (double inputSampleRate,
+                                  double outputSampleRate,
+                                  int numChannelsToUse,
+                                  int maximumInputBlockSize)
+{
+    prepare (inputSampleRate, outputSampleRate, numChannelsToUse, maximumInputBlockSize, Quality{});
+}
+
+void PolyphaseResampler::reset() noexcept
+{
+    // Starting with enough silence that the first output sample is centred on
+    // the first input sample
+    FloatVectorOperations::clear (history.get(), (size_t) numChannels * (size_t) historyCapacity);
+    numInHistory = jmax (0, numTaps / 2 - 1);
+    windowStart = 0;
+    phase = 0;
+}
+
+int PolyphaseResampler::getMaximumOutputSamples (int numInputSamples) const noexcept
+{
+    return (int) std::ceil (numInputSamples * outputRate / inputRate) + 1;
+}
+
+int PolyphaseResampler::process (const float* const* inputs, int numInputSamples, float* const* outputs) noexcept
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    jassert (numTaps > 0);
+    jassert (numInputSamples <= maxInputBlockSize);
+
+    numInputSamples = jmin (numInputSamples, maxInputBlockSize);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        FloatVectorOperations::copy (getHistory (ch) + numInHistory, inputs[ch], numInputSamples);
+
+    numInHistory += numInputSamples;
+
+    int numOutputs = 0;
+
+    while (windowStart + numTaps <= numInHistory)
+    {
+        const auto* taps = filterBank + (size_t) (phase >> 32) * (size_t) numTaps;
+
+        if (interpolatesPhases)
+        {
+            const auto proportion = (float) (phase & 0xffffffff) * (1.0f / 4294967296.0f);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                outputs[ch][numOutputs] = interpolatedDotProduct (taps, taps + numTaps, proportion,
+                                                                  getHistory (ch) + windowStart, numTaps);
+        }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                outputs[ch][numOutputs] = dotProduct (taps, getHistory (ch) + windowStart, numTaps);
+        }
+
+        ++numOutputs;
+
+        windowStart += wholeStep;
+        phase += phaseStep;
+
+        if (phase >= oneSample)
+        {
+            phase -= oneSample;
+            ++windowStart;
+        }
+    }
+
+    // Drops the input that no future output needs. When downsampling by a large
+    // ratio, the next window can start beyond the input so far, in which case
+    // some of the next block's input gets skipped too.
+    const auto numToDrop = jmin (windowStart, numInHistory);
+
+    if (numToDrop > 0)
+    {
+        numInHistory -= numToDrop;
+        windowStart -= numToDrop;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* channel = getHistory (ch);
+            std::memmove (channel, channel + numToDrop, (size_t) numInHistory * sizeof (float));
+        }
+    }
+
+    return numOutputs;
+}
+
+} // namespace juce
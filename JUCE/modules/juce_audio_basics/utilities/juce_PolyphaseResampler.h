@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Converts a stream of multichannel audio from one sample rate to another, using
+    a bank of precomputed windowed sinc filters.
+
+    The Interpolators work out each output sample's filter as they go, one channel
+    at a time, which makes them suitable for ratios that change all the time.
+    When the ratio is fixed, as it is when converting files, this is both faster
+    and much cleaner. Each of the positions between two input samples that an
+    output sample can fall on (its phase) has its own filter, worked out in
+    prepare(). Every channel is resampled in the same pass, and each output
+    sample is a SIMD inner product of the input with its phase's filter.
+
+    If the ratio can be written as a fraction whose numerator is no more than
+    maxNumPhases, as it can for all of the usual sample rates (44.1 kHz to 48 kHz
+    is 160/147), there's an exact filter for every phase. Otherwise, the output is
+    interpolated between the filters of the two nearest of maxNumPhases phases.
+
+    The output is aligned with the input, so output sample n is the input at time
+    n * inputSampleRate / outputSampleRate, with no delay. To manage that, the
+    filter needs getLookahead() input samples past the time of each output
+    sample, so the output lags behind the input by about that much. At the end of
+    a stream, it needs to be fed that much silence to produce the last of the
+    output.
+
+    @code
+    PolyphaseResampler resampler;
+    resampler.prepare (44100.0, 48000.0, numChannels, blockSize);
+
+    HeapBlock<float> ... // room for resampler.getMaximumOutputSamples (blockSize) per channel
+
+    const auto numOutputSamples = resampler.process (inputChannels, blockSize, outputChannels);
+    @endcode
+
+    @see Interpolators, ResamplingAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  PolyphaseResampler
+{
+public:
+    //==============================================================================
+    /** Describes the anti-aliasing filter. */
+    struct Quality
+    {
+        /** The frequency up to which the input is passed through unchanged, as a
+            proportion of the lower of the two Nyquist frequencies. The filter's
+            transition band lies between here and that Nyquist frequency.
+        */
+        double passband = 0.9;
+
+        /** How far frequencies beyond the lower Nyquist frequency are attenuated,
+            which sets the level of the aliasing and imaging, in decibels.
+        */
+        double stopbandAttenuationDb = 120.0;
+    };
+
+    /** The number of phases used when the ratio between the rates isn't a
+        simple enough fraction for every phase to have its own filter.
+    */
+    static constexpr int maxNumPhases = 1024;
+
+    //==============================================================================
+    /** Creates a resampler, which must be prepared before it's used. */
+    PolyphaseResampler() = default;
+
+    /** Designs the filters, and allocates room for each channel's history, for
+        process() calls of up to the given number of input samples.
+
+        This allocates, so must be called off the audio thread. It also resets
+        the resampler.
+    */
+    void prepare (double inputSampleRate,
+                  double outputSampleRate,
+                  int numChannels,
+                  int maximumInputBlockSize,
+                  Quality quality);
+
+    /** Prepares the resampler with the default Quality. */
+    void prepare (double inputSampleRate,
+                  double outputSampleRate,
+                  int numChannels,
+                  int maximumInputBlockSize);
+
+    /** Forgets the input so far, ready for a new stream. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Returns the most output samples that a call to process() with the given
+        number of input samples could produce.
+    */
+    int getMaximumOutputSamples (int numInputSamples) const noexcept;
+
+    /** Returns the number of input samples after an output sample's time that
+        are needed before it can be produced.
+    */
+    int getLookahead() const noexcept                   { return numTaps / 2; }
+
+    /** Returns the length of each phase's filter, in input samples. */
+    int getNumTaps() const noexcept                     { return numTaps; }
+
+    /** Returns true if the ratio between the rates has a filter for every phase,
+        rather than interpolating between them.
+    */
+    bool hasExactPhases() const noexcept                { return ! interpolatesPhases; }
+
+    //==============================================================================
+    /** Adds a block of input to the stream, and writes as much of the output as
+        can now be produced.
+
+        @param inputs               one pointer per channel to numInputSamples samples,
+                                    which must be no more than the maximumInputBlockSize
+                                    passed to prepare()
+        @param numInputSamples      the number of samples in each input channel
+        @param outputs              one pointer per channel, each with room for at least
+                                    getMaximumOutputSamples (numInputSamples) samples
+        @returns                    the number of samples written to each output channel
+    */
+    int process (const float* const* inputs, int numInputSamples, float* const* outputs) noexcept;
+
+private:
+    //==============================================================================
+    float* getHistory (int channel) const noexcept      { return history.get() + (size_t) channel * (size_t) historyCapacity; }
+
+    double inputRate = 0.0, outputRate = 0.0;
+    int numChannels = 0, numTaps = 0, numPhases = 0, maxInputBlockSize = 0;
+    bool interpolatesPhases = false;
+
+    // Each phase's taps, for numPhases + 1 phases so that interpolation can
+    // always use the next one. The taps are stored in the same order as the
+    // input samples that they multiply.
+    HeapBlock<float> filterBank;
+
+    // Each channel keeps the input that's still needed. The next output sample's
+    // window starts at windowStart, and its phase is in 32.32 fixed point.
+    HeapBlock<float> history;
+    int historyCapacity = 0, numInHistory = 0, windowStart = 0;
+    uint64 phase = 0, phaseStep = 0, oneSample = 0;
+    int wholeStep = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
+
+} // namespace juce
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct PolyphaseResamplerTests final : public UnitTest
+{
+    PolyphaseResamplerTests()  : UnitTest ("PolyphaseResampler", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        constexpr int maxBlockSize = 512;
+
+        beginTest ("Sine waves are resampled accurately");
+        {
+            const auto frequencies = { 1000.0, 5000.0 };
+            const auto input = makeSines (frequencies, 44100.0, 8820);
+
+            PolyphaseResampler resampler;
+            resampler.prepare (44100.0, 48000.0, input.getNumChannels(), maxBlockSize);
+            expect (resampler.hasExactPhases());
+
+            const auto output = resample (resampler, input, 44100.0, 48000.0, nullptr);
+            expectEquals (output.getNumSamples(), 9600);
+
+            const auto expected = makeSines (frequencies, 48000.0, output.getNumSamples());
+            expectLessThan (getMaximumDifference (output, expected, resampler.getNumTaps()), 1.0e-4f);
+        }
+
+        beginTest ("Downsampling rejects frequencies above the output's Nyquist frequency");
+        {
+            const auto input = makeSines ({ 23000.0 }, 48000.0, 9600);
+
+            PolyphaseResampler resampler;
+            resampler.prepare (48000.0, 44100.0, 1, maxBlockSize);
+
+            const auto output = resample (resampler, input, 48000.0, 44100.0, nullptr);
+            const auto margin = resampler.getNumTaps();
+
+            expectLessThan (output.getRMSLevel (0, margin, output.getNumSamples() - 2 * margin), 1.0e-5f);
+        }
+
+        beginTest ("Arbitrary ratios interpolate between phases");
+        {
+            const auto frequencies = { 1000.0 };
+            const auto input = makeSines (frequencies, 44100.0, 8820);
+            constexpr auto outputRate = 47999.37;
+
+            PolyphaseResampler resampler;
+            resampler.prepare (44100.0, outputRate, 1, maxBlockSize);
+            expect (! resampler.hasExactPhases());
+
+            const auto output = resample (resampler, input, 44100.0, outputRate, nullptr);
+            const auto expected = makeSines (frequencies, outputRate, output.getNumSamples());
+            expectLessThan (getMaximumDifference (output, expected, resampler.getNumTaps()), 1.0e-4f);
+        }
+
+        beginTest ("The output doesn't depend on the block sizes");
+        {
+            auto input = makeSines ({ 440.0, 3000.0 }, 44100.0, 20000);
+            auto random = getRandom();
+
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    input.addSample (ch, i, random.nextFloat() * 0.1f - 0.05f);
+
+            for (const auto outputRate : { 48000.0, 32000.0, 47999.37 })
+            {
+                PolyphaseResampler resampler;
+                resampler.prepare (44100.0, outputRate, input.getNumChannels(), maxBlockSize);
+
+                const auto fixedBlocks = resample (resampler, input, 44100.0, outputRate, nullptr);
+
+                resampler.reset();
+                const auto varyingBlocks = resample (resampler, input, 44100.0, outputRate, &random);
+
+                expect (getMaximumDifference (fixedBlocks, varyingBlocks, 0) <= 0.0f);
+            }
+        }
+
+        beginTest ("Channels are resampled independently");
+        {
+            const auto stereo = makeSines ({ 1000.0, 7000.0 }, 44100.0, 4410);
+
+            PolyphaseResampler stereoResampler;
+            stereoResampler.prepare (44100.0, 48000.0, 2, maxBlockSize);
+            const auto stereoOutput = resample (stereoResampler, stereo, 44100.0, 48000.0, nullptr);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                AudioBuffer<float> mono (1, stereo.getNumSamples());
+                mono.copyFrom (0, 0, stereo, ch, 0, stereo.getNumSamples());
+
+                PolyphaseResampler monoResampler;
+                monoResampler.prepare (44100.0, 48000.0, 1, maxBlockSize);
+                const auto monoOutput = resample (monoResampler, mono, 44100.0, 48000.0, nullptr);
+
+                AudioBuffer<float> channel (1, stereoOutput.getNumSamples());
+                channel.copyFrom (0, 0, stereoOutput, ch, 0, stereoOutput.getNumSamples());
+
+                expect (getMaximumDifference (channel, monoOutput, 0) <= 0.0f);
+            }
+        }
+    }
+
+    static AudioBuffer<float> makeSines (std::initializer_list<double> frequencies, double sampleRate, int numSamples)
+    {
+        AudioBuffer<float> buffer ((int) frequencies.size(), numSamples);
+        int ch = 0;
+
+        for (const auto frequency : frequencies)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, (float) (0.5 * std::sin (MathConstants<double>::twoPi * frequency * i / sampleRate)));
+
+            ++ch;
+        }
+
+        return buffer;
+    }
+
+    /** Resamples the whole of the input, followed by enough silence to flush the
+        resampler, in blocks of random sizes if a Random is given.
+    */
+    static AudioBuffer<float> resample (PolyphaseResampler& resampler,
+                                        const AudioBuffer<float>& input,
+                                        double inputRate,
+                                        double outputRate,
+                                        Random* random)
+    {
+        constexpr int maxBlockSize = 512;
+
+        const auto numChannels = input.getNumChannels();
+        const auto numOutputSamples = (int) std::ceil (input.getNumSamples() * outputRate / inputRate);
+
+        AudioBuffer<float> output (numChannels, numOutputSamples);
+        AudioBuffer<float> inputBlock (numChannels, maxBlockSize);
+        AudioBuffer<float> outputBlock (numChannels, resampler.getMaximumOutputSamples (maxBlockSize));
+
+        int inputPosition = 0, outputPosition = 0;
+
+        while (outputPosition < numOutputSamples)
+        {
+            const auto blockSize = random != nullptr ? random->nextInt ({ 1, maxBlockSize + 1 }) : maxBlockSize;
+            const auto numFromInput = jlimit (0, blockSize, input.getNumSamples() - inputPosition);
+
+            inputBlock.clear();
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                inputBlock.copyFrom (ch, 0, input, ch, inputPosition, numFromInput);
+
+            inputPosition += numFromInput;
+
+            const auto numProduced = resampler.process (inputBlock.getArrayOfReadPointers(), blockSize,
+                                                        outputBlock.getArrayOfWritePointers());
+            const auto numToKeep = jmin (numProduced, numOutputSamples - outputPosition);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                output.copyFrom (ch, outputPosition, outputBlock, ch, 0, numToKeep);
+
+            outputPosition += numToKeep;
+        }
+
+        return output;
+    }
+
+    /** Compares two buffers, leaving out the given number of samples at each end. */
+    static float getMaximumDifference (const AudioBuffer<float>& a, const AudioBuffer<float>& b, int margin)
+    {
+        jassert (a.getNumChannels() == b.getNumChannels() && a.getNumSamples() == b.getNumSamples());
+
+        float difference = 0.0f;
+
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = margin; i < a.getNumSamples() - margin; ++i)
+                difference = jmax (difference, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+
+        return difference;
+    }
+};
+
+static PolyphaseResamplerTests polyphaseResamplerTests;
+
+} // namespace juce
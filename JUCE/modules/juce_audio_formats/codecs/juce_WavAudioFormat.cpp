@@ -1521,6 +1521,63 @@ public:
         return true;
     }
 
+    // Decodes straight from the file's data to floats or doubles, rather than going
+    // through ints as readSamples() does.
+    template <typename SampleType>
+    bool readDecodedSamples (SampleType* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples)
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (numSamples <= 0)
+            return true;
+
+        const auto format = *getPCMFormat (bitsPerSample, usesFloatingPointData);
+        input->setPosition (dataChunkStart + startSampleInFile * bytesPerFrame);
+
+        while (numSamples > 0)
+        {
+            const int tempBufSize = 480 * 3 * 4; // (keep this a multiple of 3)
+            char tempBuffer[tempBufSize];
+
+            auto numThisTime = jmin (tempBufSize / bytesPerFrame, numSamples);
+            auto bytesRead = input->read (tempBuffer, numThisTime * bytesPerFrame);
+
+            if (bytesRead < numThisTime * bytesPerFrame)
+            {
+                jassert (bytesRead >= 0);
+                zeromem (tempBuffer + bytesRead, (size_t) (numThisTime * bytesPerFrame - bytesRead));
+            }
+
+            PCMDecoder::decodeInterleaved (format, tempBuffer, (int) numChannels,
+                                           destSamples, startOffsetInDestBuffer, numDestChannels, numThisTime);
+
+            startOffsetInDestBuffer += numThisTime;
+            numSamples -= numThisTime;
+        }
+
+        return true;
+    }
+
+    bool readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                           int64 startSampleInFile, int numSamples) override
+    {
+        if (getPCMFormat (bitsPerSample, usesFloatingPointData).has_value())
+            return readDecodedSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+        return AudioFormatReader::readFloatSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readDoubleSamples (double* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples) override
+    {
+        if (getPCMFormat (bitsPerSample, usesFloatingPointData).has_value())
+            return readDecodedSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+        return AudioFormatReader::readDoubleSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
     static void copySampleData (unsigned int numBitsPerSample, const bool floatingPointData,
                                 int* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
                                 const void* sourceData, int numberOfChannels, int numSamples) noexcept
@@ -1533,10 +1590,30 @@ public:
             case 32:    if (floatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples);
                         else                   ReadHelper<AudioData::Int32,   AudioData::Int32,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples);
                         break;
+            case 64:    if (floatingPointData) PCMDecoder::decodeInterleaved (PCMDecoder::Format::float64, sourceData, numberOfChannels, reinterpret_cast<float* const*> (destSamples),
+                                                                              startOffsetInDestBuffer, numDestChannels, numSamples);
+                        else                   jassertfalse;
+                        break;
             default:    jassertfalse; break;
         }
     }
 
+    /** Returns the PCMDecoder format for the samples in a WAV file, if it has one. */
+    static std::optional<PCMDecoder::Format> getPCMFormat (unsigned int numBitsPerSample, bool floatingPointData) noexcept
+    {
+        switch (numBitsPerSample)
+        {
+            case 8:     return PCMDecoder::Format::unsigned8;
+            case 16:    return PCMDecoder::Format::signed16;
+            case 24:    return PCMDecoder::Format::signed24;
+            case 32:    return floatingPointData ? PCMDecoder::Format::float32 : PCMDecoder::Format::signed32;
+            case 64:    if (floatingPointData) return PCMDecoder::Format::float64; break;
+            default:    break;
+        }
+
+        return {};
+    }
+
     //==============================================================================
     AudioChannelSet getChannelLayout() override
     {
@@ -1882,6 +1959,24 @@ public:
         return true;
     }
 
+    bool readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                           int64 startSampleInFile, int numSamples) override
+    {
+        if (WavAudioFormatReader::getPCMFormat (bitsPerSample, usesFloatingPointData).has_value())
+            return readDecodedSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+        return AudioFormatReader::readFloatSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
+    bool readDoubleSamples (double* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples) override
+    {
+        if (WavAudioFormatReader::getPCMFormat (bitsPerSample, usesFloatingPointData).has_value())
+            return readDecodedSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+        return AudioFormatReader::readDoubleSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+    }
+
     void getSample (int64 sample, float* result) const noexcept override
     {
         auto num = (int) numChannels;
@@ -1905,6 +2000,9 @@ public:
             case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::read (dest, 0, 1, source, 1, num);
                         else                       ReadHelper<AudioData::Float32, AudioData::Int32,   AudioData::LittleEndian>::read (dest, 0, 1, source, 1, num);
                         break;
+            case 64:    if (usesFloatingPointData) PCMDecoder::decode (PCMDecoder::Format::float64, source, result, num);
+                        else                       jassertfalse;
+                        break;
             default:    jassertfalse; break;
         }
     }
@@ -1931,6 +2029,7 @@ public:
             case 32:    if (usesFloatingPointData) scanMinAndMax<AudioData::Float32> (startSampleInFile, numSamples, results, numChannelsToRead);
                         else                       scanMinAndMax<AudioData::Int32>   (startSampleInFile, numSamples, results, numChannelsToRead);
                         break;
+            case 64:    AudioFormatReader::readMaxLevels (startSampleInFile, numSamples, results, numChannelsToRead); break;
             default:    jassertfalse; break;
         }
     }
@@ -1938,6 +2037,28 @@ public:
     using AudioFormatReader::readMaxLevels;
 
 private:
+    template <typename SampleType>
+    bool readDecodedSamples (SampleType* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                             int64 startSampleInFile, int numSamples)
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (numSamples <= 0)
+            return true;
+
+        if (map == nullptr || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+            return false;
+        }
+
+        PCMDecoder::decodeInterleaved (*WavAudioFormatReader::getPCMFormat (bitsPerSample, usesFloatingPointData),
+                                       sampleToPointer (startSampleInFile), (int) numChannels,
+                                       destSamples, startOffsetInDestBuffer, numDestChannels, numSamples);
+        return true;
+    }
+
     template <typename SampleType>
     void scanMinAndMax (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead) const noexcept
     {
@@ -1994,7 +2115,8 @@ AudioFormatReader* WavAudioFormat::createReaderFor (InputStream* sourceStream, b
     }
    #endif
 
-    if (r->sampleRate > 0 && r->numChannels > 0 && r->bytesPerFrame > 0 && r->bitsPerSample <= 32)
+    if (r->sampleRate > 0 && r->numChannels > 0 && r->bytesPerFrame > 0
+         && (r->bitsPerSample <= 32 || (r->bitsPerSample == 64 && r->usesFloatingPointData)))
         return r.release();
 
     if (! deleteStreamIfOpeningFails)
@@ -2274,6 +2396,168 @@ struct WaveAudioFormatTests final : public UnitTest
                 expect (reader->metadataValues.getValue (WavAudioFormat::aswgVersion, "") == "3.01");
             }
         }
+
+        {
+            beginTest ("Reading floats gives the same samples as reading ints and converting them");
+
+            for (const auto bits : { 8, 16, 24, 32 })
+            {
+                for (const auto numChannels : { 1, 2, 3 })
+                {
+                    const auto block = writeNoise (format, numChannels, bits);
+
+                    expectReadsMatchIntegerPath (rawToUniquePtr (format.createReaderFor (new MemoryInputStream (block, false), true)));
+
+                    TemporaryFile file (".wav");
+                    expect (file.getFile().replaceWithData (block.getData(), block.getSize()));
+
+                    auto mapped = rawToUniquePtr (format.createMemoryMappedReader (file.getFile()));
+                    expect (mapped != nullptr && mapped->mapEntireFile());
+                    expectReadsMatchIntegerPath (std::move (mapped));
+                }
+            }
+
+            // The writer only writes 32-bit floats, so this makes a 32-bit integer file
+            Random random (32);
+            MemoryBlock samples (3 * 1000 * 4);
+
+            for (size_t i = 0; i < samples.getSize(); ++i)
+                samples[i] = (char) random.nextInt (256);
+
+            const auto block = createWavFile (1 /* WAVE_FORMAT_PCM */, 3, 32, samples);
+            expectReadsMatchIntegerPath (rawToUniquePtr (format.createReaderFor (new MemoryInputStream (block, false), true)));
+        }
+
+        {
+            beginTest ("Reading doubles gives the same samples as reading floats, once they're rounded");
+
+            std::vector<MemoryBlock> blocks;
+
+            for (const auto bits : { 8, 16, 24, 32 })
+                blocks.push_back (writeNoise (format, 2, bits));
+
+            Random random (64);
+            MemoryBlock samples (2 * 1000 * 4);
+
+            for (size_t i = 0; i < samples.getSize(); ++i)
+                samples[i] = (char) random.nextInt (256);
+
+            blocks.push_back (createWavFile (1 /* WAVE_FORMAT_PCM */, 2, 32, samples));
+
+            for (const auto& block : blocks)
+            {
+                auto reader = rawToUniquePtr (format.createReaderFor (new MemoryInputStream (block, false), true));
+                expect (reader != nullptr);
+
+                if (reader == nullptr)
+                    continue;
+
+                const auto numChannels = (int) reader->numChannels;
+                const auto numSamples = (int) reader->lengthInSamples;
+
+                AudioBuffer<float> floats (numChannels, numSamples), defaultFloats (numChannels, numSamples);
+                AudioBuffer<double> doubles (numChannels, numSamples);
+
+                expect (reader->read (floats.getArrayOfWritePointers(), numChannels, 0, numSamples));
+                expect (reader->read (doubles.getArrayOfWritePointers(), numChannels, 0, numSamples));
+
+                // The base class's conversion from the integer path, which formats
+                // without their own float decoding use
+                DefaultConversionReader defaultReader (*reader);
+                expect (defaultReader.read (defaultFloats.getArrayOfWritePointers(), numChannels, 0, numSamples));
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        if (! exactlyEqual ((float) doubles.getSample (ch, i), floats.getSample (ch, i))
+                            || ! exactlyEqual (defaultFloats.getSample (ch, i), floats.getSample (ch, i)))
+                        {
+                            expect (false, String (reader->bitsPerSample) + "-bit mismatch at channel " + String (ch) + ", sample " + String (i));
+                            ch = numChannels;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        {
+            beginTest ("Subsections of a file keep the double precision of its samples");
+
+            Random random (65);
+            MemoryBlock samples (2 * 1000 * 4);
+
+            for (size_t i = 0; i < samples.getSize(); ++i)
+                samples[i] = (char) random.nextInt (256);
+
+            const auto block = createWavFile (1 /* WAVE_FORMAT_PCM */, 2, 32, samples);
+            auto* source = format.createReaderFor (new MemoryInputStream (block, false), true);
+            expect (source != nullptr);
+
+            if (source != nullptr)
+            {
+                constexpr int start = 100, length = 500;
+
+                AudioBuffer<double> expected (2, length), doubles (2, length + 50);
+                AudioBuffer<float> floats (2, length + 50);
+                expect (source->read (expected.getArrayOfWritePointers(), 2, start, length));
+
+                // A 32-bit integer has more precision than a float, which the samples
+                // would lose if they went through the base class's conversion
+                AudioSubsectionReader subsection (source, start, length, true);
+                expect (subsection.read (doubles.getArrayOfWritePointers(), 2, 0, doubles.getNumSamples()));
+                expect (subsection.read (floats.getArrayOfWritePointers(), 2, 0, floats.getNumSamples()));
+
+                auto allMatch = true;
+
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    for (int i = 0; i < doubles.getNumSamples(); ++i)
+                    {
+                        const auto sample = i < length ? expected.getSample (ch, i) : 0.0;
+                        allMatch = allMatch && exactlyEqual (doubles.getSample (ch, i), sample)
+                                            && exactlyEqual (floats.getSample (ch, i), (float) sample);
+                    }
+                }
+
+                expect (allMatch);
+            }
+        }
+
+        {
+            beginTest ("Files with 64-bit float samples can be read");
+
+            constexpr int numChannels = 2, numSamples = 100;
+            MemoryOutputStream samples;
+
+            for (int i = 0; i < numSamples * numChannels; ++i)
+                samples.writeDouble (std::sin (i * 0.1) * (1.0 + 1.0e-12));
+
+            const auto block = createWavFile (3 /* WAVE_FORMAT_IEEE_FLOAT */, numChannels, 64, samples.getMemoryBlock());
+            auto reader = rawToUniquePtr (format.createReaderFor (new MemoryInputStream (block, false), true));
+            expect (reader != nullptr);
+
+            if (reader != nullptr)
+            {
+                expectEquals ((int) reader->bitsPerSample, 64);
+
+                AudioBuffer<double> doubles (numChannels, numSamples);
+                AudioBuffer<float> floats (numChannels, numSamples);
+                expect (reader->read (doubles.getArrayOfWritePointers(), numChannels, 0, numSamples));
+                expect (reader->read (floats.getArrayOfWritePointers(), numChannels, 0, numSamples));
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const auto expected = std::sin ((i * numChannels + ch) * 0.1) * (1.0 + 1.0e-12);
+                        expect (exactlyEqual (doubles.getSample (ch, i), expected));
+                        expect (exactlyEqual (floats.getSample (ch, i), (float) expected));
+                    }
+                }
+            }
+        }
     }
 
 private:
@@ -2298,6 +2582,118 @@ private:
         return mb;
     }
 
+    /** Reads through another reader's readSamples(), leaving the conversion to
+        floats and doubles to AudioFormatReader's default implementations.
+    */
+    struct DefaultConversionReader final : public AudioFormatReader
+    {
+        explicit DefaultConversionReader (AudioFormatReader& s)
+            : AudioFormatReader (nullptr, s.getFormatName()), source (s)
+        {
+            sampleRate = source.sampleRate;
+            bitsPerSample = source.bitsPerSample;
+            lengthInSamples = source.lengthInSamples;
+            numChannels = source.numChannels;
+            usesFloatingPointData = source.usesFloatingPointData;
+        }
+
+        bool readSamples (int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            return source.readSamples (destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+        }
+
+        AudioFormatReader& source;
+    };
+
+    static MemoryBlock writeNoise (WavAudioFormat& format, int numChannels, int bitsPerSample)
+    {
+        constexpr int numSamples = 1000;
+
+        AudioBuffer<float> buffer (numChannels, numSamples);
+        Random random (bitsPerSample);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        MemoryBlock mb;
+
+        {
+            auto writer = rawToUniquePtr (format.createWriterFor (new MemoryOutputStream (mb, false), 48000.0,
+                                                                  (unsigned int) numChannels, bitsPerSample, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+        }
+
+        return mb;
+    }
+
+    static MemoryBlock createWavFile (int formatTag, int numChannels, int bitsPerSample, const MemoryBlock& samples)
+    {
+        const auto bytesPerFrame = numChannels * bitsPerSample / 8;
+        MemoryOutputStream out;
+
+        out.write ("RIFF", 4);
+        out.writeInt (36 + (int) samples.getSize());
+        out.write ("WAVEfmt ", 8);
+        out.writeInt (16);
+        out.writeShort ((short) formatTag);
+        out.writeShort ((short) numChannels);
+        out.writeInt (48000);
+        out.writeInt (48000 * bytesPerFrame);
+        out.writeShort ((short) bytesPerFrame);
+        out.writeShort ((short) bitsPerSample);
+        out.write ("data", 4);
+        out.writeInt ((int) samples.getSize());
+        out << samples;
+
+        return out.getMemoryBlock();
+    }
+
+    /** Reads a section that runs past both ends of the file, into more channels than
+        it has, through the float and double paths, and compares them with what the
+        integer path gives.
+    */
+    void expectReadsMatchIntegerPath (std::unique_ptr<AudioFormatReader> reader)
+    {
+        expect (reader != nullptr);
+
+        if (reader == nullptr)
+            return;
+
+        const auto numChannels = (int) reader->numChannels + 1;
+        const auto numSamples = (int) reader->lengthInSamples + 200;
+        const auto start = (int64) -100;
+
+        AudioBuffer<float> ints (numChannels, numSamples), floats (numChannels, numSamples);
+        AudioBuffer<double> doubles (numChannels, numSamples);
+
+        expect (reader->read (reinterpret_cast<int* const*> (ints.getArrayOfWritePointers()), numChannels, start, numSamples, false));
+        expect (reader->read (floats.getArrayOfWritePointers(), numChannels, start, numSamples));
+        expect (reader->read (doubles.getArrayOfWritePointers(), numChannels, start, numSamples));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto integer = reinterpret_cast<const int*> (ints.getReadPointer (ch))[i];
+
+                const auto expectedFloat = reader->usesFloatingPointData ? ints.getSample (ch, i)
+                                                                         : (float) integer / 2147483648.0f;
+
+                // Only 32-bit integers have more precision than a float
+                const auto expectedDouble = reader->usesFloatingPointData ? (double) expectedFloat
+                                                                          : (double) integer / 2147483648.0;
+
+                if (! exactlyEqual (floats.getSample (ch, i), expectedFloat) || ! exactlyEqual (doubles.getSample (ch, i), expectedDouble))
+                {
+                    expect (false, "Mismatch at channel " + String (ch) + ", sample " + String (i));
+                    return;
+                }
+            }
+        }
+    }
+
     StringPairArray getMetadataAfterReading (WavAudioFormat& format, const MemoryBlock& mb)
     {
         auto reader = rawToUniquePtr (format.createReaderFor (new MemoryInputStream (mb, false), true));
@@ -45,34 +45,32 @@ AudioFormatReader::~AudioFormatReader()
     delete input;
 }
 
-static void convertFixedToFloat (int* const* channels, int numChannels, int numSamples)
+//==============================================================================
+static bool readSamplesOfType (AudioFormatReader& reader, int* const* destChannels, int numDestChannels,
+                               int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
 {
-    constexpr auto scaleFactor = 1.0f / static_cast<float> (0x7fffffff);
-
-    for (int i = 0; i < numChannels; ++i)
-        if (auto d = channels[i])
-            FloatVectorOperations::convertFixedToFloat (reinterpret_cast<float*> (d), d, scaleFactor, numSamples);
+    return reader.readSamples (destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
 }
 
-bool AudioFormatReader::read (float* const* destChannels, int numDestChannels,
-                              int64 startSampleInSource, int numSamplesToRead)
+static bool readSamplesOfType (AudioFormatReader& reader, float* const* destChannels, int numDestChannels,
+                               int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
 {
-    auto channelsAsInt = reinterpret_cast<int* const*> (destChannels);
-
-    if (! read (channelsAsInt, numDestChannels, startSampleInSource, numSamplesToRead, false))
-        return false;
-
-    if (! usesFloatingPointData)
-        convertFixedToFloat (channelsAsInt, numDestChannels, numSamplesToRead);
+    return reader.readFloatSamples (destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+}
 
-    return true;
+static bool readSamplesOfType (AudioFormatReader& reader, double* const* destChannels, int numDestChannels,
+                               int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
+{
+    return reader.readDoubleSamples (destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
 }
 
-bool AudioFormatReader::read (int* const* destChannels,
-                              int numDestChannels,
-                              int64 startSampleInSource,
-                              int numSamplesToRead,
-                              bool fillLeftoverChannelsWithCopies)
+template <typename SampleType>
+static bool readChannels (AudioFormatReader& reader,
+                          SampleType* const* destChannels,
+                          int numDestChannels,
+                          int64 startSampleInSource,
+                          int numSamplesToRead,
+                          bool fillLeftoverChannelsWithCopies)
 {
     jassert (numDestChannels > 0); // you have to actually give this some channels to work with!
 
@@ -85,7 +83,7 @@ bool AudioFormatReader::read (int* const* destChannels,
 
         for (int i = numDestChannels; --i >= 0;)
             if (auto d = destChannels[i])
-                zeromem (d, (size_t) silence * sizeof (int));
+                zeromem (d, (size_t) silence * sizeof (SampleType));
 
         startOffsetInDestBuffer += silence;
         numSamplesToRead -= silence;
@@ -95,18 +93,20 @@ bool AudioFormatReader::read (int* const* destChannels,
     if (numSamplesToRead <= 0)
         return true;
 
-    if (! readSamples (destChannels,
-                       jmin ((int) numChannels, numDestChannels), startOffsetInDestBuffer,
-                       startSampleInSource, numSamplesToRead))
+    const auto numChannels = (int) reader.numChannels;
+
+    if (! readSamplesOfType (reader, destChannels,
+                             jmin (numChannels, numDestChannels), startOffsetInDestBuffer,
+                             startSampleInSource, numSamplesToRead))
         return false;
 
-    if (numDestChannels > (int) numChannels)
+    if (numDestChannels > numChannels)
     {
         if (fillLeftoverChannelsWithCopies)
         {
             auto lastFullChannel = destChannels[0];
 
-            for (int i = (int) numChannels; --i > 0;)
+            for (int i = numChannels; --i > 0;)
             {
                 if (destChannels[i] != nullptr)
                 {
@@ -116,36 +116,117 @@ bool AudioFormatReader::read (int* const* destChannels,
             }
 
             if (lastFullChannel != nullptr)
-                for (int i = (int) numChannels; i < numDestChannels; ++i)
+                for (int i = numChannels; i < numDestChannels; ++i)
                     if (auto d = destChannels[i])
-                        memcpy (d, lastFullChannel, sizeof (int) * originalNumSamplesToRead);
+                        memcpy (d, lastFullChannel, sizeof (SampleType) * originalNumSamplesToRead);
         }
         else
         {
-            for (int i = (int) numChannels; i < numDestChannels; ++i)
+            for (int i = numChannels; i < numDestChannels; ++i)
                 if (auto d = destChannels[i])
-                    zeromem (d, sizeof (int) * originalNumSamplesToRead);
+                    zeromem (d, sizeof (SampleType) * originalNumSamplesToRead);
         }
     }
 
     return true;
 }
 
-static bool readChannels (AudioFormatReader& reader, int** chans, AudioBuffer<float>* buffer,
-                          int startSample, int numSamples, int64 readerStartSample, int numTargetChannels,
-                          bool convertToFloat)
+bool AudioFormatReader::read (float* const* destChannels, int numDestChannels,
+                              int64 startSampleInSource, int numSamplesToRead)
 {
-    for (int j = 0; j < numTargetChannels; ++j)
-        chans[j] = reinterpret_cast<int*> (buffer->getWritePointer (j, startSample));
+    return readChannels (*this, destChannels, numDestChannels, startSampleInSource, numSamplesToRead, false);
+}
 
-    chans[numTargetChannels] = nullptr;
+bool AudioFormatReader::read (double* const* destChannels, int numDestChannels,
+                              int64 startSampleInSource, int numSamplesToRead)
+{
+    return readChannels (*this, destChannels, numDestChannels, startSampleInSource, numSamplesToRead, false);
+}
+
+bool AudioFormatReader::read (int* const* destChannels,
+                              int numDestChannels,
+                              int64 startSampleInSource,
+                              int numSamplesToRead,
+                              bool fillLeftoverChannelsWithCopies)
+{
+    return readChannels (*this, destChannels, numDestChannels, startSampleInSource, numSamplesToRead, fillLeftoverChannelsWithCopies);
+}
+
+bool AudioFormatReader::readFloatSamples (float* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                          int64 startSampleInFile, int numSamples)
+{
+    auto channelsAsInt = reinterpret_cast<int* const*> (destChannels);
+
+    if (! readSamples (channelsAsInt, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples))
+        return false;
+
+    if (! usesFloatingPointData)
+    {
+        // The same 2^-31 that PCMDecoder uses, so that a format's float and double
+        // paths agree. 1 / 0x7fffffff rounds to this in float anyway.
+        constexpr auto scaleFactor = 1.0f / 2147483648.0f;
+
+        for (int i = 0; i < numDestChannels; ++i)
+            if (auto d = destChannels[i])
+                FloatVectorOperations::convertFixedToFloat (d + startOffsetInDestBuffer, channelsAsInt[i] + startOffsetInDestBuffer,
+                                                            scaleFactor, numSamples);
+    }
+
+    return true;
+}
+
+bool AudioFormatReader::readDoubleSamples (double* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                           int64 startSampleInFile, int numSamples)
+{
+    const auto readAndWiden = [&] (float** floatChannels)
+    {
+        for (int i = 0; i < numDestChannels; ++i)
+            floatChannels[i] = destChannels[i] != nullptr ? reinterpret_cast<float*> (destChannels[i] + startOffsetInDestBuffer) : nullptr;
+
+        if (! readFloatSamples (floatChannels, numDestChannels, 0, startSampleInFile, numSamples))
+            return false;
+
+        // Double j takes the place of floats 2j and 2j + 1, neither of which comes
+        // before float j. Working backwards, every float after j has already been
+        // widened, and float j is read before double j is written, so no float is
+        // overwritten before it's been read.
+        for (int i = 0; i < numDestChannels; ++i)
+        {
+            if (auto bytes = reinterpret_cast<char*> (floatChannels[i]))
+            {
+                for (auto j = (size_t) numSamples; j-- > 0;)
+                {
+                    float sample;
+                    memcpy (&sample, bytes + j * sizeof (float), sizeof (float));
+
+                    const auto widened = (double) sample;
+                    memcpy (bytes + j * sizeof (double), &widened, sizeof (double));
+                }
+            }
+        }
+
+        return true;
+    };
 
-    const bool success = reader.read (chans, numTargetChannels, readerStartSample, numSamples, true);
+    if (numDestChannels <= 64)
+    {
+        float* chans[64] = {};
+        return readAndWiden (chans);
+    }
 
-    if (convertToFloat)
-        convertFixedToFloat (chans, numTargetChannels, numSamples);
+    HeapBlock<float*> chans (numDestChannels);
+    return readAndWiden (chans);
+}
 
-    return success;
+static bool readChannels (AudioFormatReader& reader, float** chans, AudioBuffer<float>* buffer,
+                          int startSample, int numSamples, int64 readerStartSample, int numTargetChannels)
+{
+    for (int j = 0; j < numTargetChannels; ++j)
+        chans[j] = buffer->getWritePointer (j, startSample);
+
+    chans[numTargetChannels] = nullptr;
+
+    return readChannels (reader, chans, numTargetChannels, readerStartSample, numSamples, true);
 }
 
 bool AudioFormatReader::read (AudioBuffer<float>* buffer,
@@ -165,9 +246,9 @@ bool AudioFormatReader::read (AudioBuffer<float>* buffer,
 
     if (numTargetChannels <= 2)
     {
-        int* dests[2] = { reinterpret_cast<int*> (buffer->getWritePointer (0, startSample)),
-                          reinterpret_cast<int*> (numTargetChannels > 1 ? buffer->getWritePointer (1, startSample) : nullptr) };
-        int* chans[3] = {};
+        float* dests[2] = { buffer->getWritePointer (0, startSample),
+                            numTargetChannels > 1 ? buffer->getWritePointer (1, startSample) : nullptr };
+        float* chans[3] = {};
 
         if (useReaderLeftChan == useReaderRightChan)
         {
@@ -185,7 +266,7 @@ bool AudioFormatReader::read (AudioBuffer<float>* buffer,
             chans[1] = dests[0];
         }
 
-        if (! read (chans, 2, readerStartSample, numSamples, true))
+        if (! readChannels (*this, chans, 2, readerStartSample, numSamples, true))
             return false;
 
         // if the target's stereo and the source is mono, dupe the first channel..
@@ -196,23 +277,20 @@ bool AudioFormatReader::read (AudioBuffer<float>* buffer,
             memcpy (dests[1], dests[0], (size_t) numSamples * sizeof (float));
         }
 
-        if (! usesFloatingPointData)
-            convertFixedToFloat (dests, 2, numSamples);
-
         return true;
     }
 
     if (numTargetChannels <= 64)
     {
-        int* chans[65];
+        float* chans[65];
         return readChannels (*this, chans, buffer, startSample, numSamples,
-                             readerStartSample, numTargetChannels, ! usesFloatingPointData);
+                             readerStartSample, numTargetChannels);
     }
 
-    HeapBlock<int*> chans (numTargetChannels + 1);
+    HeapBlock<float*> chans (numTargetChannels + 1);
 
     return readChannels (*this, chans, buffer, startSample, numSamples,
-                         readerStartSample, numTargetChannels, ! usesFloatingPointData);
+                         readerStartSample, numTargetChannels);
 }
 
 void AudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples,
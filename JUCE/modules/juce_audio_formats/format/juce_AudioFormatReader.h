@@ -93,11 +93,22 @@ public:
         @returns                    true if the operation succeeded, false if there was an error. Note
                                     that reading sections of data beyond the extent of the stream isn't an
                                     error - the reader should just return zeros for these regions
-        @see readMaxLevels
+        @see readMaxLevels, readFloatSamples
     */
     bool read (float* const* destChannels, int numDestChannels,
                int64 startSampleInSource, int numSamplesToRead);
 
+    /** Reads samples from the stream as doubles.
+
+        This works like the version of read() that takes floats. Formats that override
+        readDoubleSamples() can keep more of the precision of a 32-bit integer file
+        this way; for the others, the samples are read as floats and then widened.
+
+        @see readDoubleSamples
+    */
+    bool read (double* const* destChannels, int numDestChannels,
+               int64 startSampleInSource, int numSamplesToRead);
+
     /** Reads samples from the stream.
 
         @param destChannels         an array of buffers into which the sample data for each
@@ -282,6 +293,37 @@ public:
                               int64 startSampleInFile,
                               int numSamples) = 0;
 
+    /** Performs the low-level read operation into floating point buffers.
+
+        The floating point versions of read() call this. The default implementation
+        calls readSamples(), and then converts the integers that it produced to floats
+        by scaling them by 1 / 2^31, so a subclass only needs to override this if it can
+        decode its format straight to floats, without the extra pass. An override should
+        use the same scale, so that its samples match readDoubleSamples() once they're
+        rounded to floats.
+
+        The parameters are the same as those of readSamples().
+    */
+    virtual bool readFloatSamples (float* const* destChannels,
+                                   int numDestChannels,
+                                   int startOffsetInDestBuffer,
+                                   int64 startSampleInFile,
+                                   int numSamples);
+
+    /** Performs the low-level read operation into double precision buffers.
+
+        The default implementation calls readFloatSamples() to read floats into the
+        first half of the memory of each destination channel, and then widens them
+        to doubles in place.
+
+        The parameters are the same as those of readSamples().
+    */
+    virtual bool readDoubleSamples (double* const* destChannels,
+                                    int numDestChannels,
+                                    int startOffsetInDestBuffer,
+                                    int64 startSampleInFile,
+                                    int numSamples);
+
 
 protected:
     //==============================================================================
@@ -315,7 +357,8 @@ protected:
     /** Used by AudioFormatReader subclasses to clear any parts of the data blocks that lie
         beyond the end of their available length.
     */
-    static void clearSamplesBeyondAvailableLength (int* const* destChannels, int numDestChannels,
+    template <typename SampleType>
+    static void clearSamplesBeyondAvailableLength (SampleType* const* destChannels, int numDestChannels,
                                                    int startOffsetInDestBuffer, int64 startSampleInFile,
                                                    int& numSamples, int64 fileLengthInSamples)
     {
@@ -331,7 +374,7 @@ protected:
         {
             for (int i = numDestChannels; --i >= 0;)
                 if (destChannels[i] != nullptr)
-                    zeromem (destChannels[i] + startOffsetInDestBuffer, (size_t) numSamples * sizeof (int));
+                    zeromem (destChannels[i] + startOffsetInDestBuffer, (size_t) numSamples * sizeof (SampleType));
 
             numSamples = (int) samplesAvailable;
         }
@@ -72,6 +72,34 @@ bool AudioSubsectionReader::readSamples (int* const* destSamples, int numDestCha
                                 startSampleInFile + startSample, numSamples);
 }
 
+// These go straight to the source's own float and double decoding, rather than
+// through the base class's conversion from readSamples().
+bool AudioSubsectionReader::readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                              int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, length);
+
+    if (numSamples <= 0)
+        return true;
+
+    return source->readFloatSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                     startSampleInFile + startSample, numSamples);
+}
+
+bool AudioSubsectionReader::readDoubleSamples (double* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                               int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, length);
+
+    if (numSamples <= 0)
+        return true;
+
+    return source->readDoubleSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                      startSampleInFile + startSample, numSamples);
+}
+
 void AudioSubsectionReader::readMaxLevels (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead)
 {
     startSampleInFile = jmax ((int64) 0, startSampleInFile);
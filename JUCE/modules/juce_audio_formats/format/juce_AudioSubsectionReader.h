@@ -78,6 +78,12 @@ public:
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override;
 
+    bool readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                           int64 startSampleInFile, int numSamples) override;
+
+    bool readDoubleSamples (double* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples) override;
+
     void readMaxLevels (int64 startSample, int64 numSamples,
                         Range<float>* results, int numChannelsToRead) override;
 
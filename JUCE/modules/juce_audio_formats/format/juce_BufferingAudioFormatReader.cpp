@@ -62,8 +62,41 @@ void BufferingAudioReader::setReadTimeout (int timeoutMilliseconds) noexcept
     timeoutMs = timeoutMilliseconds;
 }
 
+static void copyBufferedSamples (float* dest, const float* source, int numSamples) noexcept
+{
+    FloatVectorOperations::copy (dest, source, numSamples);
+}
+
+static void copyBufferedSamples (double* dest, const float* source, int numSamples) noexcept
+{
+    std::copy (source, source + numSamples, dest);
+}
+
 bool BufferingAudioReader::readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                                         int64 startSampleInFile, int numSamples)
+{
+    // The buffered samples are floats, which is what this reader says it produces
+    return readBufferedSamples (reinterpret_cast<float* const*> (destSamples), numDestChannels, startOffsetInDestBuffer,
+                                startSampleInFile, numSamples);
+}
+
+bool BufferingAudioReader::readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                             int64 startSampleInFile, int numSamples)
+{
+    return readBufferedSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+}
+
+bool BufferingAudioReader::readDoubleSamples (double* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                              int64 startSampleInFile, int numSamples)
+{
+    // This widens the buffered floats as it copies them, rather than copying
+    // floats and then widening them in a second pass
+    return readBufferedSamples (destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+}
+
+template <typename SampleType>
+bool BufferingAudioReader::readBufferedSamples (SampleType* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                                int64 startSampleInFile, int numSamples)
 {
     auto startTime = Time::getMillisecondCounter();
     clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
@@ -83,12 +116,12 @@ bool BufferingAudioReader::readSamples (int* const* destSamples, int numDestChan
 
             for (int j = 0; j < numDestChannels; ++j)
             {
-                if (auto* dest = (float*) destSamples[j])
+                if (auto* dest = destSamples[j])
                 {
                     dest += startOffsetInDestBuffer;
 
                     if (j < (int) numChannels)
-                        FloatVectorOperations::copy (dest, block->buffer.getReadPointer (j, offset), numToDo);
+                        copyBufferedSamples (dest, block->buffer.getReadPointer (j, offset), numToDo);
                     else
                         FloatVectorOperations::clear (dest, numToDo);
                 }
@@ -105,7 +138,7 @@ bool BufferingAudioReader::readSamples (int* const* destSamples, int numDestChan
             if (timeoutMs >= 0 && Time::getMillisecondCounter() >= startTime + (uint32) timeoutMs)
             {
                 for (int j = 0; j < numDestChannels; ++j)
-                    if (auto* dest = (float*) destSamples[j])
+                    if (auto* dest = destSamples[j])
                         FloatVectorOperations::clear (dest + startOffsetInDestBuffer, numSamples);
 
                 allSamplesRead = false;
@@ -300,6 +333,29 @@ public:
             blockingReader->unblock.signal();
         }
 
+        beginTest ("Reading doubles from a reader should produce its source's samples, widened");
+        {
+            Random random { getRandom() };
+            constexpr auto bufferSize = 5000;
+
+            const auto source = generateTestBuffer (random, bufferSize);
+            BufferingAudioReader reader (new TestAudioFormatReader (&source), thread, bufferSize);
+            reader.setReadTimeout (-1);
+
+            // This runs past the end of the source, which should come back as silence
+            AudioBuffer<double> destination (2, bufferSize + 100);
+            expect (reader.read (destination.getArrayOfWritePointers(), 2, 0, destination.getNumSamples()));
+
+            auto allMatch = true;
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < destination.getNumSamples(); ++i)
+                    allMatch = allMatch && exactlyEqual (destination.getSample (channel, i),
+                                                         i < bufferSize ? (double) source.getSample (channel, i) : 0.0);
+
+            expect (allMatch);
+        }
+
         beginTest ("Reading samples from a reader should produce the same samples as its source");
         {
             Random random { getRandom() };
@@ -75,6 +75,12 @@ public:
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override;
 
+    bool readFloatSamples (float* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                           int64 startSampleInFile, int numSamples) override;
+
+    bool readDoubleSamples (double* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                            int64 startSampleInFile, int numSamples) override;
+
 private:
     struct BufferedBlock
     {
@@ -85,6 +91,10 @@ private:
         bool allSamplesRead = false;
     };
 
+    template <typename SampleType>
+    bool readBufferedSamples (SampleType* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                              int64 startSampleInFile, int numSamples);
+
     int useTimeSlice() override;
     BufferedBlock* getBlockContaining (int64 pos) const noexcept;
     bool readNextBufferChunk();
@@ -699,6 +699,25 @@ private:
     int channelCounter = 0;
 };
 
+/*  Returns a silenceFlags value with a bit set for each of the given number of channels. */
+static inline Steinberg::uint64 getSilenceFlagsForChannels (Steinberg::int32 numChannels)
+{
+    if (numChannels <= 0)
+        return 0;
+
+    if (numChannels >= 64)
+        return std::numeric_limits<Steinberg::uint64>::max();
+
+    return ((Steinberg::uint64) 1 << numChannels) - 1;
+}
+
+/*  Returns true if the host has flagged every channel of a bus as silent. */
+static inline bool isSilentBus (const Steinberg::Vst::AudioBusBuffers& bus)
+{
+    const auto allChannels = getSilenceFlagsForChannels (bus.numChannels);
+    return allChannels != 0 && (bus.silenceFlags & allChannels) == allChannels;
+}
+
 template <typename FloatType>
 static int countValidBuses (Steinberg::Vst::AudioBusBuffers* buffers, int32 num)
 {
@@ -787,7 +806,15 @@ public:
         const auto channelPtr = channels.empty() ? scratchBuffer.getArrayOfWritePointers()
                                                  : channels.data();
 
-        return { channelPtr, (int) channels.size(), (int) data.numSamples };
+        AudioBuffer<FloatType> result { channelPtr, (int) channels.size(), (int) data.numSamples };
+
+        // If the host says that every input is silent, mark the buffer as cleared, so that
+        // the client can find out with AudioBuffer::hasBeenCleared() rather than by
+        // scanning the samples.
+        if (vstInputs > 0 && std::all_of (data.inputs, data.inputs + vstInputs, isSilentBus))
+            result.clear();
+
+        return result;
     }
 
 private:
@@ -817,12 +844,16 @@ private:
                 jassert (mapping.size() <= static_cast<size_t> (bus.numChannels));
 
                 auto** busPtr = getAudioBusPointer (detail::Tag<FloatType>{}, bus);
+                const auto busIsSilent = isSilentBus (bus);
 
                 for (size_t channelIndex = 0; channelIndex < mapping.size(); ++channelIndex)
                 {
-                    FloatVectorOperations::copy (channels[(size_t) mapping.getJuceChannelForVst3Channel ((int) channelIndex) + originalSize],
-                                                 busPtr[channelIndex],
-                                                 (size_t) data.numSamples);
+                    auto* dest = channels[(size_t) mapping.getJuceChannelForVst3Channel ((int) channelIndex) + originalSize];
+
+                    if (busIsSilent)
+                        FloatVectorOperations::clear (dest, (size_t) data.numSamples);
+                    else
+                        FloatVectorOperations::copy (dest, busPtr[channelIndex], (size_t) data.numSamples);
                 }
             }
             else
@@ -1046,6 +1077,11 @@ public:
 private:
     void copyToHostOutputBuses (size_t vstOutputs) const
     {
+        // A buffer that the client has cleared and not written to since is silent, so we can
+        // tell the host, which may then skip processing anything downstream. The buffer only
+        // tracks this for all of its channels at once, so buses are flagged as a whole.
+        const auto outputIsSilent = buffer.hasBeenCleared();
+
         for (size_t i = 0, juceBusOffset = 0; i < outputMap->size(); ++i)
         {
             const auto& mapping = (*outputMap)[i];
@@ -1057,6 +1093,9 @@ private:
                 // Every VST3 channel must have a JUCE channel counterpart
                 jassert (static_cast<size_t> (bus.numChannels) <= mapping.size());
 
+                bus.silenceFlags = (outputIsSilent || ! mapping.isClientActive()) ? getSilenceFlagsForChannels (bus.numChannels)
+                                                                                  : 0;
+
                 if (mapping.isClientActive())
                 {
                     for (size_t j = 0; j < static_cast<size_t> (bus.numChannels); ++j)
@@ -557,6 +557,65 @@ public:
             expect (channelStartsWithValue (data.outputs[2], 3, 7.0f));
         }
 
+        beginTest ("Silence flags are passed between the host and the client");
+        {
+            ClientBufferMapperData<float> remapper;
+            remapper.prepare (2, blockSize * 2);
+
+            const Config config { { DynamicChannelMapping { AudioChannelSet::stereo() } },
+                                  { DynamicChannelMapping { AudioChannelSet::stereo() } } };
+
+            TestBuffers testBuffers { blockSize };
+
+            auto ins  = MultiBusBuffers{}.withBus (testBuffers, 2);
+            auto outs = MultiBusBuffers{}.withBus (testBuffers, 2);
+
+            auto data = makeProcessData (blockSize, ins, outs);
+
+            // Input flagged as silent arrives cleared, even if the host left junk in it
+            testBuffers.init();
+            data.inputs[0].silenceFlags = 0x3;
+
+            {
+                ClientRemappedBuffer<float> scopedBuffer { remapper, &config.ins, &config.outs, data };
+                auto& remapped = scopedBuffer.buffer;
+
+                expect (remapped.hasBeenCleared());
+                expect (allMatch (remapped, 0, 0.0f));
+                expect (allMatch (remapped, 1, 0.0f));
+            }
+
+            // A buffer that the client leaves cleared is reported as silent
+            expect (data.outputs[0].silenceFlags == 0x3);
+            expect (testBuffers.isClear (2));
+            expect (testBuffers.isClear (3));
+
+            // Input that isn't flagged is copied, and output that the client writes isn't silent
+            testBuffers.init();
+            data.inputs[0].silenceFlags = 0x1;
+
+            {
+                ClientRemappedBuffer<float> scopedBuffer { remapper, &config.ins, &config.outs, data };
+                auto& remapped = scopedBuffer.buffer;
+
+                expect (! remapped.hasBeenCleared());
+                expect (allMatch (remapped, 0, 1.0f));
+                expect (allMatch (remapped, 1, 2.0f));
+            }
+
+            expect (data.outputs[0].silenceFlags == 0);
+
+            // Output that the client clears itself is reported as silent
+            testBuffers.init();
+
+            {
+                ClientRemappedBuffer<float> scopedBuffer { remapper, &config.ins, &config.outs, data };
+                scopedBuffer.buffer.clear();
+            }
+
+            expect (data.outputs[0].silenceFlags == 0x3);
+        }
+
         beginTest ("HostBufferMapper reorders channels correctly");
         {
             HostBufferMapper mapper;
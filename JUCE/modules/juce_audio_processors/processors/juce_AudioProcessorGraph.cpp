@@ -149,11 +149,17 @@ public:
     using NodeAndChannel = AudioProcessorGraph::NodeAndChannel;
 
 private:
+    /*  Uses the set's own lookups, which find the range in logarithmic time, rather than
+        std::equal_range, which has to step through the set to get there.
+    */
     static auto equalRange (const std::set<NodeAndChannel>& pins, const NodeID node)
     {
-        return std::equal_range (pins.cbegin(), pins.cend(), node, ImplicitNode::compare);
+        return std::make_pair (pins.lower_bound (firstPinOf (node)), pins.upper_bound (lastPinOf (node)));
     }
 
+    static NodeAndChannel firstPinOf (NodeID node) { return { node, std::numeric_limits<int>::min() }; }
+    static NodeAndChannel lastPinOf  (NodeID node) { return { node, std::numeric_limits<int>::max() }; }
+
     using Map = std::map<NodeAndChannel, std::set<NodeAndChannel>>;
 
 public:
@@ -313,6 +319,16 @@ public:
             return false;
         }
 
+        /*  Calls the callback with each source that's connected to anything, and the set of inputs
+            that it's connected to.
+        */
+        template <typename Callback>
+        void forEachSource (Callback&& callback) const
+        {
+            for (const auto& [source, destinations] : map)
+                callback (source, destinations);
+        }
+
     private:
         Map map;
     };
@@ -371,7 +387,8 @@ private:
 
     std::pair<Map::const_iterator, Map::const_iterator> getMatchingDestinations (NodeID destID) const
     {
-        return std::equal_range (sourcesForDestination.cbegin(), sourcesForDestination.cend(), destID, ImplicitNode::compare);
+        return std::make_pair (sourcesForDestination.lower_bound (firstPinOf (destID)),
+                               sourcesForDestination.upper_bound (lastPinOf (destID)));
     }
 
     Map sourcesForDestination;
@@ -503,11 +520,465 @@ private:
     std::optional<PrepareSettings> current, next;
 };
 
+//==============================================================================
+/*  The order in which the tasks of a render sequence have to run, so that they can be spread
+    across several threads.
+
+    Each task is a node's render ops: the ones that gather its inputs, followed by the one that
+    processes it. While the sequence is being built, each op reports the buffers it reads and
+    writes, and a task depends on every earlier task that wrote a buffer it uses, or read a
+    buffer that it writes. Tasks that don't depend on each other, directly or indirectly, never
+    touch the same buffer in a way that could race, and every buffer sees its ops in the same
+    order as the sequential render, so the result is identical.
+*/
+class RenderTaskGraph
+{
+public:
+    enum class BufferKind { audio, midi, graphAudioOut, graphMidiOut };
+
+    /*  Call while building, for each buffer that the current op reads. */
+    void addRead (BufferKind kind, int index)
+    {
+        auto& use = uses[getKey (kind, index)];
+        addDependency (use.lastWriter);
+        use.readers.push_back (getCurrentTask());
+    }
+
+    /*  Call while building, for each buffer that the current op writes. */
+    void addWrite (BufferKind kind, int index)
+    {
+        auto& use = uses[getKey (kind, index)];
+        addDependency (use.lastWriter);
+
+        for (auto reader : use.readers)
+            addDependency (reader);
+
+        use.lastWriter = getCurrentTask();
+        use.readers.clear();
+    }
+
+    /*  Call while building, after the last op of each task. */
+    void endTask()
+    {
+        const auto task = getCurrentTask();
+
+        for (auto dependency : currentDependencies)
+            successors[(size_t) dependency].push_back (task);
+
+        numDependencies.push_back ((int) currentDependencies.size());
+        successors.emplace_back();
+        currentDependencies.clear();
+    }
+
+    /*  Call once everything has been built, to free the working space. */
+    void finishBuilding()
+    {
+        uses.clear();
+    }
+
+    int getNumTasks() const noexcept                                { return (int) numDependencies.size(); }
+    int getNumDependencies (int task) const noexcept                { return numDependencies[(size_t) task]; }
+    const std::vector<int>& getSuccessors (int task) const noexcept { return successors[(size_t) task]; }
+
+private:
+    struct BufferUse
+    {
+        int lastWriter = -1;
+        std::vector<int> readers;
+    };
+
+    static int64 getKey (BufferKind kind, int index) noexcept
+    {
+        return ((int64) index << 2) | (int64) kind;
+    }
+
+    int getCurrentTask() const noexcept { return (int) numDependencies.size(); }
+
+    void addDependency (int task)
+    {
+        if (task >= 0 && task != getCurrentTask())
+            currentDependencies.insert (task);
+    }
+
+    std::map<int64, BufferUse> uses;
+    std::set<int> currentDependencies;
+
+    std::vector<int> numDependencies;
+    std::vector<std::vector<int>> successors;
+};
+
+//==============================================================================
+/*  A pool of real-time threads that help the audio thread through a RenderTaskGraph.
+
+    The threads are started up front, and shared by every render sequence that's built while
+    the graph's number of render threads stays the same.
+
+    Every thread, including the audio thread, has a queue of tasks that are ready to run. A
+    thread that finishes a task pushes any tasks that were waiting only for it onto its own
+    queue, and runs the newest task on its queue next, so work tends to stay on the thread whose
+    cache already holds its inputs. A thread with an empty queue steals the oldest task from
+    another thread's queue. The queues are Chase-Lev deques, and the dependency counts are
+    atomics, so nothing locks or allocates while a block is rendered.
+
+    A worker that can't find a task for a while leaves the rest of the block to the threads that
+    are still busy, rather than spinning while they finish. Between blocks, if every worker can
+    have a CPU core of its own, the workers spin, yielding their time slice, for a couple of
+    milliseconds before going to sleep, so while blocks keep arriving they're ready straight
+    away. Otherwise they sleep straight away, so that spinning real-time threads never keep the
+    audio thread off a core, and each block wakes them again.
+*/
+class GraphRenderThreads
+{
+public:
+    /*  Something that can run the tasks of a RenderTaskGraph. */
+    struct Tasks
+    {
+        virtual ~Tasks() = default;
+        virtual void runTask (int task) = 0;
+    };
+
+    //==============================================================================
+    /*  A fixed-size work-stealing deque, as described in "Correct and Efficient Work-Stealing
+        for Weak Memory Models" (Lê et al., 2013). Each task is pushed at most once per block,
+        and the deque is emptied between blocks, so it never needs to grow or wrap around.
+    */
+    class WorkQueue
+    {
+    public:
+        explicit WorkQueue (int capacity) : items ((size_t) jmax (1, capacity)) {}
+
+        /*  Call only while no thread is using the queue. */
+        void clear() noexcept
+        {
+            top.store (0, std::memory_order_relaxed);
+            bottom.store (0, std::memory_order_relaxed);
+        }
+
+        /*  Call only from the thread that owns the queue. */
+        void push (int task) noexcept
+        {
+            const auto b = bottom.load (std::memory_order_relaxed);
+            items[(size_t) b].store (task, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+            bottom.store (b + 1, std::memory_order_relaxed);
+        }
+
+        /*  Call only from the thread that owns the queue. Returns -1 if it's empty. */
+        int pop() noexcept
+        {
+            const auto b = bottom.load (std::memory_order_relaxed) - 1;
+            bottom.store (b, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            auto t = top.load (std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store (b + 1, std::memory_order_relaxed);
+                return -1;
+            }
+
+            auto task = items[(size_t) b].load (std::memory_order_relaxed);
+
+            // The last task might be being stolen at the same time
+            if (t == b)
+            {
+                if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    task = -1;
+
+                bottom.store (b + 1, std::memory_order_relaxed);
+            }
+
+            return task;
+        }
+
+        /*  Call from any other thread. Returns -1 if the queue is empty, or another thread got
+            there first.
+        */
+        int steal() noexcept
+        {
+            auto t = top.load (std::memory_order_acquire);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            const auto b = bottom.load (std::memory_order_acquire);
+
+            if (t >= b)
+                return -1;
+
+            const auto task = items[(size_t) t].load (std::memory_order_relaxed);
+
+            if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return -1;
+
+            return task;
+        }
+
+    private:
+        std::vector<std::atomic<int>> items;
+        std::atomic<int> top { 0 }, bottom { 0 };
+    };
+
+    //==============================================================================
+    /*  The state of one render sequence's tasks during a block. */
+    class Schedule
+    {
+    public:
+        Schedule (const GraphRenderThreads& o, const RenderTaskGraph& g, int numQueues)
+            : owner (o),
+              graph (g),
+              numDependenciesLeft ((size_t) graph.getNumTasks())
+        {
+            for (int i = 0; i < numQueues; ++i)
+                queues.push_back (std::make_unique<WorkQueue> (graph.getNumTasks()));
+
+            for (int task = 0; task < graph.getNumTasks(); ++task)
+                if (graph.getNumDependencies (task) == 0)
+                    initialTasks.push_back (task);
+        }
+
+        ~Schedule()
+        {
+            // Workers may still be on their way out of the last block this performed
+            owner.waitForWorkersToLeave();
+        }
+
+    private:
+        friend class GraphRenderThreads;
+
+        /*  Call on the audio thread, while no worker is using the schedule. */
+        void startBlock (Tasks& t) noexcept
+        {
+            tasks = &t;
+
+            for (int task = 0; task < graph.getNumTasks(); ++task)
+                numDependenciesLeft[(size_t) task].store (graph.getNumDependencies (task), std::memory_order_relaxed);
+
+            for (auto& queue : queues)
+                queue->clear();
+
+            // Dealing out the tasks that can start straight away means that the workers
+            // don't all have to steal from the audio thread to get going
+            for (size_t i = 0; i < initialTasks.size(); ++i)
+                queues[i % queues.size()]->push (initialTasks[i]);
+
+            numTasksLeft.store (graph.getNumTasks(), std::memory_order_relaxed);
+        }
+
+        void runTask (int task, WorkQueue& queue) noexcept
+        {
+            tasks->runTask (task);
+
+            for (auto successor : graph.getSuccessors (task))
+                if (numDependenciesLeft[(size_t) successor].fetch_sub (1, std::memory_order_acq_rel) == 1)
+                    queue.push (successor);
+
+            numTasksLeft.fetch_sub (1, std::memory_order_release);
+        }
+
+        /*  Runs and steals tasks until every task in the block has finished, or, unless this is
+            the audio thread, until there's been nothing to take for a while.
+        */
+        void work (size_t queueIndex) noexcept
+        {
+            constexpr int maxFailedAttemptsBeforeYielding = 64, maxYieldsForWorkers = 16;
+            auto& queue = *queues[queueIndex];
+            int numFailedAttempts = 0;
+
+            while (numTasksLeft.load (std::memory_order_acquire) > 0)
+            {
+                auto task = queue.pop();
+
+                for (size_t i = 1; task < 0 && i < queues.size(); ++i)
+                    task = queues[(queueIndex + i) % queues.size()]->steal();
+
+                if (task >= 0)
+                {
+                    runTask (task, queue);
+                    numFailedAttempts = 0;
+                }
+                else if (++numFailedAttempts > maxFailedAttemptsBeforeYielding)
+                {
+                    // Whatever's left is running on other threads, which might need this core.
+                    // Any tasks that they make ready go onto their own queues, so a worker can
+                    // leave without anything being left undone.
+                    if (queueIndex != 0 && numFailedAttempts > maxFailedAttemptsBeforeYielding + maxYieldsForWorkers)
+                        return;
+
+                    Thread::yield();
+                }
+            }
+        }
+
+        const GraphRenderThreads& owner;
+        const RenderTaskGraph& graph;
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        std::vector<std::atomic<int>> numDependenciesLeft;
+        std::vector<int> initialTasks;
+        std::atomic<int> numTasksLeft { 0 };
+        Tasks* tasks = nullptr;
+    };
+
+    //==============================================================================
+    explicit GraphRenderThreads (int numThreads)
+        : workersSpin (numThreads < SystemStats::getNumCpus())
+    {
+        for (int i = 0; i < numThreads; ++i)
+        {
+            auto worker = std::make_unique<Worker> (*this, (size_t) i + 1);
+
+            if (! worker->startRealtimeThread (Thread::RealtimeOptions{}.withPriority (9)))
+                worker->startThread (Thread::Priority::highest);
+
+            workers.push_back (std::move (worker));
+        }
+    }
+
+    ~GraphRenderThreads()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (auto& worker : workers)
+        {
+            worker->wakeUp.signal();
+            worker->stopThread (-1);
+        }
+    }
+
+    int getNumThreads() const noexcept    { return (int) workers.size(); }
+
+    /*  Creates the state that perform() needs for a given graph. */
+    std::unique_ptr<Schedule> createSchedule (const RenderTaskGraph& graph) const
+    {
+        return std::make_unique<Schedule> (*this, graph, getNumThreads() + 1);
+    }
+
+    /*  Call on the audio thread, to run every task in the schedule. This returns once they've
+        all finished.
+
+        The audio thread runs and steals tasks along with the workers until there are none
+        left. Workers that were still looking for a task may not have left the schedule by then,
+        but they don't touch anything but the schedule itself, so rather than waiting for them
+        here, the next call waits for them before it sets the schedule up again. By then a whole
+        block has passed, so they're almost always long gone. Waking the workers only takes a
+        lock-free semaphore post for each one that's asleep.
+    */
+    void perform (Schedule& schedule, Tasks& tasks) noexcept
+    {
+        waitForWorkersToLeave();
+
+        schedule.startBlock (tasks);
+
+        openSchedule.store (&schedule);
+        blockNumber.fetch_add (1);
+
+        for (auto& worker : workers)
+            if (worker->isSleeping.load())
+                worker->wakeUp.signal();
+
+        schedule.work (0);
+
+        openSchedule.store (nullptr);
+    }
+
+    /*  Waits for any workers that might still be using a schedule that's been performed. */
+    void waitForWorkersToLeave() const noexcept
+    {
+        for (auto& worker : workers)
+            worker->waitUntilOutside();
+    }
+
+private:
+    //==============================================================================
+    class Worker final : public Thread
+    {
+    public:
+        Worker (GraphRenderThreads& o, size_t queue)
+            : Thread ("Graph render thread"), owner (o), queueIndex (queue) {}
+
+        void run() override
+        {
+            auto lastBlock = owner.blockNumber.load();
+
+            while (waitForNextBlock (lastBlock))
+            {
+                numEntriesAndExits.fetch_add (1);
+                lastBlock = owner.blockNumber.load();
+
+                // If the block has already finished, the audio thread may be setting up the next
+                // one, so this only touches the schedule while it's open
+                if (auto* schedule = owner.openSchedule.load())
+                    schedule->work (queueIndex);
+
+                numEntriesAndExits.fetch_add (1);
+            }
+        }
+
+        /*  Returns once this worker isn't using any schedule that was open before the call. */
+        void waitUntilOutside() const noexcept
+        {
+            // The count is odd while the worker is inside. If it goes in again, it sees that the
+            // schedule it was using has closed, so it only needs to have come out once.
+            const auto count = numEntriesAndExits.load();
+
+            if ((count & 1) == 0)
+                return;
+
+            while (numEntriesAndExits.load() == count)
+                Thread::yield();
+        }
+
+        std::atomic<bool> isSleeping { false };
+        LightweightSemaphore wakeUp;
+
+    private:
+        static constexpr uint32 spinTimeMs = 2;
+
+        bool waitForNextBlock (uint32 lastBlock)
+        {
+            const auto spinStart = Time::getMillisecondCounter();
+
+            while (owner.blockNumber.load() == lastBlock)
+            {
+                if (threadShouldExit())
+                    return false;
+
+                if (owner.workersSpin && Time::getMillisecondCounter() - spinStart < spinTimeMs)
+                {
+                    Thread::yield();
+                    continue;
+                }
+
+                // The audio thread checks this after starting a block, and this checks for a
+                // block after setting it, so one of them always sees the other
+                isSleeping.store (true);
+
+                if (owner.blockNumber.load() == lastBlock && ! threadShouldExit())
+                    wakeUp.wait();
+
+                isSleeping.store (false);
+            }
+
+            return ! threadShouldExit();
+        }
+
+        GraphRenderThreads& owner;
+        const size_t queueIndex;
+        std::atomic<uint32> numEntriesAndExits { 0 };
+    };
+
+    const bool workersSpin;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<Schedule*> openSchedule { nullptr };
+    std::atomic<uint32> blockNumber { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (GraphRenderThreads)
+};
+
 //==============================================================================
 template <typename FloatType>
-struct GraphRenderSequence
+struct GraphRenderSequence  : private GraphRenderThreads::Tasks
 {
     using Node = AudioProcessorGraph::Node;
+    using BufferKind = RenderTaskGraph::BufferKind;
 
     struct GlobalIO
     {
@@ -552,7 +1023,10 @@ struct GraphRenderSequence
         }
 
         currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
-        currentAudioOutputBuffer.clear();
+
+        // When a single output node writes the whole of the output, there's nothing to clear
+        if (onlyAudioOutOp == nullptr)
+            currentAudioOutputBuffer.clear();
         currentMidiOutputBuffer.clear();
 
         {
@@ -563,8 +1037,17 @@ struct GraphRenderSequence
                                     audioPlayHead,
                                     numSamples };
 
-            for (const auto& op : renderOps)
-                op->process (context);
+            if (schedule != nullptr)
+            {
+                currentContext = &context;
+                renderThreads->perform (*schedule, *this);
+                currentContext = nullptr;
+            }
+            else
+            {
+                for (const auto& op : renderOps)
+                    op->process (context);
+            }
         }
 
         for (int i = 0; i < buffer.getNumChannels(); ++i)
@@ -596,6 +1079,7 @@ struct GraphRenderSequence
             int index = 0;
         };
 
+        addWrite (BufferKind::audio, index);
         renderOps.push_back (std::make_unique<ClearOp> (index));
     }
 
@@ -621,32 +1105,75 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
+        addRead  (BufferKind::audio, srcIndex);
+        addWrite (BufferKind::audio, dstIndex);
         renderOps.push_back (std::make_unique<CopyOp> (srcIndex, dstIndex));
     }
 
-    void addAddChannelOp (int srcIndex, int dstIndex)
+    /*  Sets a channel to the sum of some others, adding them in the order they're given. If the
+        first source is the destination itself, the others are added to it.
+
+        This gives exactly the same results as a copy followed by a series of adds, but works
+        through the channels a tile at a time, so the destination stays in the cache while each
+        source is added to it, rather than being read and written once for every source.
+    */
+    void addMixChannelOp (const Array<int>& srcIndices, int dstIndex)
     {
-        struct AddOp final : public RenderOp
+        struct MixOp final : public RenderOp
         {
-            explicit AddOp (int fromIn, int toIn) : from (fromIn), to (toIn) {}
+            MixOp (const Array<int>& fromIn, int toIn)
+                : from (fromIn), to (toIn), fromBuffers ((size_t) fromIn.size()) {}
 
             void prepare (FloatType* const* renderBuffer, MidiBuffer*) override
             {
-                fromBuffer = renderBuffer[from];
+                for (size_t i = 0; i < fromBuffers.size(); ++i)
+                    fromBuffers[i] = renderBuffer[from.getUnchecked ((int) i)];
+
                 toBuffer = renderBuffer[to];
             }
 
             void process (const Context& c) override
             {
-                FloatVectorOperations::add (toBuffer, fromBuffer, c.numSamples);
+                constexpr int samplesPerTile = 256;
+
+                for (int start = 0; start < c.numSamples; start += samplesPerTile)
+                {
+                    const auto num = jmin (samplesPerTile, c.numSamples - start);
+                    auto* dest = toBuffer + start;
+                    size_t next = 1;
+
+                    if (fromBuffers[0] != toBuffer)
+                    {
+                        if (fromBuffers.size() == 1)
+                        {
+                            FloatVectorOperations::copy (dest, fromBuffers[0] + start, num);
+                        }
+                        else
+                        {
+                            FloatVectorOperations::add (dest, fromBuffers[0] + start, fromBuffers[1] + start, num);
+                            next = 2;
+                        }
+                    }
+
+                    for (; next < fromBuffers.size(); ++next)
+                        FloatVectorOperations::add (dest, fromBuffers[next] + start, num);
+                }
             }
 
-            FloatType* fromBuffer = nullptr;
+            const Array<int> from;
+            const int to;
+            std::vector<const FloatType*> fromBuffers;
             FloatType* toBuffer = nullptr;
-            int from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
+        jassert (! srcIndices.isEmpty());
+
+        for (auto srcIndex : srcIndices)
+            if (srcIndex != dstIndex)
+                addRead (BufferKind::audio, srcIndex);
+
+        addWrite (BufferKind::audio, dstIndex);
+        renderOps.push_back (std::make_unique<MixOp> (srcIndices, dstIndex));
     }
 
     JUCE_END_IGNORE_WARNINGS_MSVC
@@ -671,6 +1198,7 @@ struct GraphRenderSequence
             int index = 0;
         };
 
+        addWrite (BufferKind::midi, index);
         renderOps.push_back (std::make_unique<ClearOp> (index));
     }
 
@@ -696,6 +1224,8 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
+        addRead  (BufferKind::midi, srcIndex);
+        addWrite (BufferKind::midi, dstIndex);
         renderOps.push_back (std::make_unique<CopyOp> (srcIndex, dstIndex));
     }
 
@@ -721,6 +1251,8 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
+        addRead  (BufferKind::midi, srcIndex);
+        addWrite (BufferKind::midi, dstIndex);
         renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
     }
 
@@ -760,6 +1292,7 @@ struct GraphRenderSequence
             int readIndex = 0, writeIndex;
         };
 
+        addWrite (BufferKind::audio, chan);
         renderOps.push_back (std::make_unique<DelayChannelOp> (chan, delaySize));
     }
 
@@ -772,13 +1305,23 @@ struct GraphRenderSequence
         {
             if (auto* ioNode = dynamic_cast<const AudioProcessorGraph::AudioGraphIOProcessor*> (node->getProcessor()))
             {
+                if (ioNode->getType() == AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode)
+                    addWrite (BufferKind::graphAudioOut, 0);
+
+                if (ioNode->getType() == AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode)
+                    addWrite (BufferKind::graphMidiOut, 0);
+
                 switch (ioNode->getType())
                 {
                     case AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode:
                         return std::make_unique<AudioInOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
 
                     case AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode:
-                        return std::make_unique<AudioOutOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
+                    {
+                        auto outOp = std::make_unique<AudioOutOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
+                        audioOutOps.push_back (outOp.get());
+                        return outOp;
+                    }
 
                     case AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode:
                         return std::make_unique<MidiInOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
@@ -791,10 +1334,32 @@ struct GraphRenderSequence
             return std::make_unique<ProcessOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
         }();
 
+        // The node writes its output channels in place, and only reads the rest
+        const auto numOutputs = node->getProcessor()->getTotalNumOutputChannels();
+
+        for (int i = 0; i < audioChannelsUsed.size(); ++i)
+        {
+            if (i < numOutputs)
+                addWrite (BufferKind::audio, audioChannelsUsed.getUnchecked (i));
+            else
+                addRead (BufferKind::audio, audioChannelsUsed.getUnchecked (i));
+        }
+
+        addWrite (BufferKind::midi, midiBuffer);
+
         renderOps.push_back (std::move (op));
+
+        if (taskGraph != nullptr)
+        {
+            taskGraph->endTask();
+            taskEnds.push_back (renderOps.size());
+        }
     }
 
-    void prepareBuffers (int blockSize)
+    /*  Call once the builder has added every op, with the threads that will help to render the
+        sequence, or nullptr to render it all on the audio thread.
+    */
+    void prepareBuffers (int blockSize, std::shared_ptr<GraphRenderThreads> threads)
     {
         renderingBuffer.setSize (numBuffersNeeded + 1, blockSize);
         renderingBuffer.clear();
@@ -815,10 +1380,25 @@ struct GraphRenderSequence
 
         for (const auto& op : renderOps)
             op->prepare (renderingBuffer.getArrayOfWritePointers(), midiBuffers.data());
+
+        if (audioOutOps.size() == 1)
+        {
+            onlyAudioOutOp = audioOutOps.front();
+            onlyAudioOutOp->overwritesOutput = true;
+        }
+
+        if (taskGraph != nullptr && threads != nullptr)
+        {
+            renderThreads = std::move (threads);
+            schedule = renderThreads->createSchedule (*taskGraph);
+        }
     }
 
     int numBuffersNeeded = 0, numMidiBuffersNeeded = 0;
 
+    // Only created for sequences that may be rendered on several threads
+    std::unique_ptr<RenderTaskGraph> taskGraph;
+
     AudioBuffer<FloatType> renderingBuffer, currentAudioOutputBuffer;
 
     MidiBuffer currentMidiOutputBuffer;
@@ -827,6 +1407,27 @@ struct GraphRenderSequence
     MidiBuffer midiChunk;
 
 private:
+    //==============================================================================
+    void addRead (BufferKind kind, int index)
+    {
+        if (taskGraph != nullptr)
+            taskGraph->addRead (kind, index);
+    }
+
+    void addWrite (BufferKind kind, int index)
+    {
+        if (taskGraph != nullptr)
+            taskGraph->addWrite (kind, index);
+    }
+
+    void runTask (int task) override
+    {
+        const auto begin = task > 0 ? taskEnds[(size_t) task - 1] : 0;
+
+        for (auto i = begin; i < taskEnds[(size_t) task]; ++i)
+            renderOps[i]->process (*currentContext);
+    }
+
     //==============================================================================
     struct RenderOp
     {
@@ -877,6 +1478,7 @@ private:
             if (processor.isSuspended())
             {
                 buffer.clear();
+                processSuspended (c.globalIO);
             }
             else
             {
@@ -886,6 +1488,7 @@ private:
         }
 
         virtual void processWithBuffer (const GlobalIO&, bool bypass, AudioBuffer<FloatType>& audio, MidiBuffer& midi) = 0;
+        virtual void processSuspended (const GlobalIO&) {}
 
         const Node::Ptr node;
         AudioProcessor& processor;
@@ -987,15 +1590,183 @@ private:
 
         void processWithBuffer (const GlobalIO& g, bool bypass, AudioBuffer<FloatType>& audio, MidiBuffer&) final
         {
-            if (bypass)
+            const auto numChannels = bypass ? 0 : jmin (g.audioOut.getNumChannels(), audio.getNumChannels());
+
+            if (overwritesOutput)
+            {
+                for (int i = 0; i < numChannels; ++i)
+                    g.audioOut.copyFrom (i, 0, audio, i, 0, audio.getNumSamples());
+
+                for (int i = numChannels; i < g.audioOut.getNumChannels(); ++i)
+                    g.audioOut.clear (i, 0, audio.getNumSamples());
+
                 return;
+            }
+
+            for (int i = numChannels; --i >= 0;)
+                g.audioOut.addFrom (i, 0, audio, i, 0, audio.getNumSamples());
+        }
+
+        void processSuspended (const GlobalIO& g) final
+        {
+            if (overwritesOutput)
+                g.audioOut.clear();
+        }
+
+        // Set when this is the only output node, so the output hasn't been cleared
+        bool overwritesOutput = false;
+    };
+
+    std::vector<std::unique_ptr<RenderOp>> renderOps;
+    std::vector<size_t> taskEnds;
+
+    std::vector<AudioOutOp*> audioOutOps;
+    AudioOutOp* onlyAudioOutOp = nullptr;
+
+    std::shared_ptr<GraphRenderThreads> renderThreads;
+    std::unique_ptr<GraphRenderThreads::Schedule> schedule;
+    const Context* currentContext = nullptr;
+};
+
+//==============================================================================
+/*  The order in which a render sequence processes the graph's nodes, kept from one build to
+    the next.
+
+    Every node has to come after the nodes that feed it. After an edit, most of the previous
+    order still satisfies that, so rather than sorting the whole graph again, update() keeps the
+    previous order, and only re-sorts the stretch of it that spans the connections that now run
+    backwards. Nodes outside that stretch keep their places, and the nodes in it keep their
+    previous relative order wherever the connections allow. New nodes go at the end.
+
+    If the graph has a feedback loop, some connection in the loop has to run backwards. The
+    sort breaks the loop by placing the earliest of the stuck nodes first.
+*/
+class NodeOrder
+{
+public:
+    using Node   = AudioProcessorGraph::Node;
+    using NodeID = AudioProcessorGraph::NodeID;
+
+    void update (const Nodes& n, const Connections& c)
+    {
+        order.erase (std::remove_if (order.begin(), order.end(), [&] (NodeID id) { return n.getNodeForId (id) == nullptr; }),
+                     order.end());
+
+        std::unordered_map<uint32, int> positions;
+
+        for (const auto [index, id] : enumerate (order, int{}))
+            positions.emplace (id.uid, index);
+
+        for (auto* node : n.getNodes())
+            if (positions.emplace (node->nodeID.uid, (int) order.size()).second)
+                order.push_back (node->nodeID);
+
+        // The sources of each node, as positions in the order
+        std::vector<std::vector<int>> sources (order.size());
+        auto first = (int) order.size(), last = -1;
+
+        for (const auto [index, id] : enumerate (order, int{}))
+        {
+            for (const auto& source : c.getSourceNodesForDestination (id))
+            {
+                const auto iter = positions.find (source.uid);
+
+                if (iter == positions.end() || iter->second == index)
+                    continue;
+
+                sources[(size_t) index].push_back (iter->second);
+
+                if (iter->second > index)
+                {
+                    first = jmin (first, index);
+                    last  = jmax (last,  iter->second);
+                }
+            }
+        }
+
+        if (first < last)
+            sortRange (sources, first, last + 1);
+    }
+
+    Array<Node*> getNodes (const Nodes& n) const
+    {
+        Array<Node*> result;
+        result.ensureStorageAllocated ((int) order.size());
+
+        for (const auto& id : order)
+            result.add (n.getNodeForId (id).get());
+
+        return result;
+    }
+
+private:
+    /*  Sorts the nodes from begin to end, which have to include both ends of every connection
+        that runs backwards. Any other connection into or out of the range already runs
+        forwards, and still will afterwards.
+    */
+    void sortRange (const std::vector<std::vector<int>>& sources, int begin, int end)
+    {
+        const auto size = (size_t) (end - begin);
+        std::vector<std::vector<int>> destinations (size);
+        std::vector<int> numUnplacedSources (size, 0);
+
+        for (auto i = begin; i < end; ++i)
+        {
+            for (const auto source : sources[(size_t) i])
+            {
+                if (source < begin || end <= source)
+                    continue;
+
+                destinations[(size_t) (source - begin)].push_back (i - begin);
+                ++numUnplacedSources[(size_t) (i - begin)];
+            }
+        }
+
+        // Of the nodes whose sources have all been placed, the one that came first before
+        std::priority_queue<int, std::vector<int>, std::greater<>> ready;
+
+        for (size_t i = 0; i < size; ++i)
+            if (numUnplacedSources[i] == 0)
+                ready.push ((int) i);
+
+        std::vector<bool> placed (size, false);
+        std::vector<NodeID> sorted;
+        sorted.reserve (size);
+        size_t earliestUnplaced = 0;
+
+        while (sorted.size() < size)
+        {
+            int next = 0;
+
+            if (! ready.empty())
+            {
+                next = ready.top();
+                ready.pop();
+            }
+            else
+            {
+                // Only nodes in feedback loops are left
+                while (placed[earliestUnplaced])
+                    ++earliestUnplaced;
+
+                next = (int) earliestUnplaced;
+            }
 
-            for (int i = jmin (g.audioOut.getNumChannels(), audio.getNumChannels()); --i >= 0;)
-                g.audioOut.addFrom (i, 0, audio, i, 0, audio.getNumSamples());
+            if (placed[(size_t) next])
+                continue;
+
+            placed[(size_t) next] = true;
+            sorted.push_back (order[(size_t) (begin + next)]);
+
+            for (const auto destination : destinations[(size_t) next])
+                if (--numUnplacedSources[(size_t) destination] == 0 && ! placed[(size_t) destination])
+                    ready.push (destination);
         }
-    };
 
-    std::vector<std::unique_ptr<RenderOp>> renderOps;
+        std::copy (sorted.begin(), sorted.end(), order.begin() + begin);
+    }
+
+    std::vector<NodeID> order;
 };
 
 //==============================================================================
@@ -1019,22 +1790,34 @@ public:
 
     static constexpr auto midiChannelIndex = AudioProcessorGraph::midiChannelIndex;
 
+    /*  Builds a sequence that renders the graph's nodes one at a time, in order. With
+        forSeveralThreads set, the sequence also has a task graph, so that it can spread the
+        nodes across threads. Then, to keep the nodes from depending on each other more than
+        they have to, every buffer has a single purpose, and a node never overwrites an input
+        that another node reads. That takes more buffers, and some extra copies, but it never
+        changes the arithmetic, so both kinds of sequence produce the same results.
+    */
     template <typename FloatType>
-    static SequenceAndLatency build (const Nodes& n, const Connections& c)
+    static SequenceAndLatency build (const Nodes& n, const Connections& c, const NodeOrder& order, bool forSeveralThreads)
     {
         GraphRenderSequence<FloatType> sequence;
-        const RenderSequenceBuilder builder (n, c, sequence);
+        const RenderSequenceBuilder builder (n, c, order, sequence, forSeveralThreads);
         return { std::move (sequence), builder.totalLatency };
     }
 
 private:
     //==============================================================================
     const Array<Node*> orderedNodes;
+    const bool buildingForSeveralThreads;
 
     struct AssignedBuffer
     {
         NodeAndChannel channel;
 
+        // The last step that reads the channel that this was last checked with
+        NodeAndChannel readersFoundFor { freeNodeID(), 0 };
+        int lastReader = -1;
+
         static AssignedBuffer createReadOnlyEmpty() noexcept    { return { { zeroNodeID(), 0 } }; }
         static AssignedBuffer createFree() noexcept             { return { { freeNodeID(), 0 } }; }
 
@@ -1058,71 +1841,59 @@ private:
     std::unordered_map<uint32, int> delays;
     int totalLatency = 0;
 
-    int getNodeDelay (NodeID nodeID) const noexcept
+    /*  The first and last place in the node order of the nodes that read an output. */
+    struct Readers
     {
-        const auto iter = delays.find (nodeID.uid);
-        return iter != delays.end() ? iter->second : 0;
-    }
+        int first = std::numeric_limits<int>::max(), last = -1;
+    };
 
-    int getInputLatencyForNode (const Connections& c, NodeID nodeID) const
-    {
-        const auto sources = c.getSourceNodesForDestination (nodeID);
-        return std::accumulate (sources.cbegin(), sources.cend(), 0, [this] (auto acc, auto source)
-        {
-            return jmax (acc, this->getNodeDelay (source));
-        });
-    }
+    std::map<NodeAndChannel, Readers> readersOfOutputs;
 
-    //==============================================================================
-    void getAllParentsOfNode (const NodeID& child,
-                              std::set<NodeID>& parents,
-                              const std::map<NodeID, std::set<NodeID>>& otherParents,
-                              const Connections& c)
+    /*  Works out where in the node order each output is read, so that finding whether a buffer
+        is still needed doesn't mean searching the connections of every node after it.
+    */
+    void findReadersOfOutputs (const Connections::DestinationsForSources& c)
     {
-        for (const auto& parentNode : c.getSourceNodesForDestination (child))
-        {
-            if (parentNode == child)
-                continue;
+        std::unordered_map<uint32, int> renderingIndices;
+
+        for (int i = 0; i < orderedNodes.size(); ++i)
+            renderingIndices[orderedNodes.getUnchecked (i)->nodeID.uid] = i;
 
-            if (parents.insert (parentNode).second)
+        c.forEachSource ([&] (const NodeAndChannel& source, const std::set<NodeAndChannel>& destinations)
+        {
+            for (const auto& destination : destinations)
             {
-                const auto parentParents = otherParents.find (parentNode);
+                const auto iter = renderingIndices.find (destination.nodeID.uid);
 
-                if (parentParents != otherParents.end())
-                {
-                    parents.insert (parentParents->second.begin(), parentParents->second.end());
+                if (iter == renderingIndices.end())
                     continue;
-                }
 
-                getAllParentsOfNode (parentNode, parents, otherParents, c);
+                auto& readers = readersOfOutputs[source];
+                readers.first = jmin (readers.first, iter->second);
+                readers.last  = jmax (readers.last,  iter->second);
             }
-        }
+        });
     }
 
-    Array<Node*> createOrderedNodeList (const Nodes& n, const Connections& c)
+    Readers getReaders (const NodeAndChannel& output) const
     {
-        Array<Node*> result;
+        const auto iter = readersOfOutputs.find (output);
+        return iter != readersOfOutputs.end() ? iter->second : Readers{};
+    }
 
-        std::map<NodeID, std::set<NodeID>> nodeParents;
+    int getNodeDelay (NodeID nodeID) const noexcept
+    {
+        const auto iter = delays.find (nodeID.uid);
+        return iter != delays.end() ? iter->second : 0;
+    }
 
-        for (auto& node : n.getNodes())
+    int getInputLatencyForNode (const Connections& c, NodeID nodeID) const
+    {
+        const auto sources = c.getSourceNodesForDestination (nodeID);
+        return std::accumulate (sources.cbegin(), sources.cend(), 0, [this] (auto acc, auto source)
         {
-            const auto nodeID = node->nodeID;
-            int insertionIndex = 0;
-
-            for (; insertionIndex < result.size(); ++insertionIndex)
-            {
-                auto& parents = nodeParents[result.getUnchecked (insertionIndex)->nodeID];
-
-                if (parents.find (nodeID) != parents.end())
-                    break;
-            }
-
-            result.insert (insertionIndex, node);
-            getAllParentsOfNode (nodeID, nodeParents[node->nodeID], nodeParents, c);
-        }
-
-        return result;
+            return jmax (acc, this->getNodeDelay (source));
+        });
     }
 
     //==============================================================================
@@ -1166,7 +1937,7 @@ private:
                 jassert (bufIndex >= 0);
             }
 
-            if (inputChan < numOuts && isBufferNeededLater (reversed, ourRenderingIndex, inputChan, src))
+            if (inputChan < numOuts && isBufferUsedByAnotherNode (reversed, ourRenderingIndex, inputChan, src))
             {
                 // can't mess up this channel because it's needed later by another node,
                 // so we need to use a copy of it..
@@ -1187,6 +1958,9 @@ private:
         int reusableInputIndex = -1;
         int bufIndex = -1;
 
+        // The buffers to add up, in order, once they've all been delayed
+        Array<int> buffersToMix;
+
         {
             auto i = 0;
             for (const auto& src : sources)
@@ -1197,13 +1971,14 @@ private:
                 {
                     // we've found one of our input chans that can be re-used..
                     reusableInputIndex = i;
-                    bufIndex = sourceBufIndex;
+                    bufIndex = getBufferToOverwrite (reversed, sequence, ourRenderingIndex, inputChan, src, sourceBufIndex);
 
                     auto nodeDelay = getNodeDelay (src.nodeID);
 
                     if (nodeDelay < maxLatency)
                         sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
 
+                    buffersToMix.add (bufIndex);
                     break;
                 }
 
@@ -1219,18 +1994,22 @@ private:
 
             audioBuffers.getReference (bufIndex).setAssignedToNonExistentNode();
 
-            auto srcIndex = getBufferContaining (*sources.begin());
-
-            if (srcIndex < 0)
-                sequence.addClearChannelOp (bufIndex);  // if not found, this is probably a feedback loop
-            else
-                sequence.addCopyChannelOp (srcIndex, bufIndex);
+            // if not found, this is probably a feedback loop, so it's mixed in as silence
+            auto srcIndex = jmax ((int) readOnlyEmptyBufferIndex, getBufferContaining (*sources.begin()));
 
             reusableInputIndex = 0;
             auto nodeDelay = getNodeDelay (sources.begin()->nodeID);
 
+            // The first source only needs copying on its own if its copy is to be delayed,
+            // otherwise the mix can start from the source itself
             if (nodeDelay < maxLatency)
+            {
+                sequence.addCopyChannelOp (srcIndex, bufIndex);
                 sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                srcIndex = bufIndex;
+            }
+
+            buffersToMix.add (srcIndex);
         }
 
         {
@@ -1247,20 +2026,22 @@ private:
 
                         if (nodeDelay < maxLatency)
                         {
-                            if (! isBufferNeededLater (reversed, ourRenderingIndex, inputChan, src))
+                            if (! isBufferUsedByAnotherNode (reversed, ourRenderingIndex, inputChan, src))
                             {
                                 sequence.addDelayChannelOp (srcIndex, maxLatency - nodeDelay);
                             }
                             else // buffer is reused elsewhere, can't be delayed
                             {
+                                // Each delayed copy is held until the mix, so it can't be handed out again
                                 auto bufferToDelay = getFreeBuffer (audioBuffers);
+                                audioBuffers.getReference (bufferToDelay).setAssignedToNonExistentNode();
                                 sequence.addCopyChannelOp (srcIndex, bufferToDelay);
                                 sequence.addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay);
                                 srcIndex = bufferToDelay;
                             }
                         }
 
-                        sequence.addAddChannelOp (srcIndex, bufIndex);
+                        buffersToMix.add (srcIndex);
                     }
                 }
 
@@ -1268,6 +2049,10 @@ private:
             }
         }
 
+        // All the adds are done by one op, which is nothing if the buffer already holds the mix
+        if (buffersToMix.size() > 1 || buffersToMix.getFirst() != bufIndex)
+            sequence.addMixChannelOp (buffersToMix, bufIndex);
+
         return bufIndex;
     }
 
@@ -1300,7 +2085,7 @@ private:
 
             if (midiBufferToUse >= 0)
             {
-                if (isBufferNeededLater (reversed, ourRenderingIndex, midiChannelIndex, src))
+                if (isBufferUsedByAnotherNode (reversed, ourRenderingIndex, midiChannelIndex, src))
                 {
                     // can't mess up this channel because it's needed later by another node, so we
                     // need to use a copy of it..
@@ -1333,7 +2118,7 @@ private:
                 {
                     // we've found one of our input buffers that can be re-used..
                     reusableInputIndex = i;
-                    midiBufferToUse = sourceBufIndex;
+                    midiBufferToUse = getBufferToOverwrite (reversed, sequence, ourRenderingIndex, midiChannelIndex, src, sourceBufIndex);
                     break;
                 }
 
@@ -1433,8 +2218,18 @@ private:
     }
 
     //==============================================================================
-    static int getFreeBuffer (Array<AssignedBuffer>& buffers)
+    int getFreeBuffer (Array<AssignedBuffer>& buffers) const
     {
+        // When building for several threads, nothing is ever freed, so every buffer is
+        // claimed as soon as it's handed out, even by a node that doesn't label it as
+        // one of its outputs
+        if (buildingForSeveralThreads)
+        {
+            buffers.add (AssignedBuffer::createFree());
+            buffers.getReference (buffers.size() - 1).setAssignedToNonExistentNode();
+            return buffers.size() - 1;
+        }
+
         for (int i = 1; i < buffers.size(); ++i)
             if (buffers.getReference (i).isFree())
                 return i;
@@ -1458,13 +2253,30 @@ private:
         return -1;
     }
 
-    void markAnyUnusedBuffersAsFree (const Connections::DestinationsForSources& c,
-                                     Array<AssignedBuffer>& buffers,
-                                     const int stepIndex)
+    void markAnyUnusedBuffersAsFree (Array<AssignedBuffer>& buffers, const int stepIndex)
     {
+        // Reusing a buffer would make its next user wait for its last one
+        if (buildingForSeveralThreads)
+            return;
+
         for (auto& b : buffers)
-            if (b.isAssigned() && ! isBufferNeededLater (c, stepIndex, -1, b.channel))
+        {
+            if (! b.isAssigned())
+                continue;
+
+            // Most buffers hold the same thing from one step to the next, so looking up the
+            // readers again every time would make this quadratic in the number of nodes
+            if (b.readersFoundFor != b.channel)
+            {
+                b.readersFoundFor = b.channel;
+                b.lastReader = getReaders (b.channel).last;
+            }
+
+            // Every node that's connected to the channel is one of its readers, so this is
+            // the same as asking isBufferNeededLater()
+            if (b.lastReader < stepIndex)
                 b.setFree();
+        }
     }
 
     bool isBufferNeededLater (const Connections::DestinationsForSources& c,
@@ -1482,30 +2294,77 @@ private:
             return true;
         }
 
-        return std::any_of (orderedNodes.begin() + stepIndexToSearchFrom + 1, orderedNodes.end(), [&] (const auto* node)
+        return getReaders (output).last > stepIndexToSearchFrom;
+    }
+
+    /*  Returns true if a node other than this one needs the given output, so this node can't
+        process it in place. Only later nodes matter to a sequence that renders nodes in order,
+        but when the nodes can run at the same time, so do earlier ones.
+    */
+    bool isBufferUsedByAnotherNode (const Connections::DestinationsForSources& c,
+                                    const int ourRenderingIndex,
+                                    const int inputChannelOfIndexToIgnore,
+                                    const NodeAndChannel output) const
+    {
+        if (isBufferNeededLater (c, ourRenderingIndex, inputChannelOfIndexToIgnore, output))
+            return true;
+
+        return buildingForSeveralThreads && getReaders (output).first < ourRenderingIndex;
+    }
+
+    /*  Returns the buffer that a node should mix its inputs into, given one that holds an input
+        which no later node needs. When the nodes can run at the same time, that input is copied
+        first if an earlier node reads it, which leaves the order of the mix unchanged.
+    */
+    template <typename RenderSequence>
+    int getBufferToOverwrite (const Connections::DestinationsForSources& c,
+                              RenderSequence& sequence,
+                              const int ourRenderingIndex,
+                              const int inputChannel,
+                              const NodeAndChannel output,
+                              const int bufferIndex)
+    {
+        if (! isBufferUsedByAnotherNode (c, ourRenderingIndex, inputChannel, output))
+            return bufferIndex;
+
+        if (output.isMIDI())
         {
-            return c.isSourceConnectedToDestinationNodeIgnoringChannel (output, node->nodeID, -1);
-        });
+            const auto copy = getFreeBuffer (midiBuffers);
+            sequence.addCopyMidiBufferOp (bufferIndex, copy);
+            return copy;
+        }
+
+        const auto copy = getFreeBuffer (audioBuffers);
+        sequence.addCopyChannelOp (bufferIndex, copy);
+        return copy;
     }
 
     template <typename RenderSequence>
-    RenderSequenceBuilder (const Nodes& n, const Connections& c, RenderSequence& sequence)
-        : orderedNodes (createOrderedNodeList (n, c))
+    RenderSequenceBuilder (const Nodes& n, const Connections& c, const NodeOrder& order, RenderSequence& sequence, bool forSeveralThreads)
+        : orderedNodes (order.getNodes (n)),
+          buildingForSeveralThreads (forSeveralThreads)
     {
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
 
+        if (buildingForSeveralThreads)
+            sequence.taskGraph = std::make_unique<RenderTaskGraph>();
+
         const auto reversed = c.getDestinationsForSources();
+        findReadersOfOutputs (reversed);
 
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode (c, reversed, sequence, *orderedNodes.getUnchecked (i), i);
-            markAnyUnusedBuffersAsFree (reversed, audioBuffers, i);
-            markAnyUnusedBuffersAsFree (reversed, midiBuffers, i);
+            markAnyUnusedBuffersAsFree (audioBuffers, i);
+            markAnyUnusedBuffersAsFree (midiBuffers, i);
         }
 
         sequence.numBuffersNeeded = audioBuffers.size();
         sequence.numMidiBuffersNeeded = midiBuffers.size();
+
+        if (sequence.taskGraph != nullptr)
+            sequence.taskGraph->finishBuilding();
     }
 };
 
@@ -1521,10 +2380,13 @@ class RenderSequence
 public:
     using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
 
-    RenderSequence (const PrepareSettings s, const Nodes& n, const Connections& c)
-        : RenderSequence (s, s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
-                                ? RenderSequenceBuilder::build<float>  (n, c)
-                                : RenderSequenceBuilder::build<double> (n, c))
+    RenderSequence (const PrepareSettings s, const Nodes& n, const Connections& c, const NodeOrder& order,
+                    std::shared_ptr<GraphRenderThreads> threads)
+        : RenderSequence (s,
+                          s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
+                              ? RenderSequenceBuilder::build<float>  (n, c, order, threads != nullptr)
+                              : RenderSequenceBuilder::build<double> (n, c, order, threads != nullptr),
+                          threads)
     {
     }
 
@@ -1549,10 +2411,10 @@ private:
         jassertfalse;
     }
 
-    RenderSequence (const PrepareSettings s, SequenceAndLatency&& built)
+    RenderSequence (const PrepareSettings s, SequenceAndLatency&& built, std::shared_ptr<GraphRenderThreads> threads)
         : settings (s), sequence (std::move (built))
     {
-        visitRenderSequence (*this, [&] (auto& seq) { seq.prepareBuffers (settings.blockSize); });
+        visitRenderSequence (*this, [&] (auto& seq) { seq.prepareBuffers (settings.blockSize, threads); });
     }
 
     PrepareSettings settings;
@@ -1911,6 +2773,25 @@ public:
     /*  Call from the audio thread only. */
     auto* getAudioThreadState() const { return renderSequenceExchange.getAudioThreadState(); }
 
+    void setNumRenderThreads (int numThreads)
+    {
+        numThreads = jmax (0, numThreads);
+
+        if (numThreads == getNumRenderThreads())
+            return;
+
+        // Any sequence that's still using the old threads keeps them going until it's replaced
+        renderThreads = numThreads > 0 ? std::make_shared<GraphRenderThreads> (numThreads) : nullptr;
+
+        lastBuiltSequence.reset();
+        rebuild (UpdateKind::sync);
+    }
+
+    int getNumRenderThreads() const noexcept
+    {
+        return renderThreads != nullptr ? renderThreads->getNumThreads() : 0;
+    }
+
 private:
     void setParentGraph (AudioProcessor* p) const
     {
@@ -1935,7 +2816,8 @@ private:
 
             if (std::exchange (lastBuiltSequence, newSignature) != newSignature)
             {
-                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections);
+                nodeOrder.update (nodes, connections);
+                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections, nodeOrder, renderThreads);
                 owner->setLatencySamples (sequence->getLatencySamples());
                 renderSequenceExchange.set (std::move (sequence));
             }
@@ -1950,10 +2832,12 @@ private:
     AudioProcessorGraph* owner = nullptr;
     Nodes nodes;
     Connections connections;
+    NodeOrder nodeOrder;
     NodeStates nodeStates;
     RenderSequenceExchange renderSequenceExchange;
     NodeID lastNodeID;
     std::optional<RenderSequenceSignature> lastBuiltSequence;
+    std::shared_ptr<GraphRenderThreads> renderThreads;
     LockingAsyncUpdater updater { [this] { handleAsyncUpdate(); } };
 };
 
@@ -1983,6 +2867,8 @@ void AudioProcessorGraph::releaseResources()
 bool AudioProcessorGraph::removeIllegalConnections (UpdateKind updateKind)                                  { return pimpl->removeIllegalConnections (updateKind); }
 void AudioProcessorGraph::rebuild()                                                                         { return pimpl->rebuild (UpdateKind::sync); }
 void AudioProcessorGraph::reset()                                                                           { return pimpl->reset(); }
+void AudioProcessorGraph::setNumRenderThreads (int numThreads)                                              { return pimpl->setNumRenderThreads (numThreads); }
+int AudioProcessorGraph::getNumRenderThreads() const noexcept                                               { return pimpl->getNumRenderThreads(); }
 bool AudioProcessorGraph::canConnect (const Connection& c) const                                            { return pimpl->canConnect (c); }
 bool AudioProcessorGraph::isConnected (const Connection& c) const noexcept                                  { return pimpl->isConnected (c); }
 bool AudioProcessorGraph::isConnected (NodeID a, NodeID b) const noexcept                                   { return pimpl->isConnected (a, b); }
@@ -2303,9 +3189,337 @@ public:
             // this graph, so we just want to make sure that we finish the test without timing out.
             logMessage ("render sequence built in " + String (duration) + " ms");
         }
+
+        beginTest ("an input fed by several sources receives their sum");
+        {
+            using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+            const auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+            const auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+
+            // Three pass-through nodes, and the input itself, all mixed into the output
+            for (int i = 0; i < 3; ++i)
+            {
+                const auto node = graph.addNode (BasicProcessor::make (BasicProcessor::getStereoProperties(), MidiIn::no, MidiOut::no))->nodeID;
+
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    expect (graph.addConnection ({ { audioIn, channel }, { node, channel } }));
+                    expect (graph.addConnection ({ { node, channel }, { audioOut, channel } }));
+                }
+            }
+
+            for (int channel = 0; channel < 2; ++channel)
+                expect (graph.addConnection ({ { audioIn, channel }, { audioOut, channel } }));
+
+            graph.prepareToPlay (44100.0, 512);
+
+            AudioBuffer<float> buffer (2, 512);
+            Random random (1);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (channel, i, random.nextFloat() - 0.5f);
+
+            AudioBuffer<float> input (buffer);
+            MidiBuffer midi;
+            graph.processBlock (buffer, midi);
+
+            auto matches = true;
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    const auto x = input.getSample (channel, i);
+                    matches = matches && exactlyEqual (buffer.getSample (channel, i), ((x + x) + x) + x);
+                }
+            }
+
+            expect (matches);
+        }
+
+        beginTest ("an output node that's bypassed or suspended leaves the output silent");
+        {
+            using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+
+            const auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+            const auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode));
+
+            for (int channel = 0; channel < 2; ++channel)
+                expect (graph.addConnection ({ { audioIn, channel }, { audioOut->nodeID, channel } }));
+
+            graph.prepareToPlay (44100.0, 512);
+
+            AudioBuffer<float> buffer (2, 512);
+            MidiBuffer midi;
+
+            const auto render = [&]
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    FloatVectorOperations::fill (buffer.getWritePointer (channel), 0.5f, buffer.getNumSamples());
+
+                graph.processBlock (buffer, midi);
+            };
+
+            render();
+            expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.5f);
+
+            audioOut->setBypassed (true);
+            render();
+            expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+
+            audioOut->setBypassed (false);
+            audioOut->getProcessor()->suspendProcessing (true);
+            render();
+            expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+        }
+
+        beginTest ("a graph renders the same after an edit that reorders its nodes as when built that way");
+        {
+            using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+            using NodeID = AudioProcessorGraph::NodeID;
+
+            constexpr auto numNodes = 8;
+
+            struct Chain
+            {
+                AudioProcessorGraph graph;
+                NodeID audioIn, audioOut;
+                std::vector<NodeID> nodes;
+
+                Chain()
+                {
+                    graph.setPlayConfigDetails (2, 2, 44100.0, 512);
+                    audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+                    audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+
+                    for (int i = 0; i < numNodes; ++i)
+                        nodes.push_back (graph.addNode (std::make_unique<StatefulProcessor> (i))->nodeID);
+                }
+
+                // Connects the nodes one after another, in the given order
+                void connect (const std::vector<NodeID>& order)
+                {
+                    for (const auto& node : nodes)
+                        graph.disconnectNode (node);
+
+                    auto previous = audioIn;
+
+                    for (const auto& node : order)
+                    {
+                        for (int channel = 0; channel < 2; ++channel)
+                            graph.addConnection ({ { previous, channel }, { node, channel } });
+
+                        previous = node;
+                    }
+
+                    for (int channel = 0; channel < 2; ++channel)
+                        graph.addConnection ({ { previous, channel }, { audioOut, channel } });
+                }
+
+                std::vector<float> render()
+                {
+                    AudioBuffer<float> buffer (2, 512);
+                    Random random (1);
+
+                    for (int channel = 0; channel < 2; ++channel)
+                        for (int i = 0; i < buffer.getNumSamples(); ++i)
+                            buffer.setSample (channel, i, random.nextFloat() - 0.5f);
+
+                    MidiBuffer midi;
+                    graph.processBlock (buffer, midi);
+
+                    return { buffer.getReadPointer (0), buffer.getReadPointer (0) + buffer.getNumSamples() };
+                }
+            };
+
+            Chain edited, built;
+
+            // The edit turns the chain around, so that every node has to move
+            edited.connect (edited.nodes);
+            edited.graph.prepareToPlay (44100.0, 512);
+            edited.connect ({ edited.nodes.rbegin(), edited.nodes.rend() });
+            edited.graph.rebuild();
+
+            built.connect ({ built.nodes.rbegin(), built.nodes.rend() });
+            built.graph.prepareToPlay (44100.0, 512);
+
+            expectEquals (edited.graph.getLatencySamples(), built.graph.getLatencySamples());
+            expect (edited.render() == built.render());
+        }
+
+        beginTest ("rendering on several threads gives the same result as rendering on one");
+        {
+            for (const auto seed : { 1, 2, 3 })
+            {
+                const auto expected = renderRandomGraph (seed, 0);
+
+                for (const auto numThreads : { 1, 3, 8 })
+                {
+                    const auto result = renderRandomGraph (seed, numThreads);
+                    expect (result.audio == expected.audio);
+                    expect (result.midi == expected.midi);
+                }
+            }
+        }
+
+        beginTest ("the number of render threads can change while the graph is prepared");
+        {
+            AudioProcessorGraph graph;
+            graph.prepareToPlay (44100.0, 512);
+
+            graph.setNumRenderThreads (4);
+            expectEquals (graph.getNumRenderThreads(), 4);
+
+            graph.setNumRenderThreads (0);
+            expectEquals (graph.getNumRenderThreads(), 0);
+        }
     }
 
 private:
+    struct RenderedOutput
+    {
+        std::vector<float> audio;
+        std::vector<int> midi;
+    };
+
+    /*  Builds a graph of stateful nodes with random connections, including mixes of several
+        sources, nodes with latency and MIDI, and renders some random input through it.
+    */
+    static RenderedOutput renderRandomGraph (int seed, int numThreads)
+    {
+        constexpr auto numNodes = 24;
+        constexpr auto blockSize = 256;
+        constexpr auto numBlocks = 16;
+
+        Random random (seed);
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, 44100.0, blockSize);
+        graph.setNumRenderThreads (numThreads);
+
+        using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+        const auto midiChannelIndex = AudioProcessorGraph::midiChannelIndex;
+        const auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+        const auto midiIn   = graph.addNode (std::make_unique<IO> (IO::midiInputNode))->nodeID;
+        const auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+        const auto midiOut  = graph.addNode (std::make_unique<IO> (IO::midiOutputNode))->nodeID;
+
+        std::vector<AudioProcessorGraph::NodeID> sources { audioIn };
+        std::vector<AudioProcessorGraph::NodeID> midiSources { midiIn };
+
+        for (int i = 0; i < numNodes; ++i)
+        {
+            const auto node = graph.addNode (std::make_unique<StatefulProcessor> (random.nextInt (3) == 0 ? random.nextInt (64) : 0))->nodeID;
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int n = 1 + random.nextInt (3); --n >= 0;)
+                    graph.addConnection ({ { sources[(size_t) random.nextInt ((int) sources.size())], random.nextInt (2) }, { node, channel } });
+
+            if (random.nextBool())
+                graph.addConnection ({ { midiSources[(size_t) random.nextInt ((int) midiSources.size())], midiChannelIndex },
+                                       { node, midiChannelIndex } });
+
+            sources.push_back (node);
+            midiSources.push_back (node);
+        }
+
+        for (int n = 0; n < 6; ++n)
+        {
+            graph.addConnection ({ { sources[(size_t) (1 + random.nextInt (numNodes))], n % 2 }, { audioOut, n % 2 } });
+            graph.addConnection ({ { midiSources[(size_t) (1 + random.nextInt (numNodes))], midiChannelIndex },
+                                   { midiOut, midiChannelIndex } });
+        }
+
+        graph.prepareToPlay (44100.0, blockSize);
+
+        RenderedOutput output;
+        AudioBuffer<float> buffer (2, blockSize);
+        MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+            midi.clear();
+            midi.addEvent (MidiMessage::noteOn (1, random.nextInt (128), (uint8) 100), random.nextInt (blockSize));
+
+            graph.processBlock (buffer, midi);
+
+            for (int channel = 0; channel < 2; ++channel)
+                output.audio.insert (output.audio.end(), buffer.getReadPointer (channel), buffer.getReadPointer (channel) + blockSize);
+
+            for (const auto metadata : midi)
+            {
+                output.midi.push_back (metadata.samplePosition);
+                output.midi.push_back (metadata.getMessage().getNoteNumber());
+            }
+        }
+
+        return output;
+    }
+
+    /*  A stereo node whose output depends on its whole history, which adds a note of its own to
+        the MIDI that passes through it.
+    */
+    class StatefulProcessor final : public AudioProcessor
+    {
+    public:
+        explicit StatefulProcessor (int latency)
+            : AudioProcessor (BusesProperties().withInput  ("in",  AudioChannelSet::stereo())
+                                               .withOutput ("out", AudioChannelSet::stereo()))
+        {
+            setLatencySamples (latency);
+        }
+
+        const String getName() const override                         { return "Stateful Processor"; }
+        double getTailLengthSeconds() const override                  { return {}; }
+        bool acceptsMidi() const override                             { return true; }
+        bool producesMidi() const override                            { return true; }
+        AudioProcessorEditor* createEditor() override                 { return {}; }
+        bool hasEditor() const override                               { return {}; }
+        int getNumPrograms() override                                 { return 1; }
+        int getCurrentProgram() override                              { return {}; }
+        void setCurrentProgram (int) override                         {}
+        const String getProgramName (int) override                    { return {}; }
+        void changeProgramName (int, const String&) override          {}
+        void getStateInformation (juce::MemoryBlock&) override        {}
+        void setStateInformation (const void*, int) override          {}
+        void prepareToPlay (double, int) override                     {}
+        void releaseResources() override                              {}
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi) override
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                auto* samples = buffer.getWritePointer (channel);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    state[channel] = state[channel] * 0.9f + samples[i] * 0.7f;
+                    samples[i] = std::tanh (state[channel]);
+                }
+            }
+
+            midi.addEvent (MidiMessage::noteOn (1, getLatencySamples() % 128, (uint8) 1), numBlocks++ % buffer.getNumSamples());
+        }
+
+        using AudioProcessor::processBlock;
+
+    private:
+        float state[2] {};
+        int numBlocks = 0;
+    };
+
     enum class MidiIn  { no, yes };
     enum class MidiOut { no, yes };
 
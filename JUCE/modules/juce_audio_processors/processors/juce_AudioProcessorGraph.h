@@ -332,6 +332,38 @@ public:
     */
     void rebuild();
 
+    //==============================================================================
+    /** Spreads the processing of each block across a pool of threads.
+
+        By default, the graph processes its nodes one at a time, on whichever thread calls
+        processBlock. With one or more render threads, the graph works out which nodes don't
+        depend on each other, and that thread and the render threads process them at the same
+        time. The output is identical either way, as long as each node writes all of its output
+        channels.
+
+        The render threads are real-time threads where the platform allows it, and are started
+        here rather than when processing starts. If there are more CPU cores than render threads,
+        they spin for a couple of milliseconds between blocks before going to sleep, so that
+        they're ready for the next block as soon as it arrives. That costs CPU time, so only use
+        as many as the graph has parallel work for.
+
+        The graph takes more buffers to render this way, because it avoids reusing them
+        between nodes that could otherwise run at the same time.
+
+        Call this from the message thread. The graph is rebuilt to use the new number of threads.
+
+        @param numThreads   the number of extra threads to use, or 0 to process everything on the
+                            calling thread
+    */
+    void setNumRenderThreads (int numThreads);
+
+    /** Returns the number of render threads that the graph uses, in addition to the thread
+        that calls processBlock.
+
+        @see setNumRenderThreads
+    */
+    int getNumRenderThreads() const noexcept;
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
@@ -107,6 +107,7 @@
  #include <sys/time.h>
  #include <net/if.h>
  #include <sys/ioctl.h>
+ #include <semaphore.h>
 
  #if ! (JUCE_ANDROID || JUCE_WASM)
   #include <execinfo.h>
@@ -277,6 +278,7 @@
 #include "native/juce_AndroidDocument_android.cpp"
 #include "threads/juce_HighResolutionTimer.cpp"
 #include "threads/juce_WaitableEvent.cpp"
+#include "threads/juce_LightweightSemaphore.cpp"
 #include "network/juce_URL.cpp"
 
 #if ! JUCE_WASM
@@ -296,6 +298,7 @@
  #include "containers/juce_FixedSizeFunction_test.cpp"
  #include "json/juce_JSONSerialisation_test.cpp"
  #include "memory/juce_SharedResourcePointer_test.cpp"
+ #include "threads/juce_LightweightSemaphore_test.cpp"
  #include "text/juce_CharPointer_UTF8_test.cpp"
  #include "text/juce_CharPointer_UTF16_test.cpp"
  #include "text/juce_CharPointer_UTF32_test.cpp"
@@ -37,7 +37,7 @@
 namespace juce
 {
 
-static AllocationHooks& getAllocationHooksForThread()
+AllocationHooks& getAllocationHooksForThread()
 {
     thread_local AllocationHooks hooks;
     return hooks;
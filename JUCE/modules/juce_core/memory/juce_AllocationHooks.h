@@ -54,6 +54,16 @@ private:
     LightweightListenerList<Listener> listenerList;
 };
 
+/** Returns the AllocationHooks that are notified about new/delete calls made on
+    the calling thread.
+
+    Add a Listener to this if you need more than UnitTestAllocationChecker offers,
+    for example to capture a stack trace at the point where an allocation happens.
+    Each thread has its own set of hooks, so a listener will only hear about calls
+    made on the thread that registered it.
+*/
+AllocationHooks& getAllocationHooksForThread();
+
 //==============================================================================
 /** Scoped checker which will cause a unit test failure if any new/delete calls
     are made during the lifetime of the UnitTestAllocationChecker.
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_WINDOWS
+struct LightweightSemaphore::NativeSemaphore
+{
+    NativeSemaphore()   : handle (CreateSemaphoreW (nullptr, 0, MAXLONG, nullptr)) {}
+    ~NativeSemaphore()  { CloseHandle (handle); }
+
+    void post (int count) noexcept  { ReleaseSemaphore (handle, (LONG) count, nullptr); }
+    void wait() noexcept            { WaitForSingleObject (handle, INFINITE); }
+
+    HANDLE handle;
+};
+#elif JUCE_MAC || JUCE_IOS
+// Unnamed POSIX semaphores aren't supported on Apple platforms, but Mach ones are
+struct LightweightSemaphore::NativeSemaphore
+{
+    NativeSemaphore()   { semaphore_create (mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0); }
+    ~NativeSemaphore()  { semaphore_destroy (mach_task_self(), semaphore); }
+
+    void post (int count) noexcept
+    {
+        for (int i = 0; i < count; ++i)
+            semaphore_signal (semaphore);
+    }
+
+    void wait() noexcept
+    {
+        while (semaphore_wait (semaphore) == KERN_ABORTED) {}
+    }
+
+    semaphore_t semaphore;
+};
+#else
+struct LightweightSemaphore::NativeSemaphore
+{
+    NativeSemaphore()   { sem_init (&semaphore, 0, 0); }
+    ~NativeSemaphore()  { sem_destroy (&semaphore); }
+
+    void post (int count) noexcept
+    {
+        for (int i = 0; i < count; ++i)
+            sem_post (&semaphore);
+    }
+
+    void wait() noexcept
+    {
+        while (sem_wait (&semaphore) != 0 && errno == EINTR) {}
+    }
+
+    sem_t semaphore;
+};
+#endif
+
+//==============================================================================
+LightweightSemaphore::LightweightSemaphore (int initialCount)
+    : count (initialCount),
+      native (std::make_unique<NativeSemaphore>())
+{
+    jassert (initialCount >= 0);
+}
+
+LightweightSemaphore::~LightweightSemaphore()
+{
+    jassert (count.load() >= 0);
+}
+
+void LightweightSemaphore::signal (int numToAdd) noexcept
+{
+    jassert (numToAdd >= 0);
+
+    const auto previous = count.fetch_add (numToAdd, std::memory_order_release);
+    const auto numToWake = jmin (-previous, numToAdd);
+
+    if (numToWake > 0)
+        native->post (numToWake);
+}
+
+bool LightweightSemaphore::tryWait() noexcept
+{
+    for (auto current = count.load (std::memory_order_relaxed); current > 0;)
+        if (count.compare_exchange_weak (current, current - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+
+    return false;
+}
+
+void LightweightSemaphore::wait() noexcept
+{
+    if (count.fetch_sub (1, std::memory_order_acquire) <= 0)
+        native->wait();
+}
+
+} // namespace juce
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A counting semaphore whose signal() can be called from a real-time thread.
+
+    The count is kept in an atomic, so signal() and tryWait() never take a lock.
+    A thread that calls wait() when the count is zero sleeps on a semaphore
+    provided by the OS, which signal() only posts to when a thread is actually
+    asleep. Posting to it is a single system call that doesn't take a lock
+    either, unlike WaitableEvent::signal(), which locks a mutex.
+
+    wait() doesn't spin first, as a spinning real-time thread can keep others
+    off its core. Threads that should spin can call tryWait() in a loop.
+
+    @tags{Core}
+*/
+class JUCE_API  LightweightSemaphore
+{
+public:
+    //==============================================================================
+    /** Creates a semaphore with the given count. */
+    explicit LightweightSemaphore (int initialCount = 0);
+
+    /** Destructor. No threads may be waiting on the semaphore when it's deleted. */
+    ~LightweightSemaphore();
+
+    //==============================================================================
+    /** Adds to the count, waking up to that many of the threads that are waiting. */
+    void signal (int count = 1) noexcept;
+
+    /** Takes one from the count, first waiting for it to be above zero if it isn't. */
+    void wait() noexcept;
+
+    /** Takes one from the count if it's above zero, without waiting.
+
+        @returns    true if the count was taken from.
+    */
+    bool tryWait() noexcept;
+
+private:
+    //==============================================================================
+    struct NativeSemaphore;
+
+    // Negative when threads are asleep in wait(), in which case it's minus the number of them
+    std::atomic<int> count;
+    std::unique_ptr<NativeSemaphore> native;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LightweightSemaphore)
+};
+
+} // namespace juce
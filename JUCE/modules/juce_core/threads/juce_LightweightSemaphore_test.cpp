@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class LightweightSemaphoreTests final : public UnitTest
+{
+public:
+    LightweightSemaphoreTests()
+        : UnitTest ("LightweightSemaphore", UnitTestCategories::threads) {}
+
+    void runTest() final
+    {
+        beginTest ("Signals are counted");
+        {
+            LightweightSemaphore semaphore (1);
+            expect (semaphore.tryWait());
+            expect (! semaphore.tryWait());
+
+            semaphore.signal (3);
+            expect (semaphore.tryWait());
+            expect (semaphore.tryWait());
+            expect (semaphore.tryWait());
+            expect (! semaphore.tryWait());
+        }
+
+        beginTest ("A signal before the wait isn't lost");
+        {
+            LightweightSemaphore semaphore;
+            semaphore.signal();
+            semaphore.wait();
+            expect (! semaphore.tryWait());
+        }
+
+        beginTest ("Every waiting thread is woken");
+        {
+            constexpr int numThreads = 4, numWakeUps = 1000;
+
+            LightweightSemaphore semaphore;
+            std::atomic<int> numWoken { 0 };
+            std::vector<std::thread> threads;
+
+            for (int i = 0; i < numThreads; ++i)
+            {
+                threads.emplace_back ([&]
+                {
+                    for (int j = 0; j < numWakeUps; ++j)
+                    {
+                        semaphore.wait();
+                        ++numWoken;
+                    }
+                });
+            }
+
+            // Some of these arrive while the threads are asleep, and some while they're spinning
+            for (int i = 0; i < numThreads * numWakeUps; ++i)
+            {
+                semaphore.signal();
+
+                if (i % 100 == 0)
+                    Thread::sleep (1);
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            expectEquals (numWoken.load(), numThreads * numWakeUps);
+            expect (! semaphore.tryWait());
+        }
+    }
+};
+
+static LightweightSemaphoreTests lightweightSemaphoreTests;
+
+} // namespace juce
@@ -155,59 +155,63 @@ ConvolutionMessageQueue& ConvolutionMessageQueue::operator= (ConvolutionMessageQ
 //==============================================================================
 struct ConvolutionEngine
 {
-    ConvolutionEngine (const float* samples,
-                       size_t numSamples,
-                       size_t maxBlockSize)
-        : blockSize ((size_t) nextPowerOfTwo ((int) maxBlockSize)),
-          fftSize (blockSize > 128 ? 2 * blockSize : 4 * blockSize),
-          fftObject (std::make_unique<FFT> (roundToInt (std::log2 (fftSize)))),
-          numSegments (numSamples / (fftSize - blockSize) + 1u),
-          numInputSegments ((blockSize > 128 ? numSegments : 3 * numSegments)),
-          bufferInput      (1, static_cast<int> (fftSize)),
-          bufferOutput     (1, static_cast<int> (fftSize * 2)),
-          bufferTempOutput (1, static_cast<int> (fftSize * 2)),
-          bufferOverlap    (1, static_cast<int> (fftSize))
+    // The spectra of an IR's segments, which never change once they're made, so
+    // they can be shared by any number of engines.
+    struct Partitions
     {
-        bufferOutput.clear();
-
-        auto updateSegmentsIfNecessary = [this] (size_t numSegmentsToUpdate,
-                                                 std::vector<AudioBuffer<float>>& segments)
+        Partitions (const float* samples,
+                    size_t numSamples,
+                    size_t maxBlockSize)
+            : blockSize ((size_t) nextPowerOfTwo ((int) maxBlockSize)),
+              fftSize (blockSize > 128 ? 2 * blockSize : 4 * blockSize)
         {
-            if (numSegmentsToUpdate == 0
-                || numSegmentsToUpdate != (size_t) segments.size()
-                || (size_t) segments[0].getNumSamples() != fftSize * 2)
-            {
-                segments.clear();
+            const auto numSegments = numSamples / (fftSize - blockSize) + 1u;
 
-                for (size_t i = 0; i < numSegmentsToUpdate; ++i)
-                    segments.push_back ({ 1, static_cast<int> (fftSize * 2) });
-            }
-        };
+            FFT fftObject (roundToInt (std::log2 (fftSize)));
+            size_t currentPtr = 0;
 
-        updateSegmentsIfNecessary (numInputSegments, buffersInputSegments);
-        updateSegmentsIfNecessary (numSegments,      buffersImpulseSegments);
+            for (size_t i = 0; i < numSegments; ++i)
+            {
+                auto& buf = segments.emplace_back (1, static_cast<int> (fftSize * 2));
+                buf.clear();
 
-        auto FFTTempObject = std::make_unique<FFT> (roundToInt (std::log2 (fftSize)));
-        size_t currentPtr = 0;
+                auto* impulseResponse = buf.getWritePointer (0);
 
-        for (auto& buf : buffersImpulseSegments)
-        {
-            buf.clear();
+                if (i == 0)
+                    impulseResponse[0] = 1.0f;
 
-            auto* impulseResponse = buf.getWritePointer (0);
+                FloatVectorOperations::copy (impulseResponse,
+                                             samples + currentPtr,
+                                             static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
 
-            if (&buf == &buffersImpulseSegments.front())
-                impulseResponse[0] = 1.0f;
+                fftObject.performRealOnlyForwardTransform (impulseResponse);
+                prepareForConvolution (impulseResponse, fftSize);
 
-            FloatVectorOperations::copy (impulseResponse,
-                                         samples + currentPtr,
-                                         static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
+                currentPtr += (fftSize - blockSize);
+            }
+        }
 
-            FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
-            prepareForConvolution (impulseResponse);
+        const size_t blockSize;
+        const size_t fftSize;
+        std::vector<AudioBuffer<float>> segments;
+    };
 
-            currentPtr += (fftSize - blockSize);
-        }
+    explicit ConvolutionEngine (std::shared_ptr<const Partitions> partitionsIn)
+        : partitions (std::move (partitionsIn)),
+          blockSize (partitions->blockSize),
+          fftSize (partitions->fftSize),
+          fftObject (std::make_unique<FFT> (roundToInt (std::log2 (fftSize)))),
+          numSegments (partitions->segments.size()),
+          numInputSegments ((blockSize > 128 ? numSegments : 3 * numSegments)),
+          bufferInput      (1, static_cast<int> (fftSize)),
+          bufferOutput     (1, static_cast<int> (fftSize * 2)),
+          bufferTempOutput (1, static_cast<int> (fftSize * 2)),
+          bufferOverlap    (1, static_cast<int> (fftSize))
+    {
+        bufferOutput.clear();
+
+        for (size_t i = 0; i < numInputSegments; ++i)
+            buffersInputSegments.push_back ({ 1, static_cast<int> (fftSize * 2) });
 
         reset();
     }
@@ -249,7 +253,7 @@ struct ConvolutionEngine
             FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
             fftObject->performRealOnlyForwardTransform (inputSegmentData);
-            prepareForConvolution (inputSegmentData);
+            prepareForConvolution (inputSegmentData, fftSize);
 
             // Complex multiplication
             if (inputDataWasEmpty)
@@ -266,7 +270,7 @@ struct ConvolutionEngine
                         index -= numInputSegments;
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                        buffersImpulseSegments[i].getWritePointer (0),
+                                                        partitions->segments[i].getReadPointer (0),
                                                         outputTempData);
                 }
             }
@@ -274,7 +278,7 @@ struct ConvolutionEngine
             FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
             convolutionProcessingAndAccumulate (inputSegmentData,
-                                                buffersImpulseSegments.front().getWritePointer (0),
+                                                partitions->segments.front().getReadPointer (0),
                                                 outputData);
 
             updateSymmetricFrequencyDomainData (outputData);
@@ -311,12 +315,8 @@ struct ConvolutionEngine
         // Overlap-add, zero latency convolution algorithm with uniform partitioning
         size_t numSamplesProcessed = 0;
 
-        auto indexStep = numInputSegments / numSegments;
-
-        auto* inputData      = bufferInput.getWritePointer (0);
-        auto* outputTempData = bufferTempOutput.getWritePointer (0);
-        auto* outputData     = bufferOutput.getWritePointer (0);
-        auto* overlapData    = bufferOverlap.getWritePointer (0);
+        auto* inputData  = bufferInput.getWritePointer (0);
+        auto* outputData = bufferOutput.getWritePointer (0);
 
         while (numSamplesProcessed < numSamples)
         {
@@ -332,60 +332,84 @@ struct ConvolutionEngine
             // processing itself when needed (with latency)
             if (inputDataPos == blockSize)
             {
-                // Copy input data in input segment
-                auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer (0);
-                FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
+                convolveInputBlock();
+                inputDataPos = 0;
+            }
+        }
+    }
 
-                fftObject->performRealOnlyForwardTransform (inputSegmentData);
-                prepareForConvolution (inputSegmentData);
+    // Convolves a whole block at once, and returns the block's own output, rather
+    // than the previous block's as processSamplesWithAddedLatency() does. This
+    // lets the convolution run on another thread, whose results arrive a block later.
+    void processBlockWithAddedLatency (const float* input, float* output)
+    {
+        jassert (inputDataPos == 0);
 
-                // Complex multiplication
-                FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+        FloatVectorOperations::copy (bufferInput.getWritePointer (0), input, static_cast<int> (blockSize));
+        convolveInputBlock();
+        FloatVectorOperations::copy (output, bufferOutput.getReadPointer (0), static_cast<int> (blockSize));
+    }
 
-                auto index = currentSegment;
+    // Convolves the full input buffer, leaving the result at the start of the output buffer.
+    void convolveInputBlock()
+    {
+        auto indexStep = numInputSegments / numSegments;
 
-                for (size_t i = 1; i < numSegments; ++i)
-                {
-                    index += indexStep;
+        auto* inputData      = bufferInput.getWritePointer (0);
+        auto* outputTempData = bufferTempOutput.getWritePointer (0);
+        auto* outputData     = bufferOutput.getWritePointer (0);
+        auto* overlapData    = bufferOverlap.getWritePointer (0);
 
-                    if (index >= numInputSegments)
-                        index -= numInputSegments;
+        // Copy input data in input segment
+        auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer (0);
+        FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
-                    convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                        buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
-                }
+        fftObject->performRealOnlyForwardTransform (inputSegmentData);
+        prepareForConvolution (inputSegmentData, fftSize);
 
-                FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
+        // Complex multiplication
+        FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
 
-                convolutionProcessingAndAccumulate (inputSegmentData,
-                                                    buffersImpulseSegments.front().getWritePointer (0),
-                                                    outputData);
+        auto index = currentSegment;
 
-                updateSymmetricFrequencyDomainData (outputData);
-                fftObject->performRealOnlyInverseTransform (outputData);
+        for (size_t i = 1; i < numSegments; ++i)
+        {
+            index += indexStep;
 
-                // Add overlap
-                FloatVectorOperations::add (outputData, overlapData, static_cast<int> (blockSize));
+            if (index >= numInputSegments)
+                index -= numInputSegments;
 
-                // Input buffer is empty again now
-                FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
+            convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
+                                                partitions->segments[i].getReadPointer (0),
+                                                outputTempData);
+        }
 
-                // Extra step for segSize > blockSize
-                FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+        FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
-                // Save the overlap
-                FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+        convolutionProcessingAndAccumulate (inputSegmentData,
+                                            partitions->segments.front().getReadPointer (0),
+                                            outputData);
 
-                currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
+        updateSymmetricFrequencyDomainData (outputData);
+        fftObject->performRealOnlyInverseTransform (outputData);
 
-                inputDataPos = 0;
-            }
-        }
+        // Add overlap
+        FloatVectorOperations::add (outputData, overlapData, static_cast<int> (blockSize));
+
+        // Input buffer is empty again now
+        FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
+
+        // Extra step for segSize > blockSize
+        FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+
+        // Save the overlap
+        FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+
+        currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
     }
 
     // After each FFT, this function is called to allow convolution to be performed with only 4 SIMD functions calls.
-    void prepareForConvolution (float *samples) noexcept
+    static void prepareForConvolution (float *samples, size_t fftSize) noexcept
     {
         auto FFTSizeDiv2 = fftSize / 2;
 
@@ -435,6 +459,7 @@ struct ConvolutionEngine
     }
 
     //==============================================================================
+    const std::shared_ptr<const Partitions> partitions;
     const size_t blockSize;
     const size_t fftSize;
     const std::unique_ptr<FFT> fftObject;
@@ -443,53 +468,376 @@ struct ConvolutionEngine
     size_t currentSegment = 0, inputDataPos = 0;
 
     AudioBuffer<float> bufferInput, bufferOutput, bufferTempOutput, bufferOverlap;
-    std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
+    std::vector<AudioBuffer<float>> buffersInputSegments;
+};
+
+//==============================================================================
+// Runs the tails of the non-uniform convolutions that process them in the
+// background. A single pool is shared by every such convolution in the process.
+class BackgroundTailThreadPool
+{
+public:
+    // A piece of work which can be claimed by whichever thread gets to it first.
+    struct Job
+    {
+        virtual ~Job() = default;
+
+        // Returns true if the job was waiting to run, in which case the caller
+        // must run it.
+        virtual bool tryToClaim() noexcept = 0;
+        virtual void run() noexcept = 0;
+    };
+
+    BackgroundTailThreadPool()
+    {
+        const auto numThreads = jlimit (1, 4, SystemStats::getNumCpus() - 1);
+
+        for (auto i = 0; i < numThreads; ++i)
+        {
+            workers.add (new Worker (*this));
+            workers.getLast()->startThread (Thread::Priority::high);
+        }
+    }
+
+    ~BackgroundTailThreadPool()
+    {
+        for (auto* worker : workers)
+            worker->signalThreadShouldExit();
+
+        wakeUp.signal (workers.size());
+
+        for (auto* worker : workers)
+            worker->waitForThreadToExit (-1);
+    }
+
+    void addJob (Job& job)
+    {
+        const ScopedWriteLock lock (jobsLock);
+        jobs.add (&job);
+    }
+
+    // Once this returns, none of the workers is running the job, or will run it.
+    void removeJob (Job& job)
+    {
+        const ScopedWriteLock lock (jobsLock);
+        jobs.removeFirstMatchingValue (&job);
+    }
+
+    // Wakes a worker to look for jobs that are waiting to run. This doesn't take
+    // a lock, so the audio thread can call it.
+    void notify() noexcept
+    {
+        wakeUp.signal();
+    }
+
+private:
+    struct Worker final : public Thread
+    {
+        explicit Worker (BackgroundTailThreadPool& p)
+            : Thread ("Convolution tail"), pool (p) {}
+
+        void run() override
+        {
+            for (;;)
+            {
+                pool.wakeUp.wait();
+
+                if (threadShouldExit())
+                    return;
+
+                pool.runPendingJobs();
+            }
+        }
+
+        BackgroundTailThreadPool& pool;
+    };
+
+    void runPendingJobs()
+    {
+        const ScopedReadLock lock (jobsLock);
+
+        for (auto foundJob = true; foundJob;)
+        {
+            foundJob = false;
+
+            for (auto* job : jobs)
+            {
+                if (job->tryToClaim())
+                {
+                    // There may be more jobs waiting, which another worker could run in the meantime
+                    wakeUp.signal();
+
+                    job->run();
+                    foundJob = true;
+                }
+            }
+        }
+    }
+
+    LightweightSemaphore wakeUp;
+    ReadWriteLock jobsLock;
+    Array<Job*> jobs;
+    OwnedArray<Worker> workers;
+};
+
+// Convolves one channel's tail a whole block at a time on the thread pool, so the
+// output for each block of input arrives two blocks later than it would from
+// ConvolutionEngine::processSamplesWithAddedLatency.
+//
+// The audio thread collects a block of input and hands it over by bumping a
+// counter, then notifies the pool, neither of which takes a lock. In return it
+// takes the output of the block it handed over the time before last, so a
+// worker has had two whole blocks' worth of time to convolve it. The blocks
+// are convolved one at a time, in the order they were handed over.
+//
+// If the output still isn't ready, the audio thread has to wait for it, so that it's
+// the same however long the workers take. If no worker has started on that
+// block, the audio thread convolves it itself, which costs a forward and an
+// inverse FFT of twice the block size and a complex multiply-add for each of
+// the tail's partitions. If a worker is partway through it, the audio thread
+// yields until it's done.
+class BackgroundTail final : public BackgroundTailThreadPool::Job
+{
+public:
+    explicit BackgroundTail (std::shared_ptr<const ConvolutionEngine::Partitions> partitions)
+        : engine (std::move (partitions)),
+          buffers (numBuffers * engine.blockSize, true)
+    {
+    }
+
+    bool tryToClaim() noexcept override
+    {
+        if (! isBlockWaiting())
+            return false;
+
+        auto expected = false;
+
+        if (! busy.compare_exchange_strong (expected, true, std::memory_order_acquire))
+            return false;
+
+        // Someone else may have run the block between the check and the claim
+        if (isBlockWaiting())
+            return true;
+
+        busy.store (false, std::memory_order_release);
+        return false;
+    }
+
+    // Convolves the oldest block that's waiting
+    void run() noexcept override
+    {
+        const auto block = numBlocksDone.load (std::memory_order_relaxed);
+        const auto& slot = slots[block % numSlots];
+
+        engine.processBlockWithAddedLatency (slot.input, slot.output);
+
+        numBlocksDone.store (block + 1, std::memory_order_release);
+        busy.store (false, std::memory_order_release);
+    }
+
+    void processSamples (const float* input, float* output, size_t numSamples, BackgroundTailThreadPool& pool)
+    {
+        const auto blockSize = engine.blockSize;
+        size_t numSamplesProcessed = 0;
+
+        while (numSamplesProcessed < numSamples)
+        {
+            const auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, blockSize - inputDataPos);
+
+            FloatVectorOperations::copy (collecting + inputDataPos, input + numSamplesProcessed, static_cast<int> (numSamplesToProcess));
+            FloatVectorOperations::copy (output + numSamplesProcessed, playing + inputDataPos, static_cast<int> (numSamplesToProcess));
+
+            numSamplesProcessed += numSamplesToProcess;
+            inputDataPos += numSamplesToProcess;
+
+            if (inputDataPos == blockSize)
+            {
+                const auto block = numBlocksHandedOver.load (std::memory_order_relaxed);
+
+                // The slot this block goes in holds the one from two blocks ago
+                if (block >= numSlots)
+                    waitForBlock (block - numSlots);
+
+                auto& slot = slots[block % numSlots];
+                std::swap (playing, slot.output);
+                std::swap (collecting, slot.input);
+                inputDataPos = 0;
+
+                numBlocksHandedOver.store (block + 1, std::memory_order_release);
+                pool.notify();
+            }
+        }
+    }
+
+    void reset()
+    {
+        const auto numHandedOver = numBlocksHandedOver.load (std::memory_order_relaxed);
+
+        if (numHandedOver > 0)
+            waitForBlock (numHandedOver - 1);
+
+        // The workers only claim a block while fewer are done than handed over,
+        // which stays false while these are put back in this order
+        numBlocksHandedOver.store (0, std::memory_order_release);
+        numBlocksDone.store (0, std::memory_order_release);
+
+        engine.reset();
+        FloatVectorOperations::clear (buffers.get(), static_cast<int> (numBuffers * engine.blockSize));
+        inputDataPos = 0;
+    }
+
+private:
+    bool isBlockWaiting() const noexcept
+    {
+        return numBlocksDone.load (std::memory_order_acquire) < numBlocksHandedOver.load (std::memory_order_acquire);
+    }
+
+    void waitForBlock (size_t block) noexcept
+    {
+        while (numBlocksDone.load (std::memory_order_acquire) <= block)
+        {
+            if (tryToClaim())
+                run();
+            else
+                Thread::yield();
+        }
+    }
+
+    struct Slot
+    {
+        float* input;
+        float* output;
+    };
+
+    static constexpr size_t numSlots = 2, numBuffers = 2 + 2 * numSlots;
+
+    ConvolutionEngine engine;
+    HeapBlock<float> buffers;
+
+    // The audio thread only swaps buffers with a slot once its block is done
+    float* collecting = buffers.get();
+    float* playing    = collecting + engine.blockSize;
+    std::array<Slot, numSlots> slots { { { playing + engine.blockSize,     playing + 2 * engine.blockSize },
+                                         { playing + 3 * engine.blockSize, playing + 4 * engine.blockSize } } };
+    size_t inputDataPos = 0;
+
+    // Only the audio thread changes the number handed over, and only the thread
+    // that has claimed the tail by setting busy changes the number done
+    std::atomic<size_t> numBlocksHandedOver { 0 }, numBlocksDone { 0 };
+    std::atomic<bool> busy { false };
+};
+
+//==============================================================================
+// The partitions of each of an IR's channels, split between the head and tail
+// engines. These never change once they're made, so they can be shared by every
+// MultichannelEngine that uses the same IR with the same settings.
+struct MultichannelPartitions
+{
+    MultichannelPartitions (const AudioBuffer<float>& buf,
+                            int maxBufferSize,
+                            Convolution::NonUniform headSizeIn,
+                            bool isZeroDelay)
+        : irSize (buf.getNumSamples()),
+          isTailInBackground (headSizeIn.headSizeInSamples != 0 && headSizeIn.processTailInBackground)
+    {
+        const auto addPartitions = [&] (std::vector<ConvolutionEngine::Partitions>& partitions, int offset, int length, int thisBlockSize)
+        {
+            for (int i = 0; i < buf.getNumChannels(); ++i)
+                partitions.emplace_back (buf.getReadPointer (i, offset),
+                                         static_cast<size_t> (length),
+                                         static_cast<size_t> (thisBlockSize));
+        };
+
+        if (headSizeIn.headSizeInSamples == 0)
+        {
+            addPartitions (head, 0, irSize, maxBufferSize);
+        }
+        else if (isTailInBackground)
+        {
+            // There's at most one tail block per call, so the workers have at least
+            // two callbacks' worth of time for each one. Their results arrive two
+            // blocks late, so the head takes in two blocks more of the IR to make up
+            // for it.
+            const auto latency = isZeroDelay ? 0 : maxBufferSize;
+            const auto tailBlockSize = jmax (headSizeIn.headSizeInSamples, nextPowerOfTwo (maxBufferSize));
+            const auto size = jmin (irSize, 3 * tailBlockSize - latency);
+
+            addPartitions (head, 0, size, maxBufferSize);
+
+            if (size != irSize)
+                addPartitions (tail, size, irSize - size, tailBlockSize);
+        }
+        else
+        {
+            const auto size = jmin (irSize, headSizeIn.headSizeInSamples);
+
+            addPartitions (head, 0, size, maxBufferSize);
+
+            const auto tailBufferSize = headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize);
+
+            if (size != irSize)
+                addPartitions (tail, size, irSize - size, tailBufferSize);
+        }
+    }
+
+    const int irSize;
+    const bool isTailInBackground;
+
+    // One entry per channel of the IR. A mono IR is used for both channels.
+    std::vector<ConvolutionEngine::Partitions> head, tail;
 };
 
 //==============================================================================
 class MultichannelEngine
 {
 public:
-    MultichannelEngine (const AudioBuffer<float>& buf,
+    MultichannelEngine (std::shared_ptr<const MultichannelPartitions> partitions,
                         int maxBlockSize,
                         int maxBufferSize,
-                        Convolution::NonUniform headSizeIn,
                         bool isZeroDelayIn)
         : tailBuffer (1, maxBlockSize),
           latency (isZeroDelayIn ? 0 : maxBufferSize),
-          irSize (buf.getNumSamples()),
+          irSize (partitions->irSize),
           blockSize (maxBlockSize),
           isZeroDelay (isZeroDelayIn)
     {
         constexpr auto numChannels = 2;
 
-        const auto makeEngine = [&] (int channel, int offset, int length, uint32 thisBlockSize)
+        // Each engine keeps all of the partitions alive, by sharing ownership with the argument
+        const auto getChannel = [&partitions] (const std::vector<ConvolutionEngine::Partitions>& stage, int channel)
         {
-            return std::make_unique<ConvolutionEngine> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, channel), offset),
-                                                        length,
-                                                        static_cast<size_t> (thisBlockSize));
+            return std::shared_ptr<const ConvolutionEngine::Partitions> (partitions, &stage[(size_t) jmin ((int) stage.size() - 1, channel)]);
         };
 
-        if (headSizeIn.headSizeInSamples == 0)
+        for (int i = 0; i < numChannels; ++i)
+            head.emplace_back (std::make_unique<ConvolutionEngine> (getChannel (partitions->head, i)));
+
+        if (partitions->tail.empty())
+            return;
+
+        if (partitions->isTailInBackground)
         {
+            pool.emplace();
+
             for (int i = 0; i < numChannels; ++i)
-                head.emplace_back (makeEngine (i, 0, buf.getNumSamples(), static_cast<uint32> (maxBufferSize)));
+                backgroundTails.emplace_back (std::make_unique<BackgroundTail> (getChannel (partitions->tail, i)));
+
+            for (const auto& t : backgroundTails)
+                (*pool)->addJob (*t);
         }
         else
         {
-            const auto size = jmin (buf.getNumSamples(), headSizeIn.headSizeInSamples);
-
             for (int i = 0; i < numChannels; ++i)
-                head.emplace_back (makeEngine (i, 0, size, static_cast<uint32> (maxBufferSize)));
-
-            const auto tailBufferSize = static_cast<uint32> (headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize));
-
-            if (size != buf.getNumSamples())
-                for (int i = 0; i < numChannels; ++i)
-                    tail.emplace_back (makeEngine (i, size, buf.getNumSamples() - size, tailBufferSize));
+                tail.emplace_back (std::make_unique<ConvolutionEngine> (getChannel (partitions->tail, i)));
         }
     }
 
+    ~MultichannelEngine()
+    {
+        for (const auto& t : backgroundTails)
+            (*pool)->removeJob (*t);
+    }
+
     void reset()
     {
         for (const auto& e : head)
@@ -497,6 +845,9 @@ public:
 
         for (const auto& e : tail)
             e->reset();
+
+        for (const auto& t : backgroundTails)
+            t->reset();
     }
 
     void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
@@ -507,14 +858,19 @@ public:
         const AudioBlock<float> fullTailBlock (tailBuffer);
         const auto tailBlock = fullTailBlock.getSubBlock (0, (size_t) numSamples);
 
-        const auto isUniform = tail.empty();
+        const auto isUniform = tail.empty() && backgroundTails.empty();
 
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
-            if (! isUniform)
+            if (! tail.empty())
                 tail[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
                                                                tailBlock.getChannelPointer (0),
                                                                numSamples);
+            else if (! backgroundTails.empty())
+                backgroundTails[channel]->processSamples (input.getChannelPointer (channel),
+                                                          tailBlock.getChannelPointer (0),
+                                                          numSamples,
+                                                          pool->get());
 
             if (isZeroDelay)
                 head[channel]->processSamples (input.getChannelPointer (channel),
@@ -541,6 +897,8 @@ public:
 
 private:
     std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
+    std::vector<std::unique_ptr<BackgroundTail>> backgroundTails;
+    std::optional<SharedResourcePointer<BackgroundTailThreadPool>> pool;
     AudioBuffer<float> tailBuffer;
 
     const int latency;
@@ -730,6 +1088,149 @@ static BufferWithSampleRate loadStreamToBuffer (std::unique_ptr<InputStream> str
     return result;
 }
 
+// Returns a hash of an IR's size and samples, so that IRs with the same content
+// can be recognised without keeping copies of them around to compare.
+static uint64 hashImpulseResponse (const AudioBuffer<float>& buf)
+{
+    // 64-bit FNV-1a, taking each sample's bits at once rather than byte by byte
+    uint64 hash = 0xcbf29ce484222325;
+
+    const auto addToHash = [&hash] (uint64 value)
+    {
+        hash = (hash ^ value) * 0x100000001b3;
+    };
+
+    addToHash ((uint64) buf.getNumChannels());
+    addToHash ((uint64) buf.getNumSamples());
+
+    for (auto channel = 0; channel < buf.getNumChannels(); ++channel)
+    {
+        const auto* samples = buf.getReadPointer (channel);
+
+        for (auto i = 0; i < buf.getNumSamples(); ++i)
+        {
+            uint32 bits;
+            std::memcpy (&bits, samples + i, sizeof (bits));
+            addToHash (bits);
+        }
+    }
+
+    return hash;
+}
+
+// Shares the partitions of IRs between every Convolution in the process, so that
+// instances loading the same IR with the same settings only transform it once,
+// and only keep one copy of its spectra between them.
+//
+// The cache only holds weak references. Each set of partitions belongs to the
+// engines using it, and is freed once the last of them has gone.
+class ImpulseResponseCache
+{
+public:
+    // Everything that the partitions depend on. The IR's samples are identified
+    // by their hash, and compared in full when the rest of the key matches.
+    struct Key
+    {
+        uint64 contentHash;
+        int numChannels, numSamples;
+        double originalSampleRate, sampleRate;
+        Convolution::Normalise normalise;
+        int maxBufferSize, headSize;
+        bool processTailInBackground, isZeroDelay;
+
+        auto tie() const
+        {
+            return std::tie (contentHash, numChannels, numSamples, originalSampleRate, sampleRate, normalise,
+                             maxBufferSize, headSize, processTailInBackground, isZeroDelay);
+        }
+
+        bool operator< (const Key& other) const { return tie() < other.tie(); }
+    };
+
+    // Returns the partitions for the key and IR, calling makePartitions to make
+    // them if nobody else is using them. If somebody is, impulseResponse is
+    // pointed at the IR they loaded, so the two instances share its samples too.
+    //
+    // The lock is only held while the entries are looked up. The partitions are
+    // made outside it, and instances loading the same IR at the same time wait
+    // for the first one to finish, rather than all doing the same work.
+    template <typename MakePartitions>
+    std::shared_ptr<const MultichannelPartitions> get (const Key& key,
+                                                       std::shared_ptr<const AudioBuffer<float>>& impulseResponse,
+                                                       MakePartitions&& makePartitions)
+    {
+        for (;;)
+        {
+            std::promise<std::weak_ptr<const MultichannelPartitions>> promise;
+            std::shared_future<std::weak_ptr<const MultichannelPartitions>> pending;
+
+            {
+                const std::lock_guard<std::mutex> lock (mutex);
+
+                for (auto it = entries.begin(); it != entries.end();)
+                    it = it->second.isExpired() ? entries.erase (it) : std::next (it);
+
+                const auto range = entries.equal_range (key);
+                const auto match = std::find_if (range.first, range.second, [&] (const auto& entry)
+                {
+                    return haveSameSamples (*entry.second.impulseResponse, *impulseResponse);
+                });
+
+                if (match != range.second)
+                {
+                    impulseResponse = match->second.impulseResponse;
+                    pending = match->second.partitions;
+                }
+                else
+                {
+                    entries.emplace (key, Entry { impulseResponse, promise.get_future().share() });
+                }
+            }
+
+            if (! pending.valid())
+            {
+                std::shared_ptr<const MultichannelPartitions> result = makePartitions();
+                promise.set_value (result);
+                return result;
+            }
+
+            // If the last instance using them let them go before this one got to
+            // them, the entry is out of date, and the next time round replaces it
+            if (auto existing = pending.get().lock())
+                return existing;
+        }
+    }
+
+private:
+    struct Entry
+    {
+        bool isExpired() const
+        {
+            return partitions.wait_for (std::chrono::seconds (0)) == std::future_status::ready
+                && partitions.get().expired();
+        }
+
+        std::shared_ptr<const AudioBuffer<float>> impulseResponse;
+        std::shared_future<std::weak_ptr<const MultichannelPartitions>> partitions;
+    };
+
+    static bool haveSameSamples (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        // The bits are compared, as the hash uses them
+        for (auto channel = 0; channel < a.getNumChannels(); ++channel)
+            if (std::memcmp (a.getReadPointer (channel), b.getReadPointer (channel), sizeof (float) * (size_t) a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+
+    std::multimap<Key, Entry> entries;
+    std::mutex mutex;
+};
+
 // This class caches the data required to build a new convolution engine
 // (in particular, impulse response data and a ProcessSpec).
 // Calls to `setProcessSpec` and `setImpulseResponse` construct a
@@ -740,7 +1241,8 @@ public:
     ConvolutionEngineFactory (Convolution::Latency requiredLatency,
                               Convolution::NonUniform requiredHeadSize)
         : latency  { (requiredLatency.latencyInSamples   <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredLatency.latencyInSamples)) },
-          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)) },
+          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)),
+                     requiredHeadSize.processTailInBackground },
           shouldBeZeroLatency (requiredLatency.latencyInSamples == 0)
     {}
 
@@ -765,11 +1267,13 @@ public:
         wantsNormalise = normalise;
         originalSampleRate = buf.sampleRate;
 
-        impulseResponse = [&]
+        impulseResponse = std::make_shared<const AudioBuffer<float>> ([&]
         {
             auto corrected = fixNumChannels (buf.buffer, stereo);
             return trim == Convolution::Trim::yes ? trimImpulseResponse (corrected) : corrected;
-        }();
+        }());
+
+        impulseResponseHash = hashImpulseResponse (*impulseResponse);
 
         engine.set (makeEngine());
     }
@@ -784,33 +1288,54 @@ public:
 private:
     std::unique_ptr<MultichannelEngine> makeEngine()
     {
-        auto resampled = resampleImpulseResponse (impulseResponse, originalSampleRate, processSpec.sampleRate);
-
-        if (wantsNormalise == Convolution::Normalise::yes)
-            normaliseImpulseResponse (resampled);
-        else
-            resampled.applyGain ((float) (originalSampleRate / processSpec.sampleRate));
-
         const auto currentLatency = jmax (processSpec.maximumBlockSize, (uint32) latency.latencyInSamples);
         const auto maxBufferSize = shouldBeZeroLatency ? static_cast<int> (processSpec.maximumBlockSize)
                                                        : nextPowerOfTwo (static_cast<int> (currentLatency));
 
-        return std::make_unique<MultichannelEngine> (resampled,
+        const ImpulseResponseCache::Key key { impulseResponseHash,
+                                              impulseResponse->getNumChannels(),
+                                              impulseResponse->getNumSamples(),
+                                              originalSampleRate,
+                                              processSpec.sampleRate,
+                                              wantsNormalise,
+                                              maxBufferSize,
+                                              headSize.headSizeInSamples,
+                                              headSize.processTailInBackground,
+                                              shouldBeZeroLatency };
+
+        auto partitions = cache->get (key, impulseResponse, [&]
+        {
+            auto resampled = resampleImpulseResponse (*impulseResponse, originalSampleRate, processSpec.sampleRate);
+
+            if (wantsNormalise == Convolution::Normalise::yes)
+                normaliseImpulseResponse (resampled);
+            else
+                resampled.applyGain ((float) (originalSampleRate / processSpec.sampleRate));
+
+            return std::make_shared<const MultichannelPartitions> (resampled,
+                                                                   maxBufferSize,
+                                                                   headSize,
+                                                                   shouldBeZeroLatency);
+        });
+
+        return std::make_unique<MultichannelEngine> (std::move (partitions),
                                                      processSpec.maximumBlockSize,
                                                      maxBufferSize,
-                                                     headSize,
                                                      shouldBeZeroLatency);
     }
 
-    static AudioBuffer<float> makeImpulseBuffer()
+    static std::shared_ptr<const AudioBuffer<float>> makeImpulseBuffer()
     {
-        AudioBuffer<float> result (1, 1);
-        result.setSample (0, 0, 1.0f);
+        auto result = std::make_shared<AudioBuffer<float>> (1, 1);
+        result->setSample (0, 0, 1.0f);
         return result;
     }
 
     ProcessSpec processSpec { 44100.0, 128, 2 };
-    AudioBuffer<float> impulseResponse = makeImpulseBuffer();
+
+    // Shared with the cache, and with other instances that load the same IR
+    std::shared_ptr<const AudioBuffer<float>> impulseResponse = makeImpulseBuffer();
+    uint64 impulseResponseHash = hashImpulseResponse (*impulseResponse);
     double originalSampleRate = processSpec.sampleRate;
     Convolution::Normalise wantsNormalise = Convolution::Normalise::no;
     const Convolution::Latency latency;
@@ -818,6 +1343,7 @@ private:
     const bool shouldBeZeroLatency;
 
     TryLockedPtr<MultichannelEngine> engine;
+    SharedResourcePointer<ImpulseResponseCache> cache;
 
     mutable std::mutex mutex;
 };
@@ -138,7 +138,23 @@ public:
     explicit Convolution (const Latency& requiredLatency);
 
     /** Contains configuration information for a non-uniform convolution. */
-    struct NonUniform { int headSizeInSamples; };
+    struct NonUniform
+    {
+        int headSizeInSamples;
+
+        /** If true, the tail of the IR is convolved on a pool of background
+            threads, which leaves only the head for the audio thread.
+
+            The output and the latency are the same as when the tail is processed
+            on the audio thread, up to rounding. The workers have at least two
+            process() calls' worth of time for each of their blocks, and the head
+            covers two more of those blocks of the IR to allow for that. If a
+            worker still hasn't finished in time, the audio thread waits for it,
+            so this suits long IRs, such as reverbs, where the tail is much more
+            work than the head.
+        */
+        bool processTailInBackground = false;
+    };
 
     /** Initialises an object for performing convolution in the frequency domain
         using a non-uniform partitioned algorithm.
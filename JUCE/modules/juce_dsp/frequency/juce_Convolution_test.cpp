@@ -250,6 +250,71 @@ class ConvolutionTest final : public UnitTest
             testConvolution (spec, config, ir, irSampleRate, stereo, trim, normalise, expectedResult, sequence);
     }
 
+    static AudioBuffer<float> makeNoise (int numChannels, int length, int64 seed)
+    {
+        Random random (seed);
+        AudioBuffer<float> result (numChannels, length);
+
+        for (auto channel = 0; channel != numChannels; ++channel)
+            for (auto sample = 0; sample != length; ++sample)
+                result.setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+        return result;
+    }
+
+    // Processes the buffer in place, in blocks of varying sizes up to the spec's
+    // maximum. Nothing here allocates, so it can be checked for allocations.
+    static void processInPlaceInVaryingBlocks (Convolution& convolution,
+                                               const ProcessSpec& spec,
+                                               AudioBuffer<float>& buffer)
+    {
+        const int blockSizes[] { (int) spec.maximumBlockSize, 100, 1, (int) spec.maximumBlockSize - 1, 256 };
+
+        for (int i = 0, start = 0; start < buffer.getNumSamples(); ++i)
+        {
+            const auto numSamples = jmin (blockSizes[i % numElementsInArray (blockSizes)],
+                                          (int) spec.maximumBlockSize,
+                                          buffer.getNumSamples() - start);
+
+            auto block = AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) numSamples);
+            convolution.process (ProcessContextReplacing<float> (block));
+            start += numSamples;
+        }
+    }
+
+    // Processes a copy of the input in blocks of varying sizes
+    static AudioBuffer<float> processInVaryingBlocks (Convolution& convolution,
+                                                      const ProcessSpec& spec,
+                                                      const AudioBuffer<float>& input)
+    {
+        auto output = input;
+        processInPlaceInVaryingBlocks (convolution, spec, output);
+        return output;
+    }
+
+    // Keys that differ only in the given maximum buffer size, whatever the IR's samples
+    static ImpulseResponseCache::Key makeCacheKey (const AudioBuffer<float>& ir, int variant)
+    {
+        return { 0x1234, ir.getNumChannels(), ir.getNumSamples(), 44100.0, 44100.0,
+                 Convolution::Normalise::no, 128 * (1 + variant), 0, false, false };
+    }
+
+    static std::shared_ptr<const MultichannelPartitions> makePartitions (const AudioBuffer<float>& ir)
+    {
+        return std::make_shared<const MultichannelPartitions> (ir, 128, Convolution::NonUniform { 0 }, false);
+    }
+
+    static float getMaximumDifference (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        auto result = 0.0f;
+
+        for (auto channel = 0; channel != a.getNumChannels(); ++channel)
+            for (auto sample = 0; sample != a.getNumSamples(); ++sample)
+                result = jmax (result, std::abs (a.getSample (channel, sample) - b.getSample (channel, sample)));
+
+        return result;
+    }
+
 public:
     ConvolutionTest()
         : UnitTest ("Convolution", UnitTestCategories::dsp)
@@ -544,17 +609,196 @@ public:
 
             for (auto headSize : { spec.maximumBlockSize / 2, spec.maximumBlockSize, spec.maximumBlockSize * 9 })
             {
-                testConvolution (spec,
-                                 Convolution::NonUniform { static_cast<int> (headSize) },
-                                 ramp,
-                                 spec.sampleRate,
-                                 Convolution::Stereo::yes,
-                                 Convolution::Trim::yes,
-                                 Convolution::Normalise::no,
-                                 ramp);
+                for (auto processTailInBackground : { false, true })
+                {
+                    testConvolution (spec,
+                                     Convolution::NonUniform { static_cast<int> (headSize), processTailInBackground },
+                                     ramp,
+                                     spec.sampleRate,
+                                     Convolution::Stereo::yes,
+                                     Convolution::Trim::yes,
+                                     Convolution::Normalise::no,
+                                     ramp);
+                }
             }
         }
 
+        beginTest ("Non-uniform convolutions with background tails match those without");
+        {
+            const auto ir = makeNoise (2, 30'000, 0x1234);
+            const auto input = makeNoise (2, 40'000, 0x5678);
+
+            for (auto headSize : { 64, 512, 2048 })
+            {
+                const auto process = [&] (Convolution& convolution)
+                {
+                    auto copy = ir;
+                    convolution.loadImpulseResponse (std::move (copy),
+                                                     spec.sampleRate,
+                                                     Convolution::Stereo::yes,
+                                                     Convolution::Trim::no,
+                                                     Convolution::Normalise::yes);
+                    convolution.prepare (spec);
+
+                    auto output = input;
+
+                    {
+                        JUCE_FAIL_ON_ALLOCATION_IN_SCOPE;
+                        processInPlaceInVaryingBlocks (convolution, spec, output);
+                    }
+
+                    return output;
+                };
+
+                Convolution onAudioThread (Convolution::NonUniform { headSize, false });
+                Convolution inBackground  (Convolution::NonUniform { headSize, true });
+
+                const auto expected = process (onAudioThread);
+                const auto actual = process (inBackground);
+
+                expectEquals (inBackground.getLatency(), onAudioThread.getLatency());
+                expectEquals (inBackground.getCurrentIRSize(), onAudioThread.getCurrentIRSize());
+
+                // Only the partitioning differs, so the only differences are from rounding
+                expectLessThan (getMaximumDifference (actual, expected), 1.0e-5f * expected.getMagnitude (0, expected.getNumSamples()));
+
+                // However long the workers take, the output is the same
+                inBackground.reset();
+                expect (exactlyEqual (getMaximumDifference (processInVaryingBlocks (inBackground, spec, input), actual), 0.0f));
+            }
+        }
+
+        beginTest ("Convolutions only share an IR when its content and settings match");
+        {
+            const auto length = static_cast<int> (spec.maximumBlockSize) * 3;
+            const auto ramp = makeRamp (length);
+
+            auto reversed = ramp;
+            reversed.reverse (0, length);
+
+            const auto* rampSamples = ramp.getReadPointer (0);
+            const auto factor = 0.125f / std::sqrt (std::inner_product (rampSamples, rampSamples + length, rampSamples, 0.0f));
+
+            auto normalised = ramp;
+            normalised.applyGain (factor);
+
+            struct Instance
+            {
+                const AudioBuffer<float>& ir;
+                Convolution::Normalise normalise;
+                const AudioBuffer<float>& expected;
+                Convolution convolution;
+            };
+
+            Instance instances[] { { ramp,     Convolution::Normalise::no,  ramp,       {} },
+                                   { ramp,     Convolution::Normalise::yes, normalised, {} },
+                                   { reversed, Convolution::Normalise::no,  reversed,   {} },
+                                   { ramp,     Convolution::Normalise::no,  ramp,       {} } };
+
+            // All of the instances are loaded before any of them are checked, so
+            // that they're all in the cache at the same time
+            for (auto& instance : instances)
+            {
+                auto copy = instance.ir;
+                instance.convolution.loadImpulseResponse (std::move (copy),
+                                                          spec.sampleRate,
+                                                          Convolution::Stereo::yes,
+                                                          Convolution::Trim::no,
+                                                          instance.normalise);
+                instance.convolution.prepare (spec);
+            }
+
+            for (auto& instance : instances)
+            {
+                AudioBuffer<float> impulse (2, length);
+                addDiracImpulse (AudioBlock<float> (impulse));
+
+                const auto output = processInVaryingBlocks (instance.convolution, spec, impulse);
+
+                AudioBuffer<float> expected (2, length);
+
+                for (auto channel = 0; channel != expected.getNumChannels(); ++channel)
+                    expected.copyFrom (channel, 0, instance.expected, 0, 0, length);
+
+                expectLessThan (getMaximumDifference (output, expected), 1.0e-4f);
+            }
+        }
+
+        beginTest ("The IR cache compares the samples of IRs whose hashes match");
+        {
+            ImpulseResponseCache cache;
+
+            const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize));
+            auto reversed = ramp;
+            reversed.reverse (0, reversed.getNumSamples());
+
+            // The same hash for different samples, as if they had collided
+            const auto key = makeCacheKey (ramp, 0);
+            auto first = std::make_shared<const AudioBuffer<float>> (ramp);
+            auto second = std::make_shared<const AudioBuffer<float>> (reversed);
+            auto third = std::make_shared<const AudioBuffer<float>> (ramp);
+
+            const auto a = cache.get (key, first,  [&] { return makePartitions (*first); });
+            const auto b = cache.get (key, second, [&] { return makePartitions (*second); });
+            const auto c = cache.get (key, third,  [&] { return makePartitions (*third); });
+
+            expect (a != b);
+            expect (a == c);
+
+            // Instances sharing the partitions share the IR's samples as well
+            expect (third == first);
+            expect (second != first);
+        }
+
+        beginTest ("The IR cache doesn't hold its lock while it makes partitions");
+        {
+            ImpulseResponseCache cache;
+
+            const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize));
+            auto slow = std::make_shared<const AudioBuffer<float>> (ramp);
+            auto sameAsSlow = std::make_shared<const AudioBuffer<float>> (ramp);
+            auto other = std::make_shared<const AudioBuffer<float>> (ramp);
+
+            WaitableEvent started, canFinish;
+            std::atomic<int> numMade { 0 };
+
+            std::shared_ptr<const MultichannelPartitions> slowResult, sameResult;
+
+            std::thread slowThread ([&]
+            {
+                slowResult = cache.get (makeCacheKey (ramp, 1), slow, [&]
+                {
+                    ++numMade;
+                    started.signal();
+                    canFinish.wait (-1);
+                    return makePartitions (ramp);
+                });
+            });
+
+            started.wait (-1);
+
+            // This has to wait for the slow one, as it's the same IR with the same settings
+            std::thread sameThread ([&]
+            {
+                sameResult = cache.get (makeCacheKey (ramp, 1), sameAsSlow, [&]
+                {
+                    ++numMade;
+                    return makePartitions (ramp);
+                });
+            });
+
+            // Whereas this has different settings, so gets on with it
+            const auto otherResult = cache.get (makeCacheKey (ramp, 2), other, [&] { return makePartitions (ramp); });
+            expect (otherResult != nullptr);
+
+            canFinish.signal();
+            slowThread.join();
+            sameThread.join();
+
+            expectEquals (numMade.load(), 1);
+            expect (slowResult != nullptr && slowResult == sameResult);
+        }
+
         beginTest ("Convolutions with latency work");
         {
             const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize) * 8);
@@ -438,6 +438,477 @@ struct FFTFallback final : public FFT::Instance
 
 FFT::EngineImpl<FFTFallback> fftFallback;
 
+//==============================================================================
+//==============================================================================
+#if JUCE_USE_SIMD && (JUCE_INTEL || JUCE_ARM)
+/*  A radix-2 Stockham FFT, for platforms that have no FFT library.
+
+    The data is kept as separate arrays of real and imaginary parts, so that every
+    stage can work on a whole SIMD register of butterflies at once, and the
+    Stockham ordering means that no stage has to reorder the data in place. Real
+    transforms are done with a complex transform of half the size.
+
+    As with SIMDRegister, the instruction set is chosen when JUCE is compiled:
+    AVX2 (with FMA, if that's enabled too) when the compiler targets it, SSE
+    otherwise on Intel, and NEON on ARM. Transforms smaller than 2 ^ minimumOrder
+    are left to the fallback engine, which is just as fast at those sizes.
+*/
+struct FFTStockham final : public FFT::Instance
+{
+    // faster than the fallback, but slower than any of the platform libraries
+    static constexpr int priority = 0;
+
+    static constexpr int minimumOrder = 5;
+
+    static FFTStockham* create (int order)
+    {
+        return order >= minimumOrder ? new FFTStockham (order) : nullptr;
+    }
+
+    FFTStockham (int order)
+        : size ((size_t) 1 << order),
+          complexPlan (size),
+          realPlan (size / 2),
+          realTwiddles (size)
+    {
+        // The real transforms combine the two halves of a complex transform with these
+        for (size_t k = 0; k < size / 2; ++k)
+        {
+            const auto phase = -MathConstants<double>::twoPi * (double) k / (double) size;
+            realTwiddles[k] = (float) std::cos (phase);
+            realTwiddles[size / 2 + k] = (float) std::sin (phase);
+        }
+
+        scratch.allocate (4 * size, true);
+    }
+
+    void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept override
+    {
+        const SpinLock::ScopedLockType sl (processLock);
+
+        auto* re = scratch.get();
+        auto* im = re + size;
+
+        // An inverse transform is a forward transform with the real and imaginary parts swapped
+        if (inverse)
+            std::swap (re, im);
+
+        Vector::deinterleave (reinterpret_cast<const float*> (input), re, im, size);
+
+        const auto result = complexPlan.perform (scratch.get(), scratch.get() + 2 * size);
+
+        if (inverse)
+            Vector::interleave (result.imag, result.real, reinterpret_cast<float*> (output), size, 1.0f / (float) size);
+        else
+            Vector::interleave (result.real, result.imag, reinterpret_cast<float*> (output), size, 1.0f);
+    }
+
+    void performRealOnlyForwardTransform (float* d, bool ignoreNegativeFreqs) const noexcept override
+    {
+        const SpinLock::ScopedLockType sl (processLock);
+
+        const auto half = size / 2;
+
+        // The even samples go in the real parts, and the odd ones in the imaginary parts
+        Vector::deinterleave (d, scratch.get(), scratch.get() + half, half);
+
+        const auto z = realPlan.perform (scratch.get(), scratch.get() + size);
+        const auto* cosines = realTwiddles.data();
+        const auto* sines = cosines + half;
+
+        auto* out = reinterpret_cast<Complex<float>*> (d);
+
+        out[0]    = { z.real[0] + z.imag[0], 0.0f };
+        out[half] = { z.real[0] - z.imag[0], 0.0f };
+
+        for (size_t k = 1; k < half; ++k)
+        {
+            // Separate the transforms of the even and odd samples, then combine them
+            const auto j = half - k;
+            const auto evenRe = 0.5f * (z.real[k] + z.real[j]);
+            const auto evenIm = 0.5f * (z.imag[k] - z.imag[j]);
+            const auto oddRe  = 0.5f * (z.imag[k] + z.imag[j]);
+            const auto oddIm  = 0.5f * (z.real[j] - z.real[k]);
+
+            out[k] = { evenRe + oddRe * cosines[k] - oddIm * sines[k],
+                       evenIm + oddRe * sines[k] + oddIm * cosines[k] };
+        }
+
+        if (! ignoreNegativeFreqs)
+            for (size_t k = half + 1; k < size; ++k)
+                out[k] = std::conj (out[size - k]);
+    }
+
+    void performRealOnlyInverseTransform (float* d) const noexcept override
+    {
+        const SpinLock::ScopedLockType sl (processLock);
+
+        const auto half = size / 2;
+        const auto* in = reinterpret_cast<const Complex<float>*> (d);
+        const auto* cosines = realTwiddles.data();
+        const auto* sines = cosines + half;
+
+        // This is the inverse of the forward transform's last step, with the real and
+        // imaginary parts swapped for the inverse complex transform. The imaginary
+        // parts of the DC and Nyquist bins are ignored, as they'd be zero for a
+        // real signal.
+        auto* zIm = scratch.get();
+        auto* zRe = zIm + half;
+
+        zRe[0] = 0.5f * (in[0].real() + in[half].real());
+        zIm[0] = 0.5f * (in[0].real() - in[half].real());
+
+        for (size_t k = 1; k < half; ++k)
+        {
+            const auto j = half - k;
+            const auto evenRe = 0.5f * (in[k].real() + in[j].real());
+            const auto evenIm = 0.5f * (in[k].imag() - in[j].imag());
+            const auto diffRe = 0.5f * (in[k].real() - in[j].real());
+            const auto diffIm = 0.5f * (in[k].imag() + in[j].imag());
+
+            // The odd samples' transform is the difference, turned back by the twiddle
+            const auto oddRe = diffRe * cosines[k] + diffIm * sines[k];
+            const auto oddIm = diffIm * cosines[k] - diffRe * sines[k];
+
+            zRe[k] = evenRe - oddIm;
+            zIm[k] = evenIm + oddRe;
+        }
+
+        const auto z = realPlan.perform (scratch.get(), scratch.get() + size);
+
+        Vector::interleave (z.imag, z.real, d, half, 1.0f / (float) half);
+        std::fill (d + size, d + 2 * size, 0.0f);
+    }
+
+    //==============================================================================
+    /*  The handful of operations that the transform needs, on whichever kind of SIMD
+        register the platform has. Loads and stores don't need to be aligned.
+    */
+    struct Vector
+    {
+       #if JUCE_INTEL && defined (__AVX2__)
+        using Type = __m256;
+        static constexpr size_t width = 8;
+
+        static Type load (const float* p) noexcept                      { return _mm256_loadu_ps (p); }
+        static void store (float* p, Type v) noexcept                   { _mm256_storeu_ps (p, v); }
+        static Type expand (float x) noexcept                           { return _mm256_set1_ps (x); }
+        static Type add (Type a, Type b) noexcept                       { return _mm256_add_ps (a, b); }
+        static Type sub (Type a, Type b) noexcept                       { return _mm256_sub_ps (a, b); }
+        static Type mul (Type a, Type b) noexcept                       { return _mm256_mul_ps (a, b); }
+
+        #ifdef __FMA__
+         static Type mulAdd (Type a, Type b, Type c) noexcept           { return _mm256_fmadd_ps (a, b, c); }
+         static Type mulSub (Type a, Type b, Type c) noexcept           { return _mm256_fmsub_ps (a, b, c); }
+        #else
+         static Type mulAdd (Type a, Type b, Type c) noexcept           { return add (mul (a, b), c); }
+         static Type mulSub (Type a, Type b, Type c) noexcept           { return sub (mul (a, b), c); }
+        #endif
+
+        /*  Interleaves runs of ChunkSize elements from a and b, so that lo and hi hold
+            a's first chunk, then b's first chunk, then a's second, and so on.
+        */
+        template <size_t ChunkSize>
+        static void interleaveChunks (Type a, Type b, Type& lo, Type& hi) noexcept
+        {
+            if constexpr (ChunkSize == 1)
+            {
+                const auto u = _mm256_unpacklo_ps (a, b), v = _mm256_unpackhi_ps (a, b);
+                lo = _mm256_permute2f128_ps (u, v, 0x20);
+                hi = _mm256_permute2f128_ps (u, v, 0x31);
+            }
+            else if constexpr (ChunkSize == 2)
+            {
+                const auto u = _mm256_shuffle_ps (a, b, _MM_SHUFFLE (1, 0, 1, 0));
+                const auto v = _mm256_shuffle_ps (a, b, _MM_SHUFFLE (3, 2, 3, 2));
+                lo = _mm256_permute2f128_ps (u, v, 0x20);
+                hi = _mm256_permute2f128_ps (u, v, 0x31);
+            }
+            else
+            {
+                lo = _mm256_permute2f128_ps (a, b, 0x20);
+                hi = _mm256_permute2f128_ps (a, b, 0x31);
+            }
+        }
+
+        /*  Splits two registers of interleaved pairs into one of the first elements and
+            one of the second elements.
+        */
+        static void deinterleavePairs (Type lo, Type hi, Type& first, Type& second) noexcept
+        {
+            const auto evens = _mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+            const auto odds  = _mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+            first  = _mm256_castpd_ps (_mm256_permute4x64_pd (_mm256_castps_pd (evens), _MM_SHUFFLE (3, 1, 2, 0)));
+            second = _mm256_castpd_ps (_mm256_permute4x64_pd (_mm256_castps_pd (odds),  _MM_SHUFFLE (3, 1, 2, 0)));
+        }
+       #elif JUCE_INTEL
+        using Type = __m128;
+        static constexpr size_t width = 4;
+
+        static Type load (const float* p) noexcept                      { return _mm_loadu_ps (p); }
+        static void store (float* p, Type v) noexcept                   { _mm_storeu_ps (p, v); }
+        static Type expand (float x) noexcept                           { return _mm_set1_ps (x); }
+        static Type add (Type a, Type b) noexcept                       { return _mm_add_ps (a, b); }
+        static Type sub (Type a, Type b) noexcept                       { return _mm_sub_ps (a, b); }
+        static Type mul (Type a, Type b) noexcept                       { return _mm_mul_ps (a, b); }
+        static Type mulAdd (Type a, Type b, Type c) noexcept            { return add (mul (a, b), c); }
+        static Type mulSub (Type a, Type b, Type c) noexcept            { return sub (mul (a, b), c); }
+
+        template <size_t ChunkSize>
+        static void interleaveChunks (Type a, Type b, Type& lo, Type& hi) noexcept
+        {
+            if constexpr (ChunkSize == 1)
+            {
+                lo = _mm_unpacklo_ps (a, b);
+                hi = _mm_unpackhi_ps (a, b);
+            }
+            else
+            {
+                lo = _mm_movelh_ps (a, b);
+                hi = _mm_movehl_ps (b, a);
+            }
+        }
+
+        static void deinterleavePairs (Type lo, Type hi, Type& first, Type& second) noexcept
+        {
+            first  = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+            second = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+        }
+       #else
+        using Type = float32x4_t;
+        static constexpr size_t width = 4;
+
+        static Type load (const float* p) noexcept                      { return vld1q_f32 (p); }
+        static void store (float* p, Type v) noexcept                   { vst1q_f32 (p, v); }
+        static Type expand (float x) noexcept                           { return vdupq_n_f32 (x); }
+        static Type add (Type a, Type b) noexcept                       { return vaddq_f32 (a, b); }
+        static Type sub (Type a, Type b) noexcept                       { return vsubq_f32 (a, b); }
+        static Type mul (Type a, Type b) noexcept                       { return vmulq_f32 (a, b); }
+        static Type mulAdd (Type a, Type b, Type c) noexcept            { return vmlaq_f32 (c, a, b); }
+        static Type mulSub (Type a, Type b, Type c) noexcept            { return vsubq_f32 (vmulq_f32 (a, b), c); }
+
+        template <size_t ChunkSize>
+        static void interleaveChunks (Type a, Type b, Type& lo, Type& hi) noexcept
+        {
+            if constexpr (ChunkSize == 1)
+            {
+                const auto zipped = vzipq_f32 (a, b);
+                lo = zipped.val[0];
+                hi = zipped.val[1];
+            }
+            else
+            {
+                lo = vcombine_f32 (vget_low_f32 (a),  vget_low_f32 (b));
+                hi = vcombine_f32 (vget_high_f32 (a), vget_high_f32 (b));
+            }
+        }
+
+        static void deinterleavePairs (Type lo, Type hi, Type& first, Type& second) noexcept
+        {
+            const auto unzipped = vuzpq_f32 (lo, hi);
+            first  = unzipped.val[0];
+            second = unzipped.val[1];
+        }
+       #endif
+
+        //==============================================================================
+        /*  Converts between interleaved complex numbers and separate real and imaginary
+            parts. The number of values must be a multiple of the register width.
+        */
+        static void deinterleave (const float* source, float* re, float* im, size_t numValues) noexcept
+        {
+            for (size_t i = 0; i < numValues; i += width)
+            {
+                Type first, second;
+                deinterleavePairs (load (source + 2 * i), load (source + 2 * i + width), first, second);
+                store (re + i, first);
+                store (im + i, second);
+            }
+        }
+
+        static void interleave (const float* re, const float* im, float* dest, size_t numValues, float scale) noexcept
+        {
+            const auto factor = expand (scale);
+
+            for (size_t i = 0; i < numValues; i += width)
+            {
+                Type lo, hi;
+                interleaveChunks<1> (mul (load (re + i), factor), mul (load (im + i), factor), lo, hi);
+                store (dest + 2 * i, lo);
+                store (dest + 2 * i + width, hi);
+            }
+        }
+    };
+
+    //==============================================================================
+    struct SplitComplex
+    {
+        const float* real;
+        const float* imag;
+    };
+
+    /*  The twiddle factors for every stage of a forward complex transform of one size.
+
+        The stage with stride s combines pairs of transforms of size n / (2 * s) into
+        transforms twice the size. Its butterflies are numbered j = q + s * p, for
+        p below n / (2 * s) and q below s, and butterfly j reads elements j and
+        j + n / 2, and writes elements q + 2 * s * p and q + 2 * s * p + s, with
+        twiddle factor p. So in the later stages, where s is at least the register
+        width, each register of butterflies shares its twiddle factor, and writes its
+        results to two runs of consecutive elements. In the first few stages the
+        results have to be interleaved in runs of s elements, and the twiddle factors
+        are stored once for every butterfly, so they can be loaded straight into a
+        register.
+    */
+    struct Plan
+    {
+        explicit Plan (size_t sizeToUse)
+            : n (sizeToUse)
+        {
+            for (size_t stride = 1; stride < n; stride *= 2)
+            {
+                const auto numTwiddles = n / (2 * stride);
+                const auto repeats = stride < Vector::width ? stride : 1;
+
+                stages.push_back ({ stride, twiddles.size() });
+
+                for (auto part : { 0, 1 })
+                {
+                    for (size_t p = 0; p < numTwiddles; ++p)
+                    {
+                        const auto phase = -MathConstants<double>::pi * (double) p / (double) numTwiddles;
+                        const auto value = (float) (part == 0 ? std::cos (phase) : std::sin (phase));
+
+                        for (size_t r = 0; r < repeats; ++r)
+                            twiddles.push_back (value);
+                    }
+                }
+            }
+        }
+
+        /*  Transforms the data in the first n real and the next n imaginary parts of
+            buffer, using workspace for the same amount of working space. Returns
+            whichever of the two holds the result.
+        */
+        SplitComplex perform (float* buffer, float* workspace) const noexcept
+        {
+            float* source = buffer;
+            float* dest = workspace;
+
+            for (const auto& stage : stages)
+            {
+                const auto* twiddleRe = twiddles.data() + stage.twiddleOffset;
+                const auto* twiddleIm = twiddleRe + (stage.stride < Vector::width ? n / 2 : n / (2 * stage.stride));
+
+                switch (stage.stride)
+                {
+                    case 1:   performInterleavedStage<1> (source, dest, twiddleRe, twiddleIm); break;
+                    case 2:   performInterleavedStage<2> (source, dest, twiddleRe, twiddleIm); break;
+                   #if JUCE_INTEL && defined (__AVX2__)
+                    case 4:   performInterleavedStage<4> (source, dest, twiddleRe, twiddleIm); break;
+                   #endif
+                    default:  performStage (stage.stride, source, dest, twiddleRe, twiddleIm); break;
+                }
+
+                std::swap (source, dest);
+            }
+
+            return { source, source + n };
+        }
+
+        template <size_t Stride>
+        void performInterleavedStage (const float* source, float* dest, const float* twiddleRe, const float* twiddleIm) const noexcept
+        {
+            const auto half = n / 2;
+            const auto* sourceIm = source + n;
+            auto* destIm = dest + n;
+
+            for (size_t j = 0; j < half; j += Vector::width)
+            {
+                Type sumRe, sumIm, productRe, productIm;
+                butterfly (source + j, sourceIm + j, half,
+                           Vector::load (twiddleRe + j), Vector::load (twiddleIm + j),
+                           sumRe, sumIm, productRe, productIm);
+
+                Type lo, hi;
+                Vector::interleaveChunks<Stride> (sumRe, productRe, lo, hi);
+                Vector::store (dest + 2 * j, lo);
+                Vector::store (dest + 2 * j + Vector::width, hi);
+
+                Vector::interleaveChunks<Stride> (sumIm, productIm, lo, hi);
+                Vector::store (destIm + 2 * j, lo);
+                Vector::store (destIm + 2 * j + Vector::width, hi);
+            }
+        }
+
+        void performStage (size_t stride, const float* source, float* dest, const float* twiddleRe, const float* twiddleIm) const noexcept
+        {
+            const auto half = n / 2;
+            const auto* sourceIm = source + n;
+            auto* destIm = dest + n;
+
+            for (size_t p = 0; p < half / stride; ++p)
+            {
+                const auto wRe = Vector::expand (twiddleRe[p]);
+                const auto wIm = Vector::expand (twiddleIm[p]);
+                const auto in = stride * p, out = 2 * stride * p;
+
+                for (size_t q = 0; q < stride; q += Vector::width)
+                {
+                    Type sumRe, sumIm, productRe, productIm;
+                    butterfly (source + in + q, sourceIm + in + q, half, wRe, wIm, sumRe, sumIm, productRe, productIm);
+
+                    Vector::store (dest + out + q, sumRe);
+                    Vector::store (destIm + out + q, sumIm);
+                    Vector::store (dest + out + stride + q, productRe);
+                    Vector::store (destIm + out + stride + q, productIm);
+                }
+            }
+        }
+
+        using Type = typename Vector::Type;
+
+        /*  Returns a + b, and (a - b) * w, where a is at the given position and b is
+            half the transform further on.
+        */
+        static void butterfly (const float* re, const float* im, size_t half, Type wRe, Type wIm,
+                               Type& sumRe, Type& sumIm, Type& productRe, Type& productIm) noexcept
+        {
+            const auto aRe = Vector::load (re), aIm = Vector::load (im);
+            const auto bRe = Vector::load (re + half), bIm = Vector::load (im + half);
+
+            sumRe = Vector::add (aRe, bRe);
+            sumIm = Vector::add (aIm, bIm);
+
+            const auto dRe = Vector::sub (aRe, bRe), dIm = Vector::sub (aIm, bIm);
+            productRe = Vector::mulSub (dRe, wRe, Vector::mul (dIm, wIm));
+            productIm = Vector::mulAdd (dRe, wIm, Vector::mul (dIm, wRe));
+        }
+
+        struct Stage
+        {
+            size_t stride, twiddleOffset;
+        };
+
+        size_t n;
+        std::vector<Stage> stages;
+        std::vector<float> twiddles;
+    };
+
+    //==============================================================================
+    const size_t size;
+    Plan complexPlan, realPlan;
+    std::vector<float> realTwiddles;
+
+    SpinLock processLock;
+    HeapBlock<float> scratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FFTStockham)
+};
+
+FFT::EngineImpl<FFTStockham> fftStockham;
+#endif
+
 //==============================================================================
 //==============================================================================
 #if (JUCE_MAC || JUCE_IOS) && JUCE_USE_VDSP_FRAMEWORK
@@ -964,6 +1435,17 @@ FFT::FFT (int order)
 {
 }
 
+FFT::FFT (std::unique_ptr<Instance> engineToUse, int order)
+    : engine (std::move (engineToUse)),
+      size (1 << order)
+{
+}
+
+FFT FFT::createWithFallbackEngine (int order)
+{
+    return FFT (std::unique_ptr<Instance> (FFTFallback::create (order)), order);
+}
+
 FFT::FFT (FFT&&) noexcept = default;
 
 FFT& FFT::operator= (FFT&&) noexcept = default;
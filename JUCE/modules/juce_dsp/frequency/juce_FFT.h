@@ -66,6 +66,14 @@ public:
     /** Destructor. */
     ~FFT();
 
+    /** Creates an FFT that uses JUCE's own portable engine, rather than the
+        fastest engine that the platform has.
+
+        Its results match the other engines' to within rounding errors, so this
+        is only useful for comparing another engine's speed or accuracy with it.
+    */
+    static FFT createWithFallbackEngine (int order);
+
     //==============================================================================
     /** Performs an out-of-place FFT, either forward or inverse.
         The arrays must contain at least getSize() elements.
@@ -128,6 +136,8 @@ private:
     //==============================================================================
     struct Engine;
 
+    FFT (std::unique_ptr<Instance>, int order);
+
     std::unique_ptr<Instance> engine;
     int size;
 
@@ -203,6 +203,70 @@ struct FFTUnitTest final : public UnitTest
         }
     };
 
+   #if JUCE_USE_SIMD && (JUCE_INTEL || JUCE_ARM)
+    /*  Checks the SIMD engine against the fallback engine at every size it handles. */
+    struct StockhamTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = FFTStockham::minimumOrder; order <= 16; ++order)
+            {
+                const auto n = (size_t) 1 << order;
+
+                FFTFallback fallback (order);
+                std::unique_ptr<FFTStockham> stockham (FFTStockham::create (order));
+
+                HeapBlock<Complex<float>> input (n), expected (n), output (n);
+                fillRandom (random, input.getData(), n);
+
+                for (auto inverse : { false, true })
+                {
+                    fallback.perform (input.getData(), expected.getData(), inverse);
+                    stockham->perform (input.getData(), output.getData(), inverse);
+                    u.expect (checkArrayIsClose (expected.getData(), output.getData(), n), describe (order, inverse ? "inverse" : "forward"));
+                }
+
+                std::vector<float> realInput (2 * n), realExpected (2 * n), realOutput (2 * n);
+                fillRandom (random, realInput.data(), n);
+
+                realExpected = realInput;
+                realOutput = realInput;
+                fallback.performRealOnlyForwardTransform (realExpected.data(), false);
+                stockham->performRealOnlyForwardTransform (realOutput.data(), false);
+                u.expect (checkArrayIsClose (realExpected.data(), realOutput.data(), 2 * n), describe (order, "real forward"));
+
+                stockham->performRealOnlyInverseTransform (realOutput.data());
+                u.expect (checkArrayIsClose (realInput.data(), realOutput.data(), n), describe (order, "real inverse"));
+            }
+        }
+
+        static String describe (int order, const char* transform)
+        {
+            return "2^" + String (order) + ", " + transform;
+        }
+
+        /*  Compares two arrays, allowing for rounding errors that grow with the size
+            of the values.
+        */
+        template <typename Type>
+        static bool checkArrayIsClose (const Type* a, const Type* b, size_t n) noexcept
+        {
+            float largest = 1.0f;
+
+            for (size_t i = 0; i < n; ++i)
+                largest = jmax (largest, (float) std::abs (a[i]));
+
+            for (size_t i = 0; i < n; ++i)
+                if (std::abs (a[i] - b[i]) > 1e-5f * largest)
+                    return false;
+
+            return true;
+        }
+    };
+   #endif
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -216,6 +280,10 @@ struct FFTUnitTest final : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+
+       #if JUCE_USE_SIMD && (JUCE_INTEL || JUCE_ARM)
+        runTestForAllTypes<StockhamTest> ("SIMD engine against the fallback engine");
+       #endif
     }
 };
 
@@ -131,17 +131,19 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
         coefficientsUp   = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
         coefficientsDown = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
 
-        auto N = coefficientsUp.getFilterOrder() + 1;
-        stateUp.setSize (static_cast<int> (this->numChannels), static_cast<int> (N));
-
-        N = coefficientsDown.getFilterOrder() + 1;
-        auto Ndiv2 = N / 2;
-        auto Ndiv4 = Ndiv2 / 2;
-
-        stateDown.setSize  (static_cast<int> (this->numChannels), static_cast<int> (N));
-        stateDown2.setSize (static_cast<int> (this->numChannels), static_cast<int> (Ndiv4 + 1));
-
-        position.resize (static_cast<int> (this->numChannels));
+        // The indexing below needs orders of the form 4k + 2, so that the centre tap of
+        // each filter lands in the half of the taps that the delay lines hold. This is
+        // what designFIRLowpassHalfBandEquirippleMethod() always gives.
+        jassert (coefficientsUp.getFilterOrder() % 4 == 2);
+        jassert (coefficientsDown.getFilterOrder() % 4 == 2);
+
+        // Every other coefficient of a half-band filter is zero, so each phase only
+        // needs a delay line of every other input sample.
+        historyUp.setSize   (static_cast<int> (this->numChannels), static_cast<int> (getNumTaps (coefficientsUp) - 1));
+        historyDown.setSize (static_cast<int> (this->numChannels), static_cast<int> (getNumTaps (coefficientsDown) - 1));
+
+        // The other phase of the downsampler is just the centre tap, delayed
+        historyDownCentre.setSize (static_cast<int> (this->numChannels), static_cast<int> (getCentreDelay (coefficientsDown)));
     }
 
     //==============================================================================
@@ -150,17 +152,32 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
         return static_cast<SampleType> (coefficientsUp.getFilterOrder() + coefficientsDown.getFilterOrder()) * 0.5f;
     }
 
+    void initProcessing (size_t maximumNumberOfSamplesBeforeOversampling) override
+    {
+        ParentType::initProcessing (maximumNumberOfSamplesBeforeOversampling);
+
+        const auto maxHistory = jmax (historyUp.getNumSamples(), historyDown.getNumSamples(), historyDownCentre.getNumSamples());
+        scratch.setSize (numScratchChannels,
+                         static_cast<int> (maximumNumberOfSamplesBeforeOversampling) + maxHistory,
+                         false, false, true);
+    }
+
     void reset() override
     {
         ParentType::reset();
 
-        stateUp.clear();
-        stateDown.clear();
-        stateDown2.clear();
-
-        position.fill (0);
+        historyUp.clear();
+        historyDown.clear();
+        historyDownCentre.clear();
     }
 
+    /*  Rather than shifting a delay line along for every sample, the processing
+        works on a whole block at a time. The history and the new samples are laid
+        out end to end, so that each tap of the filter is a multiply-add across the
+        whole block, which FloatVectorOperations can vectorise. The samples are
+        accumulated in the same order as a per-sample convolution would, so the
+        results are the same.
+    */
     void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
     {
         jassert (inputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
@@ -170,34 +187,44 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
         auto fir = coefficientsUp.getRawCoefficients();
         auto N = coefficientsUp.getFilterOrder() + 1;
         auto Ndiv2 = N / 2;
+        auto numTaps = getNumTaps (coefficientsUp);
         auto numSamples = inputBlock.getNumSamples();
 
+        auto* window = scratch.getWritePointer (windowChannel);
+        auto* sums = scratch.getWritePointer (sumChannel);
+        auto* out = scratch.getWritePointer (outputChannel);
+
         // Processing
         for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
         {
             auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto buf = stateUp.getWritePointer (static_cast<int> (channel));
+            auto history = historyUp.getWritePointer (static_cast<int> (channel));
             auto samples = inputBlock.getChannelPointer (channel);
 
-            for (size_t i = 0; i < numSamples; ++i)
-            {
-                // Input
-                buf[N - 1] = 2 * samples[i];
+            // Input
+            FloatVectorOperations::copy (window, history, numTaps - 1);
+            FloatVectorOperations::copyWithMultiply (window + numTaps - 1, samples, static_cast<SampleType> (2), numSamples);
 
-                // Convolution
-                auto out = static_cast<SampleType> (0.0);
+            // Convolution
+            FloatVectorOperations::clear (out, numSamples);
 
-                for (size_t k = 0; k < Ndiv2; k += 2)
-                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+            for (size_t k = 0; k < Ndiv2; k += 2)
+            {
+                FloatVectorOperations::add (sums, window + k / 2, window + (N - k - 1) / 2, numSamples);
+                FloatVectorOperations::addWithMultiply (out, sums, fir[k], numSamples);
+            }
 
-                // Outputs
-                bufferSamples[i << 1] = out;
-                bufferSamples[(i << 1) + 1] = buf[Ndiv2 + 1] * fir[Ndiv2];
+            // Outputs
+            const auto* centre = window + (Ndiv2 + 1) / 2;
 
-                // Shift data
-                for (size_t k = 0; k < N - 2; k += 2)
-                    buf[k] = buf[k + 2];
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                bufferSamples[i << 1] = out[i];
+                bufferSamples[(i << 1) + 1] = centre[i] * fir[Ndiv2];
             }
+
+            // Keep the most recent samples for the next block
+            FloatVectorOperations::copy (history, window + numSamples, numTaps - 1);
         }
     }
 
@@ -210,53 +237,72 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
         auto fir = coefficientsDown.getRawCoefficients();
         auto N = coefficientsDown.getFilterOrder() + 1;
         auto Ndiv2 = N / 2;
-        auto Ndiv4 = Ndiv2 / 2;
+        auto numTaps = getNumTaps (coefficientsDown);
+        auto centreDelay = getCentreDelay (coefficientsDown);
         auto numSamples = outputBlock.getNumSamples();
 
+        auto* window = scratch.getWritePointer (windowChannel);
+        auto* sums = scratch.getWritePointer (sumChannel);
+        auto* centre = scratch.getWritePointer (outputChannel);
+
         // Processing
         for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto buf = stateDown.getWritePointer (static_cast<int> (channel));
-            auto buf2 = stateDown2.getWritePointer (static_cast<int> (channel));
+            auto bufferSamples = ParentType::buffer.getReadPointer (static_cast<int> (channel));
+            auto history = historyDown.getWritePointer (static_cast<int> (channel));
+            auto centreHistory = historyDownCentre.getWritePointer (static_cast<int> (channel));
             auto samples = outputBlock.getChannelPointer (channel);
-            auto pos = position.getUnchecked (static_cast<int> (channel));
+
+            // Input, split into its two phases
+            FloatVectorOperations::copy (window, history, numTaps - 1);
+            FloatVectorOperations::copy (centre, centreHistory, centreDelay);
 
             for (size_t i = 0; i < numSamples; ++i)
             {
-                // Input
-                buf[N - 1] = bufferSamples[i << 1];
-
-                // Convolution
-                auto out = static_cast<SampleType> (0.0);
-
-                for (size_t k = 0; k < Ndiv2; k += 2)
-                    out += (buf[k] + buf[N - k - 1]) * fir[k];
-
-                // Output
-                out += buf2[pos] * fir[Ndiv2];
-                buf2[pos] = bufferSamples[(i << 1) + 1];
-
-                samples[i] = out;
+                window[numTaps - 1 + i] = bufferSamples[i << 1];
+                centre[centreDelay + i] = bufferSamples[(i << 1) + 1];
+            }
 
-                // Shift data
-                for (size_t k = 0; k < N - 2; ++k)
-                    buf[k] = buf[k + 2];
+            // Convolution
+            FloatVectorOperations::clear (samples, numSamples);
 
-                // Circular buffer
-                pos = (pos == 0 ? Ndiv4 : pos - 1);
+            for (size_t k = 0; k < Ndiv2; k += 2)
+            {
+                FloatVectorOperations::add (sums, window + k / 2, window + (N - k - 1) / 2, numSamples);
+                FloatVectorOperations::addWithMultiply (samples, sums, fir[k], numSamples);
             }
 
-            position.setUnchecked (static_cast<int> (channel), pos);
-        }
+            // Output
+            FloatVectorOperations::addWithMultiply (samples, centre, fir[Ndiv2], numSamples);
 
+            // Keep the most recent samples for the next block
+            FloatVectorOperations::copy (history, window + numSamples, numTaps - 1);
+            FloatVectorOperations::copy (centreHistory, centre + numSamples, centreDelay);
+        }
     }
 
 private:
     //==============================================================================
+    /** Returns the length of the delay line that holds every other input sample. */
+    static size_t getNumTaps (const FIR::Coefficients<SampleType>& coeffs)
+    {
+        // The filter has an odd number of coefficients, with the zeros at odd indices
+        jassert (coeffs.getFilterOrder() % 2 == 0);
+        return coeffs.getFilterOrder() / 2 + 1;
+    }
+
+    /** Returns the delay, in input samples, of the downsampler's centre tap. */
+    static size_t getCentreDelay (const FIR::Coefficients<SampleType>& coeffs)
+    {
+        // The centre tap falls on an even index, along with all the other non-zero ones
+        jassert (coeffs.getFilterOrder() % 4 == 2);
+        return coeffs.getFilterOrder() / 4 + 1;
+    }
+
+    enum { windowChannel, sumChannel, outputChannel, numScratchChannels };
+
     FIR::Coefficients<SampleType> coefficientsUp, coefficientsDown;
-    AudioBuffer<SampleType> stateUp, stateDown, stateDown2;
-    Array<size_t> position;
+    AudioBuffer<SampleType> historyUp, historyDown, historyDownCentre, scratch;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesEquirippleFIR)
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class OversamplingTests final : public UnitTest
+{
+public:
+    OversamplingTests()
+        : UnitTest ("Oversampling", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Equiripple FIR stages match a per-sample convolution");
+        {
+            testEquirippleFIRStage<float>();
+            testEquirippleFIRStage<double>();
+        }
+    }
+
+private:
+    //==============================================================================
+    /*  The per-sample version of Oversampling2TimesEquirippleFIR, which shifted its
+        delay lines along for every sample, kept here to check the block version against.
+    */
+    template <typename SampleType>
+    struct ReferenceEquirippleFIR
+    {
+        ReferenceEquirippleFIR (const FIR::Coefficients<SampleType>& up,
+                                const FIR::Coefficients<SampleType>& down,
+                                int numChannels)
+            : coefficientsUp (up), coefficientsDown (down)
+        {
+            stateUp.setSize (numChannels, static_cast<int> (coefficientsUp.getFilterOrder() + 1));
+            stateDown.setSize (numChannels, static_cast<int> (coefficientsDown.getFilterOrder() + 1));
+            stateDown2.setSize (numChannels, static_cast<int> ((coefficientsDown.getFilterOrder() + 1) / 4 + 1));
+            position.insertMultiple (0, 0, numChannels);
+
+            stateUp.clear();
+            stateDown.clear();
+            stateDown2.clear();
+        }
+
+        void processSamplesUp (int channel, const SampleType* samples, SampleType* bufferSamples, size_t numSamples)
+        {
+            auto fir = coefficientsUp.getRawCoefficients();
+            auto N = coefficientsUp.getFilterOrder() + 1;
+            auto Ndiv2 = N / 2;
+            auto buf = stateUp.getWritePointer (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                buf[N - 1] = 2 * samples[i];
+
+                auto out = static_cast<SampleType> (0.0);
+
+                for (size_t k = 0; k < Ndiv2; k += 2)
+                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+
+                bufferSamples[i << 1] = out;
+                bufferSamples[(i << 1) + 1] = buf[Ndiv2 + 1] * fir[Ndiv2];
+
+                for (size_t k = 0; k < N - 2; k += 2)
+                    buf[k] = buf[k + 2];
+            }
+        }
+
+        void processSamplesDown (int channel, const SampleType* bufferSamples, SampleType* samples, size_t numSamples)
+        {
+            auto fir = coefficientsDown.getRawCoefficients();
+            auto N = coefficientsDown.getFilterOrder() + 1;
+            auto Ndiv2 = N / 2;
+            auto Ndiv4 = Ndiv2 / 2;
+            auto buf = stateDown.getWritePointer (channel);
+            auto buf2 = stateDown2.getWritePointer (channel);
+            auto pos = position.getUnchecked (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                buf[N - 1] = bufferSamples[i << 1];
+
+                auto out = static_cast<SampleType> (0.0);
+
+                for (size_t k = 0; k < Ndiv2; k += 2)
+                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+
+                out += buf2[pos] * fir[Ndiv2];
+                buf2[pos] = bufferSamples[(i << 1) + 1];
+
+                samples[i] = out;
+
+                for (size_t k = 0; k < N - 2; ++k)
+                    buf[k] = buf[k + 2];
+
+                pos = (pos == 0 ? Ndiv4 : pos - 1);
+            }
+
+            position.setUnchecked (channel, pos);
+        }
+
+        FIR::Coefficients<SampleType> coefficientsUp, coefficientsDown;
+        AudioBuffer<SampleType> stateUp, stateDown, stateDown2;
+        Array<size_t> position;
+    };
+
+    //==============================================================================
+    template <typename SampleType>
+    void testEquirippleFIRStage()
+    {
+        struct FilterSpec { SampleType transitionWidth, stopbandAmplitudedB; };
+
+        // These give a range of filter orders, from short to very long
+        const FilterSpec specs[] = { { (SampleType) 0.2,  (SampleType) -40.0 },
+                                     { (SampleType) 0.1,  (SampleType) -60.0 },
+                                     { (SampleType) 0.06, (SampleType) -75.0 },
+                                     { (SampleType) 0.03, (SampleType) -90.0 } };
+
+        const int blockSizes[] = { 1, 3, 16, 61, 256, 0 };
+
+        constexpr int numChannels = 2, maxBlockSize = 256, numSamplesToProcess = 2048;
+        auto random = getRandom();
+
+        for (const auto& up : specs)
+        {
+            for (const auto& down : specs)
+            {
+                Oversampling2TimesEquirippleFIR<SampleType> stage (numChannels,
+                                                                    up.transitionWidth, up.stopbandAmplitudedB,
+                                                                    down.transitionWidth, down.stopbandAmplitudedB);
+                stage.initProcessing (maxBlockSize);
+                stage.reset();
+
+                ReferenceEquirippleFIR<SampleType> reference (*FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (up.transitionWidth, up.stopbandAmplitudedB),
+                                                              *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (down.transitionWidth, down.stopbandAmplitudedB),
+                                                              numChannels);
+
+                expect (reference.coefficientsUp.getFilterOrder() % 4 == 2);
+                expect (reference.coefficientsDown.getFilterOrder() % 4 == 2);
+
+                for (const auto blockSize : blockSizes)
+                {
+                    AudioBuffer<SampleType> input (numChannels, maxBlockSize), output (numChannels, maxBlockSize);
+                    AudioBuffer<SampleType> oversampled (numChannels, 2 * maxBlockSize);
+                    std::vector<SampleType> expected (2 * maxBlockSize);
+
+                    SampleType maxError = 0;
+
+                    for (int position = 0; position < numSamplesToProcess;)
+                    {
+                        // A block size of zero means a random size for each block
+                        const auto numSamples = (size_t) jmin (numSamplesToProcess - position,
+                                                               blockSize > 0 ? blockSize : 1 + random.nextInt (maxBlockSize));
+
+                        for (int ch = 0; ch < numChannels; ++ch)
+                        {
+                            for (size_t i = 0; i < numSamples; ++i)
+                                input.setSample (ch, (int) i, (SampleType) (2.0f * random.nextFloat() - 1.0f));
+
+                            for (size_t i = 0; i < 2 * numSamples; ++i)
+                                oversampled.setSample (ch, (int) i, (SampleType) (2.0f * random.nextFloat() - 1.0f));
+                        }
+
+                        // Upsampling
+                        stage.processSamplesUp (AudioBlock<const SampleType> (input).getSubBlock (0, numSamples));
+
+                        for (int ch = 0; ch < numChannels; ++ch)
+                        {
+                            reference.processSamplesUp (ch, input.getReadPointer (ch), expected.data(), numSamples);
+
+                            for (size_t i = 0; i < 2 * numSamples; ++i)
+                                maxError = jmax (maxError, std::abs (stage.buffer.getSample (ch, (int) i) - expected[i]));
+                        }
+
+                        // Downsampling, of a different signal so that the two stages are checked separately
+                        for (int ch = 0; ch < numChannels; ++ch)
+                            FloatVectorOperations::copy (stage.buffer.getWritePointer (ch), oversampled.getReadPointer (ch), (int) (2 * numSamples));
+
+                        AudioBlock<SampleType> outputBlock (output);
+                        auto outputSubBlock = outputBlock.getSubBlock (0, numSamples);
+                        stage.processSamplesDown (outputSubBlock);
+
+                        for (int ch = 0; ch < numChannels; ++ch)
+                        {
+                            reference.processSamplesDown (ch, oversampled.getReadPointer (ch), expected.data(), numSamples);
+
+                            for (size_t i = 0; i < numSamples; ++i)
+                                maxError = jmax (maxError, std::abs (output.getSample (ch, (int) i) - expected[i]));
+                        }
+
+                        position += (int) numSamples;
+                    }
+
+                    // The sums are accumulated in the same order, so the only differences
+                    // can come from the compiler fusing multiplies and adds differently
+                    expectLessThan (maxError, (SampleType) 1.0e-5);
+                }
+            }
+        }
+    }
+};
+
+static OversamplingTests oversamplingTests;
+
+} // namespace juce::dsp
@@ -0,0 +1,37 @@
+#include "LoadMeter.h"
+
+//==============================================================================
+LoadMeter::LoadMeter (const ProcessorTelemetry& t)
+    : telemetry (t)
+{
+    setOpaque (true);
+    startTimerHz (15);
+}
+
+void LoadMeter::paint (juce::Graphics& g)
+{
+    auto area = getLocalBounds();
+    g.fillAll (juce::Colours::black);
+
+    auto bar = area.reduced (2).removeFromLeft (juce::roundToInt ((float) (area.getWidth() - 4) * (float) latest.load));
+    g.setColour (juce::Colours::green.interpolatedWith (juce::Colours::red, (float) latest.load));
+    g.fillRect (bar);
+
+    g.setColour (juce::Colours::white);
+    g.setFont (12.0f);
+    g.drawFittedText ("DSP " + juce::String (latest.load * 100.0, 1) + "%"
+                        + "   xruns " + juce::String (latest.xruns)
+                        + "   denormal blocks " + juce::String ((juce::int64) latest.numDenormalBlocks),
+                      area.reduced (4, 0), juce::Justification::centredLeft, 1);
+}
+
+void LoadMeter::timerCallback()
+{
+    const auto snapshot = telemetry.getSnapshot();
+
+    if (snapshot.numBlocks != latest.numBlocks || snapshot.xruns != latest.xruns)
+    {
+        latest = snapshot;
+        repaint();
+    }
+}
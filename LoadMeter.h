@@ -0,0 +1,28 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "ProcessorTelemetry.h"
+
+//==============================================================================
+/** Shows a processor's DSP load as a bar, with its xrun and denormal counts.
+
+    The telemetry is polled on a timer, which is lock-free on the processor's
+    side, so the meter can't hold up the audio thread.
+*/
+class LoadMeter final : public juce::Component,
+                        private juce::Timer
+{
+public:
+    explicit LoadMeter (const ProcessorTelemetry&);
+
+    void paint (juce::Graphics&) override;
+
+private:
+    void timerCallback() override;
+
+    const ProcessorTelemetry& telemetry;
+    ProcessorTelemetry::Snapshot latest;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoadMeter)
+};
@@ -0,0 +1,212 @@
+#include "LookaheadLimiter.h"
+
+//==============================================================================
+template <typename SampleType>
+LookaheadLimiter<SampleType>::SlidingMinimum::SlidingMinimum (int windowSize)
+    : values ((size_t) windowSize + 1),
+      indices ((size_t) windowSize + 1),
+      window (windowSize),
+      capacity (windowSize + 1)
+{
+    reset (1);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::SlidingMinimum::reset (SampleType initialValue) noexcept
+{
+    // Starting with a single entry at the end of the window is the same as a
+    // window full of the initial value, as none of those could ever be the minimum.
+    position = 0;
+    head = 0;
+    size = 1;
+    values[0] = initialValue;
+    indices[0] = -1;
+}
+
+template <typename SampleType>
+SampleType LookaheadLimiter<SampleType>::SlidingMinimum::push (SampleType value) noexcept
+{
+    // The deque holds the values that could still become the minimum, in the order
+    // they arrived, so they're always increasing from front to back. Anything that
+    // isn't smaller than the new value never will be, and each value is added and
+    // removed once, so this is constant time per sample on average.
+    while (size > 0 && values[(size_t) ((head + size - 1) % capacity)] >= value)
+        --size;
+
+    const auto back = (head + size) % capacity;
+    values[(size_t) back] = value;
+    indices[(size_t) back] = position;
+    ++size;
+
+    // The front leaves once it's older than the window
+    if (indices[(size_t) head] <= position - window)
+    {
+        head = (head + 1) % capacity;
+        --size;
+    }
+
+    ++position;
+    return values[(size_t) head];
+}
+
+//==============================================================================
+template <typename SampleType>
+LookaheadLimiter<SampleType>::LookaheadLimiter (int channels,
+                                                double sampleRate,
+                                                int maximumBlockSize,
+                                                float lookaheadMilliseconds,
+                                                int holdSamples,
+                                                int peakDelaySamples)
+    : numChannels (channels),
+      lookaheadSamples (juce::jmax (1, juce::roundToInt (sampleRate * 0.001
+                                                         * juce::jlimit (minLookaheadMilliseconds,
+                                                                         maxLookaheadMilliseconds,
+                                                                         lookaheadMilliseconds)))),
+      delaySamples (lookaheadSamples + juce::jmax (0, holdSamples) + juce::jmax (0, peakDelaySamples)),
+      delayLine (channels, delaySamples),
+      scratch (2, maximumBlockSize),
+      // Holding the gain either side of a peak just widens the window that it's the minimum of
+      windowMinimum (lookaheadSamples + 2 * juce::jmax (0, holdSamples) + 1),
+      averageHistory ((size_t) lookaheadSamples)
+{
+    releaseCoefficient = (SampleType) std::exp (-1.0 / (releaseSeconds * sampleRate));
+    reset();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::reset() noexcept
+{
+    delayLine.clear();
+    delayPosition = 0;
+
+    windowMinimum.reset (1);
+    std::fill (averageHistory.begin(), averageHistory.end(), (SampleType) 1);
+    averagePosition = 0;
+    averageSum = lookaheadSamples;
+    numUnityGains = lookaheadSamples;
+    releasedGain = 1;
+}
+
+//==============================================================================
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::process (juce::AudioBuffer<SampleType>& buffer, float ceilingDecibels) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+
+    jassert (buffer.getNumChannels() >= numChannels);
+    jassert (buffer.getNumSamples() <= scratch.getNumSamples());
+
+    const auto numSamples = buffer.getNumSamples();
+    auto* peak = scratch.getWritePointer (0);
+    auto* gain = scratch.getWritePointer (1);
+
+    // The loudest channel at each sample decides the gain for all of them
+    FVO::abs (peak, buffer.getReadPointer (0), numSamples);
+
+    for (int channel = 1; channel < numChannels; ++channel)
+    {
+        FVO::abs (gain, buffer.getReadPointer (channel), numSamples);
+        FVO::max (peak, peak, gain, numSamples);
+    }
+
+    process (buffer, peak, ceilingDecibels);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::process (juce::AudioBuffer<SampleType>& buffer, const SampleType* peak, float ceilingDecibels) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+
+    jassert (buffer.getNumChannels() >= numChannels);
+    jassert (buffer.getNumSamples() <= scratch.getNumSamples());
+
+    const auto numSamples = buffer.getNumSamples();
+    const auto ceiling = juce::Decibels::decibelsToGain ((SampleType) ceilingDecibels);
+    auto* gain = scratch.getWritePointer (1);
+
+    // Once the gain has recovered, blocks that stay under the ceiling only need delaying
+    const auto isIdle = numUnityGains >= lookaheadSamples && windowMinimum.getMinimum() >= (SampleType) 1;
+
+    if (isIdle && FVO::findMaximum (peak, numSamples) <= ceiling)
+    {
+        delay (buffer);
+        return;
+    }
+
+    computeGain (peak, gain, numSamples, ceiling);
+    delay (buffer);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        FVO::multiply (buffer.getWritePointer (channel), gain, numSamples);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::computeGain (const SampleType* peak, SampleType* gainOut, int numSamples, SampleType ceiling) noexcept
+{
+    // The gain that each sample needs on its own. This loop has no dependencies
+    // between samples, so the compiler vectorises it.
+    for (int i = 0; i < numSamples; ++i)
+        gainOut[i] = ceiling / juce::jmax (peak[i], ceiling);
+
+    const auto averageScale = 1.0 / lookaheadSamples;
+    auto g = releasedGain;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Recover exponentially, but never above what the next lookahead's worth
+        // of samples needs. Snapping to unity lets the fast path take over again.
+        g = (SampleType) 1 - ((SampleType) 1 - g) * releaseCoefficient;
+
+        if (g > (SampleType) 0.99999)
+            g = 1;
+
+        g = juce::jmin (g, windowMinimum.push (gainOut[i]));
+
+        // A running sum makes the moving average constant time as well
+        auto& oldest = averageHistory[(size_t) averagePosition];
+        averageSum += (double) g - (double) oldest;
+        oldest = g;
+
+        if (++averagePosition == lookaheadSamples)
+            averagePosition = 0;
+
+        numUnityGains = g >= (SampleType) 1 ? numUnityGains + 1 : 0;
+
+        gainOut[i] = (SampleType) juce::jmin (1.0, averageSum * averageScale);
+    }
+
+    releasedGain = g;
+
+    // Nothing but unity is left in the average, so clear out any rounding errors
+    if (numUnityGains >= lookaheadSamples)
+        averageSum = lookaheadSamples;
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::delay (juce::AudioBuffer<SampleType>& buffer) noexcept
+{
+    const auto numSamples = buffer.getNumSamples();
+    int done = 0;
+
+    // Swapping the block with the delay line puts the delayed samples in the block
+    // and the new ones in the delay line, in a single pass over each.
+    while (done < numSamples)
+    {
+        const auto chunk = juce::jmin (numSamples - done, delaySamples - delayPosition);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = buffer.getWritePointer (channel) + done;
+            std::swap_ranges (samples, samples + chunk, delayLine.getWritePointer (channel) + delayPosition);
+        }
+
+        done += chunk;
+        delayPosition += chunk;
+
+        if (delayPosition == delaySamples)
+            delayPosition = 0;
+    }
+}
+
+template class LookaheadLimiter<float>;
+template class LookaheadLimiter<double>;
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/** A brickwall limiter that looks ahead, so its gain is already down by the time
+    a peak reaches the output, and no sample ever goes over the ceiling.
+
+    The input is delayed by the lookahead time. The gain that each input sample
+    needs is the ceiling divided by its peak across all of the channels, and the
+    gain at the output is the smallest of these over the lookahead window,
+    averaged over the window again so that it ramps down in a straight line
+    instead of stepping. Every sample in the average is no higher than the gain
+    that the delayed sample needs, so neither is the average.
+
+    The window minimum is found with a monotonic deque, so it costs the same
+    amount per sample whatever the lookahead time. The peaks, the gains they
+    need, the delay and the final multiply run on whole blocks, and blocks that
+    stay under the ceiling skip the gain calculation altogether.
+
+    The peaks can also be measured elsewhere, such as by the TruePeakLimiter
+    from an oversampled copy of the signal, and passed in along with the block.
+
+    Constructing a limiter allocates, so it must be done off the audio thread.
+*/
+template <typename SampleType>
+class LookaheadLimiter final
+{
+public:
+    //==============================================================================
+    /** The shortest and longest lookahead times, in milliseconds. */
+    static constexpr float minLookaheadMilliseconds = 1.0f;
+    static constexpr float maxLookaheadMilliseconds = 20.0f;
+
+    /** The time it takes the gain to recover after a peak. */
+    static constexpr double releaseSeconds = 0.05;
+
+    /** Creates a limiter that looks ahead by the given time, which is clamped to
+        the range above.
+
+        The gain can be held down for holdSamples either side of each peak, as well
+        as ramping down before it. When the peaks are passed in, peakDelaySamples is
+        how far behind the block they are, and the block is delayed by that much more.
+    */
+    LookaheadLimiter (int numChannels,
+                      double sampleRate,
+                      int maximumBlockSize,
+                      float lookaheadMilliseconds,
+                      int holdSamples = 0,
+                      int peakDelaySamples = 0);
+
+    //==============================================================================
+    /** Returns the delay, in samples, that the limiter adds. This is the lookahead
+        time, plus any hold time and peak delay.
+    */
+    int getLatencySamples() const noexcept              { return delaySamples; }
+
+    /** Returns the number of samples that come out after the input falls silent. */
+    int getTailSamples() const noexcept                 { return delaySamples; }
+
+    /** Clears the delay line and lets go of any gain reduction. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Limits the first numChannels channels of the buffer in place.
+
+        The buffer mustn't have more samples than the maximum block size that the
+        limiter was created with.
+    */
+    void process (juce::AudioBuffer<SampleType>& buffer, float ceilingDecibels) noexcept;
+
+    /** Limits the first numChannels channels of the buffer in place, using peaks
+        that have already been measured, one for each sample of the buffer.
+    */
+    void process (juce::AudioBuffer<SampleType>& buffer, const SampleType* peaks, float ceilingDecibels) noexcept;
+
+private:
+    //==============================================================================
+    /** Keeps the smallest of the last windowSize values pushed into it. */
+    class SlidingMinimum final
+    {
+    public:
+        explicit SlidingMinimum (int windowSize);
+
+        void reset (SampleType initialValue) noexcept;
+        SampleType push (SampleType value) noexcept;
+
+        /** Returns the smallest value in the window. */
+        SampleType getMinimum() const noexcept      { return values[(size_t) head]; }
+
+    private:
+        std::vector<SampleType> values;
+        std::vector<juce::int64> indices;
+        juce::int64 position = 0;
+        int window = 0, capacity = 0, head = 0, size = 0;
+    };
+
+    void computeGain (const SampleType* peak, SampleType* gainOut, int numSamples, SampleType ceiling) noexcept;
+    void delay (juce::AudioBuffer<SampleType>& buffer) noexcept;
+
+    const int numChannels, lookaheadSamples, delaySamples;
+    juce::AudioBuffer<SampleType> delayLine, scratch;
+    int delayPosition = 0;
+
+    SlidingMinimum windowMinimum;
+    std::vector<SampleType> averageHistory;
+    int averagePosition = 0, numUnityGains = 0;
+    double averageSum = 0;
+
+    SampleType releaseCoefficient = 0, releasedGain = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LookaheadLimiter)
+};
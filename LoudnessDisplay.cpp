@@ -0,0 +1,54 @@
+#include "LoudnessDisplay.h"
+
+//==============================================================================
+LoudnessDisplay::LoudnessDisplay (LoudnessMeter& m)
+    : meter (m)
+{
+    setOpaque (true);
+    startTimerHz (10);
+}
+
+void LoudnessDisplay::paint (juce::Graphics& g)
+{
+    auto area = getLocalBounds();
+    g.fillAll (juce::Colours::black);
+
+    // The bar spans 60 LU, up to 0 LUFS, so the EBU R128 target of -23 LUFS sits
+    // a little to the right of the middle
+    const auto proportion = juce::jlimit (0.0f, 1.0f, (latest.shortTerm + 60.0f) / 60.0f);
+    auto bar = area.reduced (2).removeFromLeft (juce::roundToInt ((float) (area.getWidth() - 4) * proportion));
+    g.setColour (juce::Colours::darkcyan);
+    g.fillRect (bar);
+
+    const auto format = [] (float value)
+    {
+        return value <= LoudnessMeter::minusInfinityDb ? juce::String ("-inf") : juce::String (value, 1);
+    };
+
+    g.setColour (juce::Colours::white);
+    g.setFont (12.0f);
+    g.drawFittedText ("M " + format (latest.momentary)
+                        + "   S " + format (latest.shortTerm)
+                        + "   I " + format (latest.integrated) + " LUFS"
+                        + "   TP " + format (latest.truePeak) + " dBTP",
+                      area.reduced (4, 0), juce::Justification::centredLeft, 1);
+}
+
+void LoudnessDisplay::mouseDown (const juce::MouseEvent&)
+{
+    meter.requestReset();
+}
+
+void LoudnessDisplay::timerCallback()
+{
+    const auto snapshot = meter.getSnapshot();
+
+    if (! juce::exactlyEqual (snapshot.momentary, latest.momentary)
+        || ! juce::exactlyEqual (snapshot.shortTerm, latest.shortTerm)
+        || ! juce::exactlyEqual (snapshot.integrated, latest.integrated)
+        || ! juce::exactlyEqual (snapshot.truePeak, latest.truePeak))
+    {
+        latest = snapshot;
+        repaint();
+    }
+}
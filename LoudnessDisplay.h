@@ -0,0 +1,31 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "LoudnessMeter.h"
+
+//==============================================================================
+/** Shows a LoudnessMeter's momentary, short-term and integrated loudness, with a
+    bar for the short-term figure, and the highest true peak. Clicking it starts a
+    new measurement.
+
+    The meter is polled on a timer, which is lock-free on the processor's side, so
+    the display can't hold up the audio thread.
+*/
+class LoudnessDisplay final : public juce::Component,
+                              private juce::Timer
+{
+public:
+    explicit LoudnessDisplay (LoudnessMeter&);
+
+    void paint (juce::Graphics&) override;
+    void mouseDown (const juce::MouseEvent&) override;
+
+private:
+    void timerCallback() override;
+
+    LoudnessMeter& meter;
+    LoudnessMeter::Snapshot latest;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessDisplay)
+};
@@ -0,0 +1,412 @@
+#include "LoudnessMeter.h"
+
+//==============================================================================
+namespace
+{
+    using FVO = juce::FloatVectorOperations;
+
+    /** The first stage of the K-weighting: a high shelf that models the acoustic
+        effect of the head. BS.1770 gives the coefficients for 48 kHz; these are
+        the same filter, worked out again for any rate.
+    */
+    std::array<float, 6> makePreFilter (double sampleRate)
+    {
+        constexpr double frequency = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+
+        const auto k = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const auto vh = std::pow (10.0, gainDb / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        return { (float) ((vh + vb * k / q + k * k) / a0),
+                 (float) (2.0 * (k * k - vh) / a0),
+                 (float) ((vh - vb * k / q + k * k) / a0),
+                 1.0f,
+                 (float) (2.0 * (k * k - 1.0) / a0),
+                 (float) ((1.0 - k / q + k * k) / a0) };
+    }
+
+    /** The second stage of the K-weighting: the revised low frequency B curve, a
+        high-pass at about 38 Hz.
+    */
+    std::array<float, 6> makeHighPass (double sampleRate)
+    {
+        constexpr double frequency = 38.13547087602444, q = 0.5003270373238773;
+
+        const auto k = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        return { 1.0f, -2.0f, 1.0f, 1.0f,
+                 (float) (2.0 * (k * k - 1.0) / a0),
+                 (float) ((1.0 - k / q + k * k) / a0) };
+    }
+
+    /** The zeroth order modified Bessel function of the first kind, for the Kaiser window. */
+    double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= juce::square (0.5 * x / k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    float getMagnitude (const float* samples, int numSamples) noexcept
+    {
+        const auto range = FVO::findMinAndMax (samples, numSamples);
+        return juce::jmax (-range.getStart(), range.getEnd());
+    }
+}
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter()
+    : binPower ((size_t) numHistogramBins),
+      binCount ((size_t) numHistogramBins)
+{
+}
+
+void LoudnessMeter::prepare (double sampleRate, int maxBlockSize, const juce::AudioChannelSet& layout)
+{
+    numChannels = layout.size();
+    maximumBlockSize = juce::jmax (1, maxBlockSize);
+
+    channelWeights.resize ((size_t) numChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        channelWeights[(size_t) ch] = getChannelWeight (layout.getTypeOfChannel (ch));
+
+    kWeighting.prepare ({ sampleRate, (juce::uint32) maximumBlockSize, (juce::uint32) numChannels });
+    kWeighting.setNumStages (2);
+    kWeighting.setCoefficients (0, makePreFilter (sampleRate));
+    kWeighting.setCoefficients (1, makeHighPass (sampleRate));
+
+    weighted.setSize (numChannels, maximumBlockSize);
+    truePeakInput.setSize (numChannels, truePeakHistory + maximumBlockSize);
+    truePeakPhase.resize ((size_t) maximumBlockSize);
+
+    // Higher rates already capture most of the peaks between samples
+    truePeakFactor = sampleRate < 96000.0 ? 4 : (sampleRate < 192000.0 ? 2 : 1);
+
+    // A Kaiser windowed sinc at the original Nyquist frequency, split into one
+    // set of taps per phase. Phase 0 lands on the samples themselves, so only the
+    // others need filtering. Each is normalised so that DC passes unchanged.
+    const auto halfLength = truePeakTapsPerPhase / 2;
+    constexpr double beta = 5.0;
+
+    truePeakTaps.resize ((size_t) (truePeakTapsPerPhase * truePeakFactor));
+
+    for (int phase = 1; phase < truePeakFactor; ++phase)
+    {
+        auto* taps = truePeakTaps.data() + phase * truePeakTapsPerPhase;
+        double sum = 0.0;
+
+        for (int k = 0; k < truePeakTapsPerPhase; ++k)
+        {
+            const auto x = k - halfLength + (double) phase / truePeakFactor;
+            const auto sinc = std::sin (juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const auto window = besselI0 (beta * std::sqrt (1.0 - juce::square (x / halfLength))) / besselI0 (beta);
+
+            taps[k] = (float) (sinc * window);
+            sum += taps[k];
+        }
+
+        for (int k = 0; k < truePeakTapsPerPhase; ++k)
+            taps[k] = (float) (taps[k] / sum);
+    }
+
+    samplesPerStep = juce::jmax (1, juce::roundToInt (sampleRate * 0.1));
+
+    reset();
+}
+
+void LoudnessMeter::reset() noexcept
+{
+    kWeighting.reset();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        FVO::clear (truePeakInput.getWritePointer (ch), truePeakHistory);
+
+    truePeakMaximum = 0.0f;
+
+    samplesInStep = 0;
+    stepPower = 0.0;
+    steps.fill (0.0);
+    newestStep = 0;
+    numSteps = 0;
+    momentarySum = 0.0;
+    shortTermSum = 0.0;
+
+    std::fill (binPower.begin(), binPower.end(), 0.0);
+    std::fill (binCount.begin(), binCount.end(), (juce::uint64) 0);
+    gatedPower = 0.0;
+    numGated = 0;
+
+    publish();
+}
+
+float LoudnessMeter::getChannelWeight (juce::AudioChannelSet::ChannelType type) noexcept
+{
+    using Set = juce::AudioChannelSet;
+
+    // BS.1770-4 weights the channels between 60 and 120 degrees from the front
+    // by +1.5 dB, and leaves the LFE out altogether
+    if (type == Set::leftSurround || type == Set::rightSurround
+        || type == Set::leftSurroundSide || type == Set::rightSurroundSide)
+        return 1.41f;
+
+    if (type == Set::LFE || type == Set::LFE2)
+        return 0.0f;
+
+    return 1.0f;
+}
+
+LoudnessMeter::Snapshot LoudnessMeter::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+    snapshot.momentary = momentary.load (std::memory_order_relaxed);
+    snapshot.shortTerm = shortTerm.load (std::memory_order_relaxed);
+    snapshot.integrated = integrated.load (std::memory_order_relaxed);
+    snapshot.truePeak = truePeak.load (std::memory_order_relaxed);
+    return snapshot;
+}
+
+//==============================================================================
+template <typename SampleType>
+void LoudnessMeter::process (const juce::AudioBuffer<SampleType>& buffer) noexcept
+{
+    // A load, rather than an exchange, keeps a locked instruction out of every
+    // block. A request that comes in between the two is covered by this reset.
+    if (resetRequested.load (std::memory_order_relaxed))
+    {
+        resetRequested.store (false, std::memory_order_relaxed);
+        reset();
+    }
+
+    if (numChannels == 0)
+        return;
+
+    const auto channels = juce::jmin (numChannels, buffer.getNumChannels());
+
+    for (int start = 0; start < buffer.getNumSamples(); start += maximumBlockSize)
+    {
+        const auto numSamples = juce::jmin (maximumBlockSize, buffer.getNumSamples() - start);
+
+        if (buffer.hasBeenCleared())
+        {
+            measureSilence (numSamples);
+            continue;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* dest = truePeakInput.getWritePointer (ch, truePeakHistory);
+
+            if (ch >= channels)
+                FVO::clear (dest, numSamples);
+            else if constexpr (std::is_same_v<SampleType, float>)
+                FVO::copy (dest, buffer.getReadPointer (ch, start), numSamples);
+            else
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] = (float) buffer.getReadPointer (ch, start)[i];
+
+            FVO::copy (weighted.getWritePointer (ch), dest, numSamples);
+        }
+
+        measureTruePeak (numSamples);
+
+        juce::dsp::AudioBlock<float> block (weighted.getArrayOfWritePointers(), (size_t) numChannels, (size_t) numSamples);
+        kWeighting.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+        measureWeighted (numSamples);
+    }
+
+    truePeak.store (juce::Decibels::gainToDecibels (truePeakMaximum, minusInfinityDb), std::memory_order_relaxed);
+}
+
+template void LoudnessMeter::process (const juce::AudioBuffer<float>&) noexcept;
+template void LoudnessMeter::process (const juce::AudioBuffer<double>&) noexcept;
+
+void LoudnessMeter::measureTruePeak (int numSamples) noexcept
+{
+    auto* phaseOutput = truePeakPhase.data();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* history = truePeakInput.getWritePointer (ch);
+        const auto* input = history + truePeakHistory;
+
+        truePeakMaximum = juce::jmax (truePeakMaximum, getMagnitude (input, numSamples));
+
+        // Each phase is an FIR filter over the whole block, one tap at a time
+        for (int phase = 1; phase < truePeakFactor; ++phase)
+        {
+            const auto* taps = truePeakTaps.data() + phase * truePeakTapsPerPhase;
+
+            FVO::copyWithMultiply (phaseOutput, input, taps[0], numSamples);
+
+            for (int k = 1; k < truePeakTapsPerPhase; ++k)
+                FVO::addWithMultiply (phaseOutput, input - k, taps[k], numSamples);
+
+            truePeakMaximum = juce::jmax (truePeakMaximum, getMagnitude (phaseOutput, numSamples));
+        }
+
+        std::memmove (history, history + numSamples, (size_t) truePeakHistory * sizeof (float));
+    }
+}
+
+void LoudnessMeter::measureWeighted (int numSamples) noexcept
+{
+    for (int position = 0; position < numSamples;)
+    {
+        const auto numThisStep = juce::jmin (numSamples - position, samplesPerStep - samplesInStep);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto weight = channelWeights[(size_t) ch];
+
+            if (juce::exactlyEqual (weight, 0.0f))
+                continue;
+
+            const auto* samples = weighted.getReadPointer (ch, position);
+            double sum = 0.0;
+
+            for (int i = 0; i < numThisStep; ++i)
+                sum += (double) (samples[i] * samples[i]);
+
+            stepPower += weight * sum;
+        }
+
+        position += numThisStep;
+        samplesInStep += numThisStep;
+
+        if (samplesInStep == samplesPerStep)
+            finishStep();
+    }
+}
+
+void LoudnessMeter::measureSilence (int numSamples) noexcept
+{
+    // Silence leaves nothing ringing in the filters, and adds no power
+    kWeighting.reset();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        FVO::clear (truePeakInput.getWritePointer (ch), truePeakHistory);
+
+    for (int position = 0; position < numSamples;)
+    {
+        const auto numThisStep = juce::jmin (numSamples - position, samplesPerStep - samplesInStep);
+
+        position += numThisStep;
+        samplesInStep += numThisStep;
+
+        if (samplesInStep == samplesPerStep)
+            finishStep();
+    }
+}
+
+//==============================================================================
+void LoudnessMeter::finishStep() noexcept
+{
+    const auto power = stepPower / samplesPerStep;
+
+    // The step that's overwritten is the one leaving the short-term window, and
+    // the one four before the new step is leaving the momentary window
+    newestStep = (newestStep + 1) % stepsPerShortTerm;
+
+    shortTermSum += power - steps[(size_t) newestStep];
+    momentarySum += power - steps[(size_t) ((newestStep + stepsPerShortTerm - stepsPerMomentary) % stepsPerShortTerm)];
+    steps[(size_t) newestStep] = power;
+
+    // Once per lap of the ring, the sums are started afresh, so that rounding
+    // errors can't build up
+    if (newestStep == 0)
+    {
+        shortTermSum = std::accumulate (steps.begin(), steps.end(), 0.0);
+        momentarySum = 0.0;
+
+        for (int i = 0; i < stepsPerMomentary; ++i)
+            momentarySum += steps[(size_t) ((stepsPerShortTerm - i) % stepsPerShortTerm)];
+    }
+
+    numSteps = juce::jmin (numSteps + 1, stepsPerShortTerm);
+
+    if (numSteps >= stepsPerMomentary)
+        addGatingBlock (momentarySum / stepsPerMomentary);
+
+    samplesInStep = 0;
+    stepPower = 0.0;
+
+    publish();
+}
+
+void LoudnessMeter::addGatingBlock (double power) noexcept
+{
+    constexpr double absoluteGate = -70.0;
+
+    if (power <= 0.0)
+        return;
+
+    const auto loudness = -0.691 + 10.0 * std::log10 (power);
+
+    if (loudness <= absoluteGate)
+        return;
+
+    const auto bin = (size_t) juce::jlimit (0, numHistogramBins - 1, (int) ((loudness - histogramFloor) * binsPerLU));
+    binPower[bin] += power;
+    ++binCount[bin];
+
+    gatedPower += power;
+    ++numGated;
+}
+
+float LoudnessMeter::toLoudness (double power) noexcept
+{
+    if (power <= 0.0)
+        return minusInfinityDb;
+
+    return juce::jmax (minusInfinityDb, (float) (-0.691 + 10.0 * std::log10 (power)));
+}
+
+void LoudnessMeter::publish() noexcept
+{
+    momentary.store (toLoudness (juce::jmax (0.0, momentarySum) / stepsPerMomentary), std::memory_order_relaxed);
+    shortTerm.store (toLoudness (juce::jmax (0.0, shortTermSum) / stepsPerShortTerm), std::memory_order_relaxed);
+    truePeak.store (juce::Decibels::gainToDecibels (truePeakMaximum, minusInfinityDb), std::memory_order_relaxed);
+
+    if (numGated == 0)
+    {
+        integrated.store (minusInfinityDb, std::memory_order_relaxed);
+        return;
+    }
+
+    // The relative gate is 10 LU below the loudness of everything that passed the
+    // absolute gate. Only the bins from the one holding that threshold up count.
+    const auto relativeGate = -0.691 + 10.0 * std::log10 (gatedPower / (double) numGated) - 10.0;
+    const auto firstBin = juce::jlimit (0, numHistogramBins - 1, (int) ((relativeGate - histogramFloor) * binsPerLU));
+
+    double power = 0.0;
+    juce::uint64 count = 0;
+
+    for (auto bin = (size_t) firstBin; bin < binPower.size(); ++bin)
+    {
+        power += binPower[bin];
+        count += binCount[bin];
+    }
+
+    integrated.store (count > 0 ? toLoudness (power / (double) count) : minusInfinityDb, std::memory_order_relaxed);
+}
+
+//==============================================================================
+juce::var LoudnessMeter::Snapshot::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty ("momentaryLufs", momentary);
+    object->setProperty ("shortTermLufs", shortTerm);
+    object->setProperty ("integratedLufs", integrated);
+    object->setProperty ("truePeakDbtp", truePeak);
+    return juce::var (object);
+}
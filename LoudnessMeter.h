@@ -0,0 +1,146 @@
+#pragma once
+
+#include "BiquadCascade.h"
+
+//==============================================================================
+/** Measures loudness as ITU-R BS.1770-4 and EBU R128 define it: momentary,
+    short-term and integrated loudness in LUFS, and the true peak in dBTP.
+
+    The signal is K-weighted by a two stage BiquadCascade, which filters every
+    channel in the same pass, and each channel's power is weighted by its position
+    in the layout: 1.41 for the surround channels at the sides, 0 for the LFE, and
+    1 for everything else.
+
+    The power is collected in 100 ms steps, which are kept in a ring buffer holding
+    the last 3 seconds. The momentary and short-term loudness are the mean of the
+    last 4 and 30 steps, kept as running sums that each new step adds to and the
+    oldest one subtracts from. Every 400 ms gating block (four steps, so 75%
+    overlap) that passes the absolute gate goes into a histogram of 0.1 LU bins,
+    which is all that the integrated loudness needs, however long the measurement
+    runs. The relative gate is applied to the histogram, so the integrated figure
+    is exact to within a bin's width.
+
+    The true peak is the highest absolute value of the signal oversampled by 4
+    (2 above 96 kHz, and none above 192 kHz) with a 12 tap per phase polyphase
+    FIR, as described in BS.1770-4's Annex 2.
+
+    Only the audio thread writes the results, each into its own atomic, so any
+    thread can call getSnapshot() without locking. Only prepare() allocates.
+*/
+class LoudnessMeter final
+{
+public:
+    //==============================================================================
+    /** Reported for anything quieter than this, including loudness that hasn't been
+        measured yet.
+    */
+    static constexpr float minusInfinityDb = -100.0f;
+
+    /** The results at one moment in time. */
+    struct Snapshot
+    {
+        /** The loudness over the last 400 ms, in LUFS. */
+        float momentary = minusInfinityDb;
+
+        /** The loudness over the last 3 seconds, in LUFS. */
+        float shortTerm = minusInfinityDb;
+
+        /** The gated loudness since the meter was last reset, in LUFS. */
+        float integrated = minusInfinityDb;
+
+        /** The highest true peak since the meter was last reset, in dBTP. */
+        float truePeak = minusInfinityDb;
+
+        /** Converts this to an object that can be written as JSON. */
+        juce::var toVar() const;
+    };
+
+    LoudnessMeter();
+
+    //==============================================================================
+    /** Allocates the filters and working space, and resets the measurement.
+
+        The layout sets the number of channels that are measured, and each one's
+        weighting. This must not be called while a block is being measured.
+    */
+    void prepare (double sampleRate, int maximumBlockSize, const juce::AudioChannelSet& layout);
+
+    /** Starts a new measurement. This must only be called on the thread that calls
+        process(); other threads can use requestReset() instead.
+    */
+    void reset() noexcept;
+
+    /** Asks for the measurement to start again at the beginning of the next block.
+        This is lock-free, and safe to call from any thread.
+    */
+    void requestReset() noexcept                        { resetRequested.store (true, std::memory_order_relaxed); }
+
+    /** Returns the current results. This is lock-free, and safe to call from any
+        thread.
+
+        The values are read one at a time, so they may come from either side of a
+        step that finishes while this is running.
+    */
+    Snapshot getSnapshot() const noexcept;
+
+    /** Returns the weight that BS.1770 gives to a channel of the given type. */
+    static float getChannelWeight (juce::AudioChannelSet::ChannelType) noexcept;
+
+    //==============================================================================
+    /** Measures a block. Anything beyond the prepared number of channels is ignored,
+        and the block must be no longer than the prepared maximum.
+
+        Buffers that have been cleared are counted as silence without being filtered.
+    */
+    template <typename SampleType>
+    void process (const juce::AudioBuffer<SampleType>& buffer) noexcept;
+
+private:
+    //==============================================================================
+    void measureWeighted (int numSamples) noexcept;
+    void measureSilence (int numSamples) noexcept;
+    void measureTruePeak (int numSamples) noexcept;
+    void finishStep() noexcept;
+    void addGatingBlock (double power) noexcept;
+    void publish() noexcept;
+
+    static float toLoudness (double power) noexcept;
+
+    //==============================================================================
+    static constexpr int stepsPerMomentary = 4, stepsPerShortTerm = 30;
+    static constexpr int truePeakTapsPerPhase = 12, truePeakHistory = truePeakTapsPerPhase - 1;
+
+    // The histogram covers -70 to +30 LUFS, in 0.1 LU bins
+    static constexpr double histogramFloor = -70.0, binsPerLU = 10.0;
+    static constexpr int numHistogramBins = 1000;
+
+    int numChannels = 0, maximumBlockSize = 0;
+    std::vector<float> channelWeights;
+
+    // The K-weighting runs on a copy of the block, which also holds each
+    // channel's last few input samples for the true peak filter
+    BiquadCascade<float> kWeighting;
+    juce::AudioBuffer<float> weighted, truePeakInput;
+    std::vector<float> truePeakTaps, truePeakPhase;
+    int truePeakFactor = 1;
+    float truePeakMaximum = 0.0f;
+
+    // The current step, and the ring buffer of finished ones
+    int samplesPerStep = 0, samplesInStep = 0;
+    double stepPower = 0.0;
+    std::array<double, stepsPerShortTerm> steps {};
+    int newestStep = 0, numSteps = 0;
+    double momentarySum = 0.0, shortTermSum = 0.0;
+
+    // The gating blocks that have passed the absolute gate
+    std::vector<double> binPower;
+    std::vector<juce::uint64> binCount;
+    double gatedPower = 0.0;
+    juce::uint64 numGated = 0;
+
+    std::atomic<float> momentary { minusInfinityDb }, shortTerm { minusInfinityDb },
+                       integrated { minusInfinityDb }, truePeak { minusInfinityDb };
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+//==============================================================================
+namespace ParameterIDs
+{
+    inline constexpr auto gain               = "gain";
+    inline constexpr auto truePeak           = "truePeak";
+    inline constexpr auto ceiling            = "ceiling";
+    inline constexpr auto oversampling       = "oversampling";
+    inline constexpr auto truePeakAttack     = "truePeakAttack";
+    inline constexpr auto lookahead          = "lookahead";
+    inline constexpr auto lookaheadTime      = "lookaheadTime";
+    inline constexpr auto lowCut             = "lowCut";
+    inline constexpr auto lowCutFrequency    = "lowCutFrequency";
+    inline constexpr auto tilt               = "tilt";
+}
+
+//==============================================================================
+/** A parameter that has been looked up by ID once, up front, so that the audio
+    thread can read it with a single relaxed atomic load instead of searching the
+    AudioProcessorValueTreeState's adapter table every block.
+*/
+template <typename ValueType>
+class ParameterHandle final
+{
+public:
+    ParameterHandle (juce::AudioProcessorValueTreeState& state, juce::StringRef parameterID)
+        : value (state.getRawParameterValue (parameterID))
+    {
+        // The parameter must be part of the state's layout before the handle is created
+        jassert (value != nullptr);
+    }
+
+    ValueType get() const noexcept
+    {
+        const auto raw = value->load (std::memory_order_relaxed);
+
+        if constexpr (std::is_same_v<ValueType, bool>)
+            return raw >= 0.5f;
+        else if constexpr (std::is_integral_v<ValueType>)
+            return static_cast<ValueType> (juce::roundToInt (raw));
+        else
+            return static_cast<ValueType> (raw);
+    }
+
+private:
+    const std::atomic<float>* value = nullptr;
+};
+
+//==============================================================================
+/** The values of every parameter, read once at the start of each block so that
+    the whole block sees a consistent set of values.
+*/
+struct ParameterSnapshot
+{
+    float gainDecibels = 0.0f;
+
+    bool truePeakEnabled = false;
+    float ceilingDecibels = 0.0f;
+    int oversamplingIndex = 0;          // 2x, 4x, 8x or 16x
+    int truePeakAttackIndex = 0;        // fast or smooth
+
+    bool lookaheadEnabled = false;
+    float lookaheadMilliseconds = 0.0f;
+
+    bool lowCutEnabled = false;
+    float lowCutFrequency = 0.0f;
+    float tiltDecibels = 0.0f;
+};
+
+//==============================================================================
+/** Holds a handle for each of the processor's parameters. */
+class ParameterHandles final
+{
+public:
+    explicit ParameterHandles (juce::AudioProcessorValueTreeState& state)
+        : gain (state, ParameterIDs::gain),
+          truePeak (state, ParameterIDs::truePeak),
+          ceiling (state, ParameterIDs::ceiling),
+          oversampling (state, ParameterIDs::oversampling),
+          truePeakAttack (state, ParameterIDs::truePeakAttack),
+          lookahead (state, ParameterIDs::lookahead),
+          lookaheadTime (state, ParameterIDs::lookaheadTime),
+          lowCut (state, ParameterIDs::lowCut),
+          lowCutFrequency (state, ParameterIDs::lowCutFrequency),
+          tilt (state, ParameterIDs::tilt)
+    {
+    }
+
+    /** Reads all of the parameters. This is lock-free, allocation-free and safe to
+        call from the audio thread.
+    */
+    ParameterSnapshot snapshot() const noexcept
+    {
+        ParameterSnapshot s;
+        s.gainDecibels = gain.get();
+        s.truePeakEnabled = truePeak.get();
+        s.ceilingDecibels = ceiling.get();
+        s.oversamplingIndex = oversampling.get();
+        s.truePeakAttackIndex = truePeakAttack.get();
+        s.lookaheadEnabled = lookahead.get();
+        s.lookaheadMilliseconds = lookaheadTime.get();
+        s.lowCutEnabled = lowCut.get();
+        s.lowCutFrequency = lowCutFrequency.get();
+        s.tiltDecibels = tilt.get();
+        return s;
+    }
+
+private:
+    ParameterHandle<float> gain;
+    ParameterHandle<bool> truePeak;
+    ParameterHandle<float> ceiling;
+    ParameterHandle<int> oversampling, truePeakAttack;
+    ParameterHandle<bool> lookahead;
+    ParameterHandle<float> lookaheadTime;
+    ParameterHandle<bool> lowCut;
+    ParameterHandle<float> lowCutFrequency, tilt;
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterHandles)
+};
@@ -3,8 +3,10 @@
 
 //==============================================================================
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor& p)
-    : AudioProcessorEditor (&p), processorRef (p)
+    : AudioProcessorEditor (&p), processorRef (p), loadMeter (p.getTelemetry()), loudnessDisplay (p.getLoudnessMeter())
 {
+    addAndMakeVisible (loadMeter);
+    addAndMakeVisible (loudnessDisplay);
     
     gainSlider.setSliderStyle(juce::Slider::LinearVertical);
     gainSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
@@ -14,7 +16,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
 
     // Attach to parameter
     gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processorRef.parameters, "gain", gainSlider
+        processorRef.parameters, ParameterIDs::gain, gainSlider
     );
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -41,4 +43,7 @@ void AudioPluginAudioProcessorEditor::resized()
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
     gainSlider.setBounds(40, 40, 100, 200);
+    auto bottom = getLocalBounds().removeFromBottom (48);
+    loudnessDisplay.setBounds (bottom.removeFromTop (24).reduced (4));
+    loadMeter.setBounds (bottom.reduced (4));
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "LoadMeter.h"
+#include "LoudnessDisplay.h"
 #include "PluginProcessor.h"
 
 //==============================================================================
@@ -21,5 +23,8 @@ private:
     // access the processor object that created it.
     AudioPluginAudioProcessor& processorRef;
 
+    LoadMeter loadMeter;
+    LoudnessDisplay loudnessDisplay;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
 };
@@ -1,5 +1,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "ProcessorState.h"
+#include "SilenceDetection.h"
 
 //==============================================================================
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
@@ -7,20 +9,78 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
-                    parameters(*this, nullptr, "PARAMETERS", {
-                            std::make_unique<juce::AudioParameterFloat>(
-                            "gain",     // parameter ID
-                            "Gain",     // parameter name
-                            juce::NormalisableRange<float>(-60.0f, 0.0f), // dB range
-                            6.0f      // default value in dB
-                            )
-                        }
-                    )
+                    parameters (*this, nullptr, "PARAMETERS", createParameterLayout())
 {
+    // The limiter parameters change the limiters' structure, and their latency,
+    // so they can't be applied on the audio thread.
+    startTimerHz (20);
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
+    stopTimer();
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    layout.add (std::make_unique<juce::AudioParameterFloat> (
+                    ParameterIDs::gain,                                              // parameter ID
+                    "Gain",                                                          // parameter name
+                    juce::NormalisableRange<float> (GainRamp::muteDecibels, 0.0f),   // dB range
+                    6.0f));                                                          // default value in dB
+
+    layout.add (std::make_unique<juce::AudioParameterBool> (ParameterIDs::truePeak, "True Peak Limiter", false));
+
+    layout.add (std::make_unique<juce::AudioParameterFloat> (
+                    ParameterIDs::ceiling,
+                    "Ceiling",
+                    juce::NormalisableRange<float> (-12.0f, 0.0f),
+                    -1.0f,
+                    juce::AudioParameterFloatAttributes().withLabel ("dBTP")));
+
+    layout.add (std::make_unique<juce::AudioParameterChoice> (
+                    ParameterIDs::oversampling,
+                    "Oversampling",
+                    juce::StringArray { "2x", "4x", "8x", "16x" },
+                    1));
+
+    layout.add (std::make_unique<juce::AudioParameterChoice> (
+                    ParameterIDs::truePeakAttack,
+                    "True Peak Attack",
+                    juce::StringArray { "Fast", "Smooth" },
+                    0));
+
+    layout.add (std::make_unique<juce::AudioParameterBool> (ParameterIDs::lookahead, "Lookahead Limiter", false));
+
+    layout.add (std::make_unique<juce::AudioParameterFloat> (
+                    ParameterIDs::lookaheadTime,
+                    "Lookahead",
+                    juce::NormalisableRange<float> (LookaheadLimiter<float>::minLookaheadMilliseconds,
+                                                    LookaheadLimiter<float>::maxLookaheadMilliseconds),
+                    5.0f,
+                    juce::AudioParameterFloatAttributes().withLabel ("ms")));
+
+    // The tone filter's parameters came later than the gain and limiter ones, and
+    // stay after them, so that hosts which save parameters by index still line up.
+    layout.add (std::make_unique<juce::AudioParameterBool> (ParameterIDs::lowCut, "Low Cut", false));
+
+    layout.add (std::make_unique<juce::AudioParameterFloat> (
+                    ParameterIDs::lowCutFrequency,
+                    "Low Cut Frequency",
+                    juce::NormalisableRange<float> (20.0f, 500.0f, 0.0f, 0.4f),
+                    80.0f,
+                    juce::AudioParameterFloatAttributes().withLabel ("Hz")));
+
+    layout.add (std::make_unique<juce::AudioParameterFloat> (
+                    ParameterIDs::tilt,
+                    "Tilt",
+                    juce::NormalisableRange<float> (-6.0f, 6.0f),
+                    0.0f,
+                    juce::AudioParameterFloatAttributes().withLabel ("dB")));
+
+    return layout;
 }
 
 //==============================================================================
@@ -58,7 +118,12 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
 
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The gain stage has no memory, so silence in gives silence out straight
+    // away, and a muted block is silent whatever went in. The tone filter's
+    // ringing is left out, as it's far below the signal that caused it, so only
+    // the limiters' delay lines are counted.
+    const auto sampleRate = getSampleRate();
+    return sampleRate > 0.0 ? tailSamples.load() / sampleRate : 0.0;
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -91,15 +156,150 @@ void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String
 //==============================================================================
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
-    juce::ignoreUnused (sampleRate, samplesPerBlock);
+    maximumBlockSize = juce::jmax (1, samplesPerBlock);
+    telemetry.prepare (sampleRate, samplesPerBlock);
+
+    // Both precisions are prepared, as the filters' state is tiny
+    const juce::dsp::ProcessSpec spec { sampleRate,
+                                        (juce::uint32) maximumBlockSize,
+                                        (juce::uint32) juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels()) };
+    floatToneFilter.prepare (spec);
+    doubleToneFilter.prepare (spec);
+
+    loudnessMeter.prepare (sampleRate, (int) spec.maximumBlockSize, getChannelLayoutOfBus (false, 0));
+
+    // Start at the current parameter value, rather than ramping up to it
+    gainRamp.prepare (sampleRate);
+    gainRamp.setCurrentAndTargetDecibels (parameterHandles.snapshot().gainDecibels);
+
+    updateLimiters();
 }
 
 void AudioPluginAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    floatLimiters = {};
+    doubleLimiters = {};
+}
+
+//==============================================================================
+template <typename SampleType>
+AudioPluginAudioProcessor::Limiters<SampleType>& AudioPluginAudioProcessor::getLimiters() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return floatLimiters;
+    else
+        return doubleLimiters;
+}
+
+template <typename SampleType>
+ToneFilter<SampleType>& AudioPluginAudioProcessor::getToneFilter() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return floatToneFilter;
+    else
+        return doubleToneFilter;
+}
+
+template <typename SampleType, typename Limiters>
+static void makeLimiters (Limiters& limiters, const ParameterSnapshot& params, int numChannels, double sampleRate, int blockSize)
+{
+    using Attack = typename TruePeakLimiter<SampleType>::Attack;
+
+    if (params.lookaheadEnabled)
+        limiters.lookahead = std::make_unique<LookaheadLimiter<SampleType>> (numChannels,
+                                                                             sampleRate,
+                                                                             blockSize,
+                                                                             params.lookaheadMilliseconds);
+
+    if (params.truePeakEnabled)
+        limiters.truePeak = std::make_unique<TruePeakLimiter<SampleType>> (numChannels,
+                                                                           sampleRate,
+                                                                           blockSize,
+                                                                           params.oversamplingIndex + 1,
+                                                                           params.truePeakAttackIndex == 1 ? Attack::smooth
+                                                                                                           : Attack::fast);
+}
+
+template <typename Limiters>
+static std::pair<int, int> getLatencyAndTail (const Limiters& limiters)
+{
+    // The limiters run one after the other, so their delays add up
+    int latency = 0, tail = 0;
+
+    if (limiters.lookahead != nullptr)
+    {
+        latency += limiters.lookahead->getLatencySamples();
+        tail += limiters.lookahead->getTailSamples();
+    }
+
+    if (limiters.truePeak != nullptr)
+    {
+        latency += limiters.truePeak->getLatencySamples();
+        tail += limiters.truePeak->getTailSamples();
+    }
+
+    return { latency, tail };
+}
+
+// Only these parameters need new limiters. The ceiling is read every block.
+static bool limitersDiffer (const ParameterSnapshot& a, const ParameterSnapshot& b) noexcept
+{
+    return a.truePeakEnabled != b.truePeakEnabled
+        || a.oversamplingIndex != b.oversamplingIndex
+        || a.truePeakAttackIndex != b.truePeakAttackIndex
+        || a.lookaheadEnabled != b.lookaheadEnabled
+        || ! juce::exactlyEqual (a.lookaheadMilliseconds, b.lookaheadMilliseconds);
+}
+
+void AudioPluginAudioProcessor::updateLimiters()
+{
+    const juce::ScopedLock updateLock (limiterUpdateLock);
+
+    const auto params = parameterHandles.snapshot();
+    limiterParameters = params;
+    const auto numChannels = juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels());
+
+    Limiters<float> newFloatLimiters;
+    Limiters<double> newDoubleLimiters;
+    std::pair<int, int> latencyAndTail;
+
+    if (numChannels > 0)
+    {
+        if (isUsingDoublePrecision())
+        {
+            makeLimiters<double> (newDoubleLimiters, params, numChannels, getSampleRate(), maximumBlockSize);
+            latencyAndTail = getLatencyAndTail (newDoubleLimiters);
+        }
+        else
+        {
+            makeLimiters<float> (newFloatLimiters, params, numChannels, getSampleRate(), maximumBlockSize);
+            latencyAndTail = getLatencyAndTail (newFloatLimiters);
+        }
+    }
+
+    {
+        // The old limiters end up in the locals, so they're deleted after the
+        // lock has been released.
+        const juce::ScopedLock sl (getCallbackLock());
+        std::swap (floatLimiters, newFloatLimiters);
+        std::swap (doubleLimiters, newDoubleLimiters);
+        tailSamples = latencyAndTail.second;
+        numSilentSamples = 0;
+    }
+
+    setLatencySamples (latencyAndTail.first);
+}
+
+void AudioPluginAudioProcessor::timerCallback()
+{
+    // Nothing needs rebuilding until the host prepares the processor
+    if (getSampleRate() <= 0.0 || maximumBlockSize <= 0)
+        return;
+
+    const juce::ScopedLock updateLock (limiterUpdateLock);
+
+    if (limitersDiffer (limiterParameters, parameterHandles.snapshot()))
+        updateLimiters();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -108,12 +308,9 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // The gain is applied identically to every channel, so any main bus layout
+    // will do, from mono up to the largest surround and ambisonic formats.
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -126,15 +323,130 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
   #endif
 }
 
-void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages) {
-    auto *channeldatal = buffer.getWritePointer(0);
-    auto *channeldatar = buffer.getWritePointer(1);
-    float gainDB = *parameters.getRawParameterValue("gain");
-    float gainLinear = std::pow(10.0f, gainDB / 20.0f);  // -12 dB attenuation
-    for (int i = 0; i < buffer.getNumSamples(); i++) {
-        channeldatal[i] *= gainLinear;
-        channeldatar[i] *= gainLinear;
+bool AudioPluginAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, midiMessages);
+}
+
+void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, midiMessages);
+}
+
+// Both precisions share this one implementation, so hosts with a 64-bit mix
+// engine don't pay for converting each block to float and back.
+template <typename SampleType>
+void AudioPluginAudioProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+    const ProcessorTelemetry::ScopedBlock telemetryBlock (telemetry, buffer.getNumSamples());
+
+    const auto numSamples = buffer.getNumSamples();
+
+    if (numSamples <= maximumBlockSize || maximumBlockSize == 0)
+    {
+        processSubBlock (buffer);
+        return;
+    }
+
+    // Some hosts send bigger blocks than they said they would. The filters, the
+    // limiters and the meter only have room for the prepared size, so the block
+    // is split into pieces of that size. These refer to the block's own channels,
+    // so making them doesn't allocate for up to 32 channels.
+    auto allCleared = true;
+
+    for (int start = 0; start < numSamples; start += maximumBlockSize)
+    {
+        juce::AudioBuffer<SampleType> subBlock (buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                                start, juce::jmin (maximumBlockSize, numSamples - start));
+        processSubBlock (subBlock);
+        allCleared = allCleared && subBlock.hasBeenCleared();
     }
+
+    // Lets the host know that the whole block is silent, as it would for a smaller one
+    if (allCleared)
+        buffer.clear();
+}
+
+template <typename SampleType>
+void AudioPluginAudioProcessor::processSubBlock (juce::AudioBuffer<SampleType>& buffer)
+{
+    const auto params = parameterHandles.snapshot();
+
+    gainRamp.setTargetDecibels (params.gainDecibels);
+
+    auto& toneFilter = getToneFilter<SampleType>();
+    toneFilter.setParameters (params.lowCutEnabled, params.lowCutFrequency, params.tiltDecibels);
+
+    auto& limiters = getLimiters<SampleType>();
+    const auto hasLimiters = limiters.lookahead != nullptr || limiters.truePeak != nullptr;
+
+    const auto isMuted = gainRamp.isMuted();
+    const auto inputIsSilent = isMuted || SilenceDetection::isSilent (buffer);
+
+    // The tone filter rings on for a while after its input falls silent. Rather
+    // than cutting that off with a click, silent input keeps going through it
+    // until what comes out is silent too.
+    if (inputIsSilent && ! isMuted && toneFilterIsRinging)
+    {
+        toneFilter.process (buffer);
+        toneFilterIsRinging = ! SilenceDetection::isSilent (buffer);
+    }
+
+    // Muted or silent blocks are cleared rather than multiplied. Clearing marks
+    // the buffer as silent, which the VST3 wrapper passes on to the host.
+    if (isMuted || (inputIsSilent && ! toneFilterIsRinging))
+    {
+        gainRamp.skip (buffer.getNumSamples());
+        toneFilter.reset();
+        toneFilterIsRinging = false;
+        buffer.clear();
+
+        // Once the limiters have rung out, the silence can skip them too
+        if (! hasLimiters || numSilentSamples >= tailSamples)
+        {
+            loudnessMeter.process (buffer);
+            return;
+        }
+
+        numSilentSamples += buffer.getNumSamples();
+    }
+    else
+    {
+        numSilentSamples = 0;
+
+        if (! inputIsSilent)
+        {
+            toneFilter.process (buffer);
+            toneFilterIsRinging = ! toneFilter.isFlat();
+        }
+
+        gainRamp.process (buffer);
+    }
+
+    if (limiters.lookahead != nullptr)
+        limiters.lookahead->process (buffer, params.ceilingDecibels);
+
+    if (limiters.truePeak != nullptr)
+        limiters.truePeak->process (buffer, params.ceilingDecibels);
+
+    // Start from a clean slate when the sound comes back
+    if (numSilentSamples >= tailSamples)
+    {
+        if (limiters.lookahead != nullptr)
+            limiters.lookahead->reset();
+
+        if (limiters.truePeak != nullptr)
+            limiters.truePeak->reset();
+    }
+
+    loudnessMeter.process (buffer);
 }
 
 //==============================================================================
@@ -151,17 +463,13 @@ juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 //==============================================================================
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-    juce::ignoreUnused (destData);
+    ProcessorState::save (parameters, destData);
 }
 
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    juce::ignoreUnused (data, sizeInBytes);
+    // Invalid data is ignored, leaving the current state as it is
+    ProcessorState::restore (parameters, data, (size_t) juce::jmax (0, sizeInBytes));
 }
 
 //==============================================================================
@@ -2,8 +2,17 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 
+#include "GainRamp.h"
+#include "LookaheadLimiter.h"
+#include "LoudnessMeter.h"
+#include "ParameterHandles.h"
+#include "ProcessorTelemetry.h"
+#include "ToneFilter.h"
+#include "TruePeakLimiter.h"
+
 //==============================================================================
-class AudioPluginAudioProcessor final : public juce::AudioProcessor
+class AudioPluginAudioProcessor final : public juce::AudioProcessor,
+                                        private juce::Timer
 {
 public:
     //==============================================================================
@@ -17,7 +26,9 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-    using AudioProcessor::processBlock;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -43,9 +54,76 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
 
     //==========
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
     juce::AudioProcessorValueTreeState parameters;
 
+    /** Returns the processor's load and timing statistics. These can be read from any thread. */
+    const ProcessorTelemetry& getTelemetry() const noexcept     { return telemetry; }
+
+    /** Returns the meter that measures the output's loudness. Its results can be
+        read, and a reset requested, from any thread.
+    */
+    LoudnessMeter& getLoudnessMeter() noexcept                  { return loudnessMeter; }
+
 private:
+    //==============================================================================
+    template <typename SampleType>
+    void processSamples (juce::AudioBuffer<SampleType>&, juce::MidiBuffer&);
+
+    /** Processes a block that's no bigger than the size the processor was prepared for. */
+    template <typename SampleType>
+    void processSubBlock (juce::AudioBuffer<SampleType>&);
+
+    /** The limiters that follow the gain stage. Either can be null when it's switched off. */
+    template <typename SampleType>
+    struct Limiters
+    {
+        std::unique_ptr<LookaheadLimiter<SampleType>> lookahead;
+        std::unique_ptr<TruePeakLimiter<SampleType>> truePeak;
+    };
+
+    template <typename SampleType>
+    Limiters<SampleType>& getLimiters() noexcept;
+
+    template <typename SampleType>
+    ToneFilter<SampleType>& getToneFilter() noexcept;
+
+    /** Creates the limiters that the parameters ask for, swaps them in, and reports
+        their latency. This allocates, so it's never called on the audio thread.
+    */
+    void updateLimiters();
+
+    /** Rebuilds the limiters when the parameters that shape them have changed.
+
+        VST3 and AU hosts deliver automation on the audio thread, so the change
+        is picked up by polling, rather than by a parameter listener that would
+        have to post a message from the middle of a block.
+    */
+    void timerCallback() override;
+
+    //==============================================================================
+    ParameterHandles parameterHandles { parameters };
+    ToneFilter<float> floatToneFilter;
+    ToneFilter<double> doubleToneFilter;
+    GainRamp gainRamp;
+    ProcessorTelemetry telemetry;
+    LoudnessMeter loudnessMeter;
+
+    // Only the ones matching the processing precision are created
+    Limiters<float> floatLimiters;
+    Limiters<double> doubleLimiters;
+
+    // The parameters that the limiters were last built from. The timer and the
+    // host's prepareToPlay() calls can be on different threads.
+    juce::CriticalSection limiterUpdateLock;
+    ParameterSnapshot limiterParameters;
+
+    // The host can ask for the tail length from any thread
+    std::atomic<int> tailSamples { 0 };
+    int numSilentSamples = 0, maximumBlockSize = 0;
+    bool toneFilterIsRinging = false;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
 };
@@ -0,0 +1,126 @@
+#include "ProcessorState.h"
+
+namespace ProcessorState
+{
+
+//==============================================================================
+static constexpr juce::uint32 magicNumber = 0x6574754d;   // "Mute", read as a little-endian int
+static constexpr size_t headerSize = 3 * sizeof (juce::uint32);
+
+// This is the header used by AudioProcessor::copyXmlToBinary()
+static constexpr juce::uint32 xmlMagicNumber = 0x21324356;
+
+//==============================================================================
+void save (juce::AudioProcessorValueTreeState& parameters, juce::MemoryBlock& destData)
+{
+    auto state = parameters.copyState();
+
+    // Switches, choices and most other values are whole numbers, and an int takes
+    // half the space of a double in the stream. They're read back the same way.
+    for (auto child : state)
+    {
+        const auto value = child.getProperty ("value");
+
+        if (value.isDouble() && std::abs ((double) value) < 1.0e9 && juce::exactlyEqual ((double) value, std::round ((double) value)))
+            child.setProperty ("value", (int) value, nullptr);
+    }
+
+    juce::MemoryOutputStream tree;
+    state.writeToStream (tree);
+
+    juce::MemoryOutputStream out (destData, false);
+    out.writeInt ((int) magicNumber);
+    out.writeInt (currentVersion);
+    out.writeInt ((int) tree.getDataSize());
+    out << tree;
+}
+
+static juce::ValueTree readXml (const void* data, size_t sizeInBytes)
+{
+    if (auto xml = juce::AudioProcessor::getXmlFromBinary (data, (int) sizeInBytes))
+        return juce::ValueTree::fromXml (*xml);
+
+    return {};
+}
+
+juce::ValueTree read (const juce::AudioProcessorValueTreeState& parameters, const void* data, size_t sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes < headerSize)
+        return {};
+
+    const auto* bytes = static_cast<const char*> (data);
+    const auto magic = juce::ByteOrder::littleEndianInt (bytes);
+
+    juce::ValueTree tree;
+
+    if (magic == xmlMagicNumber)
+    {
+        tree = readXml (data, sizeInBytes);
+    }
+    else if (magic == magicNumber)
+    {
+        const auto version = (int) juce::ByteOrder::littleEndianInt (bytes + 4);
+        const auto treeSize = (size_t) juce::ByteOrder::littleEndianInt (bytes + 8);
+
+        if (version < 1 || treeSize > sizeInBytes - headerSize)
+            return {};
+
+        // Every version so far has stored the same tree, so there's nothing to
+        // migrate yet. A state from a newer version is read for whatever it has
+        // in common with this one.
+        tree = juce::ValueTree::readFromData (bytes + headerSize, treeSize);
+    }
+
+    if (! tree.hasType (parameters.state.getType()))
+        return {};
+
+    return tree;
+}
+
+// Values read from the binary format are numbers, but those that came from XML
+// are strings, and have to be checked before they're parsed.
+static std::optional<float> toFiniteFloat (const juce::var& value)
+{
+    auto result = std::numeric_limits<float>::quiet_NaN();
+
+    if (value.isDouble() || value.isInt() || value.isInt64())
+        result = (float) value;
+    else if (value.isString() && value.toString().trim().containsOnly ("0123456789.-+eE") && value.toString().isNotEmpty())
+        result = value.toString().getFloatValue();
+
+    if (std::isfinite (result))
+        return result;
+
+    return {};
+}
+
+bool restore (juce::AudioProcessorValueTreeState& parameters, const void* data, size_t sizeInBytes)
+{
+    const auto tree = read (parameters, data, sizeInBytes);
+
+    if (! tree.isValid())
+        return false;
+
+    for (auto* p : parameters.processor.getParameters())
+    {
+        auto* parameter = dynamic_cast<juce::RangedAudioParameter*> (p);
+
+        if (parameter == nullptr)
+            continue;
+
+        // Parameters that the state doesn't mention go back to their defaults,
+        // as do any whose saved value isn't a usable number.
+        const auto saved = toFiniteFloat (tree.getChildWithProperty ("id", parameter->getParameterID()).getProperty ("value"));
+        const auto normalised = saved.has_value() ? parameter->convertTo0to1 (*saved)
+                                                  : parameter->getDefaultValue();
+
+        // Most parameters in a recalled session haven't changed since the instance
+        // was created, and there's no need to send the host a change for those.
+        if (! juce::exactlyEqual (parameter->getValue(), normalised))
+            parameter->setValueNotifyingHost (normalised);
+    }
+
+    return true;
+}
+
+} // namespace ProcessorState
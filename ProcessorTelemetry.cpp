@@ -0,0 +1,115 @@
+#include "ProcessorTelemetry.h"
+
+#if JUCE_INTEL && JUCE_USE_SSE_INTRINSICS
+ #include <xmmintrin.h>
+#endif
+
+//==============================================================================
+void ProcessorTelemetry::prepare (double sampleRate, int blockSize)
+{
+    loadMeasurer.reset (sampleRate, blockSize);
+
+    numBlocks = 0;
+    numDenormalBlocks = 0;
+    totalRenderNanoseconds = 0;
+
+    for (auto& bin : histogram)
+        bin = 0;
+}
+
+ProcessorTelemetry::Snapshot ProcessorTelemetry::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+    snapshot.load = loadMeasurer.getLoadAsProportion();
+    snapshot.xruns = loadMeasurer.getXRunCount();
+    snapshot.numBlocks = numBlocks.load (std::memory_order_relaxed);
+    snapshot.numDenormalBlocks = numDenormalBlocks.load (std::memory_order_relaxed);
+    snapshot.totalRenderNanoseconds = totalRenderNanoseconds.load (std::memory_order_relaxed);
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        snapshot.histogram[i] = histogram[i].load (std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+void ProcessorTelemetry::recordBlock (double nanoseconds, int numSamples, bool hadDenormals) noexcept
+{
+    // The load measurer only takes a try-lock, so it never blocks
+    loadMeasurer.registerRenderTime (nanoseconds * 1.0e-6, numSamples);
+
+    const auto wholeNanoseconds = (juce::uint32) juce::jlimit (1.0, (double) std::numeric_limits<juce::uint32>::max(), nanoseconds);
+    increment (histogram[(size_t) juce::jmin (numHistogramBins - 1, juce::findHighestSetBit (wholeNanoseconds))]);
+
+    if (hadDenormals)
+        increment (numDenormalBlocks);
+
+    totalRenderNanoseconds.store (totalRenderNanoseconds.load (std::memory_order_relaxed) + wholeNanoseconds,
+                                  std::memory_order_relaxed);
+
+    increment (numBlocks);
+}
+
+//==============================================================================
+// Inside a ScopedNoDenormals, denormals are flushed to zero rather than computed,
+// but the CPU still raises its sticky exception flags when that happens, so they
+// show whether a block would have hit the slow path without the flush.
+
+void ProcessorTelemetry::clearDenormalFlags() noexcept
+{
+   #if JUCE_INTEL && JUCE_USE_SSE_INTRINSICS
+    constexpr unsigned int exceptionFlags = 0x3f;
+    _mm_setcsr (_mm_getcsr() & ~exceptionFlags);
+   #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+    asm volatile ("msr fpsr, xzr");
+   #endif
+}
+
+bool ProcessorTelemetry::readDenormalFlags() noexcept
+{
+   #if JUCE_INTEL && JUCE_USE_SSE_INTRINSICS
+    constexpr unsigned int denormalFlag = 0x02, underflowFlag = 0x10;
+    return (_mm_getcsr() & (denormalFlag | underflowFlag)) != 0;
+   #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+    constexpr uint64_t underflowFlag = 1 << 3, inputDenormalFlag = 1 << 7;
+    uint64_t fpsr = 0;
+    asm volatile ("mrs %0, fpsr" : "=r" (fpsr));
+    return (fpsr & (underflowFlag | inputDenormalFlag)) != 0;
+   #else
+    return false;
+   #endif
+}
+
+//==============================================================================
+ProcessorTelemetry::ScopedBlock::ScopedBlock (ProcessorTelemetry& t, int n) noexcept
+    : owner (t), numSamples (n)
+{
+    clearDenormalFlags();
+    start = std::chrono::steady_clock::now();
+}
+
+ProcessorTelemetry::ScopedBlock::~ScopedBlock() noexcept
+{
+    const auto end = std::chrono::steady_clock::now();
+    const auto hadDenormals = readDenormalFlags();
+
+    if (numSamples > 0)
+        owner.recordBlock (std::chrono::duration<double, std::nano> (end - start).count(), numSamples, hadDenormals);
+}
+
+//==============================================================================
+juce::var ProcessorTelemetry::Snapshot::toVar() const
+{
+    juce::Array<juce::var> bins;
+
+    for (auto count : histogram)
+        bins.add ((juce::int64) count);
+
+    auto* object = new juce::DynamicObject();
+    object->setProperty ("load", load);
+    object->setProperty ("xruns", xruns);
+    object->setProperty ("numBlocks", (juce::int64) numBlocks);
+    object->setProperty ("numDenormalBlocks", (juce::int64) numDenormalBlocks);
+    object->setProperty ("totalRenderNanoseconds", (juce::int64) totalRenderNanoseconds);
+    object->setProperty ("renderTimeHistogram", bins);
+    return juce::var (object);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/** Measures how much of the audio thread each processor instance is using.
+
+    Every block is timed, and the result is fed to a juce::AudioProcessLoadMeasurer,
+    which keeps a smoothed load figure and counts the blocks that took longer than
+    their own duration (xruns). The same render times are also collected into a
+    histogram, and any block that produced a denormal is counted.
+
+    Only the audio thread writes to this, and each value is a single atomic, so
+    any other thread can call getSnapshot() at any time without locking. Recording
+    a block never allocates.
+*/
+class ProcessorTelemetry final
+{
+public:
+    //==============================================================================
+    /** The histogram has one bin per power of two nanoseconds: bin n counts the
+        blocks that took at least 2^n ns and less than 2^(n + 1) ns. The last bin
+        also collects anything slower.
+    */
+    static constexpr int numHistogramBins = 32;
+
+    /** The telemetry at one moment in time. */
+    struct Snapshot
+    {
+        /** The smoothed proportion of each block's duration spent rendering it, from 0 to 1. */
+        double load = 0.0;
+
+        /** The number of blocks that took longer to render than they last. */
+        int xruns = 0;
+
+        /** The number of blocks rendered since the processor was prepared. */
+        juce::uint64 numBlocks = 0;
+
+        /** The number of blocks in which a denormal was produced or consumed. */
+        juce::uint64 numDenormalBlocks = 0;
+
+        /** The total time spent rendering those blocks, in nanoseconds. Divided by
+            numBlocks, this is the average block's render time.
+        */
+        juce::uint64 totalRenderNanoseconds = 0;
+
+        /** Block render times, as described by numHistogramBins. */
+        std::array<juce::uint64, numHistogramBins> histogram {};
+
+        /** Converts this to an object that can be written as JSON. */
+        juce::var toVar() const;
+    };
+
+    //==============================================================================
+    ProcessorTelemetry() = default;
+
+    /** Resets everything, ready for the given sample rate and block size.
+        This must not be called while a block is being rendered.
+    */
+    void prepare (double sampleRate, int blockSize);
+
+    /** Returns the current values. This is lock-free, and safe to call from any thread.
+
+        The values are read one at a time, so if a block finishes while this is
+        running, the snapshot may include some of that block's results but not others.
+    */
+    Snapshot getSnapshot() const noexcept;
+
+    //==============================================================================
+    /** Records one block, from its construction to its destruction.
+
+        Create this after the block's juce::ScopedNoDenormals, so that it's destroyed
+        before the floating point state that shows whether a denormal was produced
+        is restored.
+    */
+    class ScopedBlock final
+    {
+    public:
+        ScopedBlock (ProcessorTelemetry&, int numSamples) noexcept;
+        ~ScopedBlock() noexcept;
+
+    private:
+        ProcessorTelemetry& owner;
+        std::chrono::steady_clock::time_point start;
+        int numSamples;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+    };
+
+private:
+    //==============================================================================
+    void recordBlock (double nanoseconds, int numSamples, bool hadDenormals) noexcept;
+
+    static void clearDenormalFlags() noexcept;
+    static bool readDenormalFlags() noexcept;
+
+    // There's only ever one writer, so these are updated with a load and a store
+    // rather than a read-modify-write, which would need a locked instruction.
+    static void increment (std::atomic<juce::uint64>& counter) noexcept
+    {
+        counter.store (counter.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+    std::atomic<juce::uint64> numBlocks { 0 }, numDenormalBlocks { 0 }, totalRenderNanoseconds { 0 };
+    std::array<std::atomic<juce::uint64>, numHistogramBins> histogram {};
+
+    JUCE_DECLARE_NON_COPYABLE (ProcessorTelemetry)
+};
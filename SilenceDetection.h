@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/** Finds out whether a buffer holds nothing but digital silence, so that the
+    processor can skip it.
+*/
+namespace SilenceDetection
+{
+    /** Samples no louder than this count as silent. It's around -150 dBFS, below
+        the noise floor of a 24-bit converter, so it also catches the low-level
+        residue that some hosts and plugins leave behind instead of true zeros.
+    */
+    static constexpr float threshold = 3.0e-8f;
+
+    /** Returns true if every sample in the buffer is silent.
+
+        A buffer that has been cleared and not written to since is known to be
+        silent without looking at it. Otherwise each channel is scanned with
+        FloatVectorOperations::findMinAndMax(), stopping at the first one that
+        isn't silent, so ordinary audio usually costs a single channel's scan.
+    */
+    template <typename SampleType>
+    bool isSilent (const juce::AudioBuffer<SampleType>& buffer) noexcept
+    {
+        if (buffer.hasBeenCleared())
+            return true;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax (buffer.getReadPointer (channel),
+                                                                           buffer.getNumSamples());
+
+            if (range.getStart() < (SampleType) -threshold || range.getEnd() > (SampleType) threshold)
+                return false;
+        }
+
+        return true;
+    }
+}
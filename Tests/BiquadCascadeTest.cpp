@@ -0,0 +1,190 @@
+#include "../BiquadCascade.h"
+
+//==============================================================================
+class BiquadCascadeTest final : public juce::UnitTest
+{
+public:
+    BiquadCascadeTest()
+        : UnitTest ("Biquad cascade", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("Matches juce::dsp::IIR::Filter, float");
+        matchesJuceFilters<float> (1.0e-6);
+
+        beginTest ("Matches juce::dsp::IIR::Filter, double");
+        matchesJuceFilters<double> (1.0e-12);
+
+        beginTest ("Array coefficients match coefficient objects");
+        {
+            using Coefficients = juce::dsp::IIR::Coefficients<float>;
+            using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+
+            BiquadCascade<float> fromObjects, fromArrays;
+
+            for (auto* cascade : { &fromObjects, &fromArrays })
+            {
+                cascade->prepare ({ sampleRate, 64, 3 });
+                cascade->setNumStages (2);
+            }
+
+            fromObjects.setCoefficients (0, *Coefficients::makePeakFilter (sampleRate, 3000.0f, 2.0f, 0.5f));
+            fromObjects.setCoefficients (1, *Coefficients::makeFirstOrderHighPass (sampleRate, 40.0f));
+            fromArrays.setCoefficients (0, ArrayCoefficients::makePeakFilter (sampleRate, 3000.0f, 2.0f, 0.5f));
+            fromArrays.setCoefficients (1, ArrayCoefficients::makeFirstOrderHighPass (sampleRate, 40.0f));
+
+            auto a = makeNoise<float> (3, 64), b = makeNoise<float> (3, 64);
+            process (fromObjects, a);
+            process (fromArrays, b);
+
+            expectLessThan (getMaximumDifference (a, b), 1.0e-6);
+        }
+
+        beginTest ("Separate input and output blocks");
+        {
+            BiquadCascade<float> cascade;
+            cascade.prepare ({ sampleRate, 64, 2 });
+            cascade.setNumStages (1);
+            cascade.setCoefficients (0, juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass (sampleRate, 1000.0f));
+
+            auto input = makeNoise<float> (2, 64);
+            const auto original = makeNoise<float> (2, 64);
+            juce::AudioBuffer<float> output (2, 64);
+
+            juce::dsp::AudioBlock<float> inputBlock (input), outputBlock (output);
+            cascade.process (juce::dsp::ProcessContextNonReplacing<float> (inputBlock, outputBlock));
+
+            expectEquals (getMaximumDifference (input, original), 0.0);
+            expectGreaterThan (getMaximumDifference (output, original), 0.0);
+        }
+
+        beginTest ("Stages that are added start from silence");
+        {
+            BiquadCascade<float> cascade;
+            cascade.prepare ({ sampleRate, 64, 1 });
+            cascade.setNumStages (1);
+            cascade.setCoefficients (0, juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass (sampleRate, 100.0f));
+            cascade.setCoefficients (1, juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass (sampleRate, 100.0f));
+
+            auto buffer = makeNoise<float> (1, 64);
+            process (cascade, buffer);
+
+            // The first stage carries on ringing through the new one
+            cascade.setNumStages (2);
+            buffer.clear();
+            process (cascade, buffer);
+            expectGreaterThan (buffer.getMagnitude (0, 64), 0.0f);
+
+            // Removing both and adding them back clears everything
+            cascade.setNumStages (0);
+            cascade.setNumStages (2);
+            buffer.clear();
+            process (cascade, buffer);
+            expectEquals (buffer.getMagnitude (0, 64), 0.0f);
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr double sampleRate = 48000.0;
+
+    template <typename SampleType>
+    void matchesJuceFilters (double tolerance)
+    {
+        using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+
+        // Enough channels to fill several SIMD registers, with some left over
+        for (auto numChannels : { 1, 2, 3, 4, 5, 8, 12, 16 })
+        {
+            for (int numStages = 1; numStages <= BiquadCascade<SampleType>::maxStages; numStages += 2)
+            {
+                BiquadCascade<SampleType> cascade;
+                cascade.prepare ({ sampleRate, 100, (juce::uint32) numChannels });
+                cascade.setNumStages (numStages);
+
+                std::vector<std::vector<juce::dsp::IIR::Filter<SampleType>>> reference ((size_t) numChannels);
+
+                for (int stage = 0; stage < numStages; ++stage)
+                {
+                    const auto frequency = (SampleType) (50 + 700 * stage);
+
+                    auto coefficients = stage % 3 == 0 ? Coefficients::makeHighPass (sampleRate, frequency)
+                                      : stage % 3 == 1 ? Coefficients::makeLowShelf (sampleRate, frequency, (SampleType) 0.7, (SampleType) 2)
+                                                       : Coefficients::makeFirstOrderLowPass (sampleRate, frequency);
+
+                    cascade.setCoefficients (stage, *coefficients);
+
+                    for (auto& filters : reference)
+                        filters.emplace_back (coefficients);
+                }
+
+                auto buffer = makeNoise<SampleType> (numChannels, 1000);
+
+                juce::AudioBuffer<SampleType> expected;
+                expected.makeCopyOf (buffer);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto* samples = expected.getWritePointer (channel);
+
+                    for (int i = 0; i < expected.getNumSamples(); ++i)
+                        for (auto& filter : reference[(size_t) channel])
+                            samples[i] = filter.processSample (samples[i]);
+                }
+
+                // Uneven block sizes, including ones larger than the cascade was prepared for
+                const int blockSizes[] = { 100, 17, 1, 64, 250, 99, 3 };
+                int start = 0;
+
+                for (int i = 0; start < buffer.getNumSamples(); ++i)
+                {
+                    const auto numSamples = juce::jmin (blockSizes[i % juce::numElementsInArray (blockSizes)],
+                                                        buffer.getNumSamples() - start);
+
+                    auto block = juce::dsp::AudioBlock<SampleType> (buffer).getSubBlock ((size_t) start, (size_t) numSamples);
+                    cascade.process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+                    start += numSamples;
+                }
+
+                expectLessThan (getMaximumDifference (buffer, expected), tolerance,
+                                juce::String (numChannels) + " channels, " + juce::String (numStages) + " stages");
+            }
+        }
+    }
+
+    template <typename SampleType>
+    static void process (BiquadCascade<SampleType>& cascade, juce::AudioBuffer<SampleType>& buffer)
+    {
+        juce::dsp::AudioBlock<SampleType> block (buffer);
+        cascade.process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+    }
+
+    template <typename SampleType>
+    static juce::AudioBuffer<SampleType> makeNoise (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<SampleType> buffer (numChannels, numSamples);
+        juce::Random random (0x3d);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, (SampleType) (random.nextFloat() * 2.0f - 1.0f));
+
+        return buffer;
+    }
+
+    template <typename SampleType>
+    static double getMaximumDifference (const juce::AudioBuffer<SampleType>& a, const juce::AudioBuffer<SampleType>& b)
+    {
+        double result = 0.0;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                result = juce::jmax (result, (double) std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return result;
+    }
+};
+
+static BiquadCascadeTest biquadCascadeTest;
@@ -0,0 +1,188 @@
+#include "../FIREngine.h"
+#include "RealtimeSafetyChecker.h"
+
+//==============================================================================
+class FIREngineTest final : public juce::UnitTest
+{
+public:
+    FIREngineTest()
+        : UnitTest ("FIR engine", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("The direct form matches juce::dsp::FIR::Filter");
+        matchesJuceFilter (FIREngine::Method::directForm);
+
+        beginTest ("The partitioned FFT matches juce::dsp::FIR::Filter");
+        matchesJuceFilter (FIREngine::Method::partitionedFFT);
+
+        beginTest ("The automatic method depends on the kernel's length");
+        {
+            FIREngine engine;
+            engine.prepare ({ sampleRate, 256, 2 });
+
+            auto kernel = makeNoise (1, FIREngine::crossoverTaps);
+            engine.setKernel (kernel.getReadPointer (0), FIREngine::crossoverTaps - 1);
+            expect (engine.getMethod() == FIREngine::Method::directForm);
+
+            engine.setKernel (kernel.getReadPointer (0), FIREngine::crossoverTaps);
+            expect (engine.getMethod() == FIREngine::Method::partitionedFFT);
+            expectEquals (engine.getNumTaps(), FIREngine::crossoverTaps);
+        }
+
+        beginTest ("Separate input and output blocks");
+        {
+            const auto kernel = makeNoise (1, 300);
+
+            for (auto method : { FIREngine::Method::directForm, FIREngine::Method::partitionedFFT })
+            {
+                FIREngine engine;
+                engine.prepare ({ sampleRate, 128, 2 });
+                engine.setKernel (kernel.getReadPointer (0), kernel.getNumSamples(), method);
+
+                auto input = makeNoise (2, 128);
+                const auto original = makeNoise (2, 128);
+                juce::AudioBuffer<float> output (2, 128);
+
+                juce::dsp::AudioBlock<float> inputBlock (input), outputBlock (output);
+                engine.process (juce::dsp::ProcessContextNonReplacing<float> (inputBlock, outputBlock));
+
+                expectEquals (getMaximumDifference (input, original), 0.0);
+                expectGreaterThan (getMaximumDifference (output, original), 0.0);
+            }
+        }
+
+        beginTest ("Reset forgets the previous input");
+        {
+            const auto kernel = makeNoise (1, 1000);
+
+            for (auto method : { FIREngine::Method::directForm, FIREngine::Method::partitionedFFT })
+            {
+                FIREngine engine;
+                engine.prepare ({ sampleRate, 100, 1 });
+                engine.setKernel (kernel.getReadPointer (0), kernel.getNumSamples(), method);
+
+                auto buffer = makeNoise (1, 100);
+                process (engine, buffer);
+
+                engine.reset();
+                buffer.clear();
+                process (engine, buffer);
+                expectEquals (buffer.getMagnitude (0, 100), 0.0f);
+            }
+        }
+
+        beginTest ("Processing is real-time safe");
+        {
+            const auto kernel = makeNoise (1, 5000);
+
+            for (auto method : { FIREngine::Method::directForm, FIREngine::Method::partitionedFFT })
+            {
+                FIREngine engine;
+                engine.prepare ({ sampleRate, 512, 2 });
+                engine.setKernel (kernel.getReadPointer (0), kernel.getNumSamples(), method);
+
+                auto buffer = makeNoise (2, 512);
+
+                RealtimeSafetyChecker checker;
+
+                for (int i = 0; i < 10; ++i)
+                    process (engine, buffer);
+
+                checker.stop();
+                expectEquals (checker.getNumViolations(), 0, checker.getReport());
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr double sampleRate = 48000.0;
+
+    void matchesJuceFilter (FIREngine::Method method)
+    {
+        constexpr int numChannels = 3, numSamples = 6000;
+
+        for (auto numTaps : { 1, 2, 7, 64, 100, 513, 2000 })
+        {
+            // Down to single samples, and with blocks longer than a partition
+            for (auto maximumBlockSize : { 1, 37, 256 })
+            {
+                const auto kernel = makeNoise (1, numTaps);
+
+                FIREngine engine;
+                engine.setKernel (kernel.getReadPointer (0), numTaps, method);
+                engine.prepare ({ sampleRate, (juce::uint32) maximumBlockSize, numChannels });
+
+                auto buffer = makeNoise (numChannels, numSamples);
+
+                juce::AudioBuffer<float> expected;
+                expected.makeCopyOf (buffer);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    juce::dsp::FIR::Filter<float> filter (new juce::dsp::FIR::Coefficients<float> (kernel.getReadPointer (0), (size_t) numTaps));
+                    filter.prepare ({ sampleRate, 1, 1 });
+
+                    auto* samples = expected.getWritePointer (channel);
+
+                    for (int i = 0; i < numSamples; ++i)
+                        samples[i] = filter.processSample (samples[i]);
+                }
+
+                const int blockSizes[] = { maximumBlockSize, 17, 1, maximumBlockSize / 2 + 1, 3 };
+                int start = 0;
+
+                for (int i = 0; start < numSamples; ++i)
+                {
+                    const auto blockSize = juce::jmin (blockSizes[i % juce::numElementsInArray (blockSizes)],
+                                                       maximumBlockSize,
+                                                       numSamples - start);
+
+                    auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) blockSize);
+                    engine.process (juce::dsp::ProcessContextReplacing<float> (block));
+                    start += blockSize;
+                }
+
+                // The FFT's rounding errors grow with the output's level
+                const auto tolerance = 1.0e-5 * juce::jmax (1.0f, expected.getMagnitude (0, numSamples));
+
+                expectLessThan (getMaximumDifference (buffer, expected), tolerance,
+                                juce::String (numTaps) + " taps, blocks of up to " + juce::String (maximumBlockSize));
+            }
+        }
+    }
+
+    static void process (FIREngine& engine, juce::AudioBuffer<float>& buffer)
+    {
+        juce::dsp::AudioBlock<float> block (buffer);
+        engine.process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+
+    static juce::AudioBuffer<float> makeNoise (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+        juce::Random random (0x3d);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        return buffer;
+    }
+
+    static double getMaximumDifference (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        double result = 0.0;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                result = juce::jmax (result, (double) std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return result;
+    }
+};
+
+static FIREngineTest firEngineTest;
@@ -0,0 +1,197 @@
+#include "../PluginProcessor.h"
+#include "../LookaheadLimiter.h"
+
+//==============================================================================
+class LookaheadLimiterTest final : public juce::UnitTest
+{
+public:
+    LookaheadLimiterTest()
+        : UnitTest ("Lookahead limiter", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("No sample goes over the ceiling");
+        {
+            for (auto sampleRate : { 48000.0, 96000.0 })
+            {
+                for (auto lookahead : { 1.0f, 5.0f, 20.0f })
+                {
+                    for (auto blockSize : { 1, 64, 256, 1000 })
+                    {
+                        LookaheadLimiter<float> limiter (2, sampleRate, blockSize, lookahead);
+
+                        auto signal = makeBursts (getRandom(), (int) sampleRate / 2);
+                        processInBlocks (limiter, signal, blockSize, -1.0f);
+
+                        expectLessOrEqual (signal.getMagnitude (0, signal.getNumSamples()), ceilingGain * (1.0f + 1.0e-6f),
+                                           juce::String (sampleRate) + " Hz, " + juce::String (lookahead) + " ms, "
+                                           + juce::String (blockSize) + " sample blocks");
+                    }
+                }
+            }
+        }
+
+        beginTest ("Signals under the ceiling are only delayed");
+        {
+            LookaheadLimiter<float> limiter (1, 48000.0, 100, 5.0f);
+            const auto latency = limiter.getLatencySamples();
+            expectEquals (latency, 240);
+
+            juce::AudioBuffer<float> signal (1, 4000);
+            auto random = getRandom();
+
+            for (int i = 0; i < signal.getNumSamples(); ++i)
+                signal.setSample (0, i, 0.5f * (random.nextFloat() * 2.0f - 1.0f));
+
+            juce::AudioBuffer<float> original;
+            original.makeCopyOf (signal);
+
+            processInBlocks (limiter, signal, 100, -1.0f);
+
+            int numChanged = 0;
+
+            for (int i = 0; i < signal.getNumSamples(); ++i)
+                if (! juce::exactlyEqual (signal.getSample (0, i), i < latency ? 0.0f : original.getSample (0, i - latency)))
+                    ++numChanged;
+
+            expectEquals (numChanged, 0);
+        }
+
+        beginTest ("The gain is already down when a peak arrives");
+        {
+            LookaheadLimiter<float> limiter (1, 48000.0, 64, 5.0f);
+            const auto latency = limiter.getLatencySamples();
+
+            // A steady level with one peak that's well over the ceiling
+            constexpr int peakIndex = 1000;
+            juce::AudioBuffer<float> signal (1, 2000);
+            signal.clear();
+            juce::FloatVectorOperations::fill (signal.getWritePointer (0), 0.5f, signal.getNumSamples());
+            signal.setSample (0, peakIndex, 2.0f);
+
+            processInBlocks (limiter, signal, 64, -1.0f);
+
+            // Untouched until a lookahead's worth of samples before the peak...
+            expectEquals (signal.getSample (0, peakIndex - 1), 0.5f);
+
+            // ...then ramping down, not stepping
+            const auto halfway = signal.getSample (0, peakIndex + latency / 2);
+            expectLessThan (halfway, 0.5f);
+            expectGreaterThan (halfway, 0.5f * ceilingGain / 2.0f);
+
+            expectLessThan (signal.getSample (0, peakIndex + latency - 1), 0.25f);
+            expectWithinAbsoluteError (signal.getSample (0, peakIndex + latency), ceilingGain, 1.0e-6f);
+        }
+
+        beginTest ("The processor reports the lookahead as latency");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::lookahead, 1.0f);
+            setParameter (processor, ParameterIDs::lookaheadTime, 10.0f);
+            prepare (processor);
+
+            expectEquals (processor.getLatencySamples(), 480);
+
+            // The true peak limiter comes after it, so the delays add up
+            setParameter (processor, ParameterIDs::truePeak, 1.0f);
+            prepare (processor);
+            expectGreaterThan (processor.getLatencySamples(), 480);
+
+            setParameter (processor, ParameterIDs::lookahead, 0.0f);
+            setParameter (processor, ParameterIDs::truePeak, 0.0f);
+            prepare (processor);
+            expectEquals (processor.getLatencySamples(), 0);
+        }
+
+        beginTest ("The processor limits in both precisions");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::gain, 0.0f);
+            setParameter (processor, ParameterIDs::lookahead, 1.0f);
+
+            for (auto precision : { juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision })
+            {
+                processor.setProcessingPrecision (precision);
+                prepare (processor);
+
+                juce::MidiBuffer midi;
+                auto signal = makeBursts (getRandom(), 64 * processorBlockSize);
+
+                if (precision == juce::AudioProcessor::singlePrecision)
+                {
+                    for (int start = 0; start < signal.getNumSamples(); start += processorBlockSize)
+                    {
+                        juce::AudioBuffer<float> block (signal.getArrayOfWritePointers(), 2, start, processorBlockSize);
+                        processor.processBlock (block, midi);
+                    }
+                }
+                else
+                {
+                    juce::AudioBuffer<double> doubleSignal;
+                    doubleSignal.makeCopyOf (signal);
+
+                    for (int start = 0; start < signal.getNumSamples(); start += processorBlockSize)
+                    {
+                        juce::AudioBuffer<double> block (doubleSignal.getArrayOfWritePointers(), 2, start, processorBlockSize);
+                        processor.processBlock (block, midi);
+                    }
+
+                    signal.makeCopyOf (doubleSignal);
+                }
+
+                expectLessOrEqual (signal.getMagnitude (0, signal.getNumSamples()), ceilingGain * (1.0f + 1.0e-6f));
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr int processorBlockSize = 256;
+
+    // The processor's default ceiling
+    const float ceilingGain = juce::Decibels::decibelsToGain (-1.0f);
+
+    static void processInBlocks (LookaheadLimiter<float>& limiter, juce::AudioBuffer<float>& signal, int blockSize, float ceilingDecibels)
+    {
+        for (int start = 0; start < signal.getNumSamples(); start += blockSize)
+        {
+            juce::AudioBuffer<float> block (signal.getArrayOfWritePointers(), signal.getNumChannels(), start,
+                                            juce::jmin (blockSize, signal.getNumSamples() - start));
+            limiter.process (block, ceilingDecibels);
+        }
+    }
+
+    /** Noise that alternates between quiet and loud sections, with single sample
+        spikes scattered through it.
+    */
+    static juce::AudioBuffer<float> makeBursts (juce::Random random, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto level = i % 777 == 0 ? 10.0f : ((i / 3000) % 2 == 0 ? 0.3f : 4.0f);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.setSample (channel, i, level * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        return buffer;
+    }
+
+    static void setParameter (AudioPluginAudioProcessor& processor, juce::StringRef id, float value)
+    {
+        auto* parameter = processor.parameters.getParameter (id);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    static void prepare (AudioPluginAudioProcessor& processor)
+    {
+        processor.setRateAndBufferSizeDetails (48000.0, processorBlockSize);
+        processor.prepareToPlay (48000.0, processorBlockSize);
+    }
+};
+
+static LookaheadLimiterTest lookaheadLimiterTest;
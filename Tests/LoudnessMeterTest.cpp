@@ -0,0 +1,157 @@
+#include "../LoudnessMeter.h"
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/** Checks the meter against the simpler cases from EBU Tech 3341, the R128
+    meter conformance tests, generated here rather than read from the test files.
+*/
+class LoudnessMeterTest final : public juce::UnitTest
+{
+public:
+    LoudnessMeterTest()
+        : UnitTest ("Loudness meter", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        const auto stereo = juce::AudioChannelSet::stereo();
+
+        beginTest ("A stereo 1 kHz sine at -23 dBFS measures -23 LUFS");
+        {
+            LoudnessMeter meter;
+            meter.prepare (sampleRate, blockSize, stereo);
+
+            feedSine (meter, stereo.size(), { 0, 1 }, -23.0f, 20.0);
+
+            const auto snapshot = meter.getSnapshot();
+            expectWithinAbsoluteError (snapshot.integrated, -23.0f, 0.1f);
+            expectWithinAbsoluteError (snapshot.shortTerm, -23.0f, 0.1f);
+            expectWithinAbsoluteError (snapshot.momentary, -23.0f, 0.1f);
+        }
+
+        beginTest ("Quieter passages are gated out of the integrated loudness");
+        {
+            LoudnessMeter meter;
+            meter.prepare (sampleRate, blockSize, stereo);
+
+            // 13 LU below the rest is under the relative gate...
+            feedSine (meter, stereo.size(), { 0, 1 }, -36.0f, 10.0);
+            feedSine (meter, stereo.size(), { 0, 1 }, -23.0f, 30.0);
+            feedSine (meter, stereo.size(), { 0, 1 }, -36.0f, 10.0);
+            expectWithinAbsoluteError (meter.getSnapshot().integrated, -23.0f, 0.1f);
+
+            // ...and anything under -70 LUFS is under the absolute gate
+            feedSine (meter, stereo.size(), { 0, 1 }, -80.0f, 60.0);
+            expectWithinAbsoluteError (meter.getSnapshot().integrated, -23.0f, 0.1f);
+            expectLessThan (meter.getSnapshot().shortTerm, -70.0f);
+        }
+
+        beginTest ("Channels are weighted by their position");
+        {
+            const auto surround = juce::AudioChannelSet::create5point1();
+            const auto indexOf = [&] (auto type) { return surround.getChannelIndexForType (type); };
+
+            LoudnessMeter left, leftSurround, lfe;
+
+            for (auto* meter : { &left, &leftSurround, &lfe })
+                meter->prepare (sampleRate, blockSize, surround);
+
+            feedSine (left, surround.size(), { indexOf (juce::AudioChannelSet::left) }, -23.0f, 5.0);
+            feedSine (leftSurround, surround.size(), { indexOf (juce::AudioChannelSet::leftSurround) }, -23.0f, 5.0);
+            feedSine (lfe, surround.size(), { indexOf (juce::AudioChannelSet::LFE) }, -23.0f, 5.0);
+
+            // One channel is 3 dB down on two, and the surround is 1.5 dB up on that
+            expectWithinAbsoluteError (left.getSnapshot().integrated, -26.0f, 0.1f);
+            expectWithinAbsoluteError (leftSurround.getSnapshot().integrated, -24.5f, 0.1f);
+            expectEquals (lfe.getSnapshot().integrated, LoudnessMeter::minusInfinityDb);
+        }
+
+        beginTest ("The true peak includes peaks between samples");
+        {
+            LoudnessMeter meter;
+            meter.prepare (sampleRate, blockSize, juce::AudioChannelSet::mono());
+
+            // A quarter of the sample rate, 45 degrees out, has samples at +-0.707
+            // but peaks at 1
+            juce::AudioBuffer<float> buffer (1, blockSize);
+
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample (0, i, (float) std::sin (juce::MathConstants<double>::halfPi * i + juce::MathConstants<double>::pi / 4.0));
+
+            for (int i = 0; i < 10; ++i)
+                meter.process (buffer);
+
+            expectWithinAbsoluteError (juce::Decibels::gainToDecibels (buffer.getMagnitude (0, 0, blockSize)), -3.0f, 0.1f);
+            expectWithinAbsoluteError (meter.getSnapshot().truePeak, 0.0f, 0.2f);
+        }
+
+        beginTest ("A reset starts a new measurement");
+        {
+            LoudnessMeter meter;
+            meter.prepare (sampleRate, blockSize, stereo);
+
+            feedSine (meter, stereo.size(), { 0, 1 }, -10.0f, 5.0);
+            meter.requestReset();
+            feedSine (meter, stereo.size(), { 0, 1 }, -30.0f, 5.0);
+
+            const auto snapshot = meter.getSnapshot();
+            expectWithinAbsoluteError (snapshot.integrated, -30.0f, 0.1f);
+            expectWithinAbsoluteError (snapshot.truePeak, -30.0f, 0.1f);
+        }
+
+        beginTest ("The processor meters its output");
+        {
+            AudioPluginAudioProcessor processor;
+            auto* gain = processor.parameters.getParameter (ParameterIDs::gain);
+            gain->setValueNotifyingHost (gain->convertTo0to1 (-6.0f));
+
+            processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+
+            juce::AudioBuffer<double> buffer (2, blockSize);
+            juce::MidiBuffer midi;
+
+            for (int start = 0; start < (int) sampleRate * 5; start += blockSize)
+            {
+                fillWithSine (buffer, { 0, 1 }, -17.0f, start);
+                processor.processBlock (buffer, midi);
+            }
+
+            expectWithinAbsoluteError (processor.getLoudnessMeter().getSnapshot().integrated, -23.0f, 0.1f);
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    /** Fills the given channels with a 1 kHz sine, continuing from the given sample,
+        and clears the rest.
+    */
+    template <typename SampleType>
+    static void fillWithSine (juce::AudioBuffer<SampleType>& buffer, std::initializer_list<int> channels, float decibels, int start)
+    {
+        const auto amplitude = juce::Decibels::decibelsToGain ((double) decibels);
+
+        buffer.clear();
+
+        for (auto channel : channels)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, (SampleType) (amplitude * std::sin (juce::MathConstants<double>::twoPi * 1000.0 * (start + i) / sampleRate)));
+    }
+
+    static void feedSine (LoudnessMeter& meter, int numChannels, std::initializer_list<int> channels, float decibels, double seconds)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+
+        for (int start = 0; start < (int) (seconds * sampleRate); start += blockSize)
+        {
+            fillWithSine (buffer, channels, decibels, start);
+            meter.process (buffer);
+        }
+    }
+};
+
+static LoudnessMeterTest loudnessMeterTest;
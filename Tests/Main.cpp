@@ -0,0 +1,59 @@
+#include <juce_events/juce_events.h>
+
+#include <iostream>
+
+//==============================================================================
+class ConsoleUnitTestRunner final : public juce::UnitTestRunner
+{
+    void logMessage (const juce::String& message) override
+    {
+        std::cout << message << std::endl;
+    }
+};
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << argv[0] << " [--help|-h] [--list-categories] [--category=category] [--seed=seed]" << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption ("--list-categories"))
+    {
+        for (auto& category : juce::UnitTest::getAllCategories())
+            std::cout << category << std::endl;
+
+        return 0;
+    }
+
+    // The processor's parameter state needs a message manager
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+
+    ConsoleUnitTestRunner runner;
+
+    const auto seed = args.containsOption ("--seed") ? args.getValueForOption ("--seed").getLargeIntValue()
+                                                     : juce::Random::getSystemRandom().nextInt64();
+
+    if (args.containsOption ("--category"))
+        runner.runTestsInCategory (args.getValueForOption ("--category"), seed);
+    else
+        runner.runAllTests (seed);
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult (i)->failures;
+
+    if (numFailures > 0)
+    {
+        std::cout << std::endl << numFailures << " test failure(s)" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl << "All tests completed successfully" << std::endl;
+    return 0;
+}
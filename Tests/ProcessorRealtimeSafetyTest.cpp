@@ -0,0 +1,405 @@
+#include "RealtimeSafetyChecker.h"
+
+#include "../PluginProcessor.h"
+
+#include <mutex>
+
+//==============================================================================
+/** Checks that nothing the processor does on the audio thread allocates or
+    takes a lock, including while the host is changing its parameters, state
+    and bus layout around it.
+*/
+class ProcessorRealtimeSafetyTest final : public juce::UnitTest
+{
+public:
+    ProcessorRealtimeSafetyTest()
+        : UnitTest ("Processor real-time safety", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("The checker catches allocations");
+        {
+            RealtimeSafetyChecker checker;
+            auto* leaked = new int (1);
+            checker.stop();
+
+            expect (checker.getNumViolations() > 0);
+            expect (checker.getReport().isNotEmpty());
+            delete leaked;
+        }
+
+       #if JUCE_LINUX
+        beginTest ("The checker catches locks");
+        {
+            std::mutex mutex;
+            juce::CriticalSection criticalSection;
+
+            RealtimeSafetyChecker checker;
+            mutex.lock();
+            mutex.unlock();
+            const juce::ScopedLock sl (criticalSection);
+            checker.stop();
+
+            expect (checker.getNumViolations() >= 2);
+        }
+
+        beginTest ("The checker catches malloc");
+        {
+            // Going through a volatile pointer stops the compiler from removing the pair of calls
+            RealtimeSafetyChecker checker;
+            void* volatile allocation = std::malloc (16);
+            std::free (allocation);
+            checker.stop();
+
+            expect (checker.getNumViolations() > 0);
+        }
+       #endif
+
+        beginTest ("Steady state");
+        {
+            AudioPluginAudioProcessor processor;
+            renderEachPrecisionChecked (processor, 512, { 512, 1, 7, 64, 500 });
+        }
+
+        beginTest ("Parameter changes");
+        {
+            AudioPluginAudioProcessor processor;
+            auto* gain = processor.parameters.getParameter (ParameterIDs::gain);
+
+            forEachPrecision (processor, juce::AudioChannelSet::stereo(), 256, [&] (auto precision)
+            {
+                // Automation that arrives between blocks, as it would from the host
+                for (int i = 0; i < 50; ++i)
+                {
+                    gain->setValueNotifyingHost (getRandom().nextFloat());
+                    renderChecked (processor, precision, 2, 256, 1);
+                }
+
+                // Changes arriving from another thread while blocks are being rendered
+                ParameterChangeThread changer (*gain);
+                changer.startThread();
+                renderChecked (processor, precision, 2, 64, 500);
+                changer.stopThread (-1);
+            });
+        }
+
+        beginTest ("Limiter automation on the audio thread");
+        {
+            // VST3 and AU hosts deliver automation on the audio thread, in between
+            // the blocks they render there. JUCE's parameters lock their listener
+            // lists to notify them, which no plugin can avoid, so each change is
+            // compared with a change to the ceiling. Nothing in the processor
+            // listens to that one, so anything more is the processor's doing.
+            AudioPluginAudioProcessor processor;
+            auto* ceiling = processor.parameters.getParameter (ParameterIDs::ceiling);
+
+            forEachPrecision (processor, juce::AudioChannelSet::stereo(), 256, [&] (auto precision)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    for (auto* id : { ParameterIDs::truePeak, ParameterIDs::oversampling, ParameterIDs::truePeakAttack,
+                                      ParameterIDs::lookahead, ParameterIDs::lookaheadTime })
+                    {
+                        auto* parameter = processor.parameters.getParameter (id);
+
+                        // Each change has to move the value, or the parameter state skips its listeners
+                        const auto ceilingCalls = countCalls ([&] { flip (*ceiling); });
+
+                        juce::AudioBuffer<float> floats (2, 256);
+                        juce::AudioBuffer<double> doubles (2, 256);
+                        juce::MidiBuffer midi;
+
+                        for (int channel = 0; channel < 2; ++channel)
+                        {
+                            for (int sample = 0; sample < 256; ++sample)
+                            {
+                                const auto noise = getRandom().nextFloat() * 2.0f - 1.0f;
+                                floats.setSample (channel, sample, noise);
+                                doubles.setSample (channel, sample, noise);
+                            }
+                        }
+
+                        RealtimeSafetyChecker checker;
+                        flip (*parameter);
+
+                        if (precision == juce::AudioProcessor::doublePrecision)
+                            processor.processBlock (doubles, midi);
+                        else
+                            processor.processBlock (floats, midi);
+
+                        checker.stop();
+
+                        if (checker.getNumViolations() != ceilingCalls)
+                        {
+                            expectEquals (checker.getNumViolations(), ceilingCalls, juce::String (id) + ": " + checker.getReport());
+                            return;
+                        }
+                    }
+                }
+
+                expect (true);
+            });
+        }
+
+        beginTest ("State restore");
+        {
+            AudioPluginAudioProcessor source, processor;
+            source.parameters.getParameter (ParameterIDs::gain)->setValueNotifyingHost (0.25f);
+
+            juce::MemoryBlock state;
+            source.getStateInformation (state);
+
+            forEachPrecision (processor, juce::AudioChannelSet::stereo(), 256, [&] (auto precision)
+            {
+                for (int i = 0; i < 10; ++i)
+                {
+                    processor.setStateInformation (state.getData(), (int) state.getSize());
+                    renderChecked (processor, precision, 2, 256, 5);
+                }
+            });
+        }
+
+        beginTest ("Bus layout changes");
+        {
+            AudioPluginAudioProcessor processor;
+
+            for (auto numChannels : { 1, 2, 6, 2, 12, 1, 16 })
+            {
+                const auto layout = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+
+                if (layout.isDisabled())
+                    continue;
+
+                forEachPrecision (processor, layout, 128, [&] (auto precision)
+                {
+                    renderChecked (processor, precision, numChannels, 128, 10);
+                });
+
+                processor.releaseResources();
+            }
+        }
+
+        beginTest ("Lookahead limiter");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::lookahead, 1.0f);
+
+            for (auto lookahead : { LookaheadLimiter<float>::minLookaheadMilliseconds,
+                                    LookaheadLimiter<float>::maxLookaheadMilliseconds })
+            {
+                setParameter (processor, ParameterIDs::lookaheadTime, lookahead);
+                renderEachPrecisionChecked (processor, 256, { 256, 1, 100 });
+            }
+        }
+
+        beginTest ("True peak limiter");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::truePeak, 1.0f);
+
+            for (int oversampling = 0; oversampling < 4; ++oversampling)
+            {
+                for (int attack = 0; attack < 2; ++attack)
+                {
+                    setParameter (processor, ParameterIDs::oversampling, (float) oversampling);
+                    setParameter (processor, ParameterIDs::truePeakAttack, (float) attack);
+                    renderEachPrecisionChecked (processor, 256, { 256, 1, 100 });
+                }
+            }
+        }
+
+        beginTest ("Low cut and tilt");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::lowCut, 1.0f);
+            setParameter (processor, ParameterIDs::tilt, 6.0f);
+            renderEachPrecisionChecked (processor, 256, { 256, 1, 100 });
+
+            // The filters' coefficients are recalculated on the audio thread
+            auto* frequency = processor.parameters.getParameter (ParameterIDs::lowCutFrequency);
+            auto* tilt = processor.parameters.getParameter (ParameterIDs::tilt);
+            prepare (processor, juce::AudioChannelSet::stereo(), 256);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                frequency->setValueNotifyingHost (getRandom().nextFloat());
+                tilt->setValueNotifyingHost (getRandom().nextFloat());
+                renderChecked<float> (processor, 2, 256, 1);
+            }
+        }
+
+        beginTest ("Loudness meter");
+        {
+            AudioPluginAudioProcessor processor;
+
+            forEachPrecision (processor, juce::AudioChannelSet::create5point1(), 256, [&] (auto precision)
+            {
+                // The editor asks for resets from the message thread, to be picked up by the next block
+                for (int i = 0; i < 20; ++i)
+                {
+                    processor.getLoudnessMeter().requestReset();
+                    renderChecked (processor, precision, 6, 256, 5);
+                }
+            });
+        }
+
+        beginTest ("Silent blocks");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::lowCut, 1.0f);
+            setParameter (processor, ParameterIDs::lookahead, 1.0f);
+            setParameter (processor, ParameterIDs::truePeak, 1.0f);
+
+            forEachPrecision (processor, juce::AudioChannelSet::stereo(), 256, [&] (auto precision)
+            {
+                // Signal, then silence for long enough that the filter and the
+                // limiters ring out and the blocks start being skipped
+                for (int i = 0; i < 3; ++i)
+                {
+                    renderChecked (processor, precision, 2, 256, 5, 1.0f);
+                    renderChecked (processor, precision, 2, 256, 200, 0.0f);
+                }
+            });
+
+            // Muted, where the blocks are skipped whatever the input is
+            setParameter (processor, ParameterIDs::gain, GainRamp::muteDecibels);
+            processor.setProcessingPrecision (juce::AudioProcessor::singlePrecision);
+            prepare (processor, juce::AudioChannelSet::stereo(), 256);
+            renderChecked<float> (processor, 2, 256, 50);
+        }
+
+        beginTest ("Blocks bigger than the prepared size");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::lowCut, 1.0f);
+            setParameter (processor, ParameterIDs::lookahead, 1.0f);
+            setParameter (processor, ParameterIDs::truePeak, 1.0f);
+            renderEachPrecisionChecked (processor, 128, { 256, 1000 });
+        }
+    }
+
+private:
+    //==============================================================================
+    struct ParameterChangeThread final : public juce::Thread
+    {
+        explicit ParameterChangeThread (juce::RangedAudioParameter& p)
+            : Thread ("Parameter changes"), parameter (p)
+        {
+        }
+
+        void run() override
+        {
+            juce::Random random;
+
+            while (! threadShouldExit())
+                parameter.setValueNotifyingHost (random.nextFloat());
+        }
+
+        juce::RangedAudioParameter& parameter;
+    };
+
+    //==============================================================================
+    void prepare (AudioPluginAudioProcessor& processor, const juce::AudioChannelSet& layout, int blockSize)
+    {
+        juce::AudioProcessor::BusesLayout buses;
+        buses.inputBuses.add (layout);
+        buses.outputBuses.add (layout);
+
+        expect (processor.setBusesLayout (buses));
+        processor.setRateAndBufferSizeDetails (48000.0, blockSize);
+        processor.prepareToPlay (48000.0, blockSize);
+    }
+
+    static void setParameter (AudioPluginAudioProcessor& processor, const char* id, float value)
+    {
+        auto* parameter = processor.parameters.getParameter (id);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    /** Sets the processor to each precision in turn and prepares it, as that's
+        when the limiters for that precision are built, and then calls the body
+        with the precision. The processor is left in single precision.
+    */
+    template <typename Body>
+    void forEachPrecision (AudioPluginAudioProcessor& processor, const juce::AudioChannelSet& layout, int blockSize, Body&& body)
+    {
+        for (auto precision : { juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision })
+        {
+            processor.setProcessingPrecision (precision);
+            prepare (processor, layout, blockSize);
+            body (precision);
+        }
+
+        processor.setProcessingPrecision (juce::AudioProcessor::singlePrecision);
+    }
+
+    /** Renders some stereo blocks of each size, in each precision. */
+    void renderEachPrecisionChecked (AudioPluginAudioProcessor& processor, int preparedBlockSize, std::initializer_list<int> blockSizes)
+    {
+        forEachPrecision (processor, juce::AudioChannelSet::stereo(), preparedBlockSize, [&] (auto precision)
+        {
+            for (auto blockSize : blockSizes)
+                renderChecked (processor, precision, 2, blockSize, 20);
+        });
+    }
+
+    /** Moves a parameter to the other end of its range. */
+    static void flip (juce::RangedAudioParameter& parameter)
+    {
+        parameter.setValueNotifyingHost (parameter.getValue() < 0.5f ? 1.0f : 0.0f);
+    }
+
+    /** Returns the number of calls that aren't real-time safe that the function makes. */
+    template <typename Function>
+    static int countCalls (Function&& function)
+    {
+        RealtimeSafetyChecker checker;
+        function();
+        checker.stop();
+        return checker.getNumViolations();
+    }
+
+    void renderChecked (AudioPluginAudioProcessor& processor,
+                        juce::AudioProcessor::ProcessingPrecision precision,
+                        int numChannels,
+                        int blockSize,
+                        int numBlocks,
+                        float level = 1.0f)
+    {
+        if (precision == juce::AudioProcessor::doublePrecision)
+            renderChecked<double> (processor, numChannels, blockSize, numBlocks, level);
+        else
+            renderChecked<float> (processor, numChannels, blockSize, numBlocks, level);
+    }
+
+    template <typename SampleType>
+    void renderChecked (AudioPluginAudioProcessor& processor, int numChannels, int blockSize, int numBlocks, float level = 1.0f)
+    {
+        juce::AudioBuffer<SampleType> buffer (numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < blockSize; ++sample)
+                    buffer.setSample (channel, sample, (SampleType) (level * (getRandom().nextFloat() * 2.0f - 1.0f)));
+
+            RealtimeSafetyChecker checker;
+            processor.processBlock (buffer, midi);
+            checker.stop();
+
+            // One failure with a stack trace is enough, rather than one for every block
+            if (checker.getNumViolations() > 0)
+            {
+                expect (false, checker.getReport());
+                return;
+            }
+        }
+
+        expect (true);
+    }
+};
+
+static ProcessorRealtimeSafetyTest processorRealtimeSafetyTest;
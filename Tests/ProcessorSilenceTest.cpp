@@ -0,0 +1,160 @@
+#include "../PluginProcessor.h"
+#include "../SilenceDetection.h"
+
+//==============================================================================
+class ProcessorSilenceTest final : public juce::UnitTest
+{
+public:
+    ProcessorSilenceTest()
+        : UnitTest ("Processor silence", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("Silence detection");
+        {
+            juce::AudioBuffer<float> buffer (2, 256);
+            buffer.clear();
+            expect (SilenceDetection::isSilent (buffer));
+
+            // Silent samples that weren't written by clear()
+            buffer.setSample (1, 100, SilenceDetection::threshold * 0.5f);
+            expect (! buffer.hasBeenCleared());
+            expect (SilenceDetection::isSilent (buffer));
+
+            buffer.setSample (1, 200, -0.001f);
+            expect (! SilenceDetection::isSilent (buffer));
+
+            juce::AudioBuffer<double> doubleBuffer (1, 256);
+            doubleBuffer.clear();
+            doubleBuffer.setSample (0, 0, 1.0e-3);
+            expect (! SilenceDetection::isSilent (doubleBuffer));
+        }
+
+        beginTest ("Muted blocks are cleared");
+        {
+            AudioPluginAudioProcessor processor;
+            setGain (processor, GainRamp::muteDecibels);
+            prepare (processor);
+
+            auto buffer = makeNoise<float> (0.5f);
+            process (processor, buffer);
+
+            expect (buffer.hasBeenCleared());
+            expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+
+            auto doubleBuffer = makeNoise<double> (0.5f);
+            process (processor, doubleBuffer);
+            expect (doubleBuffer.hasBeenCleared());
+        }
+
+        beginTest ("Silent input is cleared");
+        {
+            AudioPluginAudioProcessor processor;
+            setGain (processor, 0.0f);
+            prepare (processor);
+
+            auto buffer = makeNoise<float> (SilenceDetection::threshold * 0.5f);
+            process (processor, buffer);
+
+            expect (buffer.hasBeenCleared());
+            expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+        }
+
+        beginTest ("Audible output is not flagged as silent");
+        {
+            AudioPluginAudioProcessor processor;
+            setGain (processor, -6.0f);
+            prepare (processor);
+
+            auto buffer = makeNoise<float> (0.5f);
+            process (processor, buffer);
+
+            expect (! buffer.hasBeenCleared());
+            expectGreaterThan (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+        }
+
+        beginTest ("The gain keeps ramping through silent blocks");
+        {
+            AudioPluginAudioProcessor processor;
+            setGain (processor, 0.0f);
+            prepare (processor);
+            setGain (processor, -20.0f);
+
+            // Longer than the ramp, all of it silent
+            for (int i = 0; i < 10; ++i)
+            {
+                juce::AudioBuffer<float> silence (2, blockSize);
+                silence.clear();
+                process (processor, silence);
+            }
+
+            const auto input = makeNoise<float> (0.5f);
+            auto output = input;
+            process (processor, output);
+
+            const auto expectedGain = juce::Decibels::decibelsToGain (-20.0f);
+
+            for (int sample = 0; sample < blockSize; ++sample)
+                expectWithinAbsoluteError (output.getSample (0, sample), input.getSample (0, sample) * expectedGain, 1.0e-5f);
+        }
+
+        beginTest ("Muting ramps down before clearing");
+        {
+            AudioPluginAudioProcessor processor;
+            setGain (processor, 0.0f);
+            prepare (processor);
+            setGain (processor, GainRamp::muteDecibels);
+
+            auto buffer = makeNoise<float> (0.5f);
+            process (processor, buffer);
+            expect (! buffer.hasBeenCleared());
+
+            for (int i = 0; i < 10; ++i)
+            {
+                buffer = makeNoise<float> (0.5f);
+                process (processor, buffer);
+            }
+
+            expect (buffer.hasBeenCleared());
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr int blockSize = 256;
+
+    static void setGain (AudioPluginAudioProcessor& processor, float decibels)
+    {
+        auto* gain = processor.parameters.getParameter (ParameterIDs::gain);
+        gain->setValueNotifyingHost (gain->convertTo0to1 (decibels));
+    }
+
+    static void prepare (AudioPluginAudioProcessor& processor)
+    {
+        processor.setRateAndBufferSizeDetails (48000.0, blockSize);
+        processor.prepareToPlay (48000.0, blockSize);
+    }
+
+    template <typename SampleType>
+    static void process (AudioPluginAudioProcessor& processor, juce::AudioBuffer<SampleType>& buffer)
+    {
+        juce::MidiBuffer midi;
+        processor.processBlock (buffer, midi);
+    }
+
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType> makeNoise (float level)
+    {
+        juce::AudioBuffer<SampleType> buffer (2, blockSize);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int sample = 0; sample < blockSize; ++sample)
+                buffer.setSample (channel, sample, (SampleType) ((getRandom().nextFloat() * 2.0f - 1.0f) * level));
+
+        return buffer;
+    }
+};
+
+static ProcessorSilenceTest processorSilenceTest;
@@ -0,0 +1,148 @@
+#include "../PluginProcessor.h"
+#include "../ProcessorState.h"
+
+//==============================================================================
+class ProcessorStateTest final : public juce::UnitTest
+{
+public:
+    ProcessorStateTest()
+        : UnitTest ("Processor state", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("Saved states round trip");
+        {
+            AudioPluginAudioProcessor source, destination;
+            setGain (source, -23.5f);
+
+            juce::MemoryBlock state;
+            source.getStateInformation (state);
+            destination.setStateInformation (state.getData(), (int) state.getSize());
+
+            expectWithinAbsoluteError (getGain (destination), -23.5f, 0.001f);
+        }
+
+        beginTest ("The binary format is smaller than XML");
+        {
+            AudioPluginAudioProcessor processor;
+
+            juce::MemoryBlock binary, xml;
+            processor.getStateInformation (binary);
+            juce::AudioProcessor::copyXmlToBinary (*processor.parameters.copyState().createXml(), xml);
+
+            expectLessThan (binary.getSize(), xml.getSize());
+        }
+
+        beginTest ("Invalid data is rejected without changing anything");
+        {
+            AudioPluginAudioProcessor processor;
+            setGain (processor, -12.0f);
+
+            juce::MemoryBlock state;
+            processor.getStateInformation (state);
+
+            // Truncated
+            processor.setStateInformation (state.getData(), (int) state.getSize() - 1);
+            expectWithinAbsoluteError (getGain (processor), -12.0f, 0.001f);
+
+            // Not a state at all
+            juce::Random random (getRandom().nextInt64());
+            juce::MemoryBlock garbage (64);
+
+            for (size_t i = 0; i < garbage.getSize(); ++i)
+                garbage[i] = (char) random.nextInt (256);
+
+            processor.setStateInformation (garbage.getData(), (int) garbage.getSize());
+            processor.setStateInformation (nullptr, 0);
+            expectWithinAbsoluteError (getGain (processor), -12.0f, 0.001f);
+
+            // Too short to hold a header
+            expect (! ProcessorState::read (processor.parameters, state.getData(), 4).isValid());
+
+            // A tree of the wrong type
+            const auto otherTree = makeState (juce::ValueTree ("SOMETHING_ELSE"));
+            expect (! ProcessorState::read (processor.parameters, otherTree.getData(), otherTree.getSize()).isValid());
+        }
+
+        beginTest ("States from newer versions restore what they have in common");
+        {
+            AudioPluginAudioProcessor processor;
+
+            auto tree = processor.parameters.copyState();
+            tree.getChildWithProperty ("id", ParameterIDs::gain).setProperty ("value", -30.0f, nullptr);
+            tree.setProperty ("addedLater", 42, nullptr);
+            tree.appendChild (juce::ValueTree ("PARAM").setProperty ("id", "notYetInvented", nullptr)
+                                                       .setProperty ("value", 1.0f, nullptr), nullptr);
+
+            const auto state = makeState (tree, ProcessorState::currentVersion + 1);
+            processor.setStateInformation (state.getData(), (int) state.getSize());
+
+            expectWithinAbsoluteError (getGain (processor), -30.0f, 0.001f);
+        }
+
+        beginTest ("Missing and out of range values");
+        {
+            AudioPluginAudioProcessor processor;
+            auto* gain = processor.parameters.getParameter (ParameterIDs::gain);
+            setGain (processor, -12.0f);
+
+            // A parameter that the state doesn't mention goes back to its default
+            auto state = makeState (juce::ValueTree (processor.parameters.state.getType()));
+            processor.setStateInformation (state.getData(), (int) state.getSize());
+            expectWithinAbsoluteError (gain->getValue(), gain->getDefaultValue(), 0.0001f);
+
+            // Values outside the range are clamped
+            auto tree = processor.parameters.copyState();
+            tree.getChildWithProperty ("id", ParameterIDs::gain).setProperty ("value", -1000.0f, nullptr);
+            state = makeState (tree);
+            processor.setStateInformation (state.getData(), (int) state.getSize());
+            expectWithinAbsoluteError (getGain (processor), -60.0f, 0.001f);
+        }
+
+        beginTest ("XML states are still accepted");
+        {
+            AudioPluginAudioProcessor source, destination;
+            setGain (source, -9.0f);
+
+            juce::MemoryBlock xml;
+            juce::AudioProcessor::copyXmlToBinary (*source.parameters.copyState().createXml(), xml);
+            destination.setStateInformation (xml.getData(), (int) xml.getSize());
+
+            expectWithinAbsoluteError (getGain (destination), -9.0f, 0.001f);
+        }
+    }
+
+private:
+    //==============================================================================
+    static void setGain (AudioPluginAudioProcessor& processor, float decibels)
+    {
+        auto* gain = processor.parameters.getParameter (ParameterIDs::gain);
+        gain->setValueNotifyingHost (gain->convertTo0to1 (decibels));
+    }
+
+    static float getGain (AudioPluginAudioProcessor& processor)
+    {
+        return processor.parameters.getRawParameterValue (ParameterIDs::gain)->load();
+    }
+
+    /** Writes a tree with the same header that ProcessorState::save() uses. */
+    static juce::MemoryBlock makeState (const juce::ValueTree& tree, int version = ProcessorState::currentVersion)
+    {
+        juce::MemoryOutputStream treeData;
+        tree.writeToStream (treeData);
+
+        juce::MemoryBlock result;
+        juce::MemoryOutputStream out (result, false);
+        out.write ("Mute", 4);
+        out.writeInt (version);
+        out.writeInt ((int) treeData.getDataSize());
+        out << treeData;
+        out.flush();
+
+        return result;
+    }
+};
+
+static ProcessorStateTest processorStateTest;
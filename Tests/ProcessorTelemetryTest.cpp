@@ -0,0 +1,97 @@
+#include "RealtimeSafetyChecker.h"
+
+#include "../ProcessorTelemetry.h"
+
+//==============================================================================
+class ProcessorTelemetryTest final : public juce::UnitTest
+{
+public:
+    ProcessorTelemetryTest()
+        : UnitTest ("Processor telemetry", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("Every block lands in the histogram");
+        {
+            ProcessorTelemetry telemetry;
+            telemetry.prepare (48000.0, 256);
+
+            for (int i = 0; i < 100; ++i)
+                const ProcessorTelemetry::ScopedBlock block (telemetry, 256);
+
+            const auto snapshot = telemetry.getSnapshot();
+            expectEquals ((int) snapshot.numBlocks, 100);
+            expectEquals ((int) std::accumulate (snapshot.histogram.begin(), snapshot.histogram.end(), juce::uint64 { 0 }), 100);
+            expectEquals (snapshot.xruns, 0);
+        }
+
+        beginTest ("Preparing resets the counts");
+        {
+            ProcessorTelemetry telemetry;
+            telemetry.prepare (48000.0, 256);
+
+            { const ProcessorTelemetry::ScopedBlock block (telemetry, 256); }
+
+            telemetry.prepare (48000.0, 256);
+            expectEquals ((int) telemetry.getSnapshot().numBlocks, 0);
+        }
+
+        beginTest ("Slow blocks count as xruns");
+        {
+            ProcessorTelemetry telemetry;
+            telemetry.prepare (48000.0, 48);
+
+            {
+                // 48 samples at 48kHz is one millisecond
+                const ProcessorTelemetry::ScopedBlock block (telemetry, 48);
+                juce::Thread::sleep (5);
+            }
+
+            const auto snapshot = telemetry.getSnapshot();
+            expectEquals (snapshot.xruns, 1);
+            expectGreaterOrEqual (snapshot.totalRenderNanoseconds, (juce::uint64) 5'000'000);
+        }
+
+       #if JUCE_INTEL || (JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC)
+        beginTest ("Denormals are detected");
+        {
+            ProcessorTelemetry telemetry;
+            telemetry.prepare (48000.0, 256);
+
+            volatile float tiny = std::numeric_limits<float>::min();
+
+            {
+                const juce::ScopedNoDenormals noDenormals;
+                const ProcessorTelemetry::ScopedBlock block (telemetry, 256);
+                tiny = tiny * 0.5f;
+            }
+
+            {
+                const juce::ScopedNoDenormals noDenormals;
+                const ProcessorTelemetry::ScopedBlock block (telemetry, 256);
+                tiny = 1.0f;
+            }
+
+            expectEquals ((int) telemetry.getSnapshot().numDenormalBlocks, 1);
+        }
+       #endif
+
+        beginTest ("Recording a block doesn't allocate or lock");
+        {
+            ProcessorTelemetry telemetry;
+            telemetry.prepare (48000.0, 256);
+
+            RealtimeSafetyChecker checker;
+
+            for (int i = 0; i < 100; ++i)
+                const ProcessorTelemetry::ScopedBlock block (telemetry, 256);
+
+            checker.stop();
+            expect (checker.getNumViolations() == 0, checker.getReport());
+        }
+    }
+};
+
+static ProcessorTelemetryTest processorTelemetryTest;
@@ -0,0 +1,173 @@
+#include "RealtimeSafetyChecker.h"
+
+#if JUCE_LINUX && defined (__GLIBC__)
+ #define MUTE_INTERPOSE_LIBC 1
+ #include <dlfcn.h>
+ #include <pthread.h>
+#else
+ #define MUTE_INTERPOSE_LIBC 0
+#endif
+
+// This is a plain pointer, so reading it never allocates, which matters
+// because it's read from inside malloc.
+static thread_local RealtimeSafetyChecker* activeChecker = nullptr;
+
+//==============================================================================
+RealtimeSafetyChecker::RealtimeSafetyChecker()
+{
+    // Checkers can't be nested
+    jassert (activeChecker == nullptr);
+
+    // Registering the listener can allocate, so that has to happen before the
+    // checker starts counting.
+    juce::getAllocationHooksForThread().addListener (this);
+    activeChecker = this;
+}
+
+RealtimeSafetyChecker::~RealtimeSafetyChecker()
+{
+    stop();
+}
+
+void RealtimeSafetyChecker::stop() noexcept
+{
+    if (activeChecker != this)
+        return;
+
+    activeChecker = nullptr;
+    juce::getAllocationHooksForThread().removeListener (this);
+}
+
+juce::String RealtimeSafetyChecker::getReport() const
+{
+    // The report allocates, so the checker must have been stopped first
+    jassert (activeChecker != this);
+
+    if (numViolations == 0)
+        return {};
+
+    return juce::String (numViolations) + " call(s) that aren't real-time safe were made. "
+         + "The first was to " + firstViolation + ", from:" + juce::newLine + firstStackTrace;
+}
+
+void RealtimeSafetyChecker::notifyCall (const char* functionName) noexcept
+{
+    if (auto* checker = activeChecker)
+        checker->recordViolation (functionName);
+}
+
+void RealtimeSafetyChecker::newOrDeleteCalled() noexcept
+{
+    recordViolation ("operator new or delete");
+}
+
+void RealtimeSafetyChecker::recordViolation (const char* functionName) noexcept
+{
+    // Taking the stack trace allocates and locks too, and those calls shouldn't be counted
+    if (activeChecker != this || isRecording)
+        return;
+
+    if (numViolations++ > 0)
+        return;
+
+    const juce::ScopedValueSetter<bool> recording (isRecording, true);
+    firstViolation = functionName;
+    firstStackTrace = juce::SystemStats::getStackBacktrace();
+}
+
+//==============================================================================
+#if MUTE_INTERPOSE_LIBC
+
+// Defining these in the executable takes precedence over the versions in libc,
+// for calls made from shared libraries as well as from our own code. Each one
+// reports the call, and then forwards it to the real implementation.
+
+// The pthread functions have no private aliases to forward to, so the next
+// definition along is looked up instead.
+template <typename Function>
+static Function findNextDefinition (const char* name) noexcept
+{
+    return reinterpret_cast<Function> (dlsym (RTLD_NEXT, name));
+}
+
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void  __libc_free (void*);
+
+    void* malloc (size_t size) __THROW
+    {
+        RealtimeSafetyChecker::notifyCall ("malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t numElements, size_t elementSize) __THROW
+    {
+        RealtimeSafetyChecker::notifyCall ("calloc");
+        return __libc_calloc (numElements, elementSize);
+    }
+
+    void* realloc (void* ptr, size_t size) __THROW
+    {
+        RealtimeSafetyChecker::notifyCall ("realloc");
+        return __libc_realloc (ptr, size);
+    }
+
+    void* aligned_alloc (size_t alignment, size_t size) __THROW
+    {
+        RealtimeSafetyChecker::notifyCall ("aligned_alloc");
+        return __libc_memalign (alignment, size);
+    }
+
+    int posix_memalign (void** result, size_t alignment, size_t size) __THROW
+    {
+        RealtimeSafetyChecker::notifyCall ("posix_memalign");
+
+        if (! juce::isPowerOfTwo (alignment) || alignment % sizeof (void*) != 0)
+            return EINVAL;
+
+        if (auto* ptr = __libc_memalign (alignment, size))
+        {
+            *result = ptr;
+            return 0;
+        }
+
+        return ENOMEM;
+    }
+
+    void free (void* ptr) __THROW
+    {
+        // Freeing a null pointer doesn't touch the allocator, and empty HeapBlocks
+        // and AudioBuffers do it whenever they're destroyed
+        if (ptr != nullptr)
+            RealtimeSafetyChecker::notifyCall ("free");
+
+        __libc_free (ptr);
+    }
+
+    int pthread_mutex_lock (pthread_mutex_t* mutex) __THROWNL
+    {
+        RealtimeSafetyChecker::notifyCall ("pthread_mutex_lock");
+        static const auto next = findNextDefinition<int (*) (pthread_mutex_t*)> ("pthread_mutex_lock");
+        return next (mutex);
+    }
+
+    int pthread_rwlock_rdlock (pthread_rwlock_t* lock) __THROWNL
+    {
+        RealtimeSafetyChecker::notifyCall ("pthread_rwlock_rdlock");
+        static const auto next = findNextDefinition<int (*) (pthread_rwlock_t*)> ("pthread_rwlock_rdlock");
+        return next (lock);
+    }
+
+    int pthread_rwlock_wrlock (pthread_rwlock_t* lock) __THROWNL
+    {
+        RealtimeSafetyChecker::notifyCall ("pthread_rwlock_wrlock");
+        static const auto next = findNextDefinition<int (*) (pthread_rwlock_t*)> ("pthread_rwlock_wrlock");
+        return next (lock);
+    }
+}
+
+#endif
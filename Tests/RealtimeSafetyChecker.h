@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#if ! JUCE_ENABLE_ALLOCATION_HOOKS
+ #error "The real-time safety checker needs JUCE_ENABLE_ALLOCATION_HOOKS=1"
+#endif
+
+//==============================================================================
+/** Watches the calling thread for anything that isn't safe to do on the audio
+    thread, for as long as it is active.
+
+    Calls to new and delete are picked up through juce::AllocationHooks, so the
+    code being checked must be built with JUCE_ENABLE_ALLOCATION_HOOKS=1. On
+    Linux, the checker also intercepts malloc, free and friends, which catches
+    allocations that bypass operator new (such as juce::HeapBlock), along with
+    pthread mutex and read/write lock acquisitions, which is what std::mutex and
+    juce::CriticalSection both end up calling.
+
+    The first violation is recorded along with a stack trace, so that a failing
+    test shows exactly where the allocation or lock came from.
+
+    @code
+    RealtimeSafetyChecker checker;
+    processor.processBlock (buffer, midi);
+    checker.stop();
+
+    expect (checker.getNumViolations() == 0, checker.getReport());
+    @endcode
+*/
+class RealtimeSafetyChecker final : private juce::AllocationHooks::Listener
+{
+public:
+    //==============================================================================
+    /** Starts watching the calling thread.
+        Only one checker can be active on a thread at a time.
+    */
+    RealtimeSafetyChecker();
+
+    /** Stops watching, if stop() hasn't already been called. */
+    ~RealtimeSafetyChecker() override;
+
+    /** Stops watching the thread.
+
+        This must be called before looking at the results, because building the
+        report allocates, and would otherwise be counted as a violation itself.
+    */
+    void stop() noexcept;
+
+    /** Returns the number of violations that happened while the checker was active. */
+    int getNumViolations() const noexcept       { return numViolations; }
+
+    /** Returns a description of the first violation, with its stack trace. */
+    juce::String getReport() const;
+
+    //==============================================================================
+    /** @internal Called by the interposed allocator and lock functions. */
+    static void notifyCall (const char* functionName) noexcept;
+
+private:
+    //==============================================================================
+    void newOrDeleteCalled() noexcept override;
+    void recordViolation (const char* functionName) noexcept;
+
+    bool active = true, isRecording = false;
+    int numViolations = 0;
+    const char* firstViolation = nullptr;
+    juce::String firstStackTrace;
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeSafetyChecker)
+};
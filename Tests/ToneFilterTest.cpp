@@ -0,0 +1,190 @@
+#include "../PluginProcessor.h"
+#include "../SilenceDetection.h"
+#include "../ToneFilter.h"
+
+//==============================================================================
+class ToneFilterTest final : public juce::UnitTest
+{
+public:
+    ToneFilterTest()
+        : UnitTest ("Tone filter", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("The default settings are flat");
+        {
+            ToneFilter<float> filter;
+            filter.prepare ({ sampleRate, blockSize, 2 });
+            filter.setParameters (false, 80.0f, 0.0f);
+            expect (filter.isFlat());
+
+            filter.setParameters (false, 80.0f, 1.0f);
+            expect (! filter.isFlat());
+        }
+
+        beginTest ("The low cut removes DC");
+        {
+            ToneFilter<float> filter;
+            filter.prepare ({ sampleRate, blockSize, 2 });
+            filter.setParameters (true, 80.0f, 0.0f);
+
+            const auto output = measureSine (filter, 2, 0.0);
+            expectLessThan (output, 0.001f);
+
+            // ...but leaves the midrange alone
+            expectWithinAbsoluteError (juce::Decibels::gainToDecibels (measureSine (filter, 2, 1000.0)), 0.0f, 0.1f);
+        }
+
+        beginTest ("The tilt pivots around the centre");
+        {
+            ToneFilter<double> filter;
+            filter.prepare ({ sampleRate, blockSize, 12 });
+            filter.setParameters (false, 80.0f, 6.0f);
+
+            expectWithinAbsoluteError (juce::Decibels::gainToDecibels (measureSine (filter, 12, 30.0)), -3.0f, 0.2f);
+            expectWithinAbsoluteError (juce::Decibels::gainToDecibels (measureSine (filter, 12, 1000.0)), 0.0f, 0.2f);
+            expectWithinAbsoluteError (juce::Decibels::gainToDecibels (measureSine (filter, 12, 16000.0)), 3.0f, 0.2f);
+        }
+
+        beginTest ("Taking the tilt away lets the shelves ring out");
+        {
+            ToneFilter<float> filter;
+            filter.prepare ({ sampleRate, blockSize, 1 });
+            filter.setParameters (false, 80.0f, 6.0f);
+            measureSine (filter, 1, 30.0);
+
+            // The shelves are still ringing, so they stay, at unity gain, rather
+            // than being cut off in the middle of it
+            filter.setParameters (false, 80.0f, 0.0f);
+            expect (! filter.isFlat());
+
+            juce::AudioBuffer<float> silence (1, blockSize);
+            silence.clear();
+            filter.process (silence);
+            expect (! SilenceDetection::isSilent (silence));
+
+            filter.reset();
+            expect (filter.isFlat());
+        }
+
+        beginTest ("Parameters set before prepare are applied");
+        {
+            ToneFilter<float> filter;
+            filter.setParameters (true, 200.0f, 0.0f);
+            filter.prepare ({ sampleRate, blockSize, 1 });
+
+            expect (! filter.isFlat());
+            expectLessThan (measureSine (filter, 1, 0.0), 0.001f);
+        }
+
+        beginTest ("The processor applies the low cut");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::gain, -6.0f);
+            setParameter (processor, ParameterIDs::lowCut, 1.0f);
+            processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer (2, blockSize);
+            juce::MidiBuffer midi;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    juce::FloatVectorOperations::fill (buffer.getWritePointer (channel), 0.5f, blockSize);
+
+                processor.processBlock (buffer, midi);
+            }
+
+            expectLessThan (buffer.getMagnitude (0, blockSize), 0.001f);
+        }
+
+        beginTest ("The processor lets the filter ring out when the input stops");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::gain, 0.0f);
+            setParameter (processor, ParameterIDs::lowCut, 1.0f);
+            setParameter (processor, ParameterIDs::tilt, 6.0f);
+            processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+
+            // A filter of its own, to show what the ringing should be
+            ToneFilter<float> filter;
+            filter.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            filter.setParameters (true, processor.parameters.getRawParameterValue (ParameterIDs::lowCutFrequency)->load(), 6.0f);
+
+            juce::AudioBuffer<float> buffer (2, blockSize), expected (2, blockSize);
+            juce::MidiBuffer midi;
+            int numRingingBlocks = 0;
+
+            for (int i = 0; i < 1000 && ! buffer.hasBeenCleared(); ++i)
+            {
+                // A step, which leaves the low cut ringing, and then silence
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    juce::FloatVectorOperations::fill (buffer.getWritePointer (channel), i < 4 ? 0.5f : 0.0f, blockSize);
+
+                expected.makeCopyOf (buffer);
+                filter.process (expected);
+                processor.processBlock (buffer, midi);
+
+                if (buffer.hasBeenCleared())
+                {
+                    expectLessOrEqual (expected.getMagnitude (0, blockSize), SilenceDetection::threshold);
+                    continue;
+                }
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    for (int sample = 0; sample < blockSize; ++sample)
+                        expectWithinAbsoluteError (buffer.getSample (channel, sample), expected.getSample (channel, sample), 1.0e-6f);
+
+                if (i >= 4)
+                    ++numRingingBlocks;
+            }
+
+            expect (buffer.hasBeenCleared());
+            expectGreaterThan (numRingingBlocks, 0);
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    /** Runs a second of a unit sine (or DC, at 0 Hz) through each channel, and
+        returns the highest level on any channel over the last half.
+    */
+    template <typename SampleType>
+    static float measureSine (ToneFilter<SampleType>& filter, int numChannels, double frequency)
+    {
+        filter.reset();
+
+        juce::AudioBuffer<SampleType> buffer (numChannels, blockSize);
+        float result = 0.0f;
+
+        for (int start = 0; start < (int) sampleRate; start += blockSize)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample (channel, i, (SampleType) std::cos (juce::MathConstants<double>::twoPi * frequency * (start + i) / sampleRate));
+
+            filter.process (buffer);
+
+            if (start > (int) sampleRate / 2)
+                for (int channel = 0; channel < numChannels; ++channel)
+                    result = juce::jmax (result, (float) buffer.getMagnitude (channel, 0, blockSize));
+        }
+
+        return result;
+    }
+
+    static void setParameter (AudioPluginAudioProcessor& processor, juce::StringRef id, float value)
+    {
+        auto* parameter = processor.parameters.getParameter (id);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+};
+
+static ToneFilterTest toneFilterTest;
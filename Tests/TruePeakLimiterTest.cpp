@@ -0,0 +1,284 @@
+#include "../PluginProcessor.h"
+#include "../TruePeakLimiter.h"
+
+//==============================================================================
+class TruePeakLimiterTest final : public juce::UnitTest
+{
+public:
+    TruePeakLimiterTest()
+        : UnitTest ("True peak limiter", "Mute")
+    {
+    }
+
+    void runTest() override
+    {
+        using Attack = TruePeakLimiter<float>::Attack;
+
+        for (auto attack : { Attack::fast, Attack::smooth })
+        {
+            const auto attackName = juce::String (attack == Attack::fast ? "fast attack" : "smooth attack");
+
+            beginTest ("Inter-sample peaks are held under the ceiling, " + attackName);
+            {
+                for (int order = 1; order <= TruePeakLimiter<float>::maxOversamplingOrder; ++order)
+                {
+                    TruePeakLimiter<float> limiter (2, sampleRate, blockSize, order, attack);
+
+                    // A quarter of the sample rate, 45 degrees out of phase with the
+                    // samples, peaks 3 dB higher between them than it does at them.
+                    auto signal = makeSine (0.25, juce::MathConstants<double>::pi / 4.0, 1.4, 64);
+                    expectLessThan (signal.getMagnitude (0, signal.getNumSamples()), 1.0f);
+                    expectGreaterThan (measureTruePeak (signal), 1.3f);
+
+                    processInBlocks (limiter, signal, -1.0f);
+
+                    // The first few blocks are the limiter's latency and its attack
+                    const auto settled = signal.getNumSamples() / 2;
+                    juce::AudioBuffer<float> tail (signal.getArrayOfWritePointers(), 2, settled, signal.getNumSamples() - settled);
+
+                    expectLessOrEqual (juce::Decibels::gainToDecibels (measureTruePeak (tail)), -1.0f + truePeakTolerance,
+                                       "Oversampled " + juce::String (1 << order) + "x");
+                }
+            }
+
+            beginTest ("Impulses and steps are held under the ceiling, " + attackName);
+            {
+                for (int order = 1; order <= TruePeakLimiter<float>::maxOversamplingOrder; ++order)
+                {
+                    for (const auto& [signalName, signal] : makeTransients())
+                    {
+                        TruePeakLimiter<float> limiter (2, sampleRate, blockSize, order, attack);
+
+                        auto limited = signal;
+                        processInBlocks (limiter, limited, -1.0f);
+
+                        // All of the output counts here, including the attack. 2x oversampling
+                        // can miss some of the peak between two opposite full scale samples.
+                        expectLessOrEqual (juce::Decibels::gainToDecibels (measureTruePeak (limited)), order == 1 ? -0.3f : -1.0f,
+                                           juce::String (signalName) + ", oversampled " + juce::String (1 << order) + "x");
+                    }
+                }
+            }
+
+            beginTest ("Signals under the ceiling are only delayed, " + attackName);
+            {
+                TruePeakLimiter<float> limiter (1, sampleRate, blockSize, 2, attack);
+
+                juce::AudioBuffer<float> impulse (1, blockSize * 4);
+                impulse.clear();
+                impulse.setSample (0, 0, 0.5f);
+
+                processInBlocks (limiter, impulse, 0.0f);
+
+                int peakIndex = 0;
+
+                for (int i = 1; i < impulse.getNumSamples(); ++i)
+                    if (std::abs (impulse.getSample (0, i)) > std::abs (impulse.getSample (0, peakIndex)))
+                        peakIndex = i;
+
+                expectWithinAbsoluteError (peakIndex, limiter.getLatencySamples(), 1);
+
+                // The signal is only delayed, so nothing is left once the tail has passed
+                expectEquals (limiter.getTailSamples(), limiter.getLatencySamples());
+                expectEquals (impulse.getSample (0, limiter.getLatencySamples()), 0.5f);
+
+                const auto tailEnd = limiter.getTailSamples() + 1;
+                expectEquals (impulse.getMagnitude (tailEnd, impulse.getNumSamples() - tailEnd), 0.0f);
+            }
+        }
+
+        beginTest ("The processor reports the limiter's latency");
+        {
+            AudioPluginAudioProcessor processor;
+            prepare (processor);
+            expectEquals (processor.getLatencySamples(), 0);
+            expectEquals (processor.getTailLengthSeconds(), 0.0);
+
+            setParameter (processor, ParameterIDs::truePeak, 1.0f);
+            setParameter (processor, ParameterIDs::truePeakAttack, 0.0f);
+            prepare (processor);
+
+            const auto fastLatency = processor.getLatencySamples();
+            expectGreaterThan (fastLatency, 0);
+            expectGreaterThan (processor.getTailLengthSeconds(), 0.0);
+
+            setParameter (processor, ParameterIDs::truePeakAttack, 1.0f);
+            prepare (processor);
+            expectGreaterThan (processor.getLatencySamples(), fastLatency);
+
+            setParameter (processor, ParameterIDs::truePeak, 0.0f);
+            prepare (processor);
+            expectEquals (processor.getLatencySamples(), 0);
+        }
+
+        beginTest ("The processor limits in both precisions");
+        {
+            AudioPluginAudioProcessor processor;
+            setParameter (processor, ParameterIDs::gain, 1.0f);
+            setParameter (processor, ParameterIDs::truePeak, 1.0f);
+
+            for (auto precision : { juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision })
+            {
+                processor.setProcessingPrecision (precision);
+                prepare (processor);
+
+                juce::MidiBuffer midi;
+                auto signal = makeSine (0.25, juce::MathConstants<double>::pi / 4.0, 1.4, 64);
+
+                if (precision == juce::AudioProcessor::singlePrecision)
+                {
+                    for (int start = 0; start < signal.getNumSamples(); start += blockSize)
+                    {
+                        juce::AudioBuffer<float> block (signal.getArrayOfWritePointers(), 2, start, blockSize);
+                        processor.processBlock (block, midi);
+                    }
+                }
+                else
+                {
+                    juce::AudioBuffer<double> doubleSignal (2, signal.getNumSamples());
+                    doubleSignal.makeCopyOf (signal);
+
+                    for (int start = 0; start < signal.getNumSamples(); start += blockSize)
+                    {
+                        juce::AudioBuffer<double> block (doubleSignal.getArrayOfWritePointers(), 2, start, blockSize);
+                        processor.processBlock (block, midi);
+                    }
+
+                    signal.makeCopyOf (doubleSignal);
+                }
+
+                const auto settled = signal.getNumSamples() / 2;
+                expectLessThan (signal.getMagnitude (settled, signal.getNumSamples() - settled),
+                                juce::Decibels::decibelsToGain (-1.0f + truePeakTolerance));
+            }
+        }
+
+        beginTest ("The processor splits blocks bigger than it was prepared for");
+        {
+            // Two processors with both limiters on, one given blocks of the size it
+            // was prepared for, and one given blocks twice as big
+            AudioPluginAudioProcessor expected, processor;
+
+            for (auto* p : { &expected, &processor })
+            {
+                setParameter (*p, ParameterIDs::gain, 1.0f);
+                setParameter (*p, ParameterIDs::truePeak, 1.0f);
+                setParameter (*p, ParameterIDs::lookahead, 1.0f);
+                prepare (*p);
+            }
+
+            juce::MidiBuffer midi;
+            const auto input = makeSine (0.01, 0.0, 0.9, 16);
+            auto expectedOutput = input, output = input;
+
+            for (int start = 0; start < input.getNumSamples(); start += blockSize)
+            {
+                juce::AudioBuffer<float> block (expectedOutput.getArrayOfWritePointers(), 2, start, blockSize);
+                expected.processBlock (block, midi);
+            }
+
+            for (int start = 0; start < input.getNumSamples(); start += 2 * blockSize)
+            {
+                juce::AudioBuffer<float> block (output.getArrayOfWritePointers(), 2, start, 2 * blockSize);
+                processor.processBlock (block, midi);
+            }
+
+            int numDifferent = 0;
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    if (! juce::exactlyEqual (output.getSample (channel, i), expectedOutput.getSample (channel, i)))
+                        ++numDifferent;
+
+            expectEquals (numDifferent, 0);
+            expectLessThan (output.getMagnitude (0, output.getNumSamples()), 1.0f);
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    // The filters that measure the true peak add a little ripple of their own
+    static constexpr float truePeakTolerance = 0.2f;
+
+    static void processInBlocks (TruePeakLimiter<float>& limiter, juce::AudioBuffer<float>& signal, float ceilingDecibels)
+    {
+        for (int start = 0; start < signal.getNumSamples(); start += blockSize)
+        {
+            juce::AudioBuffer<float> block (signal.getArrayOfWritePointers(), signal.getNumChannels(), start,
+                                            juce::jmin (blockSize, signal.getNumSamples() - start));
+            limiter.process (block, ceilingDecibels);
+        }
+    }
+
+    /** Measures the peak of a 4x oversampled copy of the signal, as a true peak meter would. */
+    static float measureTruePeak (const juce::AudioBuffer<float>& signal)
+    {
+        juce::dsp::Oversampling<float> oversampling ((size_t) signal.getNumChannels(), 2,
+                                                     juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple);
+        oversampling.initProcessing ((size_t) signal.getNumSamples());
+
+        const auto upsampled = oversampling.processSamplesUp (juce::dsp::AudioBlock<const float> (signal));
+        const auto latency = (size_t) juce::roundToInt (oversampling.getLatencyInSamples()) * oversampling.getOversamplingFactor();
+
+        // Skip the filter's own start-up transient
+        const auto settled = upsampled.getSubBlock (latency * 2);
+        auto range = settled.findMinAndMax();
+        return juce::jmax (-range.getStart(), range.getEnd());
+    }
+
+    /** Makes full scale impulses and steps, each after some silence, which are the
+        signals most likely to ring over the ceiling.
+    */
+    static std::vector<std::pair<const char*, juce::AudioBuffer<float>>> makeTransients()
+    {
+        std::vector<std::pair<const char*, juce::AudioBuffer<float>>> signals;
+
+        const auto add = [&] (const char* name, auto&& getSample)
+        {
+            juce::AudioBuffer<float> buffer (2, 16 * blockSize);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (channel, i, i < 4 * blockSize ? 0.0f : getSample (i - 4 * blockSize));
+
+            signals.emplace_back (name, std::move (buffer));
+        };
+
+        add ("impulse",                [] (int i) { return i == 0 ? 1.0f : 0.0f; });
+        add ("impulse pair",           [] (int i) { return i == 0 || i == 1 ? 1.0f : 0.0f; });
+        add ("alternating impulses",   [] (int i) { return i == 0 ? 1.0f : (i == 1 ? -1.0f : 0.0f); });
+        add ("step",                   [] (int)   { return 1.0f; });
+        add ("step up from -1",        [] (int i) { return i < 3 * blockSize ? -1.0f : 1.0f; });
+        add ("square wave",            [] (int i) { return (i / 8) % 2 == 0 ? 1.0f : -1.0f; });
+        add ("fs/4 square wave",       [] (int i) { return (i / 2) % 2 == 0 ? 1.0f : -1.0f; });
+
+        return signals;
+    }
+
+    static juce::AudioBuffer<float> makeSine (double cyclesPerSample, double phase, double amplitude, int numBlocks)
+    {
+        juce::AudioBuffer<float> buffer (2, numBlocks * blockSize);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, (float) (amplitude * std::sin (juce::MathConstants<double>::twoPi * cyclesPerSample * i + phase)));
+
+        return buffer;
+    }
+
+    static void setParameter (AudioPluginAudioProcessor& processor, juce::StringRef id, float normalisedValue)
+    {
+        processor.parameters.getParameter (id)->setValueNotifyingHost (normalisedValue);
+    }
+
+    static void prepare (AudioPluginAudioProcessor& processor)
+    {
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+    }
+};
+
+static TruePeakLimiterTest truePeakLimiterTest;
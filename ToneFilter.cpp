@@ -0,0 +1,90 @@
+#include "ToneFilter.h"
+
+//==============================================================================
+template <typename SampleType>
+void ToneFilter<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    cascade.prepare (spec);
+
+    // Work the coefficients out again for the new sample rate
+    const auto lowCut = currentLowCut;
+    const auto lowCutFrequency = currentLowCutFrequency;
+    const auto tilt = currentTilt;
+
+    currentLowCutFrequency = -1.0f;
+    shelvesInUse = false;
+    setParameters (lowCut, lowCutFrequency, tilt);
+}
+
+template <typename SampleType>
+void ToneFilter<SampleType>::reset() noexcept
+{
+    cascade.reset();
+
+    // With their state cleared, shelves that have no tilt can finally be dropped
+    shelvesInUse = ! juce::exactlyEqual (currentTilt, 0.0f);
+
+    if (sampleRate > 0.0)
+        cascade.setNumStages (getNumStages());
+}
+
+template <typename SampleType>
+int ToneFilter<SampleType>::getNumStages() const noexcept
+{
+    return currentLowCut ? 3 : (shelvesInUse ? 2 : 0);
+}
+
+template <typename SampleType>
+void ToneFilter<SampleType>::setParameters (bool lowCutEnabled, float lowCutFrequency, float tiltDecibels) noexcept
+{
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<SampleType>;
+
+    if (lowCutEnabled == currentLowCut
+        && juce::exactlyEqual (lowCutFrequency, currentLowCutFrequency)
+        && juce::exactlyEqual (tiltDecibels, currentTilt))
+        return;
+
+    currentLowCut = lowCutEnabled;
+    currentLowCutFrequency = lowCutFrequency;
+    currentTilt = tiltDecibels;
+
+    if (sampleRate <= 0.0)
+        return;
+
+    // The low cut comes last, so that switching it on and off doesn't disturb the
+    // shelves. With no tilt the shelves have unity gain, but they can still be
+    // ringing from the tilt they had before, so they're only dropped by reset(),
+    // once the processor has let them ring out. Until then they carry on at unity
+    // gain, and their ringing dies away instead of being cut off with a click.
+    shelvesInUse = shelvesInUse || ! juce::exactlyEqual (tiltDecibels, 0.0f);
+    cascade.setNumStages (getNumStages());
+
+    if (lowCutEnabled || shelvesInUse)
+    {
+        const auto halfTilt = juce::Decibels::decibelsToGain ((SampleType) tiltDecibels * (SampleType) 0.5);
+        const auto shelfQ = (SampleType) 0.5;
+
+        cascade.setCoefficients (0, ArrayCoefficients::makeLowShelf (sampleRate, (SampleType) pivotFrequency, shelfQ, (SampleType) 1 / halfTilt));
+        cascade.setCoefficients (1, ArrayCoefficients::makeHighShelf (sampleRate, (SampleType) pivotFrequency, shelfQ, halfTilt));
+    }
+
+    if (lowCutEnabled)
+    {
+        const auto frequency = juce::jmin ((SampleType) lowCutFrequency, (SampleType) (sampleRate * 0.45));
+        cascade.setCoefficients (2, ArrayCoefficients::makeHighPass (sampleRate, frequency));
+    }
+}
+
+template <typename SampleType>
+void ToneFilter<SampleType>::process (juce::AudioBuffer<SampleType>& buffer) noexcept
+{
+    if (isFlat())
+        return;
+
+    juce::dsp::AudioBlock<SampleType> block (buffer);
+    cascade.process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+}
+
+template class ToneFilter<float>;
+template class ToneFilter<double>;
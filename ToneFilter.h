@@ -0,0 +1,53 @@
+#pragma once
+
+#include "BiquadCascade.h"
+
+//==============================================================================
+/** The EQ in front of the gain stage: a tilt around a fixed pivot, and an
+    optional low cut.
+
+    The tilt is a low shelf and a high shelf at the pivot frequency, cutting one
+    side by half the tilt and boosting the other by the same amount. The low cut
+    is a 12 dB per octave Butterworth high-pass. All of them run in a single
+    BiquadCascade, so every channel of the bus is filtered in the same pass.
+
+    The coefficients are worked out with juce::dsp::IIR::ArrayCoefficients, which
+    doesn't allocate, so the parameters can be set on the audio thread.
+*/
+template <typename SampleType>
+class ToneFilter final
+{
+public:
+    //==============================================================================
+    /** The frequency that the tilt pivots around. */
+    static constexpr float pivotFrequency = 1000.0f;
+
+    //==============================================================================
+    /** Allocates the filters for the given number of channels and block size. */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+
+    /** Clears the filters' state. Shelves left at unity gain by taking the tilt
+        away are dropped here, as that's when they've stopped ringing.
+    */
+    void reset() noexcept;
+
+    /** Updates the filters, if any of the values have changed since the last call. */
+    void setParameters (bool lowCutEnabled, float lowCutFrequency, float tiltDecibels) noexcept;
+
+    /** True when the filter would leave the signal unchanged, and can be skipped. */
+    bool isFlat() const noexcept                        { return cascade.getNumStages() == 0; }
+
+    /** Filters the buffer in place. */
+    void process (juce::AudioBuffer<SampleType>& buffer) noexcept;
+
+private:
+    //==============================================================================
+    int getNumStages() const noexcept;
+
+    //==============================================================================
+    BiquadCascade<SampleType> cascade;
+    double sampleRate = 0.0;
+
+    bool currentLowCut = false, shelvesInUse = false;
+    float currentLowCutFrequency = 0.0f, currentTilt = 0.0f;
+};
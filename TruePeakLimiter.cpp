@@ -0,0 +1,118 @@
+#include "TruePeakLimiter.h"
+
+//==============================================================================
+template <typename SampleType>
+TruePeakLimiter<SampleType>::TruePeakLimiter (int channels,
+                                              double sampleRate,
+                                              int maximumBlockSize,
+                                              int oversamplingOrder,
+                                              Attack attack)
+    : numChannels (channels),
+      oversampling ((size_t) channels,
+                    (size_t) juce::jlimit (1, maxOversamplingOrder, oversamplingOrder),
+                    juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple,
+                    true,
+                    false),
+      factor ((int) oversampling.getOversamplingFactor()),
+      peaks (2, maximumBlockSize * factor),
+      limiter (channels,
+               sampleRate,
+               maximumBlockSize,
+               attack == Attack::smooth ? 5.0f : 1.0f,
+               holdSamples,
+               prepareOversampling (oversampling, maximumBlockSize))
+{
+}
+
+template <typename SampleType>
+int TruePeakLimiter<SampleType>::prepareOversampling (juce::dsp::Oversampling<SampleType>& oversampling, int maximumBlockSize)
+{
+    oversampling.initProcessing ((size_t) maximumBlockSize);
+
+    // The peaks come out of the upsampling filters late, so the signal has to be
+    // delayed to line up with them. Oversampling only reports the delay of the
+    // upsampling and downsampling together, so this finds where an impulse comes out.
+    juce::AudioBuffer<SampleType> impulse ((int) oversampling.numChannels, maximumBlockSize);
+    const auto factor = (int) oversampling.getOversamplingFactor();
+    SampleType loudest = 0;
+    int delay = 0;
+
+    for (int start = 0; start < 2048; start += maximumBlockSize)
+    {
+        impulse.clear();
+
+        if (start == 0)
+            impulse.setSample (0, 0, 1);
+
+        const auto upsampled = oversampling.processSamplesUp (juce::dsp::AudioBlock<const SampleType> (impulse));
+
+        for (int i = 0; i < maximumBlockSize * factor; ++i)
+        {
+            const auto sample = std::abs (upsampled.getSample (0, i));
+
+            if (sample > loudest)
+            {
+                loudest = sample;
+                delay = start + juce::roundToInt ((double) i / factor);
+            }
+        }
+    }
+
+    oversampling.reset();
+    return delay;
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::reset() noexcept
+{
+    oversampling.reset();
+    limiter.reset();
+}
+
+//==============================================================================
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::process (juce::AudioBuffer<SampleType>& buffer, float ceilingDecibels) noexcept
+{
+    jassert (buffer.getNumChannels() >= numChannels);
+    jassert (buffer.getNumSamples() * factor <= peaks.getNumSamples());
+
+    const auto block = juce::dsp::AudioBlock<SampleType> (buffer).getSubsetChannelBlock (0, (size_t) numChannels);
+
+    findPeaks (oversampling.processSamplesUp (block), buffer.getNumSamples());
+    limiter.process (buffer, peaks.getReadPointer (0), ceilingDecibels - safetyMarginDecibels);
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::findPeaks (const juce::dsp::AudioBlock<SampleType>& upsampled, int numSamples) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+
+    const auto numUpsampled = (int) upsampled.getNumSamples();
+    auto* peak = peaks.getWritePointer (0);
+    auto* scratch = peaks.getWritePointer (1);
+
+    // The loudest channel at each sample decides the gain for all of them
+    FVO::abs (peak, upsampled.getChannelPointer (0), numUpsampled);
+
+    for (size_t channel = 1; channel < upsampled.getNumChannels(); ++channel)
+    {
+        FVO::abs (scratch, upsampled.getChannelPointer (channel), numUpsampled);
+        FVO::max (peak, peak, scratch, numUpsampled);
+    }
+
+    // Each sample at the original rate takes the loudest of the oversampled ones
+    // that follow it. This is done in place, as each one is written no later
+    // than the first one it reads.
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto loudest = peak[i * factor];
+
+        for (int j = 1; j < factor; ++j)
+            loudest = juce::jmax (loudest, peak[i * factor + j]);
+
+        peak[i] = loudest;
+    }
+}
+
+template class TruePeakLimiter<float>;
+template class TruePeakLimiter<double>;
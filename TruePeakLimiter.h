@@ -0,0 +1,97 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "LookaheadLimiter.h"
+
+//==============================================================================
+/** Holds the output below a ceiling, measured between samples as well as at them.
+
+    An oversampled copy of the signal, made with juce::dsp::Oversampling, is only
+    used to find the peaks, including the ones that fall between samples. Its
+    filters are linear phase, as ones that aren't would change the shape of a
+    transient, and with it the height of the peaks between its samples. The
+    gain that those peaks need is worked out by a LookaheadLimiter, which ramps it
+    down ahead of each peak and applies it to the signal at its original rate, so
+    nothing is ever downsampled and there's no filter ringing to push a limited
+    peak back over the ceiling. The gain is shared by every channel, so that
+    limiting doesn't move the stereo image.
+
+    The gain stays fully down for a few samples either side of each peak, so
+    that the samples which the peak between them is reconstructed from are all
+    turned down by the same amount.
+
+    Constructing a limiter allocates, so it must be done off the audio thread.
+*/
+template <typename SampleType>
+class TruePeakLimiter final
+{
+public:
+    //==============================================================================
+    /** How far ahead the limiter looks, which sets how gently the gain comes down
+        before a peak, and how much latency the limiter adds.
+    */
+    enum class Attack
+    {
+        fast,       /**< Looks ahead 1 ms, for the least latency. */
+        smooth      /**< Looks ahead 5 ms, for less distortion on loud transients. */
+    };
+
+    /** The highest supported oversampling factor is 2 ^ maxOversamplingOrder. */
+    static constexpr int maxOversamplingOrder = 4;
+
+    /** The number of samples either side of a peak that the gain is held for. */
+    static constexpr int holdSamples = 8;
+
+    /** How far under the ceiling the limiter aims, to allow for a true peak meter
+        with different filters, which will find slightly different peaks.
+    */
+    static constexpr float safetyMarginDecibels = 0.02f;
+
+    /** Creates a limiter that oversamples by 2 ^ oversamplingOrder, which must be
+        between 1 and maxOversamplingOrder.
+
+        At 4x and above, the output measures at or under the ceiling on a BS.1770
+        true peak meter. 2x is cheaper, but the most extreme transients, such as a
+        full scale sample followed by its opposite, can peak up to 0.7 dB over the
+        ceiling between the points that it checks.
+    */
+    TruePeakLimiter (int numChannels,
+                     double sampleRate,
+                     int maximumBlockSize,
+                     int oversamplingOrder,
+                     Attack attack);
+
+    //==============================================================================
+    /** Returns the delay, in samples at the original rate, that the limiter adds. */
+    int getLatencySamples() const noexcept              { return limiter.getLatencySamples(); }
+
+    /** Returns the number of samples that come out after the input falls silent.
+        The signal is only ever delayed, so this is the same as the latency.
+    */
+    int getTailSamples() const noexcept                 { return limiter.getTailSamples(); }
+
+    /** Clears the filters' state and lets go of any gain reduction. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Limits the first numChannels channels of the buffer in place.
+
+        The buffer mustn't have more samples than the maximum block size that the
+        limiter was created with.
+    */
+    void process (juce::AudioBuffer<SampleType>& buffer, float ceilingDecibels) noexcept;
+
+private:
+    //==============================================================================
+    static int prepareOversampling (juce::dsp::Oversampling<SampleType>&, int maximumBlockSize);
+    void findPeaks (const juce::dsp::AudioBlock<SampleType>& upsampled, int numSamples) noexcept;
+
+    const int numChannels;
+    juce::dsp::Oversampling<SampleType> oversampling;
+    const int factor;
+    juce::AudioBuffer<SampleType> peaks;
+    LookaheadLimiter<SampleType> limiter;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TruePeakLimiter)
+};